@@ -0,0 +1,624 @@
+#include "scriptjit.h"
+#include <string.h> // memcpy()
+#include <stddef.h> // offsetof()
+#include <vector>
+
+#define UNUSED_VAR(x) (void)(x)
+
+#if defined(__x86_64__) && defined(__linux__)
+#define SCRIPTJIT_X64
+#include <sys/mman.h> // mmap()
+#endif
+
+BEGIN_AS_NAMESPACE
+
+#ifdef SCRIPTJIT_X64
+
+// Registers. Only the ones that can be addressed without a REX.R or REX.B prefix are used
+enum
+{
+	RAX = 0, RCX = 1, RDX = 2, RBX = 3, RBP = 5, RSI = 6, RDI = 7
+};
+
+// Condition codes for Jcc and SETcc
+enum
+{
+	CC_B = 0x2, CC_E = 0x4, CC_NE = 0x5, CC_A = 0x7, CC_P = 0xA, CC_L = 0xC, CC_GE = 0xD, CC_LE = 0xE, CC_G = 0xF
+};
+
+// While the machine code runs, rbx holds the asSVMRegisters and rbp the stack frame
+// pointer. rax, rcx, rdx, xmm0 and xmm1 are only used within an instruction, so all
+// the state is in memory between the instructions and the code can leave anywhere
+static const int REGS = RBX;
+static const int FP   = RBP;
+
+static const int PROGRAM_POINTER    = offsetof(asSVMRegisters, programPointer);
+static const int STACK_FRAME        = offsetof(asSVMRegisters, stackFramePointer);
+static const int VALUE_REGISTER     = offsetof(asSVMRegisters, valueRegister);
+static const int DO_PROCESS_SUSPEND = offsetof(asSVMRegisters, doProcessSuspend);
+
+class CAssembler
+{
+public:
+	size_t Size() const { return code.size(); }
+
+	void Byte(asBYTE b) { code.push_back(b); }
+	void Dword(asDWORD d) { for( int n = 0; n < 4; n++ ) code.push_back(asBYTE(d >> (n*8))); }
+	void Qword(asQWORD q) { Dword(asDWORD(q)); Dword(asDWORD(q >> 32)); }
+
+	// ModRM for the operand [base+disp32]
+	void Mem(int reg, int base, int disp) { Byte(asBYTE(0x80 | (reg << 3) | base)); Dword(asDWORD(disp)); }
+
+	// ModRM for a register operand
+	void Reg(int reg, int rm) { Byte(asBYTE(0xC0 | (reg << 3) | rm)); }
+
+	// ModRM for a variable in the stack frame. Variables are counted in dwords below the frame pointer
+	void Var(int reg, short var, int offset = 0) { Mem(reg, FP, -4*int(var) + offset); }
+
+	// Jumps with a 32 bit displacement. They return where the displacement is, so it can be patched later
+	size_t Jmp() { Byte(0xE9); Dword(0); return Size() - 4; }
+	size_t Jcc(int cc) { Byte(0x0F); Byte(asBYTE(0x80 | cc)); Dword(0); return Size() - 4; }
+	void Patch(size_t at, size_t target) { int rel = int(target) - int(at + 4); memcpy(&code[at], &rel, 4); }
+
+	std::vector<asBYTE> code;
+};
+
+// A jump to patch, either to another instruction or to a stub that returns to the VM
+struct SFixup
+{
+	size_t   at;
+	asUINT   target;
+};
+
+// Stores where the VM must continue and returns from the machine code
+static void EmitExit(CAssembler &a, asDWORD *bc)
+{
+	a.Byte(0x48); a.Byte(0xB8); a.Qword(asQWORD(asPWORD(bc)));    // mov rax, bc
+	a.Byte(0x48); a.Byte(0x89); a.Mem(RAX, REGS, PROGRAM_POINTER); // mov [regs.programPointer], rax
+	a.Byte(0x5D);                                                  // pop rbp
+	a.Byte(0x5B);                                                  // pop rbx
+	a.Byte(0xC3);                                                  // ret
+}
+
+// Sets the value register to -1, 0 or 1 from the flags of a signed or unsigned comparison
+static void EmitCompareResult(CAssembler &a, int ccGreater, int ccLess)
+{
+	a.Byte(0x0F); a.Byte(asBYTE(0x90 | ccGreater)); a.Reg(0, RCX);   // setg cl
+	a.Byte(0x0F); a.Byte(asBYTE(0x90 | ccLess)); a.Reg(0, RDX);      // setl dl
+	a.Byte(0x0F); a.Byte(0xB6); a.Reg(RCX, RCX);                    // movzx ecx, cl
+	a.Byte(0x0F); a.Byte(0xB6); a.Reg(RDX, RDX);                    // movzx edx, dl
+	a.Byte(0x2B); a.Reg(RCX, RDX);                                  // sub ecx, edx
+	a.Byte(0x89); a.Mem(RCX, REGS, VALUE_REGISTER);                 // mov [regs.valueRegister], ecx
+}
+
+// Compares xmm0 with xmm1 like the VM does, where an unordered comparison gives 1.
+// prefix is 0x66 for doubles, or 0 for floats
+static void EmitFloatCompareResult(CAssembler &a, asBYTE prefix)
+{
+	if( prefix ) a.Byte(prefix);
+	a.Byte(0x0F); a.Byte(0x2E); a.Reg(0, 1);                        // ucomiss xmm0, xmm1
+	a.Byte(0x0F); a.Byte(0x90 | CC_A); a.Reg(0, RCX);               // seta cl
+	a.Byte(0x0F); a.Byte(0x90 | CC_P); a.Reg(0, RDX);               // setp dl
+	a.Byte(0x08); a.Reg(RDX, RCX);                                  // or cl, dl
+	if( prefix ) a.Byte(prefix);
+	a.Byte(0x0F); a.Byte(0x2E); a.Reg(1, 0);                        // ucomiss xmm1, xmm0
+	a.Byte(0x0F); a.Byte(0x90 | CC_A); a.Reg(0, RAX);               // seta al
+	a.Byte(0x0F); a.Byte(0xB6); a.Reg(RCX, RCX);                    // movzx ecx, cl
+	a.Byte(0x0F); a.Byte(0xB6); a.Reg(RAX, RAX);                    // movzx eax, al
+	a.Byte(0x2B); a.Reg(RCX, RAX);                                  // sub ecx, eax
+	a.Byte(0x89); a.Mem(RCX, REGS, VALUE_REGISTER);                 // mov [regs.valueRegister], ecx
+}
+
+// mov eax, [w1]; op eax, [w2]; mov [w0], eax. rex is 0x48 for the 64 bit instructions
+static void EmitIntOp(CAssembler &a, asDWORD *bc, asBYTE rex, asBYTE op, asBYTE op2 = 0)
+{
+	if( rex ) a.Byte(rex);
+	a.Byte(0x8B); a.Var(RAX, asBC_SWORDARG1(bc));
+	if( rex ) a.Byte(rex);
+	a.Byte(op); if( op2 ) a.Byte(op2); a.Var(RAX, asBC_SWORDARG2(bc));
+	if( rex ) a.Byte(rex);
+	a.Byte(0x89); a.Var(RAX, asBC_SWORDARG0(bc));
+}
+
+// The shift count is always a 32 bit variable
+static void EmitShift(CAssembler &a, asDWORD *bc, asBYTE rex, int ext)
+{
+	if( rex ) a.Byte(rex);
+	a.Byte(0x8B); a.Var(RAX, asBC_SWORDARG1(bc));                   // mov eax, [w1]
+	a.Byte(0x8B); a.Var(RCX, asBC_SWORDARG2(bc));                   // mov ecx, [w2]
+	if( rex ) a.Byte(rex);
+	a.Byte(0xD3); a.Reg(ext, RAX);                                  // shl/shr/sar eax, cl
+	if( rex ) a.Byte(rex);
+	a.Byte(0x89); a.Var(RAX, asBC_SWORDARG0(bc));                   // mov [w0], eax
+}
+
+// movss xmm0, [w1]; op xmm0, [w2]; movss [w0], xmm0. prefix is 0xF3 for floats and 0xF2 for doubles
+static void EmitFloatOp(CAssembler &a, asDWORD *bc, asBYTE prefix, asBYTE op)
+{
+	a.Byte(prefix); a.Byte(0x0F); a.Byte(0x10); a.Var(0, asBC_SWORDARG1(bc));
+	a.Byte(prefix); a.Byte(0x0F); a.Byte(op);   a.Var(0, asBC_SWORDARG2(bc));
+	a.Byte(prefix); a.Byte(0x0F); a.Byte(0x11); a.Var(0, asBC_SWORDARG0(bc));
+}
+
+// Like EmitFloatOp, with the constant of the instruction as the second operand
+static void EmitFloatConstOp(CAssembler &a, asDWORD *bc, asBYTE op)
+{
+	a.Byte(0xB8); a.Dword(asBC_DWORDARG(bc+1));                     // mov eax, constant
+	a.Byte(0x66); a.Byte(0x0F); a.Byte(0x6E); a.Reg(1, RAX);        // movd xmm1, eax
+	a.Byte(0xF3); a.Byte(0x0F); a.Byte(0x10); a.Var(0, asBC_SWORDARG1(bc));
+	a.Byte(0xF3); a.Byte(0x0F); a.Byte(op);   a.Reg(0, 1);
+	a.Byte(0xF3); a.Byte(0x0F); a.Byte(0x11); a.Var(0, asBC_SWORDARG0(bc));
+}
+
+// Translates one instruction. Returns false if the VM must execute it
+static bool EmitInstruction(CAssembler &a, asDWORD *bc, asUINT pos, std::vector<SFixup> &jumps, std::vector<SFixup> &exits)
+{
+	asEBCInstr op = asEBCInstr(*(asBYTE*)bc);
+	switch( op )
+	{
+	case asBC_JitEntry:
+		// The machine code is already running
+		return true;
+
+	case asBC_SUSPEND:
+	{
+		// The VM calls the line callback or suspends the context
+		a.Byte(0x80); a.Mem(7, REGS, DO_PROCESS_SUSPEND); a.Byte(0); // cmp byte [regs.doProcessSuspend], 0
+		SFixup exit = { a.Jcc(CC_NE), pos };
+		exits.push_back(exit);
+		return true;
+	}
+
+	//--------------
+	// Jumps
+	case asBC_JMP:
+	{
+		SFixup jump = { a.Jmp(), asUINT(pos + 2 + asBC_INTARG(bc)) };
+		jumps.push_back(jump);
+		return true;
+	}
+
+	case asBC_JZ:
+	case asBC_JNZ:
+	case asBC_JS:
+	case asBC_JNS:
+	case asBC_JP:
+	case asBC_JNP:
+	{
+		static const int cc[] = { CC_E, CC_NE, CC_L, CC_GE, CC_G, CC_LE };
+		a.Byte(0x83); a.Mem(7, REGS, VALUE_REGISTER); a.Byte(0);    // cmp dword [regs.valueRegister], 0
+		SFixup jump = { a.Jcc(cc[op - asBC_JZ]), asUINT(pos + 2 + asBC_INTARG(bc)) };
+		jumps.push_back(jump);
+		return true;
+	}
+
+	case asBC_JLowZ:
+	case asBC_JLowNZ:
+	{
+		a.Byte(0x80); a.Mem(7, REGS, VALUE_REGISTER); a.Byte(0);    // cmp byte [regs.valueRegister], 0
+		SFixup jump = { a.Jcc(op == asBC_JLowZ ? CC_E : CC_NE), asUINT(pos + 2 + asBC_INTARG(bc)) };
+		jumps.push_back(jump);
+		return true;
+	}
+
+	//--------------
+	// Tests of the value register. The boolean is stored in the lowest byte, and the
+	// rest of the register is cleared
+	case asBC_TZ:
+	case asBC_TNZ:
+	case asBC_TS:
+	case asBC_TNS:
+	case asBC_TP:
+	case asBC_TNP:
+	{
+		static const int cc[] = { CC_E, CC_NE, CC_L, CC_GE, CC_G, CC_LE };
+		a.Byte(0x83); a.Mem(7, REGS, VALUE_REGISTER); a.Byte(0);    // cmp dword [regs.valueRegister], 0
+		a.Byte(0x0F); a.Byte(asBYTE(0x90 | cc[op - asBC_TZ])); a.Reg(0, RAX); // setcc al
+		a.Byte(0x0F); a.Byte(0xB6); a.Reg(RAX, RAX);                // movzx eax, al
+		a.Byte(0x48); a.Byte(0x89); a.Mem(RAX, REGS, VALUE_REGISTER); // mov [regs.valueRegister], rax
+		return true;
+	}
+
+	//--------------
+	// Comparisons
+	case asBC_CMPi:
+	case asBC_CMPu:
+	case asBC_CMPi64:
+	case asBC_CMPu64:
+	{
+		asBYTE rex = (op == asBC_CMPi64 || op == asBC_CMPu64) ? 0x48 : 0;
+		if( rex ) a.Byte(rex);
+		a.Byte(0x8B); a.Var(RAX, asBC_SWORDARG0(bc));               // mov eax, [w0]
+		if( rex ) a.Byte(rex);
+		a.Byte(0x3B); a.Var(RAX, asBC_SWORDARG1(bc));               // cmp eax, [w1]
+		if( op == asBC_CMPi || op == asBC_CMPi64 )
+			EmitCompareResult(a, CC_G, CC_L);
+		else
+			EmitCompareResult(a, CC_A, CC_B);
+		return true;
+	}
+
+	case asBC_CMPIi:
+	case asBC_CMPIu:
+		a.Byte(0x8B); a.Var(RAX, asBC_SWORDARG0(bc));               // mov eax, [w0]
+		a.Byte(0x3D); a.Dword(asBC_DWORDARG(bc));                   // cmp eax, constant
+		if( op == asBC_CMPIi )
+			EmitCompareResult(a, CC_G, CC_L);
+		else
+			EmitCompareResult(a, CC_A, CC_B);
+		return true;
+
+	case asBC_CMPf:
+		a.Byte(0xF3); a.Byte(0x0F); a.Byte(0x10); a.Var(0, asBC_SWORDARG0(bc)); // movss xmm0, [w0]
+		a.Byte(0xF3); a.Byte(0x0F); a.Byte(0x10); a.Var(1, asBC_SWORDARG1(bc)); // movss xmm1, [w1]
+		EmitFloatCompareResult(a, 0);
+		return true;
+
+	case asBC_CMPIf:
+		a.Byte(0xB8); a.Dword(asBC_DWORDARG(bc));                   // mov eax, constant
+		a.Byte(0x66); a.Byte(0x0F); a.Byte(0x6E); a.Reg(1, RAX);    // movd xmm1, eax
+		a.Byte(0xF3); a.Byte(0x0F); a.Byte(0x10); a.Var(0, asBC_SWORDARG0(bc)); // movss xmm0, [w0]
+		EmitFloatCompareResult(a, 0);
+		return true;
+
+	case asBC_CMPd:
+		a.Byte(0xF2); a.Byte(0x0F); a.Byte(0x10); a.Var(0, asBC_SWORDARG0(bc)); // movsd xmm0, [w0]
+		a.Byte(0xF2); a.Byte(0x0F); a.Byte(0x10); a.Var(1, asBC_SWORDARG1(bc)); // movsd xmm1, [w1]
+		EmitFloatCompareResult(a, 0x66);
+		return true;
+
+	//--------------
+	// Integer math
+	case asBC_ADDi:   EmitIntOp(a, bc, 0,    0x03);       return true;
+	case asBC_SUBi:   EmitIntOp(a, bc, 0,    0x2B);       return true;
+	case asBC_MULi:   EmitIntOp(a, bc, 0,    0x0F, 0xAF); return true;
+	case asBC_BAND:   EmitIntOp(a, bc, 0,    0x23);       return true;
+	case asBC_BOR:    EmitIntOp(a, bc, 0,    0x0B);       return true;
+	case asBC_BXOR:   EmitIntOp(a, bc, 0,    0x33);       return true;
+	case asBC_ADDi64: EmitIntOp(a, bc, 0x48, 0x03);       return true;
+	case asBC_SUBi64: EmitIntOp(a, bc, 0x48, 0x2B);       return true;
+	case asBC_MULi64: EmitIntOp(a, bc, 0x48, 0x0F, 0xAF); return true;
+	case asBC_BAND64: EmitIntOp(a, bc, 0x48, 0x23);       return true;
+	case asBC_BOR64:  EmitIntOp(a, bc, 0x48, 0x0B);       return true;
+	case asBC_BXOR64: EmitIntOp(a, bc, 0x48, 0x33);       return true;
+
+	case asBC_BSLL:   EmitShift(a, bc, 0,    4); return true;
+	case asBC_BSRL:   EmitShift(a, bc, 0,    5); return true;
+	case asBC_BSRA:   EmitShift(a, bc, 0,    7); return true;
+	case asBC_BSLL64: EmitShift(a, bc, 0x48, 4); return true;
+	case asBC_BSRL64: EmitShift(a, bc, 0x48, 5); return true;
+	case asBC_BSRA64: EmitShift(a, bc, 0x48, 7); return true;
+
+	case asBC_ADDIi:
+	case asBC_SUBIi:
+	case asBC_MULIi:
+		a.Byte(0x8B); a.Var(RAX, asBC_SWORDARG1(bc));               // mov eax, [w1]
+		if( op == asBC_ADDIi )
+			a.Byte(0x05);                                           // add eax, constant
+		else if( op == asBC_SUBIi )
+			a.Byte(0x2D);                                           // sub eax, constant
+		else
+		{
+			a.Byte(0x69); a.Reg(RAX, RAX);                          // imul eax, eax, constant
+		}
+		a.Dword(asBC_DWORDARG(bc+1));
+		a.Byte(0x89); a.Var(RAX, asBC_SWORDARG0(bc));               // mov [w0], eax
+		return true;
+
+	case asBC_DIVi:
+	case asBC_MODi:
+	case asBC_DIVu:
+	case asBC_MODu:
+	{
+		// The VM raises the exceptions for division by zero and overflow
+		a.Byte(0x8B); a.Var(RCX, asBC_SWORDARG2(bc));               // mov ecx, [w2]
+		a.Byte(0x85); a.Reg(RCX, RCX);                              // test ecx, ecx
+		SFixup zero = { a.Jcc(CC_E), pos };
+		exits.push_back(zero);
+		a.Byte(0x8B); a.Var(RAX, asBC_SWORDARG1(bc));               // mov eax, [w1]
+		if( op == asBC_DIVi || op == asBC_MODi )
+		{
+			a.Byte(0x83); a.Reg(7, RCX); a.Byte(0xFF);              // cmp ecx, -1
+			SFixup overflow = { a.Jcc(CC_E), pos };
+			exits.push_back(overflow);
+			a.Byte(0x99);                                           // cdq
+			a.Byte(0xF7); a.Reg(7, RCX);                            // idiv ecx
+		}
+		else
+		{
+			a.Byte(0x33); a.Reg(RDX, RDX);                          // xor edx, edx
+			a.Byte(0xF7); a.Reg(6, RCX);                            // div ecx
+		}
+		a.Byte(0x89); a.Var((op == asBC_DIVi || op == asBC_DIVu) ? RAX : RDX, asBC_SWORDARG0(bc));
+		return true;
+	}
+
+	case asBC_NEGi:   a.Byte(0xF7); a.Var(3, asBC_SWORDARG0(bc)); return true;              // neg dword [w0]
+	case asBC_BNOT:   a.Byte(0xF7); a.Var(2, asBC_SWORDARG0(bc)); return true;              // not dword [w0]
+	case asBC_NEGi64: a.Byte(0x48); a.Byte(0xF7); a.Var(3, asBC_SWORDARG0(bc)); return true; // neg qword [w0]
+	case asBC_BNOT64: a.Byte(0x48); a.Byte(0xF7); a.Var(2, asBC_SWORDARG0(bc)); return true; // not qword [w0]
+	case asBC_IncVi:  a.Byte(0xFF); a.Var(0, asBC_SWORDARG0(bc)); return true;              // inc dword [w0]
+	case asBC_DecVi:  a.Byte(0xFF); a.Var(1, asBC_SWORDARG0(bc)); return true;              // dec dword [w0]
+
+	case asBC_INCi:
+	case asBC_DECi:
+		// The value register holds the address of the variable
+		a.Byte(0x48); a.Byte(0x8B); a.Mem(RAX, REGS, VALUE_REGISTER); // mov rax, [regs.valueRegister]
+		a.Byte(0xFF); a.Mem(op == asBC_INCi ? 0 : 1, RAX, 0);       // inc/dec dword [rax]
+		return true;
+
+	//--------------
+	// Floating point math
+	case asBC_ADDf: EmitFloatOp(a, bc, 0xF3, 0x58); return true;
+	case asBC_SUBf: EmitFloatOp(a, bc, 0xF3, 0x5C); return true;
+	case asBC_MULf: EmitFloatOp(a, bc, 0xF3, 0x59); return true;
+	case asBC_ADDd: EmitFloatOp(a, bc, 0xF2, 0x58); return true;
+	case asBC_SUBd: EmitFloatOp(a, bc, 0xF2, 0x5C); return true;
+	case asBC_MULd: EmitFloatOp(a, bc, 0xF2, 0x59); return true;
+
+	case asBC_ADDIf: EmitFloatConstOp(a, bc, 0x58); return true;
+	case asBC_SUBIf: EmitFloatConstOp(a, bc, 0x5C); return true;
+	case asBC_MULIf: EmitFloatConstOp(a, bc, 0x59); return true;
+
+	case asBC_DIVf:
+	case asBC_DIVd:
+	{
+		// The VM raises the exception for division by zero
+		asBYTE prefix = op == asBC_DIVf ? 0xF3 : 0xF2;
+		a.Byte(prefix); a.Byte(0x0F); a.Byte(0x10); a.Var(1, asBC_SWORDARG2(bc)); // movss xmm1, [w2]
+		if( op == asBC_DIVd ) a.Byte(0x66);
+		a.Byte(0x0F); a.Byte(0x57); a.Reg(0, 0);                    // xorps xmm0, xmm0
+		if( op == asBC_DIVd ) a.Byte(0x66);
+		a.Byte(0x0F); a.Byte(0x2E); a.Reg(1, 0);                    // ucomiss xmm1, xmm0
+		a.Byte(0x7A); a.Byte(0x06);                                 // jp over the je, NaN isn't 0
+		SFixup zero = { a.Jcc(CC_E), pos };
+		exits.push_back(zero);
+		a.Byte(prefix); a.Byte(0x0F); a.Byte(0x10); a.Var(0, asBC_SWORDARG1(bc)); // movss xmm0, [w1]
+		a.Byte(prefix); a.Byte(0x0F); a.Byte(0x5E); a.Reg(0, 1);    // divss xmm0, xmm1
+		a.Byte(prefix); a.Byte(0x0F); a.Byte(0x11); a.Var(0, asBC_SWORDARG0(bc)); // movss [w0], xmm0
+		return true;
+	}
+
+	case asBC_NEGf:
+		a.Byte(0x81); a.Var(6, asBC_SWORDARG0(bc)); a.Dword(0x80000000);    // xor dword [w0], sign
+		return true;
+	case asBC_NEGd:
+		a.Byte(0x81); a.Var(6, asBC_SWORDARG0(bc), 4); a.Dword(0x80000000); // xor dword [w0+4], sign
+		return true;
+
+	//--------------
+	// Conversions
+	case asBC_iTOf:
+		a.Byte(0xF3); a.Byte(0x0F); a.Byte(0x2A); a.Var(0, asBC_SWORDARG0(bc));   // cvtsi2ss xmm0, [w0]
+		a.Byte(0xF3); a.Byte(0x0F); a.Byte(0x11); a.Var(0, asBC_SWORDARG0(bc));   // movss [w0], xmm0
+		return true;
+	case asBC_fTOi:
+		a.Byte(0xF3); a.Byte(0x0F); a.Byte(0x2C); a.Var(RAX, asBC_SWORDARG0(bc)); // cvttss2si eax, [w0]
+		a.Byte(0x89); a.Var(RAX, asBC_SWORDARG0(bc));                             // mov [w0], eax
+		return true;
+	case asBC_iTOd:
+		a.Byte(0xF2); a.Byte(0x0F); a.Byte(0x2A); a.Var(0, asBC_SWORDARG1(bc));   // cvtsi2sd xmm0, [w1]
+		a.Byte(0xF2); a.Byte(0x0F); a.Byte(0x11); a.Var(0, asBC_SWORDARG0(bc));   // movsd [w0], xmm0
+		return true;
+	case asBC_dTOi:
+		a.Byte(0xF2); a.Byte(0x0F); a.Byte(0x2C); a.Var(RAX, asBC_SWORDARG1(bc)); // cvttsd2si eax, [w1]
+		a.Byte(0x89); a.Var(RAX, asBC_SWORDARG0(bc));                             // mov [w0], eax
+		return true;
+	case asBC_fTOd:
+		a.Byte(0xF3); a.Byte(0x0F); a.Byte(0x5A); a.Var(0, asBC_SWORDARG1(bc));   // cvtss2sd xmm0, [w1]
+		a.Byte(0xF2); a.Byte(0x0F); a.Byte(0x11); a.Var(0, asBC_SWORDARG0(bc));   // movsd [w0], xmm0
+		return true;
+	case asBC_dTOf:
+		a.Byte(0xF2); a.Byte(0x0F); a.Byte(0x5A); a.Var(0, asBC_SWORDARG1(bc));   // cvtsd2ss xmm0, [w1]
+		a.Byte(0xF3); a.Byte(0x0F); a.Byte(0x11); a.Var(0, asBC_SWORDARG0(bc));   // movss [w0], xmm0
+		return true;
+
+	//--------------
+	// Copies between variables, constants and the value register
+	case asBC_CpyVtoV4:
+	case asBC_CpyVtoV8:
+		if( op == asBC_CpyVtoV8 ) a.Byte(0x48);
+		a.Byte(0x8B); a.Var(RAX, asBC_SWORDARG1(bc));               // mov eax, [w1]
+		if( op == asBC_CpyVtoV8 ) a.Byte(0x48);
+		a.Byte(0x89); a.Var(RAX, asBC_SWORDARG0(bc));               // mov [w0], eax
+		return true;
+
+	case asBC_SetV4:
+		a.Byte(0xC7); a.Var(0, asBC_SWORDARG0(bc)); a.Dword(asBC_DWORDARG(bc)); // mov dword [w0], constant
+		return true;
+
+	case asBC_SetV8:
+		a.Byte(0x48); a.Byte(0xB8); a.Qword(asBC_QWORDARG(bc));     // mov rax, constant
+		a.Byte(0x48); a.Byte(0x89); a.Var(RAX, asBC_SWORDARG0(bc)); // mov [w0], rax
+		return true;
+
+	case asBC_CpyVtoR4:
+	case asBC_CpyVtoR8:
+		if( op == asBC_CpyVtoR8 ) a.Byte(0x48);
+		a.Byte(0x8B); a.Var(RAX, asBC_SWORDARG0(bc));               // mov eax, [w0]
+		if( op == asBC_CpyVtoR8 ) a.Byte(0x48);
+		a.Byte(0x89); a.Mem(RAX, REGS, VALUE_REGISTER);             // mov [regs.valueRegister], eax
+		return true;
+
+	case asBC_CpyRtoV4:
+	case asBC_CpyRtoV8:
+		if( op == asBC_CpyRtoV8 ) a.Byte(0x48);
+		a.Byte(0x8B); a.Mem(RAX, REGS, VALUE_REGISTER);             // mov eax, [regs.valueRegister]
+		if( op == asBC_CpyRtoV8 ) a.Byte(0x48);
+		a.Byte(0x89); a.Var(RAX, asBC_SWORDARG0(bc));               // mov [w0], eax
+		return true;
+
+	default:
+		return false;
+	}
+}
+
+#endif // SCRIPTJIT_X64
+
+CScriptJIT::CScriptJIT()
+{
+	m_compiledFunctions    = 0;
+	m_compiledInstructions = 0;
+	m_fallbackInstructions = 0;
+}
+
+CScriptJIT::~CScriptJIT()
+{
+#ifdef SCRIPTJIT_X64
+	// The engines should have released all the functions already
+	for( std::map<asJITFunction, size_t>::iterator it = m_code.begin(); it != m_code.end(); ++it )
+		munmap((void*)it->first, it->second);
+#endif
+}
+
+bool CScriptJIT::IsSupported()
+{
+#ifdef SCRIPTJIT_X64
+	return true;
+#else
+	return false;
+#endif
+}
+
+int CScriptJIT::CompileFunction(asIScriptFunction *function, asJITFunction *output)
+{
+#ifdef SCRIPTJIT_X64
+	asUINT length;
+	asDWORD *byteCode = function->GetByteCode(&length);
+	if( byteCode == 0 )
+		return asINVALID_ARG;
+
+	CAssembler a;
+
+	// The VM calls the code with the registers in rdi and the jitArg in rsi,
+	// which is the address to continue from
+	a.Byte(0x53);                                                   // push rbx
+	a.Byte(0x55);                                                   // push rbp
+	a.Byte(0x48); a.Byte(0x89); a.Reg(RDI, RBX);                    // mov rbx, rdi
+	a.Byte(0x48); a.Byte(0x8B); a.Mem(RBP, REGS, STACK_FRAME);      // mov rbp, [regs.stackFramePointer]
+	a.Byte(0xFF); a.Reg(4, RSI);                                    // jmp rsi
+
+	// Where the code of each instruction starts, indexed by the bytecode position
+	std::vector<size_t> native(length, size_t(-1));
+	std::vector<bool>   translated(length, false);
+	std::vector<SFixup> jumps;
+	std::vector<SFixup> exits;
+	asUINT compiled = 0, fallback = 0;
+
+	for( asUINT pos = 0; pos < length; )
+	{
+		asDWORD *bc = byteCode + pos;
+		asEBCInstr op = asEBCInstr(*(asBYTE*)bc);
+
+		native[pos] = a.Size();
+		if( EmitInstruction(a, bc, pos, jumps, exits) )
+		{
+			translated[pos] = true;
+			if( op != asBC_JitEntry )
+				compiled++;
+		}
+		else
+		{
+			// Let the VM execute the instruction
+			EmitExit(a, bc);
+			fallback++;
+		}
+
+		pos += asBCTypeSize[asBCInfo[op].type];
+	}
+
+	// The exits for the instructions that the VM must finish after all
+	for( size_t n = 0; n < exits.size(); n++ )
+	{
+		a.Patch(exits[n].at, a.Size());
+		EmitExit(a, byteCode + exits[n].target);
+	}
+
+	for( size_t n = 0; n < jumps.size(); n++ )
+	{
+		if( jumps[n].target >= length || native[jumps[n].target] == size_t(-1) )
+		{
+			// The jump doesn't land on an instruction. No entry point has been set
+			// yet, so the VM keeps executing the whole function
+			return asERROR;
+		}
+		a.Patch(jumps[n].at, native[jumps[n].target]);
+	}
+
+	// The code is only worth entering where the next instruction was translated
+	std::vector<asUINT> entries;
+	for( asUINT pos = 0; pos < length; pos += asBCTypeSize[asBCInfo[*(asBYTE*)(byteCode + pos)].type] )
+	{
+		if( *(asBYTE*)(byteCode + pos) != asBC_JitEntry )
+			continue;
+
+		asUINT next = pos + asBCTypeSize[asBCInfo[asBC_JitEntry].type];
+		if( next < length && translated[next] && *(asBYTE*)(byteCode + next) != asBC_JitEntry )
+			entries.push_back(pos);
+		else
+			asBC_PTRARG(byteCode + pos) = 0;
+	}
+	if( entries.empty() )
+		return asNOT_SUPPORTED;
+
+	size_t size = a.Size();
+	void *code = mmap(0, size, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+	if( code == MAP_FAILED )
+		return asOUT_OF_MEMORY;
+	memcpy(code, &a.code[0], size);
+	if( mprotect(code, size, PROT_READ | PROT_EXEC) != 0 )
+	{
+		munmap(code, size);
+		return asERROR;
+	}
+
+	// The JitEntry argument tells the code where to continue. It can't be 0, as
+	// that makes the VM skip the JitEntry
+	for( size_t n = 0; n < entries.size(); n++ )
+		asBC_PTRARG(byteCode + entries[n]) = asPWORD(code) + native[entries[n]];
+
+	*output = reinterpret_cast<asJITFunction>(code);
+	m_code[*output] = size;
+
+	m_compiledFunctions++;
+	m_compiledInstructions += compiled;
+	m_fallbackInstructions += fallback;
+
+	return asSUCCESS;
+#else
+	UNUSED_VAR(function);
+	UNUSED_VAR(output);
+	return asNOT_SUPPORTED;
+#endif
+}
+
+void CScriptJIT::ReleaseJITFunction(asJITFunction func)
+{
+#ifdef SCRIPTJIT_X64
+	std::map<asJITFunction, size_t>::iterator it = m_code.find(func);
+	if( it == m_code.end() )
+		return;
+
+	munmap((void*)it->first, it->second);
+	m_code.erase(it);
+#else
+	UNUSED_VAR(func);
+#endif
+}
+
+asUINT CScriptJIT::GetCompiledFunctionCount() const
+{
+	return m_compiledFunctions;
+}
+
+asUINT CScriptJIT::GetCompiledInstructionCount() const
+{
+	return m_compiledInstructions;
+}
+
+asUINT CScriptJIT::GetFallbackInstructionCount() const
+{
+	return m_fallbackInstructions;
+}
+
+END_AS_NAMESPACE
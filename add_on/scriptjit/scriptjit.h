@@ -0,0 +1,56 @@
+#ifndef SCRIPTJIT_H
+#define SCRIPTJIT_H
+
+// CScriptJIT is a baseline JIT compiler for x86-64 Linux. Each bytecode
+// instruction of the arithmetic, comparison, jump and variable copy kinds is
+// translated to a fixed sequence of machine code that works directly on the
+// variables in the stack frame. At any other instruction the machine code
+// returns to the VM, which continues from there and enters the machine code
+// again at the next JitEntry instruction.
+//
+// Set asEP_INCLUDE_JIT_INSTRUCTIONS and give the compiler to the engine with
+// SetJITCompiler before building the scripts. On other platforms
+// CompileFunction fails and the VM runs the scripts on its own.
+//
+// The compiler must outlive the engines it is given to, and must not be used
+// by engines on different threads at the same time.
+
+#ifndef ANGELSCRIPT_H
+// Avoid having to inform include path if header is already include before
+#include <angelscript.h>
+#endif
+
+#include <map>
+
+BEGIN_AS_NAMESPACE
+
+class CScriptJIT : public asIJITCompiler
+{
+public:
+	CScriptJIT();
+	virtual ~CScriptJIT();
+
+	// asIJITCompiler
+	int  CompileFunction(asIScriptFunction *function, asJITFunction *output);
+	void ReleaseJITFunction(asJITFunction func);
+
+	// Returns false if the platform isn't supported
+	static bool IsSupported();
+
+	// Statistics of the functions compiled so far
+	asUINT GetCompiledFunctionCount() const;
+	asUINT GetCompiledInstructionCount() const;
+	asUINT GetFallbackInstructionCount() const;
+
+protected:
+	// Size of the executable memory of each compiled function
+	std::map<asJITFunction, size_t> m_code;
+
+	asUINT m_compiledFunctions;
+	asUINT m_compiledInstructions;
+	asUINT m_fallbackInstructions;
+};
+
+END_AS_NAMESPACE
+
+#endif
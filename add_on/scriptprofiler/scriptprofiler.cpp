@@ -0,0 +1,262 @@
+#include "scriptprofiler.h"
+#include <stdio.h>    // snprintf()
+#include <algorithm>  // std::sort(), std::find()
+#include <chrono>
+
+BEGIN_AS_NAMESPACE
+
+bool CScriptProfiler::SFrame::operator<(const SFrame &other) const
+{
+	if( function != other.function )
+		return function < other.function;
+	return line < other.line;
+}
+
+CScriptProfiler::CScriptProfiler()
+{
+	m_engine       = 0;
+	m_interval     = 0;
+	m_stopTimer    = false;
+	m_requestCount = 0;
+	m_timerSeconds = 0;
+	m_sampleCount  = 0;
+}
+
+CScriptProfiler::~CScriptProfiler()
+{
+	Stop();
+	Reset();
+}
+
+int CScriptProfiler::Start(asIScriptEngine *engine, asUINT samplesPerSecond)
+{
+	if( engine == 0 || samplesPerSecond == 0 )
+		return asINVALID_ARG;
+	if( m_engine )
+		return asERROR;
+
+	m_engine    = engine;
+	m_interval  = 1.0 / samplesPerSecond;
+	m_stopTimer = false;
+
+	m_engine->SetSampleCallback(SampleCallback, this);
+	m_timer = std::thread(&CScriptProfiler::TimerThread, this);
+
+	return 0;
+}
+
+void CScriptProfiler::Stop()
+{
+	if( m_engine == 0 )
+		return;
+
+	{
+		std::lock_guard<std::mutex> lock(m_timerMutex);
+		m_stopTimer = true;
+	}
+	m_timerWakeUp.notify_one();
+	m_timer.join();
+
+	// A context that saw the last request may still record it, which is harmless
+	// as long as the profiler isn't destroyed while scripts are being executed
+	m_engine->SetSampleCallback(0, 0);
+	m_engine = 0;
+}
+
+void CScriptProfiler::Reset()
+{
+	std::lock_guard<std::mutex> lock(m_mutex);
+
+	for( std::map<asIScriptFunction*, SFunctionSamples>::iterator it = m_functions.begin(); it != m_functions.end(); ++it )
+		it->first->Release();
+
+	m_functions.clear();
+	m_stacks.clear();
+	m_sampleCount = 0;
+
+	std::lock_guard<std::mutex> timerLock(m_timerMutex);
+	m_requestCount = 0;
+	m_timerSeconds = 0;
+}
+
+bool CScriptProfiler::IsRunning() const
+{
+	return m_engine != 0;
+}
+
+asUINT CScriptProfiler::GetSampleCount() const
+{
+	std::lock_guard<std::mutex> lock(m_mutex);
+	return m_sampleCount;
+}
+
+asUINT CScriptProfiler::GetRequestCount() const
+{
+	std::lock_guard<std::mutex> lock(m_timerMutex);
+	return m_requestCount;
+}
+
+double CScriptProfiler::GetSampleInterval() const
+{
+	std::lock_guard<std::mutex> lock(m_timerMutex);
+	return m_requestCount ? m_timerSeconds / m_requestCount : m_interval;
+}
+
+void CScriptProfiler::TimerThread()
+{
+	typedef std::chrono::steady_clock Clock;
+
+	Clock::duration interval = std::chrono::duration_cast<Clock::duration>(std::chrono::duration<double>(m_interval));
+	Clock::time_point last = Clock::now();
+	Clock::time_point next = last + interval;
+
+	std::unique_lock<std::mutex> lock(m_timerMutex);
+	for(;;)
+	{
+		if( m_timerWakeUp.wait_until(lock, next, [this] { return m_stopTimer; }) )
+			break;
+
+		m_engine->RequestSample();
+
+		// Each request stands for the time since the previous one
+		Clock::time_point requested = Clock::now();
+		m_timerSeconds += std::chrono::duration<double>(requested - last).count();
+		m_requestCount++;
+		last = requested;
+
+		// Keep to the rate, but don't try to catch up if the thread was held back
+		next += interval;
+		Clock::time_point now = Clock::now();
+		if( next < now )
+			next = now + interval;
+	}
+}
+
+void CScriptProfiler::SampleCallback(asIScriptContext *ctx, void *param)
+{
+	static_cast<CScriptProfiler*>(param)->TakeSample(ctx);
+}
+
+void CScriptProfiler::TakeSample(asIScriptContext *ctx)
+{
+	std::lock_guard<std::mutex> lock(m_mutex);
+
+	// Outermost function first, as in the folded stacks. Nested calls on the
+	// same context show up as levels without a function, and are skipped
+	m_stack.clear();
+	for( asUINT level = ctx->GetCallstackSize(); level-- > 0; )
+	{
+		SFrame frame;
+		frame.function = ctx->GetFunction(level);
+		if( frame.function == 0 )
+			continue;
+		frame.line = ctx->GetLineNumber(level);
+		m_stack.push_back(frame);
+	}
+	if( m_stack.empty() )
+		return;
+
+	m_sampleCount++;
+	m_stacks[m_stack]++;
+
+	// Count the total once per function, even if it appears more than once by recursion
+	m_seen.clear();
+	for( size_t n = 0; n < m_stack.size(); n++ )
+	{
+		asIScriptFunction *func = m_stack[n].function;
+		if( std::find(m_seen.begin(), m_seen.end(), func) != m_seen.end() )
+			continue;
+		m_seen.push_back(func);
+
+		std::map<asIScriptFunction*, SFunctionSamples>::iterator it = m_functions.find(func);
+		if( it == m_functions.end() )
+		{
+			func->AddRef();
+			SFunctionSamples samples = {0, 0};
+			it = m_functions.insert(std::make_pair(func, samples)).first;
+		}
+		it->second.total++;
+	}
+	m_functions[m_stack.back().function].self++;
+}
+
+void CScriptProfiler::WriteFoldedStacks(std::ostream &out, bool withLines) const
+{
+	std::lock_guard<std::mutex> lock(m_mutex);
+
+	// Without the lines, stacks that only differ in the lines are merged
+	std::map<std::string, asUINT> folded;
+	for( std::map<std::vector<SFrame>, asUINT>::const_iterator it = m_stacks.begin(); it != m_stacks.end(); ++it )
+	{
+		std::string key;
+		for( size_t n = 0; n < it->first.size(); n++ )
+		{
+			if( n > 0 )
+				key += ';';
+			key += it->first[n].function->GetDeclaration(true, true, false);
+			if( withLines )
+			{
+				char buf[16];
+				snprintf(buf, sizeof(buf), ":%d", it->first[n].line);
+				key += buf;
+			}
+		}
+		folded[key] += it->second;
+	}
+
+	for( std::map<std::string, asUINT>::const_iterator it = folded.begin(); it != folded.end(); ++it )
+		out << it->first << ' ' << it->second << '\n';
+}
+
+static bool CompareSelfTime(const CScriptProfiler::SFunctionTime &a, const CScriptProfiler::SFunctionTime &b)
+{
+	if( a.selfSamples != b.selfSamples )
+		return a.selfSamples > b.selfSamples;
+	return a.totalSamples > b.totalSamples;
+}
+
+std::vector<CScriptProfiler::SFunctionTime> CScriptProfiler::GetFunctionTimes() const
+{
+	std::lock_guard<std::mutex> lock(m_mutex);
+
+	double interval = GetSampleInterval();
+
+	std::vector<SFunctionTime> times;
+	for( std::map<asIScriptFunction*, SFunctionSamples>::const_iterator it = m_functions.begin(); it != m_functions.end(); ++it )
+	{
+		SFunctionTime time;
+		time.declaration  = it->first->GetDeclaration(true, true, false);
+		time.selfSamples  = it->second.self;
+		time.totalSamples = it->second.total;
+		time.selfSeconds  = it->second.self * interval;
+		time.totalSeconds = it->second.total * interval;
+		times.push_back(time);
+	}
+
+	std::sort(times.begin(), times.end(), CompareSelfTime);
+	return times;
+}
+
+void CScriptProfiler::WriteReport(std::ostream &out, asUINT maxFunctions) const
+{
+	std::vector<SFunctionTime> times = GetFunctionTimes();
+	asUINT samples = GetSampleCount();
+
+	char buf[64];
+	snprintf(buf, sizeof(buf), "%10s %7s %10s %7s  ", "self (ms)", "self %", "total (ms)", "total %");
+	out << buf << "function\n";
+
+	for( size_t n = 0; n < times.size() && n < maxFunctions; n++ )
+	{
+		const SFunctionTime &time = times[n];
+		snprintf(buf, sizeof(buf), "%10.1f %6.1f%% %10.1f %6.1f%%  ",
+			time.selfSeconds * 1000, samples ? 100.0 * time.selfSamples / samples : 0.0,
+			time.totalSeconds * 1000, samples ? 100.0 * time.totalSamples / samples : 0.0);
+		out << buf << time.declaration << '\n';
+	}
+
+	if( times.size() > maxFunctions )
+		out << "(" << times.size() - maxFunctions << " more functions)\n";
+}
+
+END_AS_NAMESPACE
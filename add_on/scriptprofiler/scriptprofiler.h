@@ -0,0 +1,119 @@
+#ifndef SCRIPTPROFILER_H
+#define SCRIPTPROFILER_H
+
+// CScriptProfiler is a sampling profiler for the scripts executed by an
+// engine. A timer thread asks the engine for a sample at a fixed rate, and
+// each context that is executing a script records its call stack at the next
+// statement it reaches, on its own thread. Time spent in application functions
+// is therefore counted on the statement that called them. Only the contexts
+// that start executing after Start are sampled.
+//
+// The samples can be written as folded stacks, which flamegraph.pl and most
+// other flame graph viewers read, or summarized as the time spent in each
+// function (self) and in each function with everything it called (total).
+//
+// The profiler uses std::thread, so it needs a C++11 compiler. The functions
+// that appear in the samples are kept alive until Reset or the destructor.
+
+#ifndef ANGELSCRIPT_H
+// Avoid having to inform include path if header is already include before
+#include <angelscript.h>
+#endif
+
+#include <map>
+#include <vector>
+#include <string>
+#include <ostream>
+#include <mutex>
+#include <thread>
+#include <condition_variable>
+
+BEGIN_AS_NAMESPACE
+
+class CScriptProfiler
+{
+public:
+	CScriptProfiler();
+	~CScriptProfiler();
+
+	// Starts the timer thread and sets the engine's sample callback. The engine
+	// must not be released before Stop, and only one profiler can use an engine
+	int  Start(asIScriptEngine *engine, asUINT samplesPerSecond = 1000);
+
+	// Stops sampling. The samples are kept until Reset
+	void Stop();
+	void Reset();
+
+	bool   IsRunning() const;
+	asUINT GetSampleCount() const;
+
+	// The number of samples the timer asked for, and the time each one stands
+	// for. The timer can't always keep to the rate, so the interval is measured.
+	// Requests made while no script was executing give no sample
+	asUINT GetRequestCount() const;
+	double GetSampleInterval() const;
+
+	// One line per distinct call stack, outermost function first, followed by the
+	// number of samples. With lines, each frame also has the line it was on
+	void WriteFoldedStacks(std::ostream &out, bool withLines = false) const;
+
+	struct SFunctionTime
+	{
+		std::string declaration;
+		asUINT      selfSamples;
+		asUINT      totalSamples;
+		double      selfSeconds;
+		double      totalSeconds;
+	};
+
+	// Sorted by self time, highest first
+	std::vector<SFunctionTime> GetFunctionTimes() const;
+
+	// The function times as a table, limited to the given number of functions
+	void WriteReport(std::ostream &out, asUINT maxFunctions = 20) const;
+
+protected:
+	struct SFrame
+	{
+		asIScriptFunction *function;
+		int                line;
+
+		bool operator<(const SFrame &other) const;
+	};
+
+	struct SFunctionSamples
+	{
+		asUINT self;
+		asUINT total;
+	};
+
+	static void SampleCallback(asIScriptContext *ctx, void *param);
+	void TakeSample(asIScriptContext *ctx);
+	void TimerThread();
+
+	asIScriptEngine        *m_engine;
+	double                  m_interval;
+
+	std::thread             m_timer;
+	mutable std::mutex      m_timerMutex;
+	std::condition_variable m_timerWakeUp;
+	bool                    m_stopTimer;
+
+	// Guarded by m_timerMutex
+	asUINT                  m_requestCount;
+	double                  m_timerSeconds;
+
+	// Guards the samples, as the contexts can record them from several threads
+	mutable std::mutex                             m_mutex;
+	asUINT                                         m_sampleCount;
+	std::map<std::vector<SFrame>, asUINT>          m_stacks;
+	std::map<asIScriptFunction*, SFunctionSamples> m_functions;
+
+	// Reused by TakeSample to avoid allocating for each sample
+	std::vector<SFrame>             m_stack;
+	std::vector<asIScriptFunction*> m_seen;
+};
+
+END_AS_NAMESPACE
+
+#endif
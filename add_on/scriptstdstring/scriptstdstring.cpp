@@ -18,16 +18,6 @@ BEGIN_AS_NAMESPACE
 
 #if AS_USE_STRINGPOOL == 1
 
-#ifdef AS_CAN_USE_CPP11
-	// The string pool doesn't need to keep a specific order in the
-	// pool, so the unordered_map is faster than the ordinary map
-	#include <unordered_map>  // std::unordered_map
-	typedef unordered_map<const char *, string> map_t;
-#else
-	#include <map>      // std::map
-	typedef map<const char *, string> map_t;
-#endif
-
 // By keeping the literal strings in a pool the application
 // performance is improved as there are less string copies created.
 
@@ -46,6 +36,264 @@ const asPWORD STRING_POOL = 1001;
 // IwGxInit() and finished with IwGxTerminate().
 static const string emptyString;
 
+#ifdef AS_CAN_USE_CPP11
+
+#include <atomic> // std::atomic
+
+#if defined(_MSC_VER) && _MSC_VER < 1900
+	#define STRINGPOOL_THREAD_LOCAL __declspec(thread)
+#else
+	#define STRINGPOOL_THREAD_LOCAL thread_local
+#endif
+
+// The factory is given the engine's own copy of the literal, which keeps its
+// address for as long as the engine lives, so the address identifies the literal.
+// The pool is an open addressing table keyed by that address that is searched
+// without any lock. An entry never changes after it has been published, and a
+// table is only changed by filling an empty slot. When a table is half full a
+// larger copy replaces it, and the old one is kept until the engine is released
+// as other threads may still be searching it. Adding a string takes the lock.
+class CStringPool
+{
+public:
+	CStringPool() : m_table(0) {}
+	~CStringPool();
+
+	// Safe to call from any thread at any time
+	const string *Find(const char *s) const;
+
+	// Must only be called while holding the exclusive lock
+	const string *Insert(asUINT length, const char *s);
+
+protected:
+	struct SEntry
+	{
+		const char *key;
+		string      value;
+	};
+
+	struct STable
+	{
+		asUINT           size;
+		asUINT           count;
+		atomic<SEntry*> *slots;
+		STable          *previous;
+	};
+
+	static asUINT  Hash(const char *s) { return asUINT((asQWORD(asPWORD(s)) * 0x9E3779B97F4A7C15ULL) >> 32); }
+	static STable *CreateTable(asUINT size, STable *previous);
+	static void    Publish(STable *table, SEntry *entry);
+
+	atomic<STable*> m_table;
+};
+
+CStringPool::~CStringPool()
+{
+	STable *table = m_table.load(memory_order_relaxed);
+
+	// The newest table holds all the entries
+	if( table )
+	{
+		for( asUINT n = 0; n < table->size; n++ )
+			delete table->slots[n].load(memory_order_relaxed);
+	}
+
+	while( table )
+	{
+		STable *previous = table->previous;
+		delete[] table->slots;
+		delete table;
+		table = previous;
+	}
+}
+
+CStringPool::STable *CStringPool::CreateTable(asUINT size, STable *previous)
+{
+	STable *table = new (nothrow) STable;
+	if( table == 0 )
+		return 0;
+
+	table->slots = new (nothrow) atomic<SEntry*>[size];
+	if( table->slots == 0 )
+	{
+		delete table;
+		return 0;
+	}
+
+	for( asUINT n = 0; n < size; n++ )
+		table->slots[n].store(0, memory_order_relaxed);
+	table->size     = size;
+	table->count    = 0;
+	table->previous = previous;
+	return table;
+}
+
+void CStringPool::Publish(STable *table, SEntry *entry)
+{
+	asUINT mask = table->size - 1;
+	asUINT n = Hash(entry->key) & mask;
+	while( table->slots[n].load(memory_order_relaxed) )
+		n = (n + 1) & mask;
+
+	// The release makes the entry's string visible to the threads that find the entry
+	table->slots[n].store(entry, memory_order_release);
+	table->count++;
+}
+
+const string *CStringPool::Find(const char *s) const
+{
+	const STable *table = m_table.load(memory_order_acquire);
+	if( table == 0 )
+		return 0;
+
+	// The table is never more than half full, so there is always an empty slot to stop at
+	asUINT mask = table->size - 1;
+	for( asUINT n = Hash(s) & mask; ; n = (n + 1) & mask )
+	{
+		const SEntry *entry = table->slots[n].load(memory_order_acquire);
+		if( entry == 0 )
+			return 0;
+		if( entry->key == s )
+			return &entry->value;
+	}
+}
+
+const string *CStringPool::Insert(asUINT length, const char *s)
+{
+	// Another thread may have added the string while this one waited for the lock
+	const string *found = Find(s);
+	if( found )
+		return found;
+
+	STable *table = m_table.load(memory_order_relaxed);
+	if( table == 0 || (table->count + 1) * 2 > table->size )
+	{
+		STable *larger = CreateTable(table ? table->size * 2 : 64, table);
+		if( larger == 0 )
+			return 0;
+
+		if( table )
+		{
+			for( asUINT n = 0; n < table->size; n++ )
+			{
+				SEntry *entry = table->slots[n].load(memory_order_relaxed);
+				if( entry )
+					Publish(larger, entry);
+			}
+		}
+
+		m_table.store(larger, memory_order_release);
+		table = larger;
+	}
+
+	SEntry *entry = new (nothrow) SEntry;
+	if( entry == 0 )
+		return 0;
+	entry->key   = s;
+	entry->value = string(s, length);
+	Publish(table, entry);
+
+	return &entry->value;
+}
+
+// Each thread remembers the pool of the engine it last created a string for, so
+// that the pool can be found without the lock that GetUserData takes. A new engine
+// may get the address of a released one, so the remembered pool is only used as
+// long as no pool has been destroyed since it was looked up.
+static atomic<asUINT> poolsDestroyed(0);
+
+static STRINGPOOL_THREAD_LOCAL struct
+{
+	asIScriptEngine *engine;
+	CStringPool     *pool;
+	asUINT           poolsDestroyed;
+} lastPool;
+
+static CStringPool *GetStringPool(asIScriptEngine *engine)
+{
+	asUINT destroyed = poolsDestroyed.load(memory_order_acquire);
+	if( lastPool.engine == engine && lastPool.poolsDestroyed == destroyed )
+		return lastPool.pool;
+
+	CStringPool *pool = reinterpret_cast< CStringPool* >(engine->GetUserData(STRING_POOL));
+	if( !pool )
+	{
+		// The string pool hasn't been created yet, so we'll create it now
+		asAcquireExclusiveLock();
+
+		// Make sure the string pool wasn't created while we were waiting for the lock
+		pool = reinterpret_cast< CStringPool* >(engine->GetUserData(STRING_POOL));
+		if( !pool )
+		{
+			pool = new (nothrow) CStringPool;
+			if( pool == 0 )
+			{
+				asReleaseExclusiveLock();
+				return 0;
+			}
+			engine->SetUserData(pool, STRING_POOL);
+		}
+
+		asReleaseExclusiveLock();
+	}
+
+	lastPool.engine         = engine;
+	lastPool.pool           = pool;
+	lastPool.poolsDestroyed = destroyed;
+	return pool;
+}
+
+static const string &StringFactory(asUINT length, const char *s)
+{
+	// Each engine instance has its own string pool
+	asIScriptContext *ctx = asGetActiveContext();
+	if( ctx == 0 )
+	{
+		// The string factory can only be called from a script
+		assert( ctx );
+		return emptyString;
+	}
+
+	CStringPool *pool = GetStringPool(ctx->GetEngine());
+	if( pool == 0 )
+	{
+		ctx->SetException("Out of memory");
+		return emptyString;
+	}
+
+	// Only the first use of each literal needs the lock
+	const string *str = pool->Find(s);
+	if( str == 0 )
+	{
+		asAcquireExclusiveLock();
+		str = pool->Insert(length, s);
+		asReleaseExclusiveLock();
+
+		if( str == 0 )
+		{
+			ctx->SetException("Out of memory");
+			return emptyString;
+		}
+	}
+
+	return *str;
+}
+
+static void CleanupEngineStringPool(asIScriptEngine *engine)
+{
+	CStringPool *pool = reinterpret_cast< CStringPool* >(engine->GetUserData(STRING_POOL));
+	if( pool )
+	{
+		poolsDestroyed.fetch_add(1, memory_order_release);
+		delete pool;
+	}
+}
+
+#else
+
+#include <map>      // std::map
+typedef map<const char *, string> map_t;
+
 static const string &StringFactory(asUINT length, const char *s)
 {
 	// Each engine instance has its own string pool
@@ -121,6 +369,8 @@ static void CleanupEngineStringPool(asIScriptEngine *engine)
 		delete pool;
 }
 
+#endif // AS_CAN_USE_CPP11
+
 #else
 static string StringFactory(asUINT length, const char *s)
 {
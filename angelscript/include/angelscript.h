@@ -138,6 +138,9 @@ enum asEEngineProp
 	asEP_DISABLE_INTEGER_DIVISION           = 22,
 	asEP_DISALLOW_EMPTY_LIST_ELEMENTS       = 23,
 	asEP_PRIVATE_PROP_AS_PROTECTED          = 24,
+	asEP_LAZY_BYTECODE_TRANSLATION          = 25,
+	asEP_GC_PROMOTION_AGE                   = 26,
+	asEP_MAX_POOLED_CONTEXTS                = 27,
 
 	asEP_LAST_PROPERTY
 };
@@ -274,7 +277,8 @@ enum asEGCFlags
 	asGC_FULL_CYCLE      = 1,
 	asGC_ONE_STEP        = 2,
 	asGC_DESTROY_GARBAGE = 4,
-	asGC_DETECT_GARBAGE  = 8
+	asGC_DETECT_GARBAGE  = 8,
+	asGC_TIME_BUDGET     = 16
 };
 
 // Token classes
@@ -399,8 +403,12 @@ typedef void (*asCLEANCONTEXTFUNC_t)(asIScriptContext *);
 typedef void (*asCLEANFUNCTIONFUNC_t)(asIScriptFunction *);
 typedef void (*asCLEANOBJECTTYPEFUNC_t)(asIObjectType *);
 typedef void (*asCLEANSCRIPTOBJECTFUNC_t)(asIScriptObject *);
+typedef void (*asPROFILERCALLBACK_t)(const char *path, const char *name, int depth, asQWORD count, double totalSeconds, double minSeconds, double maxSeconds, void *param);
+typedef void (*asMEMORYPOOLCALLBACK_t)(const char *name, asUINT objectSize, asUINT liveObjects, asUINT peakObjects, asQWORD totalAllocs, asUINT slabCount, void *param);
 typedef asIScriptContext *(*asREQUESTCONTEXTFUNC_t)(asIScriptEngine *, void *);
 typedef void (*asRETURNCONTEXTFUNC_t)(asIScriptEngine *, asIScriptContext *, void *);
+typedef void (*asSAMPLECALLBACK_t)(asIScriptContext *, void *);
+typedef void (*asOPCODESTATSCALLBACK_t)(asIScriptFunction *func, const asQWORD *counts, const asQWORD *cycles, void *param);
 
 // Check if the compiler can use C++11 features
 #if !defined(_MSC_VER) || _MSC_VER >= 1700   // MSVC 2012
@@ -512,6 +520,22 @@ struct asSMessageInfo
 	const char *message;
 };
 
+// Entries for the batch registration functions. Each entry takes
+// the same arguments as the corresponding single registration.
+struct asSFuncRegistration
+{
+	const char *declaration;
+	asSFuncPtr  funcPointer;
+	asDWORD     callConv;
+	void       *objForThiscall;
+};
+
+struct asSPropRegistration
+{
+	const char *declaration;
+	void       *pointer;
+};
+
 
 // API functions
 
@@ -570,6 +594,14 @@ extern "C"
 
 	// Auxiliary
 	AS_API asILockableSharedBool *asCreateLockableSharedBool();
+
+	// Profiling, returns asNOT_SUPPORTED unless the library is compiled with AS_PROFILE.
+	// asBeginProfilerScope returns 1 if it began a scope, which asEndProfilerScope must end, or 0 while disabled
+	AS_API int asSetProfilerEnabled(bool enabled);
+	AS_API int asBeginProfilerScope(const char *name);
+	AS_API int asEndProfilerScope();
+	AS_API int asEnumerateProfilerScopes(asPROFILERCALLBACK_t callback, void *param);
+	AS_API int asResetProfiler();
 }
 #endif // ANGELSCRIPT_DLL_MANUAL_IMPORT
 
@@ -650,6 +682,7 @@ public:
 	virtual int AddRef() const = 0;
 	virtual int Release() const = 0;
 	virtual int ShutDownAndRelease() = 0;
+	virtual int EnumerateMemoryPools(asMEMORYPOOLCALLBACK_t callback, void *param = 0) const = 0;
 
 	// Engine properties
 	virtual int     SetEngineProperty(asEEngineProp property, asPWORD value) = 0;
@@ -666,12 +699,14 @@ public:
 
 	// Global functions
 	virtual int                RegisterGlobalFunction(const char *declaration, const asSFuncPtr &funcPointer, asDWORD callConv, void *objForThiscall = 0) = 0;
+	virtual int                RegisterGlobalFunctions(const asSFuncRegistration *registrations, asUINT count, int *outResults = 0) = 0;
 	virtual asUINT             GetGlobalFunctionCount() const = 0;
 	virtual asIScriptFunction *GetGlobalFunctionByIndex(asUINT index) const = 0;
 	virtual asIScriptFunction *GetGlobalFunctionByDecl(const char *declaration) const = 0;
 
 	// Global properties
 	virtual int    RegisterGlobalProperty(const char *declaration, void *pointer) = 0;
+	virtual int    RegisterGlobalProperties(const asSPropRegistration *registrations, asUINT count, int *outResults = 0) = 0;
 	virtual asUINT GetGlobalPropertyCount() const = 0;
 	virtual int    GetGlobalPropertyByIndex(asUINT index, const char **name, const char **nameSpace = 0, int *typeId = 0, bool *isConst = 0, const char **configGroup = 0, void **pointer = 0, asDWORD *accessMask = 0) const = 0;
 	virtual int    GetGlobalPropertyIndexByName(const char *name) const = 0;
@@ -681,6 +716,7 @@ public:
 	virtual int            RegisterObjectType(const char *obj, int byteSize, asDWORD flags) = 0;
 	virtual int            RegisterObjectProperty(const char *obj, const char *declaration, int byteOffset) = 0;
 	virtual int            RegisterObjectMethod(const char *obj, const char *declaration, const asSFuncPtr &funcPointer, asDWORD callConv, void *objForThiscall = 0) = 0;
+	virtual int            RegisterObjectMethods(const char *obj, const asSFuncRegistration *registrations, asUINT count, int *outResults = 0) = 0;
 	virtual int            RegisterObjectBehaviour(const char *obj, asEBehaviours behaviour, const char *declaration, const asSFuncPtr &funcPointer, asDWORD callConv, void *objForThiscall = 0) = 0;
 	virtual int            RegisterInterface(const char *name) = 0;
 	virtual int            RegisterInterfaceMethod(const char *intf, const char *declaration) = 0;
@@ -722,6 +758,7 @@ public:
 	virtual asDWORD     SetDefaultAccessMask(asDWORD defaultMask) = 0;
 	virtual int         SetDefaultNamespace(const char *nameSpace) = 0;
 	virtual const char *GetDefaultNamespace() const = 0;
+	virtual asIScriptEngine *CloneConfiguration() const = 0;
 
 	// Script modules
 	virtual asIScriptModule *GetModule(const char *module, asEGMFlags flag = asGM_ONLY_IF_EXISTS) = 0;
@@ -760,6 +797,15 @@ public:
 	virtual void                   ReturnContext(asIScriptContext *ctx) = 0;
 	virtual int                    SetContextCallbacks(asREQUESTCONTEXTFUNC_t requestCtx, asRETURNCONTEXTFUNC_t returnCtx, void *param = 0) = 0;
 
+	// Sampling of the executing scripts
+	virtual int                    SetSampleCallback(asSAMPLECALLBACK_t callback, void *param = 0) = 0;
+	virtual void                   RequestSample() = 0;
+
+	// Executed instructions, returns asNOT_SUPPORTED unless the library is compiled with AS_OPCODE_STATS
+	virtual int                    EnumerateOpcodeStats(asOPCODESTATSCALLBACK_t callback, void *param = 0) const = 0;
+	virtual int                    GetOpcodePairStats(asQWORD *counts) const = 0;
+	virtual int                    ResetOpcodeStats() = 0;
+
 	// String interpretation
 	virtual asETokenClass ParseToken(const char *string, size_t stringLength = 0, asUINT *tokenLength = 0) const = 0;
 
@@ -1140,6 +1186,14 @@ public:
 	virtual void Read(void *ptr, asUINT size) = 0;
 	virtual void Write(const void *ptr, asUINT size) = 0;
 
+	// Optional. A stream that holds the data to load in one contiguous block of memory
+	// can return the bytes that haven't been read yet, and their count in size.
+	// LoadByteCode then decodes them in place instead of calling Read for every value,
+	// and calls Skip with the amount of bytes it used when it is done. Return null to
+	// have LoadByteCode use Read.
+	virtual const void *GetReadBuffer(asUINT *size) { *size = 0; return 0; }
+	virtual void        Skip(asUINT size) { (void)size; }
+
 public:
 	virtual ~asIBinaryStream() {}
 };
@@ -1557,7 +1611,26 @@ enum asEBCInstr
 	asBC_POWi64			= 198,
 	asBC_POWu64			= 199,
 	asBC_Thiscall1		= 200,
-	asBC_MAXBYTECODE	= 201,
+
+	// Superinstructions. Each is emitted in place of the opcode of the first
+	// instruction of a pair, and the second instruction is kept after it
+	asBC_CMPiJZ			= 201,
+	asBC_CMPiJNZ		= 202,
+	asBC_CMPiJS			= 203,
+	asBC_CMPiJNS		= 204,
+	asBC_CMPiJP			= 205,
+	asBC_CMPiJNP		= 206,
+	asBC_CMPIiJZ		= 207,
+	asBC_CMPIiJNZ		= 208,
+	asBC_CMPIiJS		= 209,
+	asBC_CMPIiJNS		= 210,
+	asBC_CMPIiJP		= 211,
+	asBC_CMPIiJNP		= 212,
+	asBC_RDR4ADDi		= 213,
+	asBC_PSFCALLSYS		= 214,
+	asBC_PshVPtrCALLSYS	= 215,
+	asBC_PshV4CALLSYS	= 216,
+	asBC_MAXBYTECODE	= 217,
 
 	// Temporary tokens. Can't be output to the final program
 	asBC_VarDecl		= 251,
@@ -1853,22 +1926,22 @@ const asSBCInfo asBCInfo[256] =
 	asBCINFO(POWu64,	wW_rW_rW_ARG,	0),
 	asBCINFO(Thiscall1, DW_ARG,			-AS_PTR_SIZE-1),
 
-	asBCINFO_DUMMY(201),
-	asBCINFO_DUMMY(202),
-	asBCINFO_DUMMY(203),
-	asBCINFO_DUMMY(204),
-	asBCINFO_DUMMY(205),
-	asBCINFO_DUMMY(206),
-	asBCINFO_DUMMY(207),
-	asBCINFO_DUMMY(208),
-	asBCINFO_DUMMY(209),
-	asBCINFO_DUMMY(210),
-	asBCINFO_DUMMY(211),
-	asBCINFO_DUMMY(212),
-	asBCINFO_DUMMY(213),
-	asBCINFO_DUMMY(214),
-	asBCINFO_DUMMY(215),
-	asBCINFO_DUMMY(216),
+	asBCINFO(CMPiJZ, rW_rW_ARG,		0),
+	asBCINFO(CMPiJNZ, rW_rW_ARG,		0),
+	asBCINFO(CMPiJS, rW_rW_ARG,		0),
+	asBCINFO(CMPiJNS, rW_rW_ARG,		0),
+	asBCINFO(CMPiJP, rW_rW_ARG,		0),
+	asBCINFO(CMPiJNP, rW_rW_ARG,		0),
+	asBCINFO(CMPIiJZ, rW_DW_ARG,		0),
+	asBCINFO(CMPIiJNZ, rW_DW_ARG,		0),
+	asBCINFO(CMPIiJS, rW_DW_ARG,		0),
+	asBCINFO(CMPIiJNS, rW_DW_ARG,		0),
+	asBCINFO(CMPIiJP, rW_DW_ARG,		0),
+	asBCINFO(CMPIiJNP, rW_DW_ARG,		0),
+	asBCINFO(RDR4ADDi, wW_ARG,			0),
+	asBCINFO(PSFCALLSYS, rW_ARG,			AS_PTR_SIZE),
+	asBCINFO(PshVPtrCALLSYS, rW_ARG,			AS_PTR_SIZE),
+	asBCINFO(PshV4CALLSYS, rW_ARG,			1),
 	asBCINFO_DUMMY(217),
 	asBCINFO_DUMMY(218),
 	asBCINFO_DUMMY(219),
@@ -44,6 +44,10 @@
 
 #include "as_config.h"
 
+#if defined(AS_CAN_USE_CPP11) && !defined(AS_NO_THREADS)
+#include <atomic>
+#endif
+
 BEGIN_AS_NAMESPACE
 
 class asCAtomic
@@ -64,6 +68,41 @@ protected:
 	asDWORD value;
 };
 
+// A flag that is tested without a lock. Once get() has seen the value
+// given to set(), it also sees everything written before that set()
+class asCAtomicFlag
+{
+public:
+	asCAtomicFlag() { set(false); }
+
+#if defined(AS_NO_THREADS)
+	bool get() const    { return value; }
+	void set(bool val)  { value = val; }
+
+protected:
+	bool value;
+#elif defined(AS_CAN_USE_CPP11)
+	bool get() const    { return value.load(std::memory_order_acquire); }
+	void set(bool val)  { value.store(val, std::memory_order_release); }
+
+protected:
+	std::atomic<bool> value;
+#elif defined(__GNUC__)
+	bool get() const    { bool val = value; __sync_synchronize(); return val; }
+	void set(bool val)  { __sync_synchronize(); value = val; }
+
+protected:
+	volatile bool value;
+#else
+	// MSVC gives volatile accesses acquire and release semantics
+	bool get() const    { return value; }
+	void set(bool val)  { value = val; }
+
+protected:
+	volatile bool value;
+#endif
+};
+
 END_AS_NAMESPACE
 
 #endif
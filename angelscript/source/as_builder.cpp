@@ -521,7 +521,7 @@ int asCBuilder::CompileFunction(const char *sectionName, const char *code, int l
 
 	// Create the function
 	bool isConstructor, isDestructor, isPrivate, isProtected, isFinal, isOverride, isShared;
-	asCScriptFunction *func = asNEW(asCScriptFunction)(engine, compileFlags & asCOMP_ADD_TO_MODULE ? module : 0, asFUNC_SCRIPT);
+	asCScriptFunction *func = asNEWPOOLED(engine->memoryMgr, asPOOL_SCRIPT_FUNCTION, asCScriptFunction)(engine, compileFlags & asCOMP_ADD_TO_MODULE ? module : 0, asFUNC_SCRIPT);
 	if( func == 0 )
 		return asOUT_OF_MEMORY;
 
@@ -933,7 +933,7 @@ int asCBuilder::ParseDataType(const char *datatype, asCDataType *result, asSName
 	Reset();
 
 	asCScriptCode source;
-	source.SetCode("", datatype, true);
+	source.SetCode("", datatype, false);
 
 	asCParser parser(this);
 	int r = parser.ParseDataType(&source, isReturnType);
@@ -1000,7 +1000,7 @@ int asCBuilder::VerifyProperty(asCDataType *dt, const char *decl, asCString &nam
 
 	// Check property declaration and type
 	asCScriptCode source;
-	source.SetCode(TXT_PROPERTY, decl, true);
+	source.SetCode(TXT_PROPERTY, decl, false);
 
 	asCParser parser(this);
 	int r = parser.ParsePropertyDeclaration(&source);
@@ -1153,8 +1153,10 @@ int asCBuilder::ParseFunctionDeclaration(asCObjectType *objType, const char *dec
 
 	Reset();
 
+	// The declaration outlives the parsed nodes, so it isn't copied. This
+	// is called for every registered function and method
 	asCScriptCode source;
-	source.SetCode(TXT_SYSTEM_FUNCTION, decl, true);
+	source.SetCode(TXT_SYSTEM_FUNCTION, decl, false);
 
 	asCParser parser(this);
 	int r = parser.ParseFunctionDefinition(&source, listPattern != 0);
@@ -1319,7 +1321,7 @@ int asCBuilder::ParseVariableDeclaration(const char *decl, asSNameSpace *implici
 	Reset();
 
 	asCScriptCode source;
-	source.SetCode(TXT_VARIABLE_DECL, decl, true);
+	source.SetCode(TXT_VARIABLE_DECL, decl, false);
 
 	asCParser parser(this);
 
@@ -1847,7 +1849,7 @@ int asCBuilder::RegisterClass(asCScriptNode *node, asCScriptCode *file, asSNameS
 	}
 
 	// Create a new object type for this class
-	asCObjectType *st = asNEW(asCObjectType)(engine);
+	asCObjectType *st = asNEWPOOLED(engine->memoryMgr, asPOOL_OBJECT_TYPE, asCObjectType)(engine);
 	if( st == 0 )
 		return asOUT_OF_MEMORY;
 
@@ -1960,7 +1962,7 @@ int asCBuilder::RegisterInterface(asCScriptNode *node, asCScriptCode *file, asSN
 	}
 
 	// Register the object type for the interface
-	asCObjectType *st = asNEW(asCObjectType)(engine);
+	asCObjectType *st = asNEWPOOLED(engine->memoryMgr, asPOOL_OBJECT_TYPE, asCObjectType)(engine);
 	if( st == 0 )
 		return asOUT_OF_MEMORY;
 
@@ -2126,7 +2128,7 @@ void asCBuilder::CompileGlobalVariables()
 			else
 			{
 				// Compile the global variable
-				initFunc = asNEW(asCScriptFunction)(engine, module, asFUNC_SCRIPT);
+				initFunc = asNEWPOOLED(engine->memoryMgr, asPOOL_SCRIPT_FUNCTION, asCScriptFunction)(engine, module, asFUNC_SCRIPT);
 				if( initFunc == 0 )
 				{
 					// Out of memory
@@ -2148,7 +2150,7 @@ void asCBuilder::CompileGlobalVariables()
 				{
 					// Compilation failed
 					initFunc->funcType = asFUNC_DUMMY;
-					asDELETE(initFunc, asCScriptFunction);
+					asDELETEPOOLED(initFunc, asCScriptFunction);
 					initFunc = 0;
 				}
 			}
@@ -2193,7 +2195,7 @@ void asCBuilder::CompileGlobalVariables()
 				{
 					// Destroy the function as it won't be used
 					initFunc->funcType = asFUNC_DUMMY;
-					asDELETE(initFunc, asCScriptFunction);
+					asDELETEPOOLED(initFunc, asCScriptFunction);
 					initFunc = 0;
 				}
 
@@ -2290,7 +2292,7 @@ void asCBuilder::CompileGlobalVariables()
 			}
 			if( gvar->property )
 			{
-				asDELETE(gvar->property, asCGlobalProperty);
+				asDELETEPOOLED(gvar->property, asCGlobalProperty);
 				gvar->property = 0;
 			}
 
@@ -3581,7 +3583,7 @@ void asCBuilder::IncludePropertiesFromMixins(sClassDeclaration *decl)
 
 int asCBuilder::CreateVirtualFunction(asCScriptFunction *func, int idx)
 {
-	asCScriptFunction *vf = asNEW(asCScriptFunction)(engine, module, asFUNC_VIRTUAL);
+	asCScriptFunction *vf = asNEWPOOLED(engine->memoryMgr, asPOOL_SCRIPT_FUNCTION, asCScriptFunction)(engine, module, asFUNC_VIRTUAL);
 	if( vf == 0 )
 		return asOUT_OF_MEMORY;
 
@@ -3787,7 +3789,7 @@ int asCBuilder::RegisterEnum(asCScriptNode *node, asCScriptCode *file, asSNameSp
 		}
 		else
 		{
-			st = asNEW(asCObjectType)(engine);
+			st = asNEWPOOLED(engine->memoryMgr, asPOOL_OBJECT_TYPE, asCObjectType)(engine);
 			if( st == 0 )
 				return asOUT_OF_MEMORY;
 
@@ -3898,7 +3900,7 @@ int asCBuilder::RegisterEnum(asCScriptNode *node, asCScriptCode *file, asSNameSp
 
 				// Allocate dummy property so we can compile the value.
 				// This will be removed later on so we don't add it to the engine.
-				gvar->property = asNEW(asCGlobalProperty);
+				gvar->property = asNEWPOOLED(engine->memoryMgr, asPOOL_GLOBAL_PROPERTY, asCGlobalProperty);
 				if( gvar->property == 0 )
 					return asOUT_OF_MEMORY;
 
@@ -3939,7 +3941,7 @@ int asCBuilder::RegisterTypedef(asCScriptNode *node, asCScriptCode *file, asSNam
 	if( asSUCCESS == r )
 	{
 		// Create the new type
-		st = asNEW(asCObjectType)(engine);
+		st = asNEWPOOLED(engine->memoryMgr, asPOOL_OBJECT_TYPE, asCObjectType)(engine);
 		if( st == 0 )
 			r = asOUT_OF_MEMORY;
 	}
@@ -5379,14 +5381,11 @@ bool asCBuilder::DoesTypeExist(const asCString &type)
 		hasCachedKnownTypes = true;
 
 		// Add registered object types
-		asSMapNode<asSNameSpaceNamePair, asCObjectType*> *cursor;
-		engine->allRegisteredTypes.MoveFirst(&cursor);
-		while( cursor )
+		for( n = 0; n < engine->allRegisteredTypes.GetCount(); n++ )
 		{
-			if( !knownTypes.MoveTo(0, cursor->key.name) )
-				knownTypes.Insert(cursor->key.name, true);
-
-			engine->allRegisteredTypes.MoveNext(&cursor, cursor);
+			const asCString &name = engine->allRegisteredTypes.GetKey(n).name;
+			if( !knownTypes.MoveTo(0, name) )
+				knownTypes.Insert(name, true);
 		}
 
 		// Add registered funcdefs
@@ -5463,7 +5462,12 @@ asCObjectType *asCBuilder::GetObjectTypeFromTypesKnownByObject(const char *type,
 
 asCScriptFunction *asCBuilder::GetFuncDef(const char *type)
 {
-	for( asUINT n = 0; n < engine->registeredFuncDefs.GetLength(); n++ )
+	// Most names are only registered once. If there are more the first one registered is returned
+	int cursor = engine->registeredFuncDefIndex.GetFirst(asCString(type));
+	if( cursor >= 0 && engine->registeredFuncDefIndex.GetNext(cursor) < 0 )
+		return engine->registeredFuncDefIndex.GetValue(cursor);
+
+	for( asUINT n = 0; cursor >= 0 && n < engine->registeredFuncDefs.GetLength(); n++ )
 		// TODO: access: Only return the definitions that the module has access to
 		if( engine->registeredFuncDefs[n]->name == type )
 			return engine->registeredFuncDefs[n];
@@ -75,6 +75,9 @@ void asCByteCode::Finalize(const asCArray<int> &tempVariableOffsets)
 	// Optimize the code
 	Optimize();
 
+	// Replace common instruction pairs with superinstructions
+	FuseInstructions();
+
 	// Resolve jumps
 	ResolveJumpAddresses();
 
@@ -1184,6 +1187,60 @@ void asCByteCode::Optimize()
 	}
 }
 
+// The pairs were picked from the opcode pair counts of compiled game scripts
+static const struct { asEBCInstr first, second, fused; } superInstructions[] =
+{
+	{asBC_CMPi,    asBC_JZ,      asBC_CMPiJZ},
+	{asBC_CMPi,    asBC_JNZ,     asBC_CMPiJNZ},
+	{asBC_CMPi,    asBC_JS,      asBC_CMPiJS},
+	{asBC_CMPi,    asBC_JNS,     asBC_CMPiJNS},
+	{asBC_CMPi,    asBC_JP,      asBC_CMPiJP},
+	{asBC_CMPi,    asBC_JNP,     asBC_CMPiJNP},
+	{asBC_CMPIi,   asBC_JZ,      asBC_CMPIiJZ},
+	{asBC_CMPIi,   asBC_JNZ,     asBC_CMPIiJNZ},
+	{asBC_CMPIi,   asBC_JS,      asBC_CMPIiJS},
+	{asBC_CMPIi,   asBC_JNS,     asBC_CMPIiJNS},
+	{asBC_CMPIi,   asBC_JP,      asBC_CMPIiJP},
+	{asBC_CMPIi,   asBC_JNP,     asBC_CMPIiJNP},
+	{asBC_RDR4,    asBC_ADDi,    asBC_RDR4ADDi},
+	{asBC_PSF,     asBC_CALLSYS, asBC_PSFCALLSYS},
+	{asBC_PshVPtr, asBC_CALLSYS, asBC_PshVPtrCALLSYS},
+	{asBC_PshV4,   asBC_CALLSYS, asBC_PshV4CALLSYS}
+};
+
+void asCByteCode::FuseInstructions()
+{
+	// Only the opcode of the first instruction is replaced. The second instruction
+	// is kept as it is, so the size of the code, the jumps into it and the line
+	// numbers stay the same, and the superinstruction just skips over it
+
+	// A JIT compiler only knows the original instructions
+	if( !engine->ep.optimizeByteCode || engine->ep.includeJitInstructions || engine->jitCompiler )
+		return;
+
+	for( asCByteInstruction *curr = first; curr; curr = curr->next )
+	{
+		if( curr->GetSize() == 0 )
+			continue;
+
+		// Labels, line numbers and other pseudo instructions don't end up in the bytecode
+		asCByteInstruction *next = curr->next;
+		while( next && next->GetSize() == 0 )
+			next = next->next;
+		if( next == 0 )
+			break;
+
+		for( asUINT n = 0; n < sizeof(superInstructions)/sizeof(superInstructions[0]); n++ )
+		{
+			if( superInstructions[n].first == curr->op && superInstructions[n].second == next->op )
+			{
+				curr->op = superInstructions[n].fused;
+				break;
+			}
+		}
+	}
+}
+
 bool asCByteCode::IsTempVarReadByInstr(asCByteInstruction *curr, int offset)
 {
 	// Which instructions read from variables?
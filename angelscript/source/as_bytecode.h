@@ -69,6 +69,7 @@ public:
 	void Finalize(const asCArray<int> &tempVariableOffsets);
 
 	void Optimize();
+	void FuseInstructions();
 	void OptimizeLocally(const asCArray<int> &tempVariableOffsets);
 	void ExtractLineNumbers();
 	void ExtractObjectVariableInfo(asCScriptFunction *outFunc);
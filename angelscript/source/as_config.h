@@ -104,6 +104,11 @@
 // AS_USE_NAMESPACE
 // Adds the AngelScript namespace on the declarations.
 
+// AS_NO_COMPUTED_GOTO
+// On compilers that support labels as values (gcc, clang) the VM jumps directly from
+// one instruction to the next through a table of labels. Define this flag to use the
+// plain switch instead.
+
 
 
 //
@@ -1194,6 +1199,18 @@
 	#define AS_NO_THREADS
 #endif
 
+// Threaded dispatch in the VM needs the labels as values extension. It is left
+// out in debug and opcode statistics builds, where each instruction passes the
+// checks in the loop
+#if defined(__GNUC__) && !defined(AS_NO_COMPUTED_GOTO) && !defined(AS_DEBUG) && !defined(AS_OPCODE_STATS)
+	#define AS_COMPUTED_GOTO
+#endif
+
+// The cycles of each instruction are read from the time stamp counter, which only x86 and x64 have
+#if defined(AS_OPCODE_CYCLES) && !(defined(AS_OPCODE_STATS) && (defined(__i386__) || defined(__x86_64__) || defined(_M_IX86) || defined(_M_X64)))
+	#undef AS_OPCODE_CYCLES
+#endif
+
 
 // The assert macro
 #if defined(ANDROID)
@@ -160,6 +160,11 @@ void asCConfigGroup::RemoveConfiguration(asCScriptEngine *engine, bool notUsed)
 	for( n = 0; n < funcDefs.GetLength(); n++ )
 	{
 		engine->registeredFuncDefs.RemoveValue(funcDefs[n]);
+		int cursor = engine->registeredFuncDefIndex.GetFirst(funcDefs[n]->name);
+		while( cursor >= 0 && engine->registeredFuncDefIndex.GetValue(cursor) != funcDefs[n] )
+			cursor = engine->registeredFuncDefIndex.GetNext(cursor);
+		if( cursor >= 0 )
+			engine->registeredFuncDefIndex.Erase(cursor);
 		funcDefs[n]->ReleaseInternal();
 		engine->RemoveFuncdef(funcDefs[n]);
 		funcDefs[n]->ReleaseInternal();
@@ -172,9 +177,10 @@ void asCConfigGroup::RemoveConfiguration(asCScriptEngine *engine, bool notUsed)
 		for( n = asUINT(objTypes.GetLength()); n-- > 0; )
 		{
 			asCObjectType *t = objTypes[n];
-			asSMapNode<asSNameSpaceNamePair, asCObjectType*> *cursor;
-			if( engine->allRegisteredTypes.MoveTo(&cursor, asSNameSpaceNamePair(t->nameSpace, t->name)) &&
-				cursor->value == t )
+			int cursor = engine->allRegisteredTypes.GetFirst(asSNameSpaceNamePair(t->nameSpace, t->name));
+			while( cursor >= 0 && engine->allRegisteredTypes.GetValue(cursor) != t )
+				cursor = engine->allRegisteredTypes.GetNext(cursor);
+			if( cursor >= 0 )
 			{
 				engine->allRegisteredTypes.Erase(cursor);
 
@@ -48,6 +48,14 @@
 #include "as_bytecode.h"
 #include "as_scriptobject.h"
 
+#ifdef AS_OPCODE_CYCLES
+	#ifdef _MSC_VER
+		#include <intrin.h>    // __rdtsc()
+	#else
+		#include <x86intrin.h> // __rdtsc()
+	#endif
+#endif
+
 #ifdef _MSC_VER
 #pragma warning(disable:4702) // unreachable code
 #endif
@@ -185,6 +193,8 @@ asCContext::asCContext(asCScriptEngine *engine, bool holdRef)
 	m_initialFunction           = 0;
 	m_lineCallback              = false;
 	m_exceptionCallback         = false;
+	m_samplePending             = false;
+	m_sampleIndex               = -1;
 	m_regs.doProcessSuspend     = false;
 	m_doSuspend                 = false;
 	m_userData                  = 0;
@@ -290,6 +300,9 @@ void asCContext::DetachEngine()
 	}
 	m_userData.SetLength(0);
 
+	if( m_sampleIndex >= 0 )
+		m_engine->RemoveSampledContext(this);
+
 	// Clear engine pointer
 	if( m_holdEngineRef )
 		m_engine->Release();
@@ -450,6 +463,16 @@ int asCContext::Prepare(asIScriptFunction *func)
 		else
 			m_returnValueSize = 0;
 
+		// The stack needed isn't known until bytecode loaded with
+		// asEP_LAZY_BYTECODE_TRANSLATION has been translated
+		if( m_currentFunction->TranslatePendingByteCode() < 0 )
+		{
+			asCString str;
+			str.Format(TXT_FAILED_IN_FUNC_s_WITH_s_d, "Prepare", func->GetDeclaration(true, true), asERROR);
+			m_engine->WriteMessage("", 0, 0, asMSGTYPE_ERROR, str.AddressOf());
+			return asERROR;
+		}
+
 		// Determine the minimum stack size needed
 		int stackSize = m_argumentsSize + m_returnValueSize;
 		if( m_currentFunction->scriptData )
@@ -546,6 +569,46 @@ int asCContext::Unprepare()
 	return 0;
 }
 
+// internal
+// Prepares the context to be kept in the engine's pool. Returns false if the context can't be pooled
+bool asCContext::ReleaseForPool()
+{
+	if( m_status == asEXECUTION_ACTIVE || m_status == asEXECUTION_SUSPENDED || m_refCount.get() != 1 || !m_holdEngineRef )
+		return false;
+
+	// Don't keep the last function, and through it its module, alive
+	Unprepare();
+
+	// The next user shouldn't inherit the callbacks
+	ClearLineCallback();
+	ClearExceptionCallback();
+
+	// A pooled context mustn't keep the engine alive. The caller makes sure this isn't the last reference
+	m_holdEngineRef = false;
+	m_engine->Release();
+
+	return true;
+}
+
+// internal
+void asCContext::TakeFromPool()
+{
+	m_engine->AddRef();
+	m_holdEngineRef = true;
+}
+
+// internal
+// Called by the engine from any thread. If the context is executing, the
+// sample is taken at the next statement, like with Suspend
+void asCContext::RequestSample()
+{
+	if( m_status != asEXECUTION_ACTIVE )
+		return;
+
+	m_samplePending = true;
+	m_regs.doProcessSuspend = true;
+}
+
 asBYTE asCContext::GetReturnByte()
 {
 	if( m_status != asEXECUTION_FINISHED ) return 0;
@@ -1184,6 +1247,11 @@ int asCContext::Execute()
 
 	m_status = asEXECUTION_ACTIVE;
 
+	// Let RequestSample find the context. It stays in the list until it is destroyed,
+	// so only the first execution while a sample callback is set takes the lock
+	if( m_sampleIndex < 0 && m_engine->sampleCallback )
+		m_engine->AddSampledContext(this);
+
 	asCThreadLocalData *tld = asPushActiveContext((asIScriptContext *)this);
 
 	if( m_regs.programPointer == 0 )
@@ -1257,10 +1325,20 @@ int asCContext::Execute()
 
 		if( m_currentFunction->funcType == asFUNC_SCRIPT )
 		{
-			m_regs.programPointer = m_currentFunction->scriptData->byteCode.AddressOf();
+			// The function a delegate or virtual method resolved to may still need its translation.
+			// If it fails the exception is raised in the initial function, which has no stack frame.
+			if( m_currentFunction->scriptData->translationPending.get() && m_currentFunction->TranslatePendingByteCode() < 0 )
+			{
+				m_currentFunction = m_initialFunction;
+				SetInternalException(TXT_UNTRANSLATED_FUNCTION);
+			}
+			else
+			{
+				m_regs.programPointer = m_currentFunction->scriptData->byteCode.AddressOf();
 
-			// Set up the internal registers for executing the script function
-			PrepareScriptFunction();
+				// Set up the internal registers for executing the script function
+				PrepareScriptFunction();
+			}
 		}
 		else if( m_currentFunction->funcType == asFUNC_SYSTEM )
 		{
@@ -1290,6 +1368,9 @@ int asCContext::Execute()
 	while( m_status == asEXECUTION_ACTIVE )
 		ExecuteNext();
 
+	// Don't leave a request that came too late for the next execution
+	m_samplePending = false;
+
 	if( m_lineCallback )
 	{
 		// Call the line callback one last time before leaving
@@ -1679,6 +1760,13 @@ void asCContext::CallScriptFunction(asCScriptFunction *func)
 {
 	asASSERT( func->scriptData );
 
+	// Bytecode loaded with asEP_LAZY_BYTECODE_TRANSLATION is translated on the first call
+	if( func->scriptData->translationPending.get() && func->TranslatePendingByteCode() < 0 )
+	{
+		SetInternalException(TXT_UNTRANSLATED_FUNCTION);
+		return;
+	}
+
 	// Push the framepointer, function id and programCounter on the stack
 	PushCallState();
 
@@ -1797,15 +1885,162 @@ void asCContext::CallInterfaceMethod(asCScriptFunction *func)
 	CallScriptFunction(realFunc);
 }
 
+#ifdef AS_COMPUTED_GOTO
+	// Every instruction ends with its own jump to the next instruction's label,
+	// which the CPU predicts much better than the one shared jump of the switch.
+	// The switch is still used to dispatch the first instruction
+	#define asBC_CASE(op) case op: asBC_LABEL_##op
+	#define asBC_NEXT()   goto *dispatchTable[*(asBYTE*)l_bc]
+#else
+	#define asBC_CASE(op) case op
+	#define asBC_NEXT()   break
+#endif
+
+// A comparison of a variable with right, fused with the conditional jump after
+// it. The value register is still set in case it is read after the jump
+#define asBC_CMPi_JUMP(right, cond) \
+	{ \
+		int i1 = *(int*)(l_fp - asBC_SWORDARG0(l_bc)); \
+		int i2 = (right); \
+		if( i1 == i2 )     *(int*)&m_regs.valueRegister =  0; \
+		else if( i1 < i2 ) *(int*)&m_regs.valueRegister = -1; \
+		else               *(int*)&m_regs.valueRegister =  1; \
+		if( i1 cond i2 ) \
+			l_bc += asBC_INTARG(l_bc+2) + 4; \
+		else \
+			l_bc += 4; \
+	} \
+	asBC_NEXT()
+
+#ifdef AS_OPCODE_CYCLES
+// Charges the time stamp counter cycles since the start of an instruction to its
+// opcode. ExecuteNext returns from many places, so the last instruction it executed
+// is charged when the timer goes out of scope
+struct asSOpcodeTimer
+{
+	asSOpcodeTimer() : cycles(0), start(0) {}
+	~asSOpcodeTimer() { Next(0, __rdtsc()); }
+
+	void Next(asQWORD *nextCycles, asQWORD now)
+	{
+		if( cycles )
+			*cycles += now - start;
+		cycles = nextCycles;
+		start  = now;
+	}
+
+	asQWORD *cycles;
+	asQWORD  start;
+};
+#endif
+
 void asCContext::ExecuteNext()
 {
 	asDWORD *l_bc = m_regs.programPointer;
 	asDWORD *l_sp = m_regs.stackPointer;
 	asDWORD *l_fp = m_regs.stackFramePointer;
 
+#ifdef AS_COMPUTED_GOTO
+	// The labels must be in the same order as the cases, i.e. the bytecodes
+	static const void *const dispatchTable[256] =
+	{
+		&&asBC_LABEL_asBC_PopPtr, &&asBC_LABEL_asBC_PshGPtr, &&asBC_LABEL_asBC_PshC4, &&asBC_LABEL_asBC_PshV4,
+		&&asBC_LABEL_asBC_PSF, &&asBC_LABEL_asBC_SwapPtr, &&asBC_LABEL_asBC_NOT, &&asBC_LABEL_asBC_PshG4,
+		&&asBC_LABEL_asBC_LdGRdR4, &&asBC_LABEL_asBC_CALL, &&asBC_LABEL_asBC_RET, &&asBC_LABEL_asBC_JMP,
+		&&asBC_LABEL_asBC_JZ, &&asBC_LABEL_asBC_JNZ, &&asBC_LABEL_asBC_JS, &&asBC_LABEL_asBC_JNS,
+		&&asBC_LABEL_asBC_JP, &&asBC_LABEL_asBC_JNP, &&asBC_LABEL_asBC_TZ, &&asBC_LABEL_asBC_TNZ,
+		&&asBC_LABEL_asBC_TS, &&asBC_LABEL_asBC_TNS, &&asBC_LABEL_asBC_TP, &&asBC_LABEL_asBC_TNP,
+		&&asBC_LABEL_asBC_NEGi, &&asBC_LABEL_asBC_NEGf, &&asBC_LABEL_asBC_NEGd, &&asBC_LABEL_asBC_INCi16,
+		&&asBC_LABEL_asBC_INCi8, &&asBC_LABEL_asBC_DECi16, &&asBC_LABEL_asBC_DECi8, &&asBC_LABEL_asBC_INCi,
+		&&asBC_LABEL_asBC_DECi, &&asBC_LABEL_asBC_INCf, &&asBC_LABEL_asBC_DECf, &&asBC_LABEL_asBC_INCd,
+		&&asBC_LABEL_asBC_DECd, &&asBC_LABEL_asBC_IncVi, &&asBC_LABEL_asBC_DecVi, &&asBC_LABEL_asBC_BNOT,
+		&&asBC_LABEL_asBC_BAND, &&asBC_LABEL_asBC_BOR, &&asBC_LABEL_asBC_BXOR, &&asBC_LABEL_asBC_BSLL,
+		&&asBC_LABEL_asBC_BSRL, &&asBC_LABEL_asBC_BSRA, &&asBC_LABEL_asBC_COPY, &&asBC_LABEL_asBC_PshC8,
+		&&asBC_LABEL_asBC_PshVPtr, &&asBC_LABEL_asBC_RDSPtr, &&asBC_LABEL_asBC_CMPd, &&asBC_LABEL_asBC_CMPu,
+		&&asBC_LABEL_asBC_CMPf, &&asBC_LABEL_asBC_CMPi, &&asBC_LABEL_asBC_CMPIi, &&asBC_LABEL_asBC_CMPIf,
+		&&asBC_LABEL_asBC_CMPIu, &&asBC_LABEL_asBC_JMPP, &&asBC_LABEL_asBC_PopRPtr, &&asBC_LABEL_asBC_PshRPtr,
+		&&asBC_LABEL_asBC_STR, &&asBC_LABEL_asBC_CALLSYS, &&asBC_LABEL_asBC_CALLBND, &&asBC_LABEL_asBC_SUSPEND,
+		&&asBC_LABEL_asBC_ALLOC, &&asBC_LABEL_asBC_FREE, &&asBC_LABEL_asBC_LOADOBJ, &&asBC_LABEL_asBC_STOREOBJ,
+		&&asBC_LABEL_asBC_GETOBJ, &&asBC_LABEL_asBC_REFCPY, &&asBC_LABEL_asBC_CHKREF, &&asBC_LABEL_asBC_GETOBJREF,
+		&&asBC_LABEL_asBC_GETREF, &&asBC_LABEL_asBC_PshNull, &&asBC_LABEL_asBC_ClrVPtr, &&asBC_LABEL_asBC_OBJTYPE,
+		&&asBC_LABEL_asBC_TYPEID, &&asBC_LABEL_asBC_SetV4, &&asBC_LABEL_asBC_SetV8, &&asBC_LABEL_asBC_ADDSi,
+		&&asBC_LABEL_asBC_CpyVtoV4, &&asBC_LABEL_asBC_CpyVtoV8, &&asBC_LABEL_asBC_CpyVtoR4, &&asBC_LABEL_asBC_CpyVtoR8,
+		&&asBC_LABEL_asBC_CpyVtoG4, &&asBC_LABEL_asBC_CpyRtoV4, &&asBC_LABEL_asBC_CpyRtoV8, &&asBC_LABEL_asBC_CpyGtoV4,
+		&&asBC_LABEL_asBC_WRTV1, &&asBC_LABEL_asBC_WRTV2, &&asBC_LABEL_asBC_WRTV4, &&asBC_LABEL_asBC_WRTV8,
+		&&asBC_LABEL_asBC_RDR1, &&asBC_LABEL_asBC_RDR2, &&asBC_LABEL_asBC_RDR4, &&asBC_LABEL_asBC_RDR8,
+		&&asBC_LABEL_asBC_LDG, &&asBC_LABEL_asBC_LDV, &&asBC_LABEL_asBC_PGA, &&asBC_LABEL_asBC_CmpPtr,
+		&&asBC_LABEL_asBC_VAR, &&asBC_LABEL_asBC_iTOf, &&asBC_LABEL_asBC_fTOi, &&asBC_LABEL_asBC_uTOf,
+		&&asBC_LABEL_asBC_fTOu, &&asBC_LABEL_asBC_sbTOi, &&asBC_LABEL_asBC_swTOi, &&asBC_LABEL_asBC_ubTOi,
+		&&asBC_LABEL_asBC_uwTOi, &&asBC_LABEL_asBC_dTOi, &&asBC_LABEL_asBC_dTOu, &&asBC_LABEL_asBC_dTOf,
+		&&asBC_LABEL_asBC_iTOd, &&asBC_LABEL_asBC_uTOd, &&asBC_LABEL_asBC_fTOd, &&asBC_LABEL_asBC_ADDi,
+		&&asBC_LABEL_asBC_SUBi, &&asBC_LABEL_asBC_MULi, &&asBC_LABEL_asBC_DIVi, &&asBC_LABEL_asBC_MODi,
+		&&asBC_LABEL_asBC_ADDf, &&asBC_LABEL_asBC_SUBf, &&asBC_LABEL_asBC_MULf, &&asBC_LABEL_asBC_DIVf,
+		&&asBC_LABEL_asBC_MODf, &&asBC_LABEL_asBC_ADDd, &&asBC_LABEL_asBC_SUBd, &&asBC_LABEL_asBC_MULd,
+		&&asBC_LABEL_asBC_DIVd, &&asBC_LABEL_asBC_MODd, &&asBC_LABEL_asBC_ADDIi, &&asBC_LABEL_asBC_SUBIi,
+		&&asBC_LABEL_asBC_MULIi, &&asBC_LABEL_asBC_ADDIf, &&asBC_LABEL_asBC_SUBIf, &&asBC_LABEL_asBC_MULIf,
+		&&asBC_LABEL_asBC_SetG4, &&asBC_LABEL_asBC_ChkRefS, &&asBC_LABEL_asBC_ChkNullV, &&asBC_LABEL_asBC_CALLINTF,
+		&&asBC_LABEL_asBC_iTOb, &&asBC_LABEL_asBC_iTOw, &&asBC_LABEL_asBC_SetV1, &&asBC_LABEL_asBC_SetV2,
+		&&asBC_LABEL_asBC_Cast, &&asBC_LABEL_asBC_i64TOi, &&asBC_LABEL_asBC_uTOi64, &&asBC_LABEL_asBC_iTOi64,
+		&&asBC_LABEL_asBC_fTOi64, &&asBC_LABEL_asBC_dTOi64, &&asBC_LABEL_asBC_fTOu64, &&asBC_LABEL_asBC_dTOu64,
+		&&asBC_LABEL_asBC_i64TOf, &&asBC_LABEL_asBC_u64TOf, &&asBC_LABEL_asBC_i64TOd, &&asBC_LABEL_asBC_u64TOd,
+		&&asBC_LABEL_asBC_NEGi64, &&asBC_LABEL_asBC_INCi64, &&asBC_LABEL_asBC_DECi64, &&asBC_LABEL_asBC_BNOT64,
+		&&asBC_LABEL_asBC_ADDi64, &&asBC_LABEL_asBC_SUBi64, &&asBC_LABEL_asBC_MULi64, &&asBC_LABEL_asBC_DIVi64,
+		&&asBC_LABEL_asBC_MODi64, &&asBC_LABEL_asBC_BAND64, &&asBC_LABEL_asBC_BOR64, &&asBC_LABEL_asBC_BXOR64,
+		&&asBC_LABEL_asBC_BSLL64, &&asBC_LABEL_asBC_BSRL64, &&asBC_LABEL_asBC_BSRA64, &&asBC_LABEL_asBC_CMPi64,
+		&&asBC_LABEL_asBC_CMPu64, &&asBC_LABEL_asBC_ChkNullS, &&asBC_LABEL_asBC_ClrHi, &&asBC_LABEL_asBC_JitEntry,
+		&&asBC_LABEL_asBC_CallPtr, &&asBC_LABEL_asBC_FuncPtr, &&asBC_LABEL_asBC_LoadThisR, &&asBC_LABEL_asBC_PshV8,
+		&&asBC_LABEL_asBC_DIVu, &&asBC_LABEL_asBC_MODu, &&asBC_LABEL_asBC_DIVu64, &&asBC_LABEL_asBC_MODu64,
+		&&asBC_LABEL_asBC_LoadRObjR, &&asBC_LABEL_asBC_LoadVObjR, &&asBC_LABEL_asBC_RefCpyV, &&asBC_LABEL_asBC_JLowZ,
+		&&asBC_LABEL_asBC_JLowNZ, &&asBC_LABEL_asBC_AllocMem, &&asBC_LABEL_asBC_SetListSize, &&asBC_LABEL_asBC_PshListElmnt,
+		&&asBC_LABEL_asBC_SetListType, &&asBC_LABEL_asBC_POWi, &&asBC_LABEL_asBC_POWu, &&asBC_LABEL_asBC_POWf,
+		&&asBC_LABEL_asBC_POWd, &&asBC_LABEL_asBC_POWdi, &&asBC_LABEL_asBC_POWi64, &&asBC_LABEL_asBC_POWu64,
+		&&asBC_LABEL_asBC_Thiscall1, &&asBC_LABEL_asBC_CMPiJZ, &&asBC_LABEL_asBC_CMPiJNZ, &&asBC_LABEL_asBC_CMPiJS,
+		&&asBC_LABEL_asBC_CMPiJNS, &&asBC_LABEL_asBC_CMPiJP, &&asBC_LABEL_asBC_CMPiJNP, &&asBC_LABEL_asBC_CMPIiJZ,
+		&&asBC_LABEL_asBC_CMPIiJNZ, &&asBC_LABEL_asBC_CMPIiJS, &&asBC_LABEL_asBC_CMPIiJNS, &&asBC_LABEL_asBC_CMPIiJP,
+		&&asBC_LABEL_asBC_CMPIiJNP, &&asBC_LABEL_asBC_RDR4ADDi, &&asBC_LABEL_asBC_PSFCALLSYS, &&asBC_LABEL_asBC_PshVPtrCALLSYS,
+		&&asBC_LABEL_asBC_PshV4CALLSYS, &&asBC_LABEL_invalid, &&asBC_LABEL_invalid, &&asBC_LABEL_invalid,
+		&&asBC_LABEL_invalid, &&asBC_LABEL_invalid, &&asBC_LABEL_invalid, &&asBC_LABEL_invalid,
+		&&asBC_LABEL_invalid, &&asBC_LABEL_invalid, &&asBC_LABEL_invalid, &&asBC_LABEL_invalid,
+		&&asBC_LABEL_invalid, &&asBC_LABEL_invalid, &&asBC_LABEL_invalid, &&asBC_LABEL_invalid,
+		&&asBC_LABEL_invalid, &&asBC_LABEL_invalid, &&asBC_LABEL_invalid, &&asBC_LABEL_invalid,
+		&&asBC_LABEL_invalid, &&asBC_LABEL_invalid, &&asBC_LABEL_invalid, &&asBC_LABEL_invalid,
+		&&asBC_LABEL_invalid, &&asBC_LABEL_invalid, &&asBC_LABEL_invalid, &&asBC_LABEL_invalid,
+		&&asBC_LABEL_invalid, &&asBC_LABEL_invalid, &&asBC_LABEL_invalid, &&asBC_LABEL_invalid,
+		&&asBC_LABEL_invalid, &&asBC_LABEL_invalid, &&asBC_LABEL_invalid, &&asBC_LABEL_invalid,
+		&&asBC_LABEL_invalid, &&asBC_LABEL_invalid, &&asBC_LABEL_invalid, &&asBC_LABEL_invalid
+	};
+#endif
+
+#ifdef AS_OPCODE_STATS
+	// The previous instruction, and where the next one would be if there was no jump or call in between
+	asBYTE   l_prevOp = 0;
+	asDWORD *l_nextBC = 0;
+#ifdef AS_OPCODE_CYCLES
+	asSOpcodeTimer l_timer;
+#endif
+#endif
+
 	for(;;)
 	{
 
+#ifdef AS_OPCODE_STATS
+	{
+		// Count the instruction for the current function, and the pair if the
+		// two instructions follow each other so they could be fused
+		asBYTE op = *(asBYTE*)l_bc;
+		m_currentFunction->scriptData->opcodeCounts[op]++;
+		if( l_bc == l_nextBC )
+			m_engine->opcodePairs[l_prevOp * 256 + op]++;
+		l_prevOp = op;
+		l_nextBC = l_bc + asBCTypeSize[asBCInfo[op].type];
+
+#ifdef AS_OPCODE_CYCLES
+		// The previous instruction ends where this one starts
+		l_timer.Next(&m_currentFunction->scriptData->opcodeCycles[op], __rdtsc());
+#endif
+	}
+#endif
+
 #ifdef AS_DEBUG
 	// Gather statistics on executed bytecode
 	stats.Instr(*(asBYTE*)l_bc);
@@ -1825,52 +2060,52 @@ void asCContext::ExecuteNext()
 //--------------
 // memory access functions
 
-	case asBC_PopPtr:
+	asBC_CASE(asBC_PopPtr):
 		// Pop a pointer from the stack
 		l_sp += AS_PTR_SIZE;
 		l_bc++;
-		break;
+		asBC_NEXT();
 
-	case asBC_PshGPtr:
+	asBC_CASE(asBC_PshGPtr):
 		// Replaces PGA + RDSPtr
 		l_sp -= AS_PTR_SIZE;
 		*(asPWORD*)l_sp = *(asPWORD*)asBC_PTRARG(l_bc);
 		l_bc += 1 + AS_PTR_SIZE;
-		break;
+		asBC_NEXT();
 
 	// Push a dword value on the stack
-	case asBC_PshC4:
+	asBC_CASE(asBC_PshC4):
 		--l_sp;
 		*l_sp = asBC_DWORDARG(l_bc);
 		l_bc += 2;
-		break;
+		asBC_NEXT();
 
 	// Push the dword value of a variable on the stack
-	case asBC_PshV4:
+	asBC_CASE(asBC_PshV4):
 		--l_sp;
 		*l_sp = *(l_fp - asBC_SWORDARG0(l_bc));
 		l_bc++;
-		break;
+		asBC_NEXT();
 
 	// Push the address of a variable on the stack
-	case asBC_PSF:
+	asBC_CASE(asBC_PSF):
 		l_sp -= AS_PTR_SIZE;
 		*(asPWORD*)l_sp = asPWORD(l_fp - asBC_SWORDARG0(l_bc));
 		l_bc++;
-		break;
+		asBC_NEXT();
 
 	// Swap the top 2 pointers on the stack
-	case asBC_SwapPtr:
+	asBC_CASE(asBC_SwapPtr):
 		{
 			asPWORD p = *(asPWORD*)l_sp;
 			*(asPWORD*)l_sp = *(asPWORD*)(l_sp+AS_PTR_SIZE);
 			*(asPWORD*)(l_sp+AS_PTR_SIZE) = p;
 			l_bc++;
 		}
-		break;
+		asBC_NEXT();
 
 	// Do a boolean not operation, modifying the value of the variable
-	case asBC_NOT:
+	asBC_CASE(asBC_NOT):
 #if AS_SIZEOF_BOOL == 1
 		{
 			// Set the value to true if it is equal to 0
@@ -1889,28 +2124,28 @@ void asCContext::ExecuteNext()
 		*(l_fp - asBC_SWORDARG0(l_bc)) = (*(l_fp - asBC_SWORDARG0(l_bc)) == 0 ? VALUE_OF_BOOLEAN_TRUE : 0);
 #endif
 		l_bc++;
-		break;
+		asBC_NEXT();
 
 	// Push the dword value of a global variable on the stack
-	case asBC_PshG4:
+	asBC_CASE(asBC_PshG4):
 		--l_sp;
 		*l_sp = *(asDWORD*)asBC_PTRARG(l_bc);
 		l_bc += 1 + AS_PTR_SIZE;
-		break;
+		asBC_NEXT();
 
 	// Load the address of a global variable in the register, then
 	// copy the value of the global variable into a local variable
-	case asBC_LdGRdR4:
+	asBC_CASE(asBC_LdGRdR4):
 		*(void**)&m_regs.valueRegister = (void*)asBC_PTRARG(l_bc);
 		*(l_fp - asBC_SWORDARG0(l_bc)) = **(asDWORD**)&m_regs.valueRegister;
 		l_bc += 1+AS_PTR_SIZE;
-		break;
+		asBC_NEXT();
 
 //----------------
 // path control instructions
 
 	// Begin execution of a script function
-	case asBC_CALL:
+	asBC_CASE(asBC_CALL):
 		{
 			int i = asBC_INTARG(l_bc);
 			l_bc += 2;
@@ -1934,10 +2169,10 @@ void asCContext::ExecuteNext()
 			if( m_status != asEXECUTION_ACTIVE )
 				return;
 		}
-		break;
+		asBC_NEXT();
 
 	// Return to the caller, and remove the arguments from the stack
-	case asBC_RET:
+	asBC_CASE(asBC_RET):
 		{
 			// Return if this was the first function, or a nested execution
 			if( m_callStack.GetLength() == 0 ||
@@ -1960,68 +2195,68 @@ void asCContext::ExecuteNext()
 			// Pop arguments from stack
 			l_sp += w;
 		}
-		break;
+		asBC_NEXT();
 
 	// Jump to a relative position
-	case asBC_JMP:
+	asBC_CASE(asBC_JMP):
 		l_bc += 2 + asBC_INTARG(l_bc);
-		break;
+		asBC_NEXT();
 
 //----------------
 // Conditional jumps
 
 	// Jump to a relative position if the value in the register is 0
-	case asBC_JZ:
+	asBC_CASE(asBC_JZ):
 		if( *(int*)&m_regs.valueRegister == 0 )
 			l_bc += asBC_INTARG(l_bc) + 2;
 		else
 			l_bc += 2;
-		break;
+		asBC_NEXT();
 
 	// Jump to a relative position if the value in the register is not 0
-	case asBC_JNZ:
+	asBC_CASE(asBC_JNZ):
 		if( *(int*)&m_regs.valueRegister != 0 )
 			l_bc += asBC_INTARG(l_bc) + 2;
 		else
 			l_bc += 2;
-		break;
+		asBC_NEXT();
 
 	// Jump to a relative position if the value in the register is negative
-	case asBC_JS:
+	asBC_CASE(asBC_JS):
 		if( *(int*)&m_regs.valueRegister < 0 )
 			l_bc += asBC_INTARG(l_bc) + 2;
 		else
 			l_bc += 2;
-		break;
+		asBC_NEXT();
 
 	// Jump to a relative position if the value in the register it not negative
-	case asBC_JNS:
+	asBC_CASE(asBC_JNS):
 		if( *(int*)&m_regs.valueRegister >= 0 )
 			l_bc += asBC_INTARG(l_bc) + 2;
 		else
 			l_bc += 2;
-		break;
+		asBC_NEXT();
 
 	// Jump to a relative position if the value in the register is greater than 0
-	case asBC_JP:
+	asBC_CASE(asBC_JP):
 		if( *(int*)&m_regs.valueRegister > 0 )
 			l_bc += asBC_INTARG(l_bc) + 2;
 		else
 			l_bc += 2;
-		break;
+		asBC_NEXT();
 
 	// Jump to a relative position if the value in the register is not greater than 0
-	case asBC_JNP:
+	asBC_CASE(asBC_JNP):
 		if( *(int*)&m_regs.valueRegister <= 0 )
 			l_bc += asBC_INTARG(l_bc) + 2;
 		else
 			l_bc += 2;
-		break;
+		asBC_NEXT();
 //--------------------
 // test instructions
 
 	// If the value in the register is 0, then set the register to 1, else to 0
-	case asBC_TZ:
+	asBC_CASE(asBC_TZ):
 #if AS_SIZEOF_BOOL == 1
 		{
 			// Set the value to true if it is equal to 0
@@ -2045,10 +2280,10 @@ void asCContext::ExecuteNext()
 		*(int*)&m_regs.valueRegister = (*(int*)&m_regs.valueRegister == 0 ? VALUE_OF_BOOLEAN_TRUE : 0);
 #endif
 		l_bc++;
-		break;
+		asBC_NEXT();
 
 	// If the value in the register is not 0, then set the register to 1, else to 0
-	case asBC_TNZ:
+	asBC_CASE(asBC_TNZ):
 #if AS_SIZEOF_BOOL == 1
 		{
 			// Set the value to true if it is not equal to 0
@@ -2072,10 +2307,10 @@ void asCContext::ExecuteNext()
 		*(int*)&m_regs.valueRegister = (*(int*)&m_regs.valueRegister == 0 ? 0 : VALUE_OF_BOOLEAN_TRUE);
 #endif
 		l_bc++;
-		break;
+		asBC_NEXT();
 
 	// If the value in the register is negative, then set the register to 1, else to 0
-	case asBC_TS:
+	asBC_CASE(asBC_TS):
 #if AS_SIZEOF_BOOL == 1
 		{
 			// Set the value to true if it is less than 0
@@ -2099,10 +2334,10 @@ void asCContext::ExecuteNext()
 		*(int*)&m_regs.valueRegister = (*(int*)&m_regs.valueRegister < 0 ? VALUE_OF_BOOLEAN_TRUE : 0);
 #endif
 		l_bc++;
-		break;
+		asBC_NEXT();
 
 	// If the value in the register is not negative, then set the register to 1, else to 0
-	case asBC_TNS:
+	asBC_CASE(asBC_TNS):
 #if AS_SIZEOF_BOOL == 1
 		{
 			// Set the value to true if it is not less than 0
@@ -2126,10 +2361,10 @@ void asCContext::ExecuteNext()
 		*(int*)&m_regs.valueRegister = (*(int*)&m_regs.valueRegister < 0 ? 0 : VALUE_OF_BOOLEAN_TRUE);
 #endif
 		l_bc++;
-		break;
+		asBC_NEXT();
 
 	// If the value in the register is greater than 0, then set the register to 1, else to 0
-	case asBC_TP:
+	asBC_CASE(asBC_TP):
 #if AS_SIZEOF_BOOL == 1
 		{
 			// Set the value to true if it is greater than 0
@@ -2153,10 +2388,10 @@ void asCContext::ExecuteNext()
 		*(int*)&m_regs.valueRegister = (*(int*)&m_regs.valueRegister > 0 ? VALUE_OF_BOOLEAN_TRUE : 0);
 #endif
 		l_bc++;
-		break;
+		asBC_NEXT();
 
 	// If the value in the register is not greater than 0, then set the register to 1, else to 0
-	case asBC_TNP:
+	asBC_CASE(asBC_TNP):
 #if AS_SIZEOF_BOOL == 1
 		{
 			// Set the value to true if it is not greater than 0
@@ -2180,150 +2415,150 @@ void asCContext::ExecuteNext()
 		*(int*)&m_regs.valueRegister = (*(int*)&m_regs.valueRegister > 0 ? 0 : VALUE_OF_BOOLEAN_TRUE);
 #endif
 		l_bc++;
-		break;
+		asBC_NEXT();
 
 //--------------------
 // negate value
 
 	// Negate the integer value in the variable
-	case asBC_NEGi:
+	asBC_CASE(asBC_NEGi):
 		*(l_fp - asBC_SWORDARG0(l_bc)) = asDWORD(-int(*(l_fp - asBC_SWORDARG0(l_bc))));
 		l_bc++;
-		break;
+		asBC_NEXT();
 
 	// Negate the float value in the variable
-	case asBC_NEGf:
+	asBC_CASE(asBC_NEGf):
 		*(float*)(l_fp - asBC_SWORDARG0(l_bc)) = -*(float*)(l_fp - asBC_SWORDARG0(l_bc));
 		l_bc++;
-		break;
+		asBC_NEXT();
 
 	// Negate the double value in the variable
-	case asBC_NEGd:
+	asBC_CASE(asBC_NEGd):
 		*(double*)(l_fp - asBC_SWORDARG0(l_bc)) = -*(double*)(l_fp - asBC_SWORDARG0(l_bc));
 		l_bc++;
-		break;
+		asBC_NEXT();
 
 //-------------------------
 // Increment value pointed to by address in register
 
 	// Increment the short value pointed to by the register
-	case asBC_INCi16:
+	asBC_CASE(asBC_INCi16):
 		(**(short**)&m_regs.valueRegister)++;
 		l_bc++;
-		break;
+		asBC_NEXT();
 
 	// Increment the byte value pointed to by the register
-	case asBC_INCi8:
+	asBC_CASE(asBC_INCi8):
 		(**(char**)&m_regs.valueRegister)++;
 		l_bc++;
-		break;
+		asBC_NEXT();
 
 	// Decrement the short value pointed to by the register
-	case asBC_DECi16:
+	asBC_CASE(asBC_DECi16):
 		(**(short**)&m_regs.valueRegister)--;
 		l_bc++;
-		break;
+		asBC_NEXT();
 
 	// Decrement the byte value pointed to by the register
-	case asBC_DECi8:
+	asBC_CASE(asBC_DECi8):
 		(**(char**)&m_regs.valueRegister)--;
 		l_bc++;
-		break;
+		asBC_NEXT();
 
 	// Increment the integer value pointed to by the register
-	case asBC_INCi:
+	asBC_CASE(asBC_INCi):
 		++(**(int**)&m_regs.valueRegister);
 		l_bc++;
-		break;
+		asBC_NEXT();
 
 	// Decrement the integer value pointed to by the register
-	case asBC_DECi:
+	asBC_CASE(asBC_DECi):
 		--(**(int**)&m_regs.valueRegister);
 		l_bc++;
-		break;
+		asBC_NEXT();
 
 	// Increment the float value pointed to by the register
-	case asBC_INCf:
+	asBC_CASE(asBC_INCf):
 		++(**(float**)&m_regs.valueRegister);
 		l_bc++;
-		break;
+		asBC_NEXT();
 
 	// Decrement the float value pointed to by the register
-	case asBC_DECf:
+	asBC_CASE(asBC_DECf):
 		--(**(float**)&m_regs.valueRegister);
 		l_bc++;
-		break;
+		asBC_NEXT();
 
 	// Increment the double value pointed to by the register
-	case asBC_INCd:
+	asBC_CASE(asBC_INCd):
 		++(**(double**)&m_regs.valueRegister);
 		l_bc++;
-		break;
+		asBC_NEXT();
 
 	// Decrement the double value pointed to by the register
-	case asBC_DECd:
+	asBC_CASE(asBC_DECd):
 		--(**(double**)&m_regs.valueRegister);
 		l_bc++;
-		break;
+		asBC_NEXT();
 
 	// Increment the local integer variable
-	case asBC_IncVi:
+	asBC_CASE(asBC_IncVi):
 		(*(int*)(l_fp - asBC_SWORDARG0(l_bc)))++;
 		l_bc++;
-		break;
+		asBC_NEXT();
 
 	// Decrement the local integer variable
-	case asBC_DecVi:
+	asBC_CASE(asBC_DecVi):
 		(*(int*)(l_fp - asBC_SWORDARG0(l_bc)))--;
 		l_bc++;
-		break;
+		asBC_NEXT();
 
 //--------------------
 // bits instructions
 
 	// Do a bitwise not on the value in the variable
-	case asBC_BNOT:
+	asBC_CASE(asBC_BNOT):
 		*(l_fp - asBC_SWORDARG0(l_bc)) = ~*(l_fp - asBC_SWORDARG0(l_bc));
 		l_bc++;
-		break;
+		asBC_NEXT();
 
 	// Do a bitwise and of two variables and store the result in a third variable
-	case asBC_BAND:
+	asBC_CASE(asBC_BAND):
 		*(l_fp - asBC_SWORDARG0(l_bc)) = *(l_fp - asBC_SWORDARG1(l_bc)) & *(l_fp - asBC_SWORDARG2(l_bc));
 		l_bc += 2;
-		break;
+		asBC_NEXT();
 
 	// Do a bitwise or of two variables and store the result in a third variable
-	case asBC_BOR:
+	asBC_CASE(asBC_BOR):
 		*(l_fp - asBC_SWORDARG0(l_bc)) = *(l_fp - asBC_SWORDARG1(l_bc)) | *(l_fp - asBC_SWORDARG2(l_bc));
 		l_bc += 2;
-		break;
+		asBC_NEXT();
 
 	// Do a bitwise xor of two variables and store the result in a third variable
-	case asBC_BXOR:
+	asBC_CASE(asBC_BXOR):
 		*(l_fp - asBC_SWORDARG0(l_bc)) = *(l_fp - asBC_SWORDARG1(l_bc)) ^ *(l_fp - asBC_SWORDARG2(l_bc));
 		l_bc += 2;
-		break;
+		asBC_NEXT();
 
 	// Do a logical shift left of two variables and store the result in a third variable
-	case asBC_BSLL:
+	asBC_CASE(asBC_BSLL):
 		*(l_fp - asBC_SWORDARG0(l_bc)) = *(l_fp - asBC_SWORDARG1(l_bc)) << *(l_fp - asBC_SWORDARG2(l_bc));
 		l_bc += 2;
-		break;
+		asBC_NEXT();
 
 	// Do a logical shift right of two variables and store the result in a third variable
-	case asBC_BSRL:
+	asBC_CASE(asBC_BSRL):
 		*(l_fp - asBC_SWORDARG0(l_bc)) = *(l_fp - asBC_SWORDARG1(l_bc)) >> *(l_fp - asBC_SWORDARG2(l_bc));
 		l_bc += 2;
-		break;
+		asBC_NEXT();
 
 	// Do an arithmetic shift right of two variables and store the result in a third variable
-	case asBC_BSRA:
+	asBC_CASE(asBC_BSRA):
 		*(l_fp - asBC_SWORDARG0(l_bc)) = int(*(l_fp - asBC_SWORDARG1(l_bc))) >> *(l_fp - asBC_SWORDARG2(l_bc));
 		l_bc += 2;
-		break;
+		asBC_NEXT();
 
-	case asBC_COPY:
+	asBC_CASE(asBC_COPY):
 		{
 			void *d = (void*)*(asPWORD*)l_sp; l_sp += AS_PTR_SIZE;
 			void *s = (void*)*(asPWORD*)l_sp;
@@ -2344,21 +2579,21 @@ void asCContext::ExecuteNext()
 			*(asPWORD**)l_sp = (asPWORD*)d;
 		}
 		l_bc += 2;
-		break;
+		asBC_NEXT();
 
-	case asBC_PshC8:
+	asBC_CASE(asBC_PshC8):
 		l_sp -= 2;
 		*(asQWORD*)l_sp = asBC_QWORDARG(l_bc);
 		l_bc += 3;
-		break;
+		asBC_NEXT();
 
-	case asBC_PshVPtr:
+	asBC_CASE(asBC_PshVPtr):
 		l_sp -= AS_PTR_SIZE;
 		*(asPWORD*)l_sp = *(asPWORD*)(l_fp - asBC_SWORDARG0(l_bc));
 		l_bc++;
-		break;
+		asBC_NEXT();
 
-	case asBC_RDSPtr:
+	asBC_CASE(asBC_RDSPtr):
 		{
 			// The pointer must not be null
 			asPWORD a = *(asPWORD*)l_sp;
@@ -2375,11 +2610,11 @@ void asCContext::ExecuteNext()
 			*(asPWORD*)l_sp = *(asPWORD*)a;
 		}
 		l_bc++;
-		break;
+		asBC_NEXT();
 
 	//----------------------------
 	// Comparisons
-	case asBC_CMPd:
+	asBC_CASE(asBC_CMPd):
 		{
 			// Do a comparison of the values, rather than a subtraction
 			// in order to get proper behaviour for infinity values.
@@ -2390,9 +2625,9 @@ void asCContext::ExecuteNext()
 			else                   *(int*)&m_regs.valueRegister =  1;
 			l_bc += 2;
 		}
-		break;
+		asBC_NEXT();
 
-	case asBC_CMPu:
+	asBC_CASE(asBC_CMPu):
 		{
 			asDWORD d1 = *(asDWORD*)(l_fp - asBC_SWORDARG0(l_bc));
 			asDWORD d2 = *(asDWORD*)(l_fp - asBC_SWORDARG1(l_bc));
@@ -2401,9 +2636,9 @@ void asCContext::ExecuteNext()
 			else               *(int*)&m_regs.valueRegister =  1;
 			l_bc += 2;
 		}
-		break;
+		asBC_NEXT();
 
-	case asBC_CMPf:
+	asBC_CASE(asBC_CMPf):
 		{
 			// Do a comparison of the values, rather than a subtraction
 			// in order to get proper behaviour for infinity values.
@@ -2414,9 +2649,9 @@ void asCContext::ExecuteNext()
 			else               *(int*)&m_regs.valueRegister =  1;
 			l_bc += 2;
 		}
-		break;
+		asBC_NEXT();
 
-	case asBC_CMPi:
+	asBC_CASE(asBC_CMPi):
 		{
 			int i1 = *(int*)(l_fp - asBC_SWORDARG0(l_bc));
 			int i2 = *(int*)(l_fp - asBC_SWORDARG1(l_bc));
@@ -2425,11 +2660,11 @@ void asCContext::ExecuteNext()
 			else               *(int*)&m_regs.valueRegister =  1;
 			l_bc += 2;
 		}
-		break;
+		asBC_NEXT();
 
 	//----------------------------
 	// Comparisons with constant value
-	case asBC_CMPIi:
+	asBC_CASE(asBC_CMPIi):
 		{
 			int i1 = *(int*)(l_fp - asBC_SWORDARG0(l_bc));
 			int i2 = asBC_INTARG(l_bc);
@@ -2438,9 +2673,9 @@ void asCContext::ExecuteNext()
 			else               *(int*)&m_regs.valueRegister =  1;
 			l_bc += 2;
 		}
-		break;
+		asBC_NEXT();
 
-	case asBC_CMPIf:
+	asBC_CASE(asBC_CMPIf):
 		{
 			// Do a comparison of the values, rather than a subtraction
 			// in order to get proper behaviour for infinity values.
@@ -2451,9 +2686,9 @@ void asCContext::ExecuteNext()
 			else               *(int*)&m_regs.valueRegister =  1;
 			l_bc += 2;
 		}
-		break;
+		asBC_NEXT();
 
-	case asBC_CMPIu:
+	asBC_CASE(asBC_CMPIu):
 		{
 			asDWORD d1 = *(asDWORD*)(l_fp - asBC_SWORDARG0(l_bc));
 			asDWORD d2 = asBC_DWORDARG(l_bc);
@@ -2462,25 +2697,25 @@ void asCContext::ExecuteNext()
 			else               *(int*)&m_regs.valueRegister =  1;
 			l_bc += 2;
 		}
-		break;
+		asBC_NEXT();
 
-	case asBC_JMPP:
+	asBC_CASE(asBC_JMPP):
 		l_bc += 1 + (*(int*)(l_fp - asBC_SWORDARG0(l_bc)))*2;
-		break;
+		asBC_NEXT();
 
-	case asBC_PopRPtr:
+	asBC_CASE(asBC_PopRPtr):
 		*(asPWORD*)&m_regs.valueRegister = *(asPWORD*)l_sp;
 		l_sp += AS_PTR_SIZE;
 		l_bc++;
-		break;
+		asBC_NEXT();
 
-	case asBC_PshRPtr:
+	asBC_CASE(asBC_PshRPtr):
 		l_sp -= AS_PTR_SIZE;
 		*(asPWORD*)l_sp = *(asPWORD*)&m_regs.valueRegister;
 		l_bc++;
-		break;
+		asBC_NEXT();
 
-	case asBC_STR:
+	asBC_CASE(asBC_STR):
 		{
 			// Get the string id from the argument
 			asWORD w = asBC_WORDARG0(l_bc);
@@ -2493,9 +2728,10 @@ void asCContext::ExecuteNext()
 			*l_sp = (asDWORD)b.GetLength();
 			l_bc++;
 		}
-		break;
+		asBC_NEXT();
 
-	case asBC_CALLSYS:
+	asBC_CASE(asBC_CALLSYS):
+	asBC_CALLSYS_BODY:
 		{
 			// Get function ID from the argument
 			int i = asBC_INTARG(l_bc);
@@ -2534,9 +2770,9 @@ void asCContext::ExecuteNext()
 				}
 			}
 		}
-		break;
+		asBC_NEXT();
 
-	case asBC_CALLBND:
+	asBC_CASE(asBC_CALLBND):
 		{
 			// TODO: Clean-up: This code is very similar to asBC_CallPtr. Create a shared method for them
 			// Get the function ID from the stack
@@ -2615,11 +2851,29 @@ void asCContext::ExecuteNext()
 			if( m_status != asEXECUTION_ACTIVE )
 				return;
 		}
-		break;
+		asBC_NEXT();
 
-	case asBC_SUSPEND:
+	asBC_CASE(asBC_SUSPEND):
 		if( m_regs.doProcessSuspend )
 		{
+			if( m_samplePending )
+			{
+				m_regs.programPointer    = l_bc;
+				m_regs.stackPointer      = l_sp;
+				m_regs.stackFramePointer = l_fp;
+
+				m_samplePending = false;
+				asSAMPLECALLBACK_t callback = m_engine->sampleCallback;
+				if( callback )
+					callback(this, m_engine->sampleCallbackParam);
+
+				// Clear the flag before checking the other requests, so that
+				// one made from another thread in the meantime isn't lost
+				m_regs.doProcessSuspend = false;
+				if( m_lineCallback || m_doSuspend || m_samplePending )
+					m_regs.doProcessSuspend = true;
+			}
+
 			if( m_lineCallback )
 			{
 				m_regs.programPointer    = l_bc;
@@ -2643,9 +2897,9 @@ void asCContext::ExecuteNext()
 		}
 
 		l_bc++;
-		break;
+		asBC_NEXT();
 
-	case asBC_ALLOC:
+	asBC_CASE(asBC_ALLOC):
 		{
 			asCObjectType *objType = (asCObjectType*)asBC_PTRARG(l_bc);
 			int func = asBC_INTARG(l_bc+AS_PTR_SIZE);
@@ -2741,9 +2995,9 @@ void asCContext::ExecuteNext()
 				}
 			}
 		}
-		break;
+		asBC_NEXT();
 
-	case asBC_FREE:
+	asBC_CASE(asBC_FREE):
 		{
 			// Get the variable that holds the object handle/reference
 			asPWORD *a = (asPWORD*)asPWORD(l_fp - asBC_SWORDARG0(l_bc));
@@ -2779,9 +3033,9 @@ void asCContext::ExecuteNext()
 			}
 		}
 		l_bc += 1+AS_PTR_SIZE;
-		break;
+		asBC_NEXT();
 
-	case asBC_LOADOBJ:
+	asBC_CASE(asBC_LOADOBJ):
 		{
 			// Move the object pointer from the object variable into the object register
 			void **a = (void**)(l_fp - asBC_SWORDARG0(l_bc));
@@ -2790,16 +3044,16 @@ void asCContext::ExecuteNext()
 			*a = 0;
 		}
 		l_bc++;
-		break;
+		asBC_NEXT();
 
-	case asBC_STOREOBJ:
+	asBC_CASE(asBC_STOREOBJ):
 		// Move the object pointer from the object register to the object variable
 		*(asPWORD*)(l_fp - asBC_SWORDARG0(l_bc)) = asPWORD(m_regs.objectRegister);
 		m_regs.objectRegister = 0;
 		l_bc++;
-		break;
+		asBC_NEXT();
 
-	case asBC_GETOBJ:
+	asBC_CASE(asBC_GETOBJ):
 		{
 			// Read variable index from location on stack
 			asPWORD *a = (asPWORD*)(l_sp + asBC_WORDARG0(l_bc));
@@ -2811,9 +3065,9 @@ void asCContext::ExecuteNext()
 			*v = 0;
 		}
 		l_bc++;
-		break;
+		asBC_NEXT();
 
-	case asBC_REFCPY:
+	asBC_CASE(asBC_REFCPY):
 		{
 			asCObjectType *objType = (asCObjectType*)asBC_PTRARG(l_bc);
 			asSTypeBehaviour *beh = &objType->beh;
@@ -2845,9 +3099,9 @@ void asCContext::ExecuteNext()
 			*d = s;
 		}
 		l_bc += 1+AS_PTR_SIZE;
-		break;
+		asBC_NEXT();
 
-	case asBC_CHKREF:
+	asBC_CASE(asBC_CHKREF):
 		{
 			// Verify if the pointer on the stack is null
 			// This is used when validating a pointer that an operator will work on
@@ -2863,9 +3117,9 @@ void asCContext::ExecuteNext()
 			}
 		}
 		l_bc++;
-		break;
+		asBC_NEXT();
 
-	case asBC_GETOBJREF:
+	asBC_CASE(asBC_GETOBJREF):
 		{
 			// Get the location on the stack where the reference will be placed
 			asPWORD *a = (asPWORD*)(l_sp + asBC_WORDARG0(l_bc));
@@ -2874,9 +3128,9 @@ void asCContext::ExecuteNext()
 			*(asPWORD**)a = *(asPWORD**)(l_fp - *a);
 		}
 		l_bc++;
-		break;
+		asBC_NEXT();
 
-	case asBC_GETREF:
+	asBC_CASE(asBC_GETREF):
 		{
 			// Get the location on the stack where the reference will be placed
 			asPWORD *a = (asPWORD*)(l_sp + asBC_WORDARG0(l_bc));
@@ -2885,49 +3139,49 @@ void asCContext::ExecuteNext()
 			*(asPWORD**)a = (asPWORD*)(l_fp - (int)*a);
 		}
 		l_bc++;
-		break;
+		asBC_NEXT();
 
-	case asBC_PshNull:
+	asBC_CASE(asBC_PshNull):
 		// Push a null pointer on the stack
 		l_sp -= AS_PTR_SIZE;
 		*(asPWORD*)l_sp = 0;
 		l_bc++;
-		break;
+		asBC_NEXT();
 
-	case asBC_ClrVPtr:
+	asBC_CASE(asBC_ClrVPtr):
 		// TODO: runtime optimize: Is this instruction really necessary?
 		//                         CallScriptFunction() can clear the null handles upon entry, just as is done for
 		//                         all other object variables
 		// Clear pointer variable
 		*(asPWORD*)(l_fp - asBC_SWORDARG0(l_bc)) = 0;
 		l_bc++;
-		break;
+		asBC_NEXT();
 
-	case asBC_OBJTYPE:
+	asBC_CASE(asBC_OBJTYPE):
 		// Push the object type on the stack
 		l_sp -= AS_PTR_SIZE;
 		*(asPWORD*)l_sp = asBC_PTRARG(l_bc);
 		l_bc += 1+AS_PTR_SIZE;
-		break;
+		asBC_NEXT();
 
-	case asBC_TYPEID:
+	asBC_CASE(asBC_TYPEID):
 		// Equivalent to PshC4, but kept as separate instruction for bytecode serialization
 		--l_sp;
 		*l_sp = asBC_DWORDARG(l_bc);
 		l_bc += 2;
-		break;
+		asBC_NEXT();
 
-	case asBC_SetV4:
+	asBC_CASE(asBC_SetV4):
 		*(l_fp - asBC_SWORDARG0(l_bc)) = asBC_DWORDARG(l_bc);
 		l_bc += 2;
-		break;
+		asBC_NEXT();
 
-	case asBC_SetV8:
+	asBC_CASE(asBC_SetV8):
 		*(asQWORD*)(l_fp - asBC_SWORDARG0(l_bc)) = asBC_QWORDARG(l_bc);
 		l_bc += 3;
-		break;
+		asBC_NEXT();
 
-	case asBC_ADDSi:
+	asBC_CASE(asBC_ADDSi):
 		{
 			// The pointer must not be null
 			asPWORD a = *(asPWORD*)l_sp;
@@ -2944,71 +3198,71 @@ void asCContext::ExecuteNext()
 			*(asPWORD*)l_sp = a + asBC_SWORDARG0(l_bc);
 		}
 		l_bc += 2;
-		break;
+		asBC_NEXT();
 
-	case asBC_CpyVtoV4:
+	asBC_CASE(asBC_CpyVtoV4):
 		*(l_fp - asBC_SWORDARG0(l_bc)) = *(l_fp - asBC_SWORDARG1(l_bc));
 		l_bc += 2;
-		break;
+		asBC_NEXT();
 
-	case asBC_CpyVtoV8:
+	asBC_CASE(asBC_CpyVtoV8):
 		*(asQWORD*)(l_fp - asBC_SWORDARG0(l_bc)) = *(asQWORD*)(l_fp - asBC_SWORDARG1(l_bc));
 		l_bc += 2;
-		break;
+		asBC_NEXT();
 
-	case asBC_CpyVtoR4:
+	asBC_CASE(asBC_CpyVtoR4):
 		*(asDWORD*)&m_regs.valueRegister = *(asDWORD*)(l_fp - asBC_SWORDARG0(l_bc));
 		l_bc++;
-		break;
+		asBC_NEXT();
 
-	case asBC_CpyVtoR8:
+	asBC_CASE(asBC_CpyVtoR8):
 		*(asQWORD*)&m_regs.valueRegister = *(asQWORD*)(l_fp - asBC_SWORDARG0(l_bc));
 		l_bc++;
-		break;
+		asBC_NEXT();
 
-	case asBC_CpyVtoG4:
+	asBC_CASE(asBC_CpyVtoG4):
 		*(asDWORD*)asBC_PTRARG(l_bc) = *(asDWORD*)(l_fp - asBC_SWORDARG0(l_bc));
 		l_bc += 1 + AS_PTR_SIZE;
-		break;
+		asBC_NEXT();
 
-	case asBC_CpyRtoV4:
+	asBC_CASE(asBC_CpyRtoV4):
 		*(asDWORD*)(l_fp - asBC_SWORDARG0(l_bc)) = *(asDWORD*)&m_regs.valueRegister;
 		l_bc++;
-		break;
+		asBC_NEXT();
 
-	case asBC_CpyRtoV8:
+	asBC_CASE(asBC_CpyRtoV8):
 		*(asQWORD*)(l_fp - asBC_SWORDARG0(l_bc)) = m_regs.valueRegister;
 		l_bc++;
-		break;
+		asBC_NEXT();
 
-	case asBC_CpyGtoV4:
+	asBC_CASE(asBC_CpyGtoV4):
 		*(asDWORD*)(l_fp - asBC_SWORDARG0(l_bc)) = *(asDWORD*)asBC_PTRARG(l_bc);
 		l_bc += 1 + AS_PTR_SIZE;
-		break;
+		asBC_NEXT();
 
-	case asBC_WRTV1:
+	asBC_CASE(asBC_WRTV1):
 		// The pointer in the register points to a byte, and *(l_fp - offset) too
 		**(asBYTE**)&m_regs.valueRegister = *(asBYTE*)(l_fp - asBC_SWORDARG0(l_bc));
 		l_bc++;
-		break;
+		asBC_NEXT();
 
-	case asBC_WRTV2:
+	asBC_CASE(asBC_WRTV2):
 		// The pointer in the register points to a word, and *(l_fp - offset) too
 		**(asWORD**)&m_regs.valueRegister = *(asWORD*)(l_fp - asBC_SWORDARG0(l_bc));
 		l_bc++;
-		break;
+		asBC_NEXT();
 
-	case asBC_WRTV4:
+	asBC_CASE(asBC_WRTV4):
 		**(asDWORD**)&m_regs.valueRegister = *(l_fp - asBC_SWORDARG0(l_bc));
 		l_bc++;
-		break;
+		asBC_NEXT();
 
-	case asBC_WRTV8:
+	asBC_CASE(asBC_WRTV8):
 		**(asQWORD**)&m_regs.valueRegister = *(asQWORD*)(l_fp - asBC_SWORDARG0(l_bc));
 		l_bc++;
-		break;
+		asBC_NEXT();
 
-	case asBC_RDR1:
+	asBC_CASE(asBC_RDR1):
 		{
 			// The pointer in the register points to a byte, and *(l_fp - offset) will also point to a byte
 			asBYTE *bPtr = (asBYTE*)(l_fp - asBC_SWORDARG0(l_bc));
@@ -3018,9 +3272,9 @@ void asCContext::ExecuteNext()
 			bPtr[3] = 0;
 		}
 		l_bc++;
-		break;
+		asBC_NEXT();
 
-	case asBC_RDR2:
+	asBC_CASE(asBC_RDR2):
 		{
 			// The pointer in the register points to a word, and *(l_fp - offset) will also point to a word
 			asWORD *wPtr = (asWORD*)(l_fp - asBC_SWORDARG0(l_bc));
@@ -3028,35 +3282,35 @@ void asCContext::ExecuteNext()
 			wPtr[1] = 0;                      // 0 the rest of the DWORD
 		}
 		l_bc++;
-		break;
+		asBC_NEXT();
 
-	case asBC_RDR4:
+	asBC_CASE(asBC_RDR4):
 		*(asDWORD*)(l_fp - asBC_SWORDARG0(l_bc)) = **(asDWORD**)&m_regs.valueRegister;
 		l_bc++;
-		break;
+		asBC_NEXT();
 
-	case asBC_RDR8:
+	asBC_CASE(asBC_RDR8):
 		*(asQWORD*)(l_fp - asBC_SWORDARG0(l_bc)) = **(asQWORD**)&m_regs.valueRegister;
 		l_bc++;
-		break;
+		asBC_NEXT();
 
-	case asBC_LDG:
+	asBC_CASE(asBC_LDG):
 		*(asPWORD*)&m_regs.valueRegister = asBC_PTRARG(l_bc);
 		l_bc += 1+AS_PTR_SIZE;
-		break;
+		asBC_NEXT();
 
-	case asBC_LDV:
+	asBC_CASE(asBC_LDV):
 		*(asDWORD**)&m_regs.valueRegister = (l_fp - asBC_SWORDARG0(l_bc));
 		l_bc++;
-		break;
+		asBC_NEXT();
 
-	case asBC_PGA:
+	asBC_CASE(asBC_PGA):
 		l_sp -= AS_PTR_SIZE;
 		*(asPWORD*)l_sp = asBC_PTRARG(l_bc);
 		l_bc += 1+AS_PTR_SIZE;
-		break;
+		asBC_NEXT();
 
-	case asBC_CmpPtr:
+	asBC_CASE(asBC_CmpPtr):
 		{
 			// TODO: runtime optimize: This instruction should really just be an equals, and return true or false.
 			//                         The instruction is only used for is and !is tests anyway.
@@ -3067,110 +3321,110 @@ void asCContext::ExecuteNext()
 			else               *(int*)&m_regs.valueRegister =  1;
 			l_bc += 2;
 		}
-		break;
+		asBC_NEXT();
 
-	case asBC_VAR:
+	asBC_CASE(asBC_VAR):
 		l_sp -= AS_PTR_SIZE;
 		*(asPWORD*)l_sp = (asPWORD)asBC_SWORDARG0(l_bc);
 		l_bc++;
-		break;
+		asBC_NEXT();
 
 	//----------------------------
 	// Type conversions
-	case asBC_iTOf:
+	asBC_CASE(asBC_iTOf):
 		*(float*)(l_fp - asBC_SWORDARG0(l_bc)) = float(*(int*)(l_fp - asBC_SWORDARG0(l_bc)));
 		l_bc++;
-		break;
+		asBC_NEXT();
 
-	case asBC_fTOi:
+	asBC_CASE(asBC_fTOi):
 		*(l_fp - asBC_SWORDARG0(l_bc)) = int(*(float*)(l_fp - asBC_SWORDARG0(l_bc)));
 		l_bc++;
-		break;
+		asBC_NEXT();
 
-	case asBC_uTOf:
+	asBC_CASE(asBC_uTOf):
 		*(float*)(l_fp - asBC_SWORDARG0(l_bc)) = float(*(l_fp - asBC_SWORDARG0(l_bc)));
 		l_bc++;
-		break;
+		asBC_NEXT();
 
-	case asBC_fTOu:
+	asBC_CASE(asBC_fTOu):
 		// We must cast to int first, because on some compilers the cast of a negative float value to uint result in 0
 		*(l_fp - asBC_SWORDARG0(l_bc)) = asUINT(int(*(float*)(l_fp - asBC_SWORDARG0(l_bc))));
 		l_bc++;
-		break;
+		asBC_NEXT();
 
-	case asBC_sbTOi:
+	asBC_CASE(asBC_sbTOi):
 		// *(l_fp - offset) points to a char, and will point to an int afterwards
 		*(l_fp - asBC_SWORDARG0(l_bc)) = *(signed char*)(l_fp - asBC_SWORDARG0(l_bc));
 		l_bc++;
-		break;
+		asBC_NEXT();
 
-	case asBC_swTOi:
+	asBC_CASE(asBC_swTOi):
 		// *(l_fp - offset) points to a short, and will point to an int afterwards
 		*(l_fp - asBC_SWORDARG0(l_bc)) = *(short*)(l_fp - asBC_SWORDARG0(l_bc));
 		l_bc++;
-		break;
+		asBC_NEXT();
 
-	case asBC_ubTOi:
+	asBC_CASE(asBC_ubTOi):
 		// (l_fp - offset) points to a byte, and will point to an int afterwards
 		*(l_fp - asBC_SWORDARG0(l_bc)) = *(asBYTE*)(l_fp - asBC_SWORDARG0(l_bc));
 		l_bc++;
-		break;
+		asBC_NEXT();
 
-	case asBC_uwTOi:
+	asBC_CASE(asBC_uwTOi):
 		// *(l_fp - offset) points to a word, and will point to an int afterwards
 		*(l_fp - asBC_SWORDARG0(l_bc)) = *(asWORD*)(l_fp - asBC_SWORDARG0(l_bc));
 		l_bc++;
-		break;
+		asBC_NEXT();
 
-	case asBC_dTOi:
+	asBC_CASE(asBC_dTOi):
 		*(l_fp - asBC_SWORDARG0(l_bc)) = int(*(double*)(l_fp - asBC_SWORDARG1(l_bc)));
 		l_bc += 2;
-		break;
+		asBC_NEXT();
 
-	case asBC_dTOu:
+	asBC_CASE(asBC_dTOu):
 		// We must cast to int first, because on some compilers the cast of a negative float value to uint result in 0
 		*(l_fp - asBC_SWORDARG0(l_bc)) = asUINT(int(*(double*)(l_fp - asBC_SWORDARG1(l_bc))));
 		l_bc += 2;
-		break;
+		asBC_NEXT();
 
-	case asBC_dTOf:
+	asBC_CASE(asBC_dTOf):
 		*(float*)(l_fp - asBC_SWORDARG0(l_bc)) = float(*(double*)(l_fp - asBC_SWORDARG1(l_bc)));
 		l_bc += 2;
-		break;
+		asBC_NEXT();
 
-	case asBC_iTOd:
+	asBC_CASE(asBC_iTOd):
 		*(double*)(l_fp - asBC_SWORDARG0(l_bc)) = double(*(int*)(l_fp - asBC_SWORDARG1(l_bc)));
 		l_bc += 2;
-		break;
+		asBC_NEXT();
 
-	case asBC_uTOd:
+	asBC_CASE(asBC_uTOd):
 		*(double*)(l_fp - asBC_SWORDARG0(l_bc)) = double(*(asUINT*)(l_fp - asBC_SWORDARG1(l_bc)));
 		l_bc += 2;
-		break;
+		asBC_NEXT();
 
-	case asBC_fTOd:
+	asBC_CASE(asBC_fTOd):
 		*(double*)(l_fp - asBC_SWORDARG0(l_bc)) = double(*(float*)(l_fp - asBC_SWORDARG1(l_bc)));
 		l_bc += 2;
-		break;
+		asBC_NEXT();
 
 	//------------------------------
 	// Math operations
-	case asBC_ADDi:
+	asBC_CASE(asBC_ADDi):
 		*(int*)(l_fp - asBC_SWORDARG0(l_bc)) = *(int*)(l_fp - asBC_SWORDARG1(l_bc)) + *(int*)(l_fp - asBC_SWORDARG2(l_bc));
 		l_bc += 2;
-		break;
+		asBC_NEXT();
 
-	case asBC_SUBi:
+	asBC_CASE(asBC_SUBi):
 		*(int*)(l_fp - asBC_SWORDARG0(l_bc)) = *(int*)(l_fp - asBC_SWORDARG1(l_bc)) - *(int*)(l_fp - asBC_SWORDARG2(l_bc));
 		l_bc += 2;
-		break;
+		asBC_NEXT();
 
-	case asBC_MULi:
+	asBC_CASE(asBC_MULi):
 		*(int*)(l_fp - asBC_SWORDARG0(l_bc)) = *(int*)(l_fp - asBC_SWORDARG1(l_bc)) * *(int*)(l_fp - asBC_SWORDARG2(l_bc));
 		l_bc += 2;
-		break;
+		asBC_NEXT();
 
-	case asBC_DIVi:
+	asBC_CASE(asBC_DIVi):
 		{
 			int divider = *(int*)(l_fp - asBC_SWORDARG2(l_bc));
 			if( divider == 0 )
@@ -3203,9 +3457,9 @@ void asCContext::ExecuteNext()
 			*(int*)(l_fp - asBC_SWORDARG0(l_bc)) = *(int*)(l_fp - asBC_SWORDARG1(l_bc)) / divider;
 		}
 		l_bc += 2;
-		break;
+		asBC_NEXT();
 
-	case asBC_MODi:
+	asBC_CASE(asBC_MODi):
 		{
 			int divider = *(int*)(l_fp - asBC_SWORDARG2(l_bc));
 			if( divider == 0 )
@@ -3238,24 +3492,24 @@ void asCContext::ExecuteNext()
 			*(int*)(l_fp - asBC_SWORDARG0(l_bc)) = *(int*)(l_fp - asBC_SWORDARG1(l_bc)) % divider;
 		}
 		l_bc += 2;
-		break;
+		asBC_NEXT();
 
-	case asBC_ADDf:
+	asBC_CASE(asBC_ADDf):
 		*(float*)(l_fp - asBC_SWORDARG0(l_bc)) = *(float*)(l_fp - asBC_SWORDARG1(l_bc)) + *(float*)(l_fp - asBC_SWORDARG2(l_bc));
 		l_bc += 2;
-		break;
+		asBC_NEXT();
 
-	case asBC_SUBf:
+	asBC_CASE(asBC_SUBf):
 		*(float*)(l_fp - asBC_SWORDARG0(l_bc)) = *(float*)(l_fp - asBC_SWORDARG1(l_bc)) - *(float*)(l_fp - asBC_SWORDARG2(l_bc));
 		l_bc += 2;
-		break;
+		asBC_NEXT();
 
-	case asBC_MULf:
+	asBC_CASE(asBC_MULf):
 		*(float*)(l_fp - asBC_SWORDARG0(l_bc)) = *(float*)(l_fp - asBC_SWORDARG1(l_bc)) * *(float*)(l_fp - asBC_SWORDARG2(l_bc));
 		l_bc += 2;
-		break;
+		asBC_NEXT();
 
-	case asBC_DIVf:
+	asBC_CASE(asBC_DIVf):
 		{
 			float divider = *(float*)(l_fp - asBC_SWORDARG2(l_bc));
 			if( divider == 0 )
@@ -3272,9 +3526,9 @@ void asCContext::ExecuteNext()
 			*(float*)(l_fp - asBC_SWORDARG0(l_bc)) = *(float*)(l_fp - asBC_SWORDARG1(l_bc)) / divider;
 		}
 		l_bc += 2;
-		break;
+		asBC_NEXT();
 
-	case asBC_MODf:
+	asBC_CASE(asBC_MODf):
 		{
 			float divider = *(float*)(l_fp - asBC_SWORDARG2(l_bc));
 			if( divider == 0 )
@@ -3291,24 +3545,24 @@ void asCContext::ExecuteNext()
 			*(float*)(l_fp - asBC_SWORDARG0(l_bc)) = fmodf(*(float*)(l_fp - asBC_SWORDARG1(l_bc)), divider);
 		}
 		l_bc += 2;
-		break;
+		asBC_NEXT();
 
-	case asBC_ADDd:
+	asBC_CASE(asBC_ADDd):
 		*(double*)(l_fp - asBC_SWORDARG0(l_bc)) = *(double*)(l_fp - asBC_SWORDARG1(l_bc)) + *(double*)(l_fp - asBC_SWORDARG2(l_bc));
 		l_bc += 2;
-		break;
+		asBC_NEXT();
 
-	case asBC_SUBd:
+	asBC_CASE(asBC_SUBd):
 		*(double*)(l_fp - asBC_SWORDARG0(l_bc)) = *(double*)(l_fp - asBC_SWORDARG1(l_bc)) - *(double*)(l_fp - asBC_SWORDARG2(l_bc));
 		l_bc += 2;
-		break;
+		asBC_NEXT();
 
-	case asBC_MULd:
+	asBC_CASE(asBC_MULd):
 		*(double*)(l_fp - asBC_SWORDARG0(l_bc)) = *(double*)(l_fp - asBC_SWORDARG1(l_bc)) * *(double*)(l_fp - asBC_SWORDARG2(l_bc));
 		l_bc += 2;
-		break;
+		asBC_NEXT();
 
-	case asBC_DIVd:
+	asBC_CASE(asBC_DIVd):
 		{
 			double divider = *(double*)(l_fp - asBC_SWORDARG2(l_bc));
 			if( divider == 0 )
@@ -3326,9 +3580,9 @@ void asCContext::ExecuteNext()
 			*(double*)(l_fp - asBC_SWORDARG0(l_bc)) = *(double*)(l_fp - asBC_SWORDARG1(l_bc)) / divider;
 			l_bc += 2;
 		}
-		break;
+		asBC_NEXT();
 
-	case asBC_MODd:
+	asBC_CASE(asBC_MODd):
 		{
 			double divider = *(double*)(l_fp - asBC_SWORDARG2(l_bc));
 			if( divider == 0 )
@@ -3346,47 +3600,47 @@ void asCContext::ExecuteNext()
 			*(double*)(l_fp - asBC_SWORDARG0(l_bc)) = fmod(*(double*)(l_fp - asBC_SWORDARG1(l_bc)), divider);
 			l_bc += 2;
 		}
-		break;
+		asBC_NEXT();
 
 	//------------------------------
 	// Math operations with constant value
-	case asBC_ADDIi:
+	asBC_CASE(asBC_ADDIi):
 		*(int*)(l_fp - asBC_SWORDARG0(l_bc)) = *(int*)(l_fp - asBC_SWORDARG1(l_bc)) + asBC_INTARG(l_bc+1);
 		l_bc += 3;
-		break;
+		asBC_NEXT();
 
-	case asBC_SUBIi:
+	asBC_CASE(asBC_SUBIi):
 		*(int*)(l_fp - asBC_SWORDARG0(l_bc)) = *(int*)(l_fp - asBC_SWORDARG1(l_bc)) - asBC_INTARG(l_bc+1);
 		l_bc += 3;
-		break;
+		asBC_NEXT();
 
-	case asBC_MULIi:
+	asBC_CASE(asBC_MULIi):
 		*(int*)(l_fp - asBC_SWORDARG0(l_bc)) = *(int*)(l_fp - asBC_SWORDARG1(l_bc)) * asBC_INTARG(l_bc+1);
 		l_bc += 3;
-		break;
+		asBC_NEXT();
 
-	case asBC_ADDIf:
+	asBC_CASE(asBC_ADDIf):
 		*(float*)(l_fp - asBC_SWORDARG0(l_bc)) = *(float*)(l_fp - asBC_SWORDARG1(l_bc)) + asBC_FLOATARG(l_bc+1);
 		l_bc += 3;
-		break;
+		asBC_NEXT();
 
-	case asBC_SUBIf:
+	asBC_CASE(asBC_SUBIf):
 		*(float*)(l_fp - asBC_SWORDARG0(l_bc)) = *(float*)(l_fp - asBC_SWORDARG1(l_bc)) - asBC_FLOATARG(l_bc+1);
 		l_bc += 3;
-		break;
+		asBC_NEXT();
 
-	case asBC_MULIf:
+	asBC_CASE(asBC_MULIf):
 		*(float*)(l_fp - asBC_SWORDARG0(l_bc)) = *(float*)(l_fp - asBC_SWORDARG1(l_bc)) * asBC_FLOATARG(l_bc+1);
 		l_bc += 3;
-		break;
+		asBC_NEXT();
 
 	//-----------------------------------
-	case asBC_SetG4:
+	asBC_CASE(asBC_SetG4):
 		*(asDWORD*)asBC_PTRARG(l_bc) = asBC_DWORDARG(l_bc+AS_PTR_SIZE);
 		l_bc += 2 + AS_PTR_SIZE;
-		break;
+		asBC_NEXT();
 
-	case asBC_ChkRefS:
+	asBC_CASE(asBC_ChkRefS):
 		{
 			// Verify if the pointer on the stack refers to a non-null value
 			// This is used to validate a reference to a handle
@@ -3402,9 +3656,9 @@ void asCContext::ExecuteNext()
 			}
 		}
 		l_bc++;
-		break;
+		asBC_NEXT();
 
-	case asBC_ChkNullV:
+	asBC_CASE(asBC_ChkNullV):
 		{
 			// Verify if variable (on the stack) is not null
 			asDWORD *a = *(asDWORD**)(l_fp - asBC_SWORDARG0(l_bc));
@@ -3419,9 +3673,9 @@ void asCContext::ExecuteNext()
 			}
 		}
 		l_bc++;
-		break;
+		asBC_NEXT();
 
-	case asBC_CALLINTF:
+	asBC_CASE(asBC_CALLINTF):
 		{
 			int i = asBC_INTARG(l_bc);
 			l_bc += 2;
@@ -3445,9 +3699,9 @@ void asCContext::ExecuteNext()
 			if( m_status != asEXECUTION_ACTIVE )
 				return;
 		}
-		break;
+		asBC_NEXT();
 
-	case asBC_iTOb:
+	asBC_CASE(asBC_iTOb):
 		{
 			// *(l_fp - offset) points to an int, and will point to a byte afterwards
 
@@ -3461,9 +3715,9 @@ void asCContext::ExecuteNext()
 			bPtr[3] = 0;
 		}
 		l_bc++;
-		break;
+		asBC_NEXT();
 
-	case asBC_iTOw:
+	asBC_CASE(asBC_iTOw):
 		{
 			// *(l_fp - offset) points to an int, and will point to word afterwards
 
@@ -3475,9 +3729,9 @@ void asCContext::ExecuteNext()
 			wPtr[1] = 0;           // 0 the rest of the DWORD
 		}
 		l_bc++;
-		break;
+		asBC_NEXT();
 
-	case asBC_SetV1:
+	asBC_CASE(asBC_SetV1):
 		// TODO: This is exactly the same as SetV4. This is a left over from the time
 		//       when the bytecode instructions were more tightly packed. It can now
 		//       be removed. When removing it, make sure the value is correctly converted
@@ -3486,9 +3740,9 @@ void asCContext::ExecuteNext()
 		// The byte is already stored correctly in the argument
 		*(l_fp - asBC_SWORDARG0(l_bc)) = asBC_DWORDARG(l_bc);
 		l_bc += 2;
-		break;
+		asBC_NEXT();
 
-	case asBC_SetV2:
+	asBC_CASE(asBC_SetV2):
 		// TODO: This is exactly the same as SetV4. This is a left over from the time
 		//       when the bytecode instructions were more tightly packed. It can now
 		//       be removed. When removing it, make sure the value is correctly converted
@@ -3497,9 +3751,9 @@ void asCContext::ExecuteNext()
 		// The word is already stored correctly in the argument
 		*(l_fp - asBC_SWORDARG0(l_bc)) = asBC_DWORDARG(l_bc);
 		l_bc += 2;
-		break;
+		asBC_NEXT();
 
-	case asBC_Cast:
+	asBC_CASE(asBC_Cast):
 		// Cast the handle at the top of the stack to the type in the argument
 		{
 			asDWORD **a = (asDWORD**)*(asPWORD*)l_sp;
@@ -3531,49 +3785,49 @@ void asCContext::ExecuteNext()
 			l_sp += AS_PTR_SIZE;
 		}
 		l_bc += 2;
-		break;
+		asBC_NEXT();
 
-	case asBC_i64TOi:
+	asBC_CASE(asBC_i64TOi):
 		*(l_fp - asBC_SWORDARG0(l_bc)) = int(*(asINT64*)(l_fp - asBC_SWORDARG1(l_bc)));
 		l_bc += 2;
-		break;
+		asBC_NEXT();
 
-	case asBC_uTOi64:
+	asBC_CASE(asBC_uTOi64):
 		*(asINT64*)(l_fp - asBC_SWORDARG0(l_bc)) = asINT64(*(asUINT*)(l_fp - asBC_SWORDARG1(l_bc)));
 		l_bc += 2;
-		break;
+		asBC_NEXT();
 
-	case asBC_iTOi64:
+	asBC_CASE(asBC_iTOi64):
 		*(asINT64*)(l_fp - asBC_SWORDARG0(l_bc)) = asINT64(*(int*)(l_fp - asBC_SWORDARG1(l_bc)));
 		l_bc += 2;
-		break;
+		asBC_NEXT();
 
-	case asBC_fTOi64:
+	asBC_CASE(asBC_fTOi64):
 		*(asINT64*)(l_fp - asBC_SWORDARG0(l_bc)) = asINT64(*(float*)(l_fp - asBC_SWORDARG1(l_bc)));
 		l_bc += 2;
-		break;
+		asBC_NEXT();
 
-	case asBC_dTOi64:
+	asBC_CASE(asBC_dTOi64):
 		*(asINT64*)(l_fp - asBC_SWORDARG0(l_bc)) = asINT64(*(double*)(l_fp - asBC_SWORDARG0(l_bc)));
 		l_bc++;
-		break;
+		asBC_NEXT();
 
-	case asBC_fTOu64:
+	asBC_CASE(asBC_fTOu64):
 		*(asQWORD*)(l_fp - asBC_SWORDARG0(l_bc)) = asQWORD(asINT64(*(float*)(l_fp - asBC_SWORDARG1(l_bc))));
 		l_bc += 2;
-		break;
+		asBC_NEXT();
 
-	case asBC_dTOu64:
+	asBC_CASE(asBC_dTOu64):
 		*(asQWORD*)(l_fp - asBC_SWORDARG0(l_bc)) = asQWORD(asINT64(*(double*)(l_fp - asBC_SWORDARG0(l_bc))));
 		l_bc++;
-		break;
+		asBC_NEXT();
 
-	case asBC_i64TOf:
+	asBC_CASE(asBC_i64TOf):
 		*(float*)(l_fp - asBC_SWORDARG0(l_bc)) = float(*(asINT64*)(l_fp - asBC_SWORDARG1(l_bc)));
 		l_bc += 2;
-		break;
+		asBC_NEXT();
 
-	case asBC_u64TOf:
+	asBC_CASE(asBC_u64TOf):
 #if defined(_MSC_VER) && _MSC_VER <= 1200 // MSVC6
 		{
 			// MSVC6 doesn't permit UINT64 to double
@@ -3587,14 +3841,14 @@ void asCContext::ExecuteNext()
 		*(float*)(l_fp - asBC_SWORDARG0(l_bc)) = float(*(asQWORD*)(l_fp - asBC_SWORDARG1(l_bc)));
 #endif
 		l_bc += 2;
-		break;
+		asBC_NEXT();
 
-	case asBC_i64TOd:
+	asBC_CASE(asBC_i64TOd):
 		*(double*)(l_fp - asBC_SWORDARG0(l_bc)) = double(*(asINT64*)(l_fp - asBC_SWORDARG0(l_bc)));
 		l_bc++;
-		break;
+		asBC_NEXT();
 
-	case asBC_u64TOd:
+	asBC_CASE(asBC_u64TOd):
 #if defined(_MSC_VER) && _MSC_VER <= 1200 // MSVC6
 		{
 			// MSVC6 doesn't permit UINT64 to double
@@ -3608,44 +3862,44 @@ void asCContext::ExecuteNext()
 		*(double*)(l_fp - asBC_SWORDARG0(l_bc)) = double(*(asQWORD*)(l_fp - asBC_SWORDARG0(l_bc)));
 #endif
 		l_bc++;
-		break;
+		asBC_NEXT();
 
-	case asBC_NEGi64:
+	asBC_CASE(asBC_NEGi64):
 		*(asINT64*)(l_fp - asBC_SWORDARG0(l_bc)) = -*(asINT64*)(l_fp - asBC_SWORDARG0(l_bc));
 		l_bc++;
-		break;
+		asBC_NEXT();
 
-	case asBC_INCi64:
+	asBC_CASE(asBC_INCi64):
 		++(**(asQWORD**)&m_regs.valueRegister);
 		l_bc++;
-		break;
+		asBC_NEXT();
 
-	case asBC_DECi64:
+	asBC_CASE(asBC_DECi64):
 		--(**(asQWORD**)&m_regs.valueRegister);
 		l_bc++;
-		break;
+		asBC_NEXT();
 
-	case asBC_BNOT64:
+	asBC_CASE(asBC_BNOT64):
 		*(asQWORD*)(l_fp - asBC_SWORDARG0(l_bc)) = ~*(asQWORD*)(l_fp - asBC_SWORDARG0(l_bc));
 		l_bc++;
-		break;
+		asBC_NEXT();
 
-	case asBC_ADDi64:
+	asBC_CASE(asBC_ADDi64):
 		*(asQWORD*)(l_fp - asBC_SWORDARG0(l_bc)) = *(asQWORD*)(l_fp - asBC_SWORDARG1(l_bc)) + *(asQWORD*)(l_fp - asBC_SWORDARG2(l_bc));
 		l_bc += 2;
-		break;
+		asBC_NEXT();
 
-	case asBC_SUBi64:
+	asBC_CASE(asBC_SUBi64):
 		*(asQWORD*)(l_fp - asBC_SWORDARG0(l_bc)) = *(asQWORD*)(l_fp - asBC_SWORDARG1(l_bc)) - *(asQWORD*)(l_fp - asBC_SWORDARG2(l_bc));
 		l_bc += 2;
-		break;
+		asBC_NEXT();
 
-	case asBC_MULi64:
+	asBC_CASE(asBC_MULi64):
 		*(asQWORD*)(l_fp - asBC_SWORDARG0(l_bc)) = *(asQWORD*)(l_fp - asBC_SWORDARG1(l_bc)) * *(asQWORD*)(l_fp - asBC_SWORDARG2(l_bc));
 		l_bc += 2;
-		break;
+		asBC_NEXT();
 
-	case asBC_DIVi64:
+	asBC_CASE(asBC_DIVi64):
 		{
 			asINT64 divider = *(asINT64*)(l_fp - asBC_SWORDARG2(l_bc));
 			if( divider == 0 )
@@ -3679,9 +3933,9 @@ void asCContext::ExecuteNext()
 			*(asINT64*)(l_fp - asBC_SWORDARG0(l_bc)) = *(asINT64*)(l_fp - asBC_SWORDARG1(l_bc)) / divider;
 		}
 		l_bc += 2;
-		break;
+		asBC_NEXT();
 
-	case asBC_MODi64:
+	asBC_CASE(asBC_MODi64):
 		{
 			asINT64 divider = *(asINT64*)(l_fp - asBC_SWORDARG2(l_bc));
 			if( divider == 0 )
@@ -3714,39 +3968,39 @@ void asCContext::ExecuteNext()
 			*(asINT64*)(l_fp - asBC_SWORDARG0(l_bc)) = *(asINT64*)(l_fp - asBC_SWORDARG1(l_bc)) % divider;
 		}
 		l_bc += 2;
-		break;
+		asBC_NEXT();
 
-	case asBC_BAND64:
+	asBC_CASE(asBC_BAND64):
 		*(asQWORD*)(l_fp - asBC_SWORDARG0(l_bc)) = *(asQWORD*)(l_fp - asBC_SWORDARG1(l_bc)) & *(asQWORD*)(l_fp - asBC_SWORDARG2(l_bc));
 		l_bc += 2;
-		break;
+		asBC_NEXT();
 
-	case asBC_BOR64:
+	asBC_CASE(asBC_BOR64):
 		*(asQWORD*)(l_fp - asBC_SWORDARG0(l_bc)) = *(asQWORD*)(l_fp - asBC_SWORDARG1(l_bc)) | *(asQWORD*)(l_fp - asBC_SWORDARG2(l_bc));
 		l_bc += 2;
-		break;
+		asBC_NEXT();
 
-	case asBC_BXOR64:
+	asBC_CASE(asBC_BXOR64):
 		*(asQWORD*)(l_fp - asBC_SWORDARG0(l_bc)) = *(asQWORD*)(l_fp - asBC_SWORDARG1(l_bc)) ^ *(asQWORD*)(l_fp - asBC_SWORDARG2(l_bc));
 		l_bc += 2;
-		break;
+		asBC_NEXT();
 
-	case asBC_BSLL64:
+	asBC_CASE(asBC_BSLL64):
 		*(asQWORD*)(l_fp - asBC_SWORDARG0(l_bc)) = *(asQWORD*)(l_fp - asBC_SWORDARG1(l_bc)) << *(l_fp - asBC_SWORDARG2(l_bc));
 		l_bc += 2;
-		break;
+		asBC_NEXT();
 
-	case asBC_BSRL64:
+	asBC_CASE(asBC_BSRL64):
 		*(asQWORD*)(l_fp - asBC_SWORDARG0(l_bc)) = *(asQWORD*)(l_fp - asBC_SWORDARG1(l_bc)) >> *(l_fp - asBC_SWORDARG2(l_bc));
 		l_bc += 2;
-		break;
+		asBC_NEXT();
 
-	case asBC_BSRA64:
+	asBC_CASE(asBC_BSRA64):
 		*(asINT64*)(l_fp - asBC_SWORDARG0(l_bc)) = *(asINT64*)(l_fp - asBC_SWORDARG1(l_bc)) >> *(l_fp - asBC_SWORDARG2(l_bc));
 		l_bc += 2;
-		break;
+		asBC_NEXT();
 
-	case asBC_CMPi64:
+	asBC_CASE(asBC_CMPi64):
 		{
 			asINT64 i1 = *(asINT64*)(l_fp - asBC_SWORDARG0(l_bc));
 			asINT64 i2 = *(asINT64*)(l_fp - asBC_SWORDARG1(l_bc));
@@ -3755,9 +4009,9 @@ void asCContext::ExecuteNext()
 			else               *(int*)&m_regs.valueRegister =  1;
 			l_bc += 2;
 		}
-		break;
+		asBC_NEXT();
 
-	case asBC_CMPu64:
+	asBC_CASE(asBC_CMPu64):
 		{
 			asQWORD d1 = *(asQWORD*)(l_fp - asBC_SWORDARG0(l_bc));
 			asQWORD d2 = *(asQWORD*)(l_fp - asBC_SWORDARG1(l_bc));
@@ -3766,9 +4020,9 @@ void asCContext::ExecuteNext()
 			else               *(int*)&m_regs.valueRegister =  1;
 			l_bc += 2;
 		}
-		break;
+		asBC_NEXT();
 
-	case asBC_ChkNullS:
+	asBC_CASE(asBC_ChkNullS):
 		{
 			// Verify if the pointer on the stack is null
 			// This is used for example when validating handles passed as function arguments
@@ -3784,9 +4038,9 @@ void asCContext::ExecuteNext()
 			}
 		}
 		l_bc++;
-		break;
+		asBC_NEXT();
 
-	case asBC_ClrHi:
+	asBC_CASE(asBC_ClrHi):
 #if AS_SIZEOF_BOOL == 1
 		{
 			// Clear the upper bytes, so that trash data don't interfere with boolean operations
@@ -3803,9 +4057,9 @@ void asCContext::ExecuteNext()
 		// We don't have anything to do here
 #endif
 		l_bc++;
-		break;
+		asBC_NEXT();
 
-	case asBC_JitEntry:
+	asBC_CASE(asBC_JitEntry):
 		{
 			if( m_currentFunction->scriptData->jitFunction )
 			{
@@ -3828,16 +4082,16 @@ void asCContext::ExecuteNext()
 					if( m_status != asEXECUTION_ACTIVE )
 						return;
 
-					break;
+					asBC_NEXT();
 				}
 			}
 
 			// Not a JIT resume point, treat as nop
 			l_bc += 1+AS_PTR_SIZE;
 		}
-		break;
+		asBC_NEXT();
 
-	case asBC_CallPtr:
+	asBC_CASE(asBC_CallPtr):
 		{
 			// Get the function pointer from the local variable
 			asCScriptFunction *func = *(asCScriptFunction**)(l_fp - asBC_SWORDARG0(l_bc));
@@ -3912,16 +4166,16 @@ void asCContext::ExecuteNext()
 			if( m_status != asEXECUTION_ACTIVE )
 				return;
 		}
-		break;
+		asBC_NEXT();
 
-	case asBC_FuncPtr:
+	asBC_CASE(asBC_FuncPtr):
 		// Push the function pointer on the stack. The pointer is in the argument
 		l_sp -= AS_PTR_SIZE;
 		*(asPWORD*)l_sp = asBC_PTRARG(l_bc);
 		l_bc += 1+AS_PTR_SIZE;
-		break;
+		asBC_NEXT();
 
-	case asBC_LoadThisR:
+	asBC_CASE(asBC_LoadThisR):
 		{
 			// PshVPtr 0
 			asPWORD tmp = *(asPWORD*)l_fp;
@@ -3946,16 +4200,16 @@ void asCContext::ExecuteNext()
 			*(asPWORD*)&m_regs.valueRegister = tmp;
 			l_bc += 2;
 		}
-		break;
+		asBC_NEXT();
 
 	// Push the qword value of a variable on the stack
-	case asBC_PshV8:
+	asBC_CASE(asBC_PshV8):
 		l_sp -= 2;
 		*(asQWORD*)l_sp = *(asQWORD*)(l_fp - asBC_SWORDARG0(l_bc));
 		l_bc++;
-		break;
+		asBC_NEXT();
 
-	case asBC_DIVu:
+	asBC_CASE(asBC_DIVu):
 		{
 			asUINT divider = *(asUINT*)(l_fp - asBC_SWORDARG2(l_bc));
 			if( divider == 0 )
@@ -3972,9 +4226,9 @@ void asCContext::ExecuteNext()
 			*(asUINT*)(l_fp - asBC_SWORDARG0(l_bc)) = *(asUINT*)(l_fp - asBC_SWORDARG1(l_bc)) / divider;
 		}
 		l_bc += 2;
-		break;
+		asBC_NEXT();
 
-	case asBC_MODu:
+	asBC_CASE(asBC_MODu):
 		{
 			asUINT divider = *(asUINT*)(l_fp - asBC_SWORDARG2(l_bc));
 			if( divider == 0 )
@@ -3991,9 +4245,9 @@ void asCContext::ExecuteNext()
 			*(asUINT*)(l_fp - asBC_SWORDARG0(l_bc)) = *(asUINT*)(l_fp - asBC_SWORDARG1(l_bc)) % divider;
 		}
 		l_bc += 2;
-		break;
+		asBC_NEXT();
 
-	case asBC_DIVu64:
+	asBC_CASE(asBC_DIVu64):
 		{
 			asQWORD divider = *(asQWORD*)(l_fp - asBC_SWORDARG2(l_bc));
 			if( divider == 0 )
@@ -4010,9 +4264,9 @@ void asCContext::ExecuteNext()
 			*(asQWORD*)(l_fp - asBC_SWORDARG0(l_bc)) = *(asQWORD*)(l_fp - asBC_SWORDARG1(l_bc)) / divider;
 		}
 		l_bc += 2;
-		break;
+		asBC_NEXT();
 
-	case asBC_MODu64:
+	asBC_CASE(asBC_MODu64):
 		{
 			asQWORD divider = *(asQWORD*)(l_fp - asBC_SWORDARG2(l_bc));
 			if( divider == 0 )
@@ -4029,9 +4283,9 @@ void asCContext::ExecuteNext()
 			*(asQWORD*)(l_fp - asBC_SWORDARG0(l_bc)) = *(asQWORD*)(l_fp - asBC_SWORDARG1(l_bc)) % divider;
 		}
 		l_bc += 2;
-		break;
+		asBC_NEXT();
 
-	case asBC_LoadRObjR:
+	asBC_CASE(asBC_LoadRObjR):
 		{
 			// PshVPtr x
 			asPWORD tmp = *(asPWORD*)(l_fp - asBC_SWORDARG0(l_bc));
@@ -4056,9 +4310,9 @@ void asCContext::ExecuteNext()
 			*(asPWORD*)&m_regs.valueRegister = tmp;
 			l_bc += 3;
 		}
-		break;
+		asBC_NEXT();
 
-	case asBC_LoadVObjR:
+	asBC_CASE(asBC_LoadVObjR):
 		{
 			// PSF x
 			asPWORD tmp = (asPWORD)(l_fp - asBC_SWORDARG0(l_bc));
@@ -4070,9 +4324,9 @@ void asCContext::ExecuteNext()
 			*(asPWORD*)&m_regs.valueRegister = tmp;
 			l_bc += 3;
 		}
-		break;
+		asBC_NEXT();
 
-	case asBC_RefCpyV:
+	asBC_CASE(asBC_RefCpyV):
 		// Same as PSF v, REFCPY
 		{
 			asCObjectType *objType = (asCObjectType*)asBC_PTRARG(l_bc);
@@ -4104,23 +4358,23 @@ void asCContext::ExecuteNext()
 			*d = s;
 		}
 		l_bc += 1+AS_PTR_SIZE;
-		break;
+		asBC_NEXT();
 
-	case asBC_JLowZ:
+	asBC_CASE(asBC_JLowZ):
 		if( *(asBYTE*)&m_regs.valueRegister == 0 )
 			l_bc += asBC_INTARG(l_bc) + 2;
 		else
 			l_bc += 2;
-		break;
+		asBC_NEXT();
 
-	case asBC_JLowNZ:
+	asBC_CASE(asBC_JLowNZ):
 		if( *(asBYTE*)&m_regs.valueRegister != 0 )
 			l_bc += asBC_INTARG(l_bc) + 2;
 		else
 			l_bc += 2;
-		break;
+		asBC_NEXT();
 
-	case asBC_AllocMem:
+	asBC_CASE(asBC_AllocMem):
 		// Allocate a buffer and store the pointer in the local variable
 		{
 			// TODO: runtime optimize: As the list buffers are going to be short lived, it may be interesting
@@ -4138,9 +4392,9 @@ void asCContext::ExecuteNext()
 			memset(*var, 0, size);
 		}
 		l_bc += 2;
-		break;
+		asBC_NEXT();
 
-	case asBC_SetListSize:
+	asBC_CASE(asBC_SetListSize):
 		{
 			// Set the size element in the buffer
 			asBYTE *var = *(asBYTE**)(l_fp - asBC_SWORDARG0(l_bc));
@@ -4152,9 +4406,9 @@ void asCContext::ExecuteNext()
 			*(asUINT*)(var+off) = size;
 		}
 		l_bc += 3;
-		break;
+		asBC_NEXT();
 
-	case asBC_PshListElmnt:
+	asBC_CASE(asBC_PshListElmnt):
 		{
 			// Push the pointer to the list element on the stack
 			// In essence it does the same as PSF, RDSPtr, ADDSi
@@ -4167,9 +4421,9 @@ void asCContext::ExecuteNext()
 			*(asPWORD*)l_sp = asPWORD(var+off);
 		}
 		l_bc += 2;
-		break;
+		asBC_NEXT();
 
-	case asBC_SetListType:
+	asBC_CASE(asBC_SetListType):
 		{
 			// Set the type id in the buffer
 			asBYTE *var = *(asBYTE**)(l_fp - asBC_SWORDARG0(l_bc));
@@ -4181,11 +4435,11 @@ void asCContext::ExecuteNext()
 			*(asUINT*)(var+off) = type;
 		}
 		l_bc += 3;
-		break;
+		asBC_NEXT();
 
 	//------------------------------
 	// Exponent operations
-	case asBC_POWi:
+	asBC_CASE(asBC_POWi):
 		{
 			bool isOverflow;
 			*(int*)(l_fp - asBC_SWORDARG0(l_bc)) = as_powi(*(int*)(l_fp - asBC_SWORDARG1(l_bc)), *(int*)(l_fp - asBC_SWORDARG2(l_bc)), isOverflow);
@@ -4202,9 +4456,9 @@ void asCContext::ExecuteNext()
 			}
 		}
 		l_bc += 2;
-		break;
+		asBC_NEXT();
 
-	case asBC_POWu:
+	asBC_CASE(asBC_POWu):
 		{
 			bool isOverflow;
 			*(asDWORD*)(l_fp - asBC_SWORDARG0(l_bc)) = as_powu(*(asDWORD*)(l_fp - asBC_SWORDARG1(l_bc)), *(asDWORD*)(l_fp - asBC_SWORDARG2(l_bc)), isOverflow);
@@ -4221,9 +4475,9 @@ void asCContext::ExecuteNext()
 			}
 		}
 		l_bc += 2;
-		break;
+		asBC_NEXT();
 
-	case asBC_POWf:
+	asBC_CASE(asBC_POWf):
 		{
 			float r = powf(*(float*)(l_fp - asBC_SWORDARG1(l_bc)), *(float*)(l_fp - asBC_SWORDARG2(l_bc)));
 			*(float*)(l_fp - asBC_SWORDARG0(l_bc)) = r;
@@ -4240,9 +4494,9 @@ void asCContext::ExecuteNext()
 			}
 		}
 		l_bc += 2;
-		break;
+		asBC_NEXT();
 
-	case asBC_POWd:
+	asBC_CASE(asBC_POWd):
 		{
 			double r = pow(*(double*)(l_fp - asBC_SWORDARG1(l_bc)), *(double*)(l_fp - asBC_SWORDARG2(l_bc)));
 			*(double*)(l_fp - asBC_SWORDARG0(l_bc)) = r;
@@ -4259,9 +4513,9 @@ void asCContext::ExecuteNext()
 			}
 		}
 		l_bc += 2;
-		break;
+		asBC_NEXT();
 
-	case asBC_POWdi:
+	asBC_CASE(asBC_POWdi):
 		{
 			double r = pow(*(double*)(l_fp - asBC_SWORDARG1(l_bc)), *(int*)(l_fp - asBC_SWORDARG2(l_bc)));
 			*(double*)(l_fp - asBC_SWORDARG0(l_bc)) = r;
@@ -4278,9 +4532,9 @@ void asCContext::ExecuteNext()
 			}
 			l_bc += 2;
 		}
-		break;
+		asBC_NEXT();
 
-	case asBC_POWi64:
+	asBC_CASE(asBC_POWi64):
 		{
 			bool isOverflow;
 			*(asINT64*)(l_fp - asBC_SWORDARG0(l_bc)) = as_powi64(*(asINT64*)(l_fp - asBC_SWORDARG1(l_bc)), *(asINT64*)(l_fp - asBC_SWORDARG2(l_bc)), isOverflow);
@@ -4297,9 +4551,9 @@ void asCContext::ExecuteNext()
 			}
 		}
 		l_bc += 2;
-		break;
+		asBC_NEXT();
 
-	case asBC_POWu64:
+	asBC_CASE(asBC_POWu64):
 		{
 			bool isOverflow;
 			*(asQWORD*)(l_fp - asBC_SWORDARG0(l_bc)) = as_powu64(*(asQWORD*)(l_fp - asBC_SWORDARG1(l_bc)), *(asQWORD*)(l_fp - asBC_SWORDARG2(l_bc)), isOverflow);
@@ -4316,8 +4570,8 @@ void asCContext::ExecuteNext()
 			}
 		}
 		l_bc += 2;
-		break;
-	case asBC_Thiscall1:
+		asBC_NEXT();
+	asBC_CASE(asBC_Thiscall1):
 		// This instruction is a faster version of asBC_CALLSYS. It is faster because
 		// it has much less runtime overhead with determining the calling convention 
 		// and no dynamic code for loading the parameters. The instruction can only
@@ -4377,65 +4631,69 @@ void asCContext::ExecuteNext()
 				}
 			}
 		}
-		break;
+		asBC_NEXT();
+
+//-------------------------------
+// Superinstructions. The second instruction of the pair is still in the
+// bytecode right after the first, so jumps that land on it still work
+
+	asBC_CASE(asBC_CMPiJZ):   asBC_CMPi_JUMP(*(int*)(l_fp - asBC_SWORDARG1(l_bc)), ==);
+	asBC_CASE(asBC_CMPiJNZ):  asBC_CMPi_JUMP(*(int*)(l_fp - asBC_SWORDARG1(l_bc)), !=);
+	asBC_CASE(asBC_CMPiJS):   asBC_CMPi_JUMP(*(int*)(l_fp - asBC_SWORDARG1(l_bc)), <);
+	asBC_CASE(asBC_CMPiJNS):  asBC_CMPi_JUMP(*(int*)(l_fp - asBC_SWORDARG1(l_bc)), >=);
+	asBC_CASE(asBC_CMPiJP):   asBC_CMPi_JUMP(*(int*)(l_fp - asBC_SWORDARG1(l_bc)), >);
+	asBC_CASE(asBC_CMPiJNP):  asBC_CMPi_JUMP(*(int*)(l_fp - asBC_SWORDARG1(l_bc)), <=);
+	asBC_CASE(asBC_CMPIiJZ):  asBC_CMPi_JUMP(asBC_INTARG(l_bc), ==);
+	asBC_CASE(asBC_CMPIiJNZ): asBC_CMPi_JUMP(asBC_INTARG(l_bc), !=);
+	asBC_CASE(asBC_CMPIiJS):  asBC_CMPi_JUMP(asBC_INTARG(l_bc), <);
+	asBC_CASE(asBC_CMPIiJNS): asBC_CMPi_JUMP(asBC_INTARG(l_bc), >=);
+	asBC_CASE(asBC_CMPIiJP):  asBC_CMPi_JUMP(asBC_INTARG(l_bc), >);
+	asBC_CASE(asBC_CMPIiJNP): asBC_CMPi_JUMP(asBC_INTARG(l_bc), <=);
+
+	// RDR4 followed by ADDi
+	asBC_CASE(asBC_RDR4ADDi):
+		*(asDWORD*)(l_fp - asBC_SWORDARG0(l_bc)) = **(asDWORD**)&m_regs.valueRegister;
+		l_bc++;
+		*(int*)(l_fp - asBC_SWORDARG0(l_bc)) = *(int*)(l_fp - asBC_SWORDARG1(l_bc)) + *(int*)(l_fp - asBC_SWORDARG2(l_bc));
+		l_bc += 2;
+		asBC_NEXT();
+
+	// The pushes followed by CALLSYS continue in the CALLSYS handler
+	asBC_CASE(asBC_PSFCALLSYS):
+		l_sp -= AS_PTR_SIZE;
+		*(asPWORD*)l_sp = asPWORD(l_fp - asBC_SWORDARG0(l_bc));
+		l_bc++;
+		goto asBC_CALLSYS_BODY;
+
+	asBC_CASE(asBC_PshVPtrCALLSYS):
+		l_sp -= AS_PTR_SIZE;
+		*(asPWORD*)l_sp = *(asPWORD*)(l_fp - asBC_SWORDARG0(l_bc));
+		l_bc++;
+		goto asBC_CALLSYS_BODY;
+
+	asBC_CASE(asBC_PshV4CALLSYS):
+		--l_sp;
+		*l_sp = *(l_fp - asBC_SWORDARG0(l_bc));
+		l_bc++;
+		goto asBC_CALLSYS_BODY;
 
 	// Don't let the optimizer optimize for size,
 	// since it requires extra conditions and jumps
-	case 201: l_bc = (asDWORD*)201; break;
-	case 202: l_bc = (asDWORD*)202; break;
-	case 203: l_bc = (asDWORD*)203; break;
-	case 204: l_bc = (asDWORD*)204; break;
-	case 205: l_bc = (asDWORD*)205; break;
-	case 206: l_bc = (asDWORD*)206; break;
-	case 207: l_bc = (asDWORD*)207; break;
-	case 208: l_bc = (asDWORD*)208; break;
-	case 209: l_bc = (asDWORD*)209; break;
-	case 210: l_bc = (asDWORD*)210; break;
-	case 211: l_bc = (asDWORD*)211; break;
-	case 212: l_bc = (asDWORD*)212; break;
-	case 213: l_bc = (asDWORD*)213; break;
-	case 214: l_bc = (asDWORD*)214; break;
-	case 215: l_bc = (asDWORD*)215; break;
-	case 216: l_bc = (asDWORD*)216; break;
-	case 217: l_bc = (asDWORD*)217; break;
-	case 218: l_bc = (asDWORD*)218; break;
-	case 219: l_bc = (asDWORD*)219; break;
-	case 220: l_bc = (asDWORD*)220; break;
-	case 221: l_bc = (asDWORD*)221; break;
-	case 222: l_bc = (asDWORD*)222; break;
-	case 223: l_bc = (asDWORD*)223; break;
-	case 224: l_bc = (asDWORD*)224; break;
-	case 225: l_bc = (asDWORD*)225; break;
-	case 226: l_bc = (asDWORD*)226; break;
-	case 227: l_bc = (asDWORD*)227; break;
-	case 228: l_bc = (asDWORD*)228; break;
-	case 229: l_bc = (asDWORD*)229; break;
-	case 230: l_bc = (asDWORD*)230; break;
-	case 231: l_bc = (asDWORD*)231; break;
-	case 232: l_bc = (asDWORD*)232; break;
-	case 233: l_bc = (asDWORD*)233; break;
-	case 234: l_bc = (asDWORD*)234; break;
-	case 235: l_bc = (asDWORD*)235; break;
-	case 236: l_bc = (asDWORD*)236; break;
-	case 237: l_bc = (asDWORD*)237; break;
-	case 238: l_bc = (asDWORD*)238; break;
-	case 239: l_bc = (asDWORD*)239; break;
-	case 240: l_bc = (asDWORD*)240; break;
-	case 241: l_bc = (asDWORD*)241; break;
-	case 242: l_bc = (asDWORD*)242; break;
-	case 243: l_bc = (asDWORD*)243; break;
-	case 244: l_bc = (asDWORD*)244; break;
-	case 245: l_bc = (asDWORD*)245; break;
-	case 246: l_bc = (asDWORD*)246; break;
-	case 247: l_bc = (asDWORD*)247; break;
-	case 248: l_bc = (asDWORD*)248; break;
-	case 249: l_bc = (asDWORD*)249; break;
-	case 250: l_bc = (asDWORD*)250; break;
-	case 251: l_bc = (asDWORD*)251; break;
-	case 252: l_bc = (asDWORD*)252; break;
-	case 253: l_bc = (asDWORD*)253; break;
-	case 254: l_bc = (asDWORD*)254; break;
-	case 255: l_bc = (asDWORD*)255; break;
+	// The unused opcodes. The compiler never emits them, so the bytecode is broken
+	case 217: case 218: case 219: case 220: case 221: case 222: case 223: case 224:
+	case 225: case 226: case 227: case 228: case 229: case 230: case 231: case 232:
+	case 233: case 234: case 235: case 236: case 237: case 238: case 239: case 240:
+	case 241: case 242: case 243: case 244: case 245: case 246: case 247: case 248:
+	case 249: case 250: case 251: case 252: case 253: case 254: case 255:
+#ifdef AS_COMPUTED_GOTO
+	asBC_LABEL_invalid:
+#endif
+		m_regs.programPointer    = l_bc;
+		m_regs.stackPointer      = l_sp;
+		m_regs.stackFramePointer = l_fp;
+
+		SetInternalException(TXT_UNRECOGNIZED_BYTE_CODE);
+		return;
 
 #ifdef AS_DEBUG
 	default:
@@ -4456,7 +4714,7 @@ void asCContext::ExecuteNext()
 		asDWORD instr = *(asBYTE*)old;
 		if( instr != asBC_JMP && instr != asBC_JMPP && (instr < asBC_JZ || instr > asBC_JNP) && instr != asBC_JLowZ && instr != asBC_JLowNZ &&
 			instr != asBC_CALL && instr != asBC_CALLBND && instr != asBC_CALLINTF && instr != asBC_RET && instr != asBC_ALLOC && instr != asBC_CallPtr &&
-			instr != asBC_JitEntry )
+			instr != asBC_JitEntry && (instr < asBC_CMPiJZ || instr > asBC_PshV4CALLSYS) )
 		{
 			asASSERT( (l_bc - old) == asBCTypeSize[asBCInfo[instr].type] );
 		}
@@ -4464,6 +4722,10 @@ void asCContext::ExecuteNext()
 	}
 }
 
+#undef asBC_CASE
+#undef asBC_NEXT
+#undef asBC_CMPi_JUMP
+
 int asCContext::SetException(const char *descr)
 {
 	// Only allow this if we're executing a CALL byte code
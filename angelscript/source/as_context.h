@@ -146,6 +146,9 @@ public:
 	void CleanStackFrame();
 	void CleanArgsOnStack();
 	void CleanReturnObject();
+	bool ReleaseForPool();
+	void TakeFromPool();
+	void RequestSample();
 	void DetermineLiveObjects(asCArray<int> &liveObjects, asUINT stackLevel);
 
 	void PushCallState();
@@ -205,6 +208,11 @@ public:
 	asSSystemFunctionInterface m_exceptionCallbackFunc;
 	void *                     m_exceptionCallbackObj;
 
+	// Set by the engine's RequestSample, from any thread, while the context is executing
+	bool                       m_samplePending;
+	// The context's index in the engine's list of sampled contexts, or -1
+	int                        m_sampleIndex;
+
 	asCArray<asPWORD> m_userData;
 
 	// Registers available to JIT compiler functions
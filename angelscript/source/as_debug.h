@@ -82,152 +82,64 @@ typedef double float64_t;
 
 
 
-#if defined(_MSC_VER) && defined(AS_PROFILE)
-// Currently only do profiling with MSVC++
+#if defined(AS_PROFILE)
+// Portable profiler. TimeIt scopes are accumulated per thread into a tree of
+// call paths, which is merged across threads when it is enumerated. Timing is
+// off until asSetProfilerEnabled(true) is called.
 
-#include <mmsystem.h>
-#include <direct.h>
+#include "as_criticalsection.h"
 #include "as_string.h"
-#include "as_map.h"
-#include "as_string_util.h"
 
 BEGIN_AS_NAMESPACE
 
-struct TimeCount
+struct asSProfileNode
 {
-	double time;
-	int    count;
-	double max;
-	double min;
+	const char     *name;
+	asSProfileNode *parent;
+	asSProfileNode *firstChild;
+	asSProfileNode *nextSibling;
+
+	double          beginTime;
+	asQWORD         count;
+	double          time;
+	double          max;
+	double          min;
 };
 
 class CProfiler
 {
 public:
-	CProfiler()
-	{
-		// We need to know how often the clock is updated
-		__int64 tps;
-		if( !QueryPerformanceFrequency((LARGE_INTEGER *)&tps) )
-			usePerformance = false;
-		else
-		{
-			usePerformance = true;
-			ticksPerSecond = double(tps);
-		}
-
-		timeOffset = GetTime();
-	}
-
-	~CProfiler()
-	{
-		WriteSummary();
-	}
-
-	double GetTime()
-	{
-		if( usePerformance )
-		{
-			__int64 ticks;
-			QueryPerformanceCounter((LARGE_INTEGER *)&ticks);
-
-			return double(ticks)/ticksPerSecond - timeOffset;
-		}
-		
-		return double(timeGetTime())/1000.0 - timeOffset;
-	}
+	CProfiler();
+	~CProfiler();
 
-	double Begin(const char *name)
-	{
-		double time = GetTime();
+	static double GetTime();
 
-		// Add the scope to the key
-		if( key.GetLength() )
-			key += "|";
-		key += name;
+	void SetEnabled(bool enable) { enabled = enable; }
+	bool IsEnabled() const { return enabled; }
 
-		// Compensate for the time spent writing to the file
-		timeOffset += GetTime() - time;
+	// The name must stay valid for the lifetime of the profiler, usually it's a literal
+	void Begin(const char *name);
+	void End();
 
-		return time;
-	}
+	// Must not be called while other threads are inside a scope
+	void Enumerate(asPROFILERCALLBACK_t callback, void *param);
+	void Reset();
 
-	void End(const char * /*name*/, double beginTime)
-	{
-		double time = GetTime();
-
-		double elapsed = time - beginTime;
-
-		// Update the profile info for this scope
-		asSMapNode<asCString, TimeCount> *cursor;
-		if( map.MoveTo(&cursor, key) )
-		{
-			cursor->value.time += elapsed;
-			cursor->value.count++;
-			if( cursor->value.max < elapsed ) 
-				cursor->value.max = elapsed;
-			if( cursor->value.min > elapsed ) 
-				cursor->value.min = elapsed;
-		}
-		else
-		{
-			TimeCount tc = {elapsed, 1, elapsed, elapsed};
-			map.Insert(key, tc);
-		}
-
-		// Remove the inner most scope from the key
-		int n = key.FindLast("|");
-		if( n > 0 )
-			key.SetLength(n);
-		else
-			key.SetLength(0);
-
-		// Compensate for the time spent writing to the file
-		timeOffset += GetTime() - time;
-	}
-	
 protected:
-	void WriteSummary()
-	{
-		// Write the analyzed info into a file for inspection
-		_mkdir("AS_DEBUG");
-		FILE *fp;
-		#if _MSC_VER >= 1500 && !defined(AS_MARMALADE)
-			fopen_s(&fp, "AS_DEBUG/profiling_summary.txt", "wt");
-		#else
-			fp = fopen("AS_DEBUG/profiling_summary.txt", "wt");
-		#endif
-		if( fp == 0 )
-			return;
-
-		fprintf(fp, "%-60s %10s %15s %15s %15s %15s\n\n", "Scope", "Count", "Tot time", "Avg time", "Max time", "Min time");
-
-		asSMapNode<asCString, TimeCount> *cursor;
-		map.MoveLast(&cursor);
-		while( cursor )
-		{
-			asCString key = cursor->key;
-			int count;
-			int n = key.FindLast("|", &count);
-			if( count )
-			{
-				key = asCString("                                               ", count) + key.SubString(n+1);
-			}
-
-			fprintf(fp, "%-60s %10d %15.6f %15.6f %15.6f %15.6f\n", key.AddressOf(), cursor->value.count, cursor->value.time, cursor->value.time / cursor->value.count, cursor->value.max, cursor->value.min);
-
-			map.MovePrev(&cursor, cursor);
-		}
-
-		fclose(fp);
-	}
+	asSProfileNode *GetThreadRoot();
+
+	static asSProfileNode *CreateNode(const char *name, asSProfileNode *parent);
+	static asSProfileNode *FindChild(asSProfileNode *parent, const char *name);
+	static void            Merge(asSProfileNode *to, const asSProfileNode *from);
+	static void            Report(const asSProfileNode *node, asCString &path, int depth, asPROFILERCALLBACK_t callback, void *param);
+	static void            Clear(asSProfileNode *node);
+	static void            Free(asSProfileNode *node);
 
-	double  timeOffset;
-	double  ticksPerSecond;
-	bool    usePerformance;
+	volatile bool   enabled;
 
-	asCString                    key;
-	asCMap<asCString, TimeCount> map;
+	// The root of every thread that has used the profiler, linked through nextSibling
+	asSProfileNode *threadRoots;
+	DECLARECRITICALSECTION(lock)
 };
 
 extern CProfiler g_profiler;
@@ -237,30 +149,31 @@ class CProfilerScope
 public:
 	CProfilerScope(const char *name)
 	{
-		this->name = name;
-		beginTime = g_profiler.Begin(name);
+		active = g_profiler.IsEnabled();
+		if( active )
+			g_profiler.Begin(name);
 	}
 
 	~CProfilerScope()
 	{
-		g_profiler.End(name, beginTime);
+		if( active )
+			g_profiler.End();
 	}
 
 protected:
-	const char *name;
-	double      beginTime;
+	bool active;
 };
 
 #define TimeIt(x) CProfilerScope profilescope(x)
 
 END_AS_NAMESPACE
 
-#else // !(_MSC_VER && AS_PROFILE)
+#else // !AS_PROFILE
 
 // Define it so nothing is done
 #define TimeIt(x) 
 
-#endif // !(_MSC_VER && AS_PROFILE)
+#endif // !AS_PROFILE
 
 
 
@@ -43,8 +43,34 @@
 #include "as_scriptobject.h"
 #include "as_texts.h"
 
+#if defined(_WIN32)
+#ifndef WIN32_LEAN_AND_MEAN
+#define WIN32_LEAN_AND_MEAN
+#endif
+#include <windows.h>
+#undef GetObject
+#undef RegisterClass
+#else
+#include <time.h>
+#endif
+
 BEGIN_AS_NAMESPACE
 
+// Monotonic time used for the time budget of GarbageCollect
+static asQWORD GetTimeInMicroseconds()
+{
+#if defined(_WIN32)
+	LARGE_INTEGER frequency, counter;
+	QueryPerformanceFrequency(&frequency);
+	QueryPerformanceCounter(&counter);
+	return asQWORD(counter.QuadPart / frequency.QuadPart * 1000000 + counter.QuadPart % frequency.QuadPart * 1000000 / frequency.QuadPart);
+#else
+	timespec now;
+	clock_gettime(CLOCK_MONOTONIC, &now);
+	return asQWORD(now.tv_sec) * 1000000 + asQWORD(now.tv_nsec) / 1000;
+#endif
+}
+
 asCGarbageCollector::asCGarbageCollector()
 {
 	engine          = 0;
@@ -55,21 +81,12 @@ asCGarbageCollector::asCGarbageCollector()
 	numNewDestroyed = 0;
 	numDetected     = 0;
 	numAdded        = 0;
+	gcMapIdx        = 0;
 	isProcessing    = false;
-
-	seqAtSweepStart[0] = 0;
-	seqAtSweepStart[1] = 0;
-	seqAtSweepStart[2] = 0;
 }
 
 asCGarbageCollector::~asCGarbageCollector()
 {
-	// This local typedef is done to workaround a compiler error on
-	// MSVC6 when using the typedef declared in the class definition
-	typedef asSMapNode_t node_t;
-	for( asUINT n = 0; n < freeNodes.GetLength(); n++ )
-		asDELETE(freeNodes[n], node_t);
-	freeNodes.SetLength(0);
 }
 
 int asCGarbageCollector::AddScriptObjectToGC(void *obj, asCObjectType *objType)
@@ -224,6 +241,39 @@ int asCGarbageCollector::GarbageCollect(asDWORD flags, asUINT iterations)
 			LEAVECRITICALSECTION(gcCollecting);
 			return 0;
 		}
+		else if( flags & asGC_TIME_BUDGET )
+		{
+			// The iterations is the number of microseconds the application can spare. Run
+			// steps until that time is spent or until each task has finished its sweep. The
+			// time is checked after every step, but a single step can still overshoot it, e.g.
+			// when releasing an object makes it free a large structure of other objects
+			asQWORD deadline = GetTimeInMicroseconds() + iterations;
+			bool newDone    = !doDestroy;
+			bool oldDone    = !doDestroy;
+			bool detectDone = !doDetect;
+			for( int task = 0; !(newDone && oldDone && detectDone); task = (task + 1) % 3 )
+			{
+				if( task == 0 && !newDone )
+					newDone = DestroyNewGarbage() == 0;
+				else if( task == 1 && !oldDone )
+					oldDone = DestroyOldGarbage() == 0;
+				else if( task == 2 && !detectDone )
+					detectDone = gcOldObjects.GetLength() == 0 || IdentifyGarbageWithCyclicRefs() == 0;
+				else
+					continue;
+
+				if( GetTimeInMicroseconds() >= deadline )
+					break;
+			}
+
+			if( newDone && oldDone && detectDone )
+			{
+				// Return 0 to tell the application that there is nothing left to do at the moment
+				isProcessing = false;
+				LEAVECRITICALSECTION(gcCollecting);
+				return 0;
+			}
+		}
 		else
 		{
 			while( iterations-- > 0 )
@@ -372,9 +422,23 @@ int asCGarbageCollector::DestroyNewGarbage()
 
 			// Update the seqAtSweepStart which is used to determine when 
 			// to move an object from the new set to the old set
-			seqAtSweepStart[0] = seqAtSweepStart[1];
-			seqAtSweepStart[1] = seqAtSweepStart[2];
-			seqAtSweepStart[2] = numAdded;
+			asUINT age = engine->ep.gcPromotionAge;
+			if( seqAtSweepStart.GetLength() != age )
+			{
+				// The promotion age was changed. Count the sweeps from 
+				// here so that no object is moved earlier than it should
+				seqAtSweepStart.SetLength(age);
+				if( seqAtSweepStart.GetLength() != age )
+				{
+					// Out of memory
+					return 0;
+				}
+				for( asUINT n = 0; n < age; n++ )
+					seqAtSweepStart[n] = 0;
+			}
+			for( asUINT n = 1; n < age; n++ )
+				seqAtSweepStart[n-1] = seqAtSweepStart[n];
+			seqAtSweepStart[age-1] = numAdded;
 
 			destroyNewIdx = (asUINT)-1;
 			destroyNewState = destroyGarbage_loop;
@@ -427,9 +491,9 @@ int asCGarbageCollector::DestroyNewGarbage()
 
 					destroyNewState = destroyGarbage_haveMore;
 				}
-				// Check if this object has been inspected 3 times already, and if so move it to the 
-				// set of old objects that are less likely to become garbage in a short time
-				// TODO: Is 3 really a good value? Should the number of times be dynamic? 
+				// Check if this object has been inspected enough times already, and if so move it to the 
+				// set of old objects that are less likely to become garbage in a short time. The number
+				// of times is set with asEP_GC_PROMOTION_AGE
 				else if( gcObj.seqNbr < seqAtSweepStart[0] )
 				{
 					// We've already verified this object multiple times. It is likely
@@ -635,17 +699,17 @@ int asCGarbageCollector::IdentifyGarbageWithCyclicRefs()
 
 		case clearCounters_loop:
 		{
-			// Decrease reference counter for all objects removed from the map
-			asSMapNode<void*, asSIntTypePair> *cursor = 0;
-			gcMap.MoveFirst(&cursor);
-			if( cursor )
+			// Decrease reference counter for all objects removed from the map. Removing
+			// the last entry keeps the memory of the map for the next detection
+			if( gcMap.GetCount() )
 			{
-				void *obj = gcMap.GetKey(cursor);
-				asSIntTypePair it = gcMap.GetValue(cursor);
+				int last = int(gcMap.GetCount()) - 1;
+				void *obj = gcMap.GetKey(last);
+				asSIntTypePair it = gcMap.GetValue(last);
 
 				engine->CallObjectMethod(obj, it.type->beh.release);
 
-				ReturnNode(gcMap.Remove(cursor));
+				gcMap.Erase(last);
 
 				return 1;
 			}
@@ -685,7 +749,7 @@ int asCGarbageCollector::IdentifyGarbageWithCyclicRefs()
 				{
 					asSIntTypePair it = {refCount-1, gcObj.type};
 
-					gcMap.Insert(GetNode(gcObj.obj, it));
+					gcMap.Insert(gcObj.obj, it);
 
 					// Increment the object's reference counter when putting it in the map
 					engine->CallObjectMethod(gcObj.obj, gcObj.type->beh.addref);
@@ -707,7 +771,7 @@ int asCGarbageCollector::IdentifyGarbageWithCyclicRefs()
 
 		case countReferences_init:
 		{
-			gcMap.MoveFirst(&gcMapCursor);
+			gcMapIdx = 0;
 			detectState = countReferences_loop;
 		}
 		break;
@@ -725,11 +789,11 @@ int asCGarbageCollector::IdentifyGarbageWithCyclicRefs()
 
 			// Any new objects created after this step in the GC cycle won't be
 			// in the map, and is thus automatically considered alive.
-			if( gcMapCursor )
+			if( gcMapIdx < gcMap.GetCount() )
 			{
-				void *obj = gcMap.GetKey(gcMapCursor);
-				asCObjectType *type = gcMap.GetValue(gcMapCursor).type;
-				gcMap.MoveNext(&gcMapCursor, gcMapCursor);
+				void *obj = gcMap.GetKey(gcMapIdx);
+				asCObjectType *type = gcMap.GetValue(gcMapIdx).type;
+				gcMapIdx++;
 
 				if( engine->CallObjectMethodRetBool(obj, type->beh.gcGetFlag) )
 				{
@@ -746,7 +810,7 @@ int asCGarbageCollector::IdentifyGarbageWithCyclicRefs()
 
 		case detectGarbage_init:
 		{
-			gcMap.MoveFirst(&gcMapCursor);
+			gcMapIdx = 0;
 			liveObjects.SetLength(0);
 			detectState = detectGarbage_loop1;
 		}
@@ -762,13 +826,11 @@ int asCGarbageCollector::IdentifyGarbageWithCyclicRefs()
 			// references were not found in the map.
 
 			// Add all alive objects from the map to the liveObjects array
-			if( gcMapCursor )
+			if( gcMapIdx < gcMap.GetCount() )
 			{
-				asSMapNode<void*, asSIntTypePair> *cursor = gcMapCursor;
-				gcMap.MoveNext(&gcMapCursor, gcMapCursor);
-
-				void *obj = gcMap.GetKey(cursor);
-				asSIntTypePair it = gcMap.GetValue(cursor);
+				void *obj = gcMap.GetKey(gcMapIdx);
+				asSIntTypePair it = gcMap.GetValue(gcMapIdx);
+				gcMapIdx++;
 
 				bool gcFlag = engine->CallObjectMethodRetBool(obj, it.type->beh.gcGetFlag);
 				if( !gcFlag || it.i > 0 )
@@ -796,11 +858,11 @@ int asCGarbageCollector::IdentifyGarbageWithCyclicRefs()
 				asCObjectType *type = 0;
 
 				// Remove the object from the map to mark it as alive
-				asSMapNode<void*, asSIntTypePair> *cursor = 0;
-				if( gcMap.MoveTo(&cursor, gcObj) )
+				int idx = gcMap.GetFirst(gcObj);
+				if( idx >= 0 )
 				{
-					type = gcMap.GetValue(cursor).type;
-					ReturnNode(gcMap.Remove(cursor));
+					type = gcMap.GetValue(idx).type;
+					gcMap.Erase(idx);
 
 					// We need to decrease the reference count again as we remove the object from the map
 					engine->CallObjectMethod(gcObj, type->beh.release);
@@ -818,7 +880,7 @@ int asCGarbageCollector::IdentifyGarbageWithCyclicRefs()
 		break;
 
 		case verifyUnmarked_init:
-			gcMap.MoveFirst(&gcMapCursor);
+			gcMapIdx = 0;
 			detectState = verifyUnmarked_loop;
 			break;
 
@@ -827,10 +889,10 @@ int asCGarbageCollector::IdentifyGarbageWithCyclicRefs()
 			// In this step we must make sure that none of the objects still in the map
 			// has been touched by the application. If they have then we must run the
 			// detectGarbage loop once more.
-			if( gcMapCursor )
+			if( gcMapIdx < gcMap.GetCount() )
 			{
-				void *gcObj = gcMap.GetKey(gcMapCursor);
-				asCObjectType *type = gcMap.GetValue(gcMapCursor).type;
+				void *gcObj = gcMap.GetKey(gcMapIdx);
+				asCObjectType *type = gcMap.GetValue(gcMapIdx).type;
 
 				bool gcFlag = engine->CallObjectMethodRetBool(gcObj, type->beh.gcGetFlag);
 				if( !gcFlag )
@@ -839,7 +901,7 @@ int asCGarbageCollector::IdentifyGarbageWithCyclicRefs()
 					detectState = detectGarbage_init;
 				}
 				else
-					gcMap.MoveNext(&gcMapCursor, gcMapCursor);
+					gcMapIdx++;
 
 				// Allow the application to work a little
 				return 1;
@@ -855,7 +917,7 @@ int asCGarbageCollector::IdentifyGarbageWithCyclicRefs()
 
 		case breakCircles_init:
 		{
-			gcMap.MoveFirst(&gcMapCursor);
+			gcMapIdx = 0;
 			detectState = breakCircles_loop;
 		}
 		break;
@@ -867,11 +929,11 @@ int asCGarbageCollector::IdentifyGarbageWithCyclicRefs()
 			// kept alive through circular references. To be able to free
 			// these objects we need to force the breaking of the circle
 			// by having the objects release their references.
-			if( gcMapCursor )
+			if( gcMapIdx < gcMap.GetCount() )
 			{
 				numDetected++;
-				void *gcObj = gcMap.GetKey(gcMapCursor);
-				asCObjectType *type = gcMap.GetValue(gcMapCursor).type;
+				void *gcObj = gcMap.GetKey(gcMapIdx);
+				asCObjectType *type = gcMap.GetValue(gcMapIdx).type;
 				if( type->flags & asOBJ_SCRIPT_OBJECT )
 				{
 					// For script objects we must call the class destructor before
@@ -882,7 +944,7 @@ int asCGarbageCollector::IdentifyGarbageWithCyclicRefs()
 				}
 				engine->CallObjectMethod(gcObj, engine, type->beh.gcReleaseAllReferences);
 
-				gcMap.MoveNext(&gcMapCursor, gcMapCursor);
+				gcMapIdx++;
 
 				detectState = breakCircles_haveGarbage;
 
@@ -913,37 +975,6 @@ int asCGarbageCollector::IdentifyGarbageWithCyclicRefs()
 	UNREACHABLE_RETURN;
 }
 
-asCGarbageCollector::asSMapNode_t *asCGarbageCollector::GetNode(void *obj, asSIntTypePair it)
-{
-	// This function will only be called within the critical section gcCollecting
-	asASSERT(isProcessing);
-
-	asSMapNode_t *node;
-	if( freeNodes.GetLength() )
-		node = freeNodes.PopLast();
-	else
-	{
-		node = asNEW(asSMapNode_t);
-		if( !node )
-		{
-			// Out of memory
-			return 0;
-		}
-	}
-	
-	node->Init(obj, it);
-	return node;
-}
-
-void asCGarbageCollector::ReturnNode(asSMapNode_t *node)
-{
-	// This function will only be called within the critical section gcCollecting
-	asASSERT(isProcessing);
-
-	if( node )
-		freeNodes.PushLast(node);
-}
-
 void asCGarbageCollector::GCEnumCallback(void *reference)
 {
 	// This function will only be called within the critical section gcCollecting
@@ -952,18 +983,17 @@ void asCGarbageCollector::GCEnumCallback(void *reference)
 	if( detectState == countReferences_loop )
 	{
 		// Find the reference in the map
-		asSMapNode<void*, asSIntTypePair> *cursor = 0;
-		if( gcMap.MoveTo(&cursor, reference) )
+		int idx = gcMap.GetFirst(reference);
+		if( idx >= 0 )
 		{
 			// Decrease the counter in the map for the reference
-			gcMap.GetValue(cursor).i--;
+			gcMap.GetValue(idx).i--;
 		}
 	}
 	else if( detectState == detectGarbage_loop2 )
 	{
 		// Find the reference in the map
-		asSMapNode<void*, asSIntTypePair> *cursor = 0;
-		if( gcMap.MoveTo(&cursor, reference) )
+		if( gcMap.GetFirst(reference) >= 0 )
 		{
 			// Add the object to the list of objects to mark as alive
 			liveObjects.PushLast(reference);
@@ -42,7 +42,7 @@
 
 #include "as_config.h"
 #include "as_array.h"
-#include "as_map.h"
+#include "as_hashmap.h"
 #include "as_thread.h"
 
 BEGIN_AS_NAMESPACE
@@ -69,7 +69,6 @@ public:
 protected:
 	struct asSObjTypePair {void *obj; asCObjectType *type; asUINT seqNbr;};
 	struct asSIntTypePair {int i; asCObjectType *type;};
-	typedef asSMapNode<void*, asSIntTypePair> asSMapNode_t;
 
 	enum egcDestroyState
 	{
@@ -114,8 +113,9 @@ protected:
 	asCArray<void*>                    liveObjects;
 
 	// This map holds objects currently being searched for cyclic references, it also holds a 
-	// counter that gives the number of references to the object that the GC can't reach
-	asCMap<void*, asSIntTypePair>      gcMap;
+	// counter that gives the number of references to the object that the GC can't reach.
+	// The entries are visited by index, and the memory is kept from one detection to the next
+	asCHashMap<void*, asSIntTypePair>  gcMap;
 
 	// State variables
 	egcDestroyState                    destroyNewState;
@@ -128,14 +128,12 @@ protected:
 	asUINT                             detectIdx;
 	asUINT                             numDetected;
 	asUINT                             numAdded;
-	asUINT                             seqAtSweepStart[3];
-	asSMapNode_t                      *gcMapCursor;
+	asUINT                             gcMapIdx;
 	bool                               isProcessing;
 
-	// We'll keep a pool of nodes to avoid allocating memory all the time
-	asSMapNode_t            *GetNode(void *obj, asSIntTypePair it);
-	void                     ReturnNode(asSMapNode_t *node);
-	asCArray<asSMapNode_t*>  freeNodes;
+	// The value of numAdded at the start of the last sweeps of the new objects, oldest 
+	// first. There is one per sweep an object must survive before it is moved to the old list
+	asCArray<asUINT>                   seqAtSweepStart;
 
 	// Critical section for multithreaded access
 	DECLARECRITICALSECTION(gcCritical)   // Used for adding/removing objects
@@ -68,7 +68,7 @@ void asCGlobalProperty::AddRef()
 void asCGlobalProperty::Release()
 {
 	if( refCount.atomicDec() == 0 )
-		asDELETE(this, asCGlobalProperty);
+		asDELETEPOOLED(this, asCGlobalProperty);
 }
 
 void asCGlobalProperty::DestroyInternal()
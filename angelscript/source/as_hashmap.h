@@ -0,0 +1,284 @@
+/*
+   AngelCode Scripting Library
+   Copyright (c) 2003-2015 Andreas Jonsson
+
+   This software is provided 'as-is', without any express or implied
+   warranty. In no event will the authors be held liable for any
+   damages arising from the use of this software.
+
+   Permission is granted to anyone to use this software for any
+   purpose, including commercial applications, and to alter it and
+   redistribute it freely, subject to the following restrictions:
+
+   1. The origin of this software must not be misrepresented; you
+      must not claim that you wrote the original software. If you use
+      this software in a product, an acknowledgment in the product
+      documentation would be appreciated but is not required.
+
+   2. Altered source versions must be plainly marked as such, and
+      must not be misrepresented as being the original software.
+
+   3. This notice may not be removed or altered from any source
+      distribution.
+
+   The original version of this library can be located at:
+   http://www.angelcode.com/angelscript/
+
+   Andreas Jonsson
+   andreas@angelcode.com
+*/
+
+
+//
+// as_hashmap.h
+//
+// Unordered map with chained buckets. The entries are kept in one array so
+// that they can be visited in insertion order, and the same key can be
+// inserted more than once. Use asCMap when the keys must be kept sorted.
+//
+
+
+#ifndef AS_HASHMAP_H
+#define AS_HASHMAP_H
+
+#include "as_array.h"
+#include "as_string.h"
+
+BEGIN_AS_NAMESPACE
+
+// Hash functions for the key types. Other key types must provide an overload
+inline asUINT asHashValue(asQWORD value)
+{
+	// Fold and mix, so that keys differing only in the upper or lower bits spread over the buckets
+	value ^= value >> 33;
+	value *= 0xff51afd7ed558ccdULL;
+	value ^= value >> 33;
+	return asUINT(value);
+}
+
+inline asUINT asHashValue(asUINT value)
+{
+	return asHashValue(asQWORD(value));
+}
+
+inline asUINT asHashValue(const void *value)
+{
+	return asHashValue(asQWORD(asPWORD(value)));
+}
+
+inline asUINT asHashValue(const char *str, asUINT length, asUINT seed = 2166136261u)
+{
+	// FNV-1a
+	asUINT hash = seed;
+	for( asUINT n = 0; n < length; n++ )
+	{
+		hash ^= (unsigned char)str[n];
+		hash *= 16777619u;
+	}
+	return hash;
+}
+
+inline asUINT asHashValue(const asCString &str)
+{
+	return asHashValue(str.AddressOf(), (asUINT)str.GetLength());
+}
+
+template <class KEY, class VAL> struct asSHashEntry
+{
+	KEY    key;
+	VAL    value;
+	asUINT hash;
+	int    next;
+};
+
+template <class KEY, class VAL> class asCHashMap
+{
+public:
+	asCHashMap();
+
+	// Adds the entry even if the key is already in the map. Returns the index of the entry
+	int    Insert(const KEY &key, const VAL &value);
+
+	// Index of the first entry with the key, or -1. GetNext continues with the
+	// next entry with the same key, in insertion order unless entries were erased
+	int    GetFirst(const KEY &key) const;
+	int    GetNext(int entry) const;
+
+	const KEY &GetKey(int entry) const;
+	const VAL &GetValue(int entry) const;
+	VAL       &GetValue(int entry);
+
+	// Removes the entry. The last entry is moved into its place, so indices of
+	// entries other than the erased one may change
+	void   Erase(int entry);
+	void   EraseAll();
+
+	asUINT GetCount() const;
+
+	void   SwapWith(asCHashMap<KEY,VAL> &other);
+
+protected:
+	// Don't allow value assignment
+	asCHashMap &operator=(const asCHashMap &) { return *this; }
+
+	void   Rehash(asUINT bucketCount);
+	int   *FindLink(int entry);
+
+	asCArray<asSHashEntry<KEY,VAL> > entries;
+	asCArray<int>                    buckets;
+};
+
+//---------------------------------------------------------------------------
+// Implementation
+
+template <class KEY, class VAL>
+asCHashMap<KEY, VAL>::asCHashMap()
+{
+}
+
+template <class KEY, class VAL>
+void asCHashMap<KEY, VAL>::Rehash(asUINT bucketCount)
+{
+	buckets.SetLength(bucketCount);
+	for( asUINT n = 0; n < bucketCount; n++ )
+		buckets[n] = -1;
+
+	// Link the entries backwards, so that each chain ends up in insertion order
+	for( int n = int(entries.GetLength()) - 1; n >= 0; n-- )
+	{
+		int &head = buckets[entries[n].hash & (bucketCount - 1)];
+		entries[n].next = head;
+		head = n;
+	}
+}
+
+template <class KEY, class VAL>
+int asCHashMap<KEY, VAL>::Insert(const KEY &key, const VAL &value)
+{
+	asSHashEntry<KEY,VAL> entry;
+	entry.key   = key;
+	entry.value = value;
+	entry.hash  = asHashValue(key);
+	entry.next  = -1;
+
+	int index = int(entries.GetLength());
+	entries.PushLast(entry);
+
+	// Keep at most one entry per bucket on average
+	if( entries.GetLength() > buckets.GetLength() )
+	{
+		Rehash(buckets.GetLength() ? buckets.GetLength() * 2 : 16);
+		return index;
+	}
+
+	// Append to the end of the chain to keep the insertion order
+	int *link = &buckets[entry.hash & (buckets.GetLength() - 1)];
+	while( *link >= 0 )
+		link = &entries[*link].next;
+	*link = index;
+
+	return index;
+}
+
+template <class KEY, class VAL>
+int asCHashMap<KEY, VAL>::GetFirst(const KEY &key) const
+{
+	if( buckets.GetLength() == 0 )
+		return -1;
+
+	asUINT hash = asHashValue(key);
+	for( int n = buckets[hash & (buckets.GetLength() - 1)]; n >= 0; n = entries[n].next )
+	{
+		if( entries[n].hash == hash && entries[n].key == key )
+			return n;
+	}
+
+	return -1;
+}
+
+template <class KEY, class VAL>
+int asCHashMap<KEY, VAL>::GetNext(int entry) const
+{
+	const asSHashEntry<KEY,VAL> &current = entries[entry];
+	for( int n = current.next; n >= 0; n = entries[n].next )
+	{
+		if( entries[n].hash == current.hash && entries[n].key == current.key )
+			return n;
+	}
+
+	return -1;
+}
+
+template <class KEY, class VAL>
+const KEY &asCHashMap<KEY, VAL>::GetKey(int entry) const
+{
+	return entries[entry].key;
+}
+
+template <class KEY, class VAL>
+const VAL &asCHashMap<KEY, VAL>::GetValue(int entry) const
+{
+	return entries[entry].value;
+}
+
+template <class KEY, class VAL>
+VAL &asCHashMap<KEY, VAL>::GetValue(int entry)
+{
+	return entries[entry].value;
+}
+
+template <class KEY, class VAL>
+int *asCHashMap<KEY, VAL>::FindLink(int entry)
+{
+	int *link = &buckets[entries[entry].hash & (buckets.GetLength() - 1)];
+	while( *link != entry )
+		link = &entries[*link].next;
+	return link;
+}
+
+template <class KEY, class VAL>
+void asCHashMap<KEY, VAL>::Erase(int entry)
+{
+	asASSERT( entry >= 0 && asUINT(entry) < entries.GetLength() );
+
+	// Unlink the entry
+	*FindLink(entry) = entries[entry].next;
+
+	// Move the last entry into the hole
+	int last = int(entries.GetLength()) - 1;
+	if( entry != last )
+	{
+		*FindLink(last) = entry;
+		entries[entry] = entries[last];
+	}
+
+	// asCArray doesn't destroy popped elements, so release what the key and value hold
+	entries[last].~asSHashEntry<KEY,VAL>();
+	new (&entries[last]) asSHashEntry<KEY,VAL>();
+	entries.PopLast();
+}
+
+template <class KEY, class VAL>
+void asCHashMap<KEY, VAL>::EraseAll()
+{
+	// Free the arrays rather than just shortening them, so the keys and values are destroyed
+	entries.Allocate(0, false);
+	buckets.Allocate(0, false);
+}
+
+template <class KEY, class VAL>
+asUINT asCHashMap<KEY, VAL>::GetCount() const
+{
+	return entries.GetLength();
+}
+
+template <class KEY, class VAL>
+void asCHashMap<KEY, VAL>::SwapWith(asCHashMap<KEY,VAL> &other)
+{
+	entries.SwapWith(other.entries);
+	buckets.SwapWith(other.buckets);
+}
+
+END_AS_NAMESPACE
+
+#endif
@@ -46,6 +46,9 @@
 #include "as_memory.h"
 #include "as_scriptnode.h"
 #include "as_bytecode.h"
+#include "as_scriptfunction.h"
+#include "as_objecttype.h"
+#include "as_property.h"
 
 BEGIN_AS_NAMESPACE
 
@@ -181,13 +184,178 @@ void asFreeMem(void *mem)
 
 } // extern "C"
 
+// Each block starts with a pointer to the pool that owns it. The union
+// keeps the object as aligned as if it had been allocated on its own
+union asUPoolBlockHeader
+{
+	asCSlabPool *pool;
+	asQWORD      alignQword;
+	double       alignDouble;
+};
+
+// Roughly how much memory each slab should hold
+const size_t SLAB_SIZE = 16384;
+
+asCSlabPool::asCSlabPool(const char *in_name, size_t in_objectSize)
+{
+	name          = in_name;
+	objectSize    = in_objectSize;
+	freeList      = 0;
+	liveObjects   = 0;
+	peakObjects   = 0;
+	totalAllocs   = 0;
+	isOrphaned    = false;
+
+	// The free list is threaded through the objects, so they must hold at least a pointer
+	size_t size = objectSize < sizeof(void*) ? sizeof(void*) : objectSize;
+	blockSize = sizeof(asUPoolBlockHeader) + (size + sizeof(asUPoolBlockHeader) - 1) / sizeof(asUPoolBlockHeader) * sizeof(asUPoolBlockHeader);
+
+	blocksPerSlab = asUINT(SLAB_SIZE / blockSize);
+	if( blocksPerSlab < 16 )
+		blocksPerSlab = 16;
+}
+
+asCSlabPool::~asCSlabPool()
+{
+	for( asUINT n = 0; n < slabs.GetLength(); n++ )
+		asDELETEARRAY(slabs[n]);
+}
+
+bool asCSlabPool::AddSlab()
+{
+	asBYTE *slab = asNEWARRAY(asBYTE, blockSize * blocksPerSlab);
+	if( slab == 0 )
+		return false;
+
+	slabs.PushLast(slab);
+
+	// Link the blocks backwards so they are handed out in address order
+	for( asUINT n = blocksPerSlab; n-- > 0; )
+	{
+		asUPoolBlockHeader *block = reinterpret_cast<asUPoolBlockHeader*>(slab + n * blockSize);
+		block->pool = this;
+		*reinterpret_cast<void**>(block + 1) = freeList;
+		freeList = block + 1;
+	}
+
+	return true;
+}
+
+void *asCSlabPool::Alloc()
+{
+	ENTERCRITICALSECTION(cs);
+
+	if( freeList == 0 && !AddSlab() )
+	{
+		LEAVECRITICALSECTION(cs);
+		return 0;
+	}
+
+	void *ptr = freeList;
+	freeList = *reinterpret_cast<void**>(ptr);
+
+	totalAllocs++;
+	if( ++liveObjects > peakObjects )
+		peakObjects = liveObjects;
+
+	LEAVECRITICALSECTION(cs);
+
+	return ptr;
+}
+
+void asCSlabPool::Free(void *ptr)
+{
+	if( ptr == 0 )
+		return;
+
+	asCSlabPool *pool = (reinterpret_cast<asUPoolBlockHeader*>(ptr) - 1)->pool;
+
+	ENTERCRITICALSECTION(pool->cs);
+
+	*reinterpret_cast<void**>(ptr) = pool->freeList;
+	pool->freeList = ptr;
+
+	asASSERT( pool->liveObjects > 0 );
+	bool destroy = --pool->liveObjects == 0 && pool->isOrphaned;
+
+	LEAVECRITICALSECTION(pool->cs);
+
+	if( destroy )
+		asDELETE(pool, asCSlabPool);
+}
+
+void asCSlabPool::Orphan()
+{
+	ENTERCRITICALSECTION(cs);
+
+	// Objects may outlive the engine, e.g. functions still referenced by the
+	// application, so the slabs must be kept until the last one is freed
+	isOrphaned = true;
+	bool destroy = liveObjects == 0;
+
+	LEAVECRITICALSECTION(cs);
+
+	if( destroy )
+		asDELETE(this, asCSlabPool);
+}
+
+void asCSlabPool::GetStatistics(asUINT *out_liveObjects, asUINT *out_peakObjects, asQWORD *out_totalAllocs, asUINT *out_slabCount) const
+{
+	ENTERCRITICALSECTION(cs);
+
+	if( out_liveObjects ) *out_liveObjects = liveObjects;
+	if( out_peakObjects ) *out_peakObjects = peakObjects;
+	if( out_totalAllocs ) *out_totalAllocs = totalAllocs;
+	if( out_slabCount )   *out_slabCount   = slabs.GetLength();
+
+	LEAVECRITICALSECTION(cs);
+}
+
 asCMemoryMgr::asCMemoryMgr()
 {
+	pools[asPOOL_SCRIPT_FUNCTION] = asNEW(asCSlabPool)("asCScriptFunction", sizeof(asCScriptFunction));
+	pools[asPOOL_OBJECT_TYPE]     = asNEW(asCSlabPool)("asCObjectType", sizeof(asCObjectType));
+	pools[asPOOL_OBJECT_PROPERTY] = asNEW(asCSlabPool)("asCObjectProperty", sizeof(asCObjectProperty));
+	pools[asPOOL_GLOBAL_PROPERTY] = asNEW(asCSlabPool)("asCGlobalProperty", sizeof(asCGlobalProperty));
 }
 
 asCMemoryMgr::~asCMemoryMgr()
 {
 	FreeUnusedMemory();
+
+	for( asUINT n = 0; n < asPOOL_COUNT; n++ )
+		if( pools[n] )
+			pools[n]->Orphan();
+}
+
+void *asCMemoryMgr::AllocPooled(asEMemoryPool pool)
+{
+	asASSERT( pool < asPOOL_COUNT );
+	return pools[pool] ? pools[pool]->Alloc() : 0;
+}
+
+void asCMemoryMgr::FreePooled(void *ptr)
+{
+	asCSlabPool::Free(ptr);
+}
+
+int asCMemoryMgr::EnumeratePools(asMEMORYPOOLCALLBACK_t callback, void *param) const
+{
+	if( callback == 0 )
+		return asINVALID_ARG;
+
+	for( asUINT n = 0; n < asPOOL_COUNT; n++ )
+	{
+		if( pools[n] == 0 )
+			continue;
+
+		asUINT live, peak, slabCount;
+		asQWORD allocs;
+		pools[n]->GetStatistics(&live, &peak, &allocs, &slabCount);
+		callback(pools[n]->name, asUINT(pools[n]->objectSize), live, peak, allocs, slabCount, param);
+	}
+
+	return asSUCCESS;
 }
 
 void asCMemoryMgr::FreeUnusedMemory()
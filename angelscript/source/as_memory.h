@@ -100,6 +100,12 @@ bool isAligned(const void* const pointer, asUINT alignment);
 
 #endif
 
+// The engine's metadata objects are allocated from typed slab pools in asCMemoryMgr.
+// The pool is found through a header in front of the object, so they can be freed
+// without knowing the engine, e.g. after the engine has already been destroyed
+#define asNEWPOOLED(mgr,pool,x) new((mgr).AllocPooled(pool)) x
+#define asDELETEPOOLED(ptr,x)   {void *tmp = ptr; (ptr)->~x(); asCMemoryMgr::FreePooled(tmp);}
+
 END_AS_NAMESPACE
 
 #include <new>
@@ -108,6 +114,47 @@ END_AS_NAMESPACE
 
 BEGIN_AS_NAMESPACE
 
+enum asEMemoryPool
+{
+	asPOOL_SCRIPT_FUNCTION,
+	asPOOL_OBJECT_TYPE,
+	asPOOL_OBJECT_PROPERTY,
+	asPOOL_GLOBAL_PROPERTY,
+	asPOOL_COUNT
+};
+
+// Fixed size blocks carved from larger slabs, with the free blocks kept in a list
+class asCSlabPool
+{
+public:
+	asCSlabPool(const char *name, size_t objectSize);
+
+	void *Alloc();
+	static void Free(void *ptr);
+
+	// The owner no longer uses the pool. It is destroyed with the last of its objects
+	void Orphan();
+
+	void GetStatistics(asUINT *liveObjects, asUINT *peakObjects, asQWORD *totalAllocs, asUINT *slabCount) const;
+
+	const char *name;
+	size_t      objectSize;
+
+protected:
+	~asCSlabPool();
+	bool AddSlab();
+
+	DECLARECRITICALSECTION(mutable cs)
+	asCArray<void *> slabs;
+	void            *freeList;
+	size_t           blockSize;
+	asUINT           blocksPerSlab;
+	asUINT           liveObjects;
+	asUINT           peakObjects;
+	asQWORD          totalAllocs;
+	bool             isOrphaned;
+};
+
 class asCMemoryMgr
 {
 public:
@@ -124,7 +171,13 @@ public:
 	void FreeByteInstruction(void *ptr);
 #endif
 
+	void *AllocPooled(asEMemoryPool pool);
+	static void FreePooled(void *ptr);
+	int   EnumeratePools(asMEMORYPOOLCALLBACK_t callback, void *param) const;
+
 protected:
+	asCSlabPool *pools[asPOOL_COUNT];
+
 	DECLARECRITICALSECTION(cs)
 	asCArray<void *> scriptNodePool;
 	asCArray<void *> byteInstructionPool;
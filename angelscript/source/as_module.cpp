@@ -56,6 +56,7 @@ asCModule::asCModule(const char *name, asCScriptEngine *engine)
 	userData = 0;
 	builder = 0;
 	isGlobalVarInitialized = false;
+	pendingReader = 0;
 
 	accessMask = 1;
 
@@ -600,6 +601,14 @@ void asCModule::InternalReset()
 	}
 	bindInformations.SetLength(0);
 
+	// No script code runs from here on, so the functions that haven't been translated yet never will be
+	if( pendingReader )
+	{
+		pendingReader->DiscardPending();
+		asDELETE(pendingReader, asCReader);
+		pendingReader = 0;
+	}
+
 	// Free declared types, including classes, typedefs, and enums
 	for( n = 0; n < templateInstances.GetLength(); n++ )
 	{
@@ -1175,7 +1184,7 @@ int asCModule::AddScriptFunction(int sectionIdx, int declaredAt, int id, const a
 	asASSERT(id >= 0);
 
 	// Store the function information
-	asCScriptFunction *func = asNEW(asCScriptFunction)(engine, this, isInterface ? asFUNC_INTERFACE : asFUNC_SCRIPT);
+	asCScriptFunction *func = asNEWPOOLED(engine->memoryMgr, asPOOL_SCRIPT_FUNCTION, asCScriptFunction)(engine, this, isInterface ? asFUNC_INTERFACE : asFUNC_SCRIPT);
 	if( func == 0 )
 	{
 		// Free the default args
@@ -1280,7 +1289,7 @@ int asCModule::AddImportedFunction(int id, const asCString &name, const asCDataT
 	asASSERT(id >= 0);
 
 	// Store the function information
-	asCScriptFunction *func = asNEW(asCScriptFunction)(engine, this, asFUNC_IMPORTED);
+	asCScriptFunction *func = asNEWPOOLED(engine->memoryMgr, asPOOL_SCRIPT_FUNCTION, asCScriptFunction)(engine, this, asFUNC_IMPORTED);
 	if( func == 0 )
 	{
 		// Free the default args
@@ -1303,7 +1312,7 @@ int asCModule::AddImportedFunction(int id, const asCString &name, const asCDataT
 	sBindInfo *info = asNEW(sBindInfo);
 	if( info == 0 )
 	{
-		asDELETE(func, asCScriptFunction);
+		asDELETEPOOLED(func, asCScriptFunction);
 		return asOUT_OF_MEMORY;
 	}
 
@@ -1528,6 +1537,14 @@ int asCModule::SaveByteCode(asIBinaryStream *out, bool stripDebugInfo) const
 	if( IsEmpty() )
 		return asERROR;
 
+	// The writer needs the translated bytecode
+	for( asUINT n = 0; pendingReader && n < scriptFunctions.GetLength(); n++ )
+	{
+		int r = scriptFunctions[n]->TranslatePendingByteCode();
+		if( r < 0 )
+			return r;
+	}
+
 	asCWriter write(const_cast<asCModule*>(this), out, engine, stripDebugInfo);
 	return write.Write();
 #endif
@@ -1552,8 +1569,16 @@ int asCModule::LoadByteCode(asIBinaryStream *in, bool *wasDebugInfoStripped)
 	if( r < 0 )
 		return r;
 
-	asCReader read(this, in, engine);
-	r = read.Read(wasDebugInfoStripped);
+	// The module takes over the reader if it leaves functions to be translated later
+	asCReader *read = asNEW(asCReader)(this, in, engine);
+	if( read == 0 )
+	{
+		engine->BuildCompleted();
+		return asOUT_OF_MEMORY;
+	}
+	r = read->Read(wasDebugInfoStripped);
+	if( pendingReader != read )
+		asDELETE(read, asCReader);
 
 	JITCompile();
 
@@ -1716,7 +1741,7 @@ int asCModule::RemoveFunction(asIScriptFunction *func)
 // internal
 int asCModule::AddFuncDef(const asCString &name, asSNameSpace *ns)
 {
-	asCScriptFunction *func = asNEW(asCScriptFunction)(engine, 0, asFUNC_FUNCDEF);
+	asCScriptFunction *func = asNEWPOOLED(engine->memoryMgr, asPOOL_SCRIPT_FUNCTION, asCScriptFunction)(engine, 0, asFUNC_FUNCDEF);
 	if( func == 0 )
 		return asOUT_OF_MEMORY;
 
@@ -58,6 +58,7 @@ class asCCompiler;
 class asCBuilder;
 class asCContext;
 class asCConfigGroup;
+class asCReader;
 struct asSNameSpace;
 
 struct sBindInfo
@@ -228,6 +229,9 @@ public:
 	asCArray<asCObjectType*>       typeDefs; // increases ref count
 	// This array holds the funcdefs declared in the module
 	asCArray<asCScriptFunction*>   funcDefs; // increases ref count
+
+	// The reader that loaded the module, while some of the functions are still to be translated
+	asCReader                     *pendingReader;
 };
 
 END_AS_NAMESPACE
@@ -52,6 +52,7 @@ struct asSNameSpaceNamePair
 
 	asSNameSpaceNamePair() : ns(0) {}
 	asSNameSpaceNamePair(const asSNameSpace *_ns, const asCString &_name) : ns(_ns), name(_name) {}
+	asSNameSpaceNamePair(const asSNameSpaceNamePair &other) : ns(other.ns), name(other.name) {}
 
 	asSNameSpaceNamePair &operator=(const asSNameSpaceNamePair &other)
 	{
@@ -107,7 +107,7 @@ int asCObjectType::Release() const
 		{
 			// If the engine is no longer set, then it has already been 
 			// released and we must take care of the deletion ourselves
-			asDELETE(const_cast<asCObjectType*>(this), asCObjectType);
+			asDELETEPOOLED(const_cast<asCObjectType*>(this), asCObjectType);
 		}
 	}
 
@@ -131,7 +131,7 @@ int asCObjectType::ReleaseInternal()
 		{
 			// If the engine is no longer set, then it has already been 
 			// released and we must take care of the deletion ourselves
-			asDELETE(const_cast<asCObjectType*>(this), asCObjectType);
+			asDELETEPOOLED(const_cast<asCObjectType*>(this), asCObjectType);
 		}
 	}
 
@@ -685,7 +685,7 @@ asCObjectProperty *asCObjectType::AddPropertyToClass(const asCString &name, cons
 	asASSERT( !IsInterface() );
 
 	// Store the properties in the object type descriptor
-	asCObjectProperty *prop = asNEW(asCObjectProperty);
+	asCObjectProperty *prop = asNEWPOOLED(engine->memoryMgr, asPOOL_OBJECT_PROPERTY, asCObjectProperty);
 	if( prop == 0 )
 	{
 		// Out of memory
@@ -775,7 +775,7 @@ void asCObjectType::ReleaseAllProperties()
 					type->ReleaseInternal();
 			}
 
-			asDELETE(properties[n],asCObjectProperty);
+			asDELETEPOOLED(properties[n],asCObjectProperty);
 		}
 	}
 
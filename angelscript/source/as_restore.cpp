@@ -49,11 +49,51 @@ asCReader::asCReader(asCModule* _module, asIBinaryStream* _stream, asCScriptEngi
 {
 	error = false;
 	bytesRead = 0;
+	buffer = 0;
+	bufferSize = 0;
+	bufferPos = 0;
+	pendingCount = 0;
+}
+
+asCReader::~asCReader()
+{
+	asUINT n;
+	for( n = 0; n < pinnedTypes.GetLength(); n++ )
+		pinnedTypes[n]->ReleaseInternal();
+	for( n = 0; n < pinnedFunctions.GetLength(); n++ )
+		pinnedFunctions[n]->ReleaseInternal();
+	for( n = 0; n < pinnedProperties.GetLength(); n++ )
+		pinnedProperties[n]->Release();
+	for( n = 0; n < pinnedGroups.GetLength(); n++ )
+		pinnedGroups[n]->Release();
 }
 
 void asCReader::ReadData(void *data, asUINT size)
 {
 	asASSERT(size == 1 || size == 2 || size == 4 || size == 8);
+	if( buffer )
+	{
+		if( bufferSize - bufferPos < size )
+		{
+			// The stream ends too early
+			memset(data, 0, size);
+			bufferPos = bufferSize;
+			Error(TXT_INVALID_BYTECODE_d);
+			return;
+		}
+
+		const asBYTE *src = buffer + bufferPos;
+#if defined(AS_BIG_ENDIAN)
+		memcpy(data, src, size);
+#else
+		for( asUINT n = 0; n < size; n++ )
+			((asBYTE*)data)[n] = src[size-1-n];
+#endif
+		bufferPos += size;
+		bytesRead += size;
+		return;
+	}
+
 #if defined(AS_BIG_ENDIAN)
 	for( asUINT n = 0; n < size; n++ )
 		stream->Read(((asBYTE*)data)+n, 1);
@@ -64,6 +104,20 @@ void asCReader::ReadData(void *data, asUINT size)
 	bytesRead += size;
 }
 
+asBYTE asCReader::ReadByte()
+{
+	// Most of the data is read a byte at a time, so this is kept short for the buffer
+	if( bufferPos < bufferSize )
+	{
+		bytesRead++;
+		return buffer[bufferPos++];
+	}
+
+	asBYTE b;
+	ReadData(&b, 1);
+	return b;
+}
+
 int asCReader::Read(bool *wasDebugInfoStripped)
 {
 	TimeIt("asCReader::Read");
@@ -72,8 +126,17 @@ int asCReader::Read(bool *wasDebugInfoStripped)
 	// any existing resources have been freed
 	module->InternalReset();
 
+	// Decode in place if the stream can give us its data in one piece
+	buffer = reinterpret_cast<const asBYTE*>(stream->GetReadBuffer(&bufferSize));
+	if( buffer == 0 )
+		bufferSize = 0;
+	bufferPos = 0;
+
 	// Call the inner method to do the actual loading
 	int r = ReadInner();
+
+	if( buffer )
+		stream->Skip(bufferPos);
 	if( r < 0 )
 	{
 		// Something went wrong while loading the bytecode, so we need
@@ -85,7 +148,11 @@ int asCReader::Read(bool *wasDebugInfoStripped)
 		for( i = 0; i < module->scriptFunctions.GetLength(); i++ )
 			if( !dontTranslate.MoveTo(0, module->scriptFunctions[i]) )
 				if( module->scriptFunctions[i]->scriptData )
+				{
 					module->scriptFunctions[i]->scriptData->byteCode.SetLength(0);
+					module->scriptFunctions[i]->scriptData->translationPending.set(false);
+				}
+		pendingCount = 0;
 
 		asCSymbolTable<asCGlobalProperty>::iterator it = module->scriptGlobals.List();
 		for( ; it; it++ )
@@ -97,6 +164,10 @@ int asCReader::Read(bool *wasDebugInfoStripped)
 	}
 	else
 	{
+		// The module must be able to translate the functions as soon as the global variables are initialized
+		if( pendingCount )
+			module->pendingReader = this;
+
 		// Init system functions properly
 		engine->PrepareEngine();
 
@@ -111,6 +182,137 @@ int asCReader::Read(bool *wasDebugInfoStripped)
 	return r;
 }
 
+bool asCReader::HasPendingFunctions() const
+{
+	return pendingCount > 0;
+}
+
+int asCReader::TranslatePending(asCScriptFunction *func)
+{
+	TimeIt("asCReader::TranslatePending");
+
+	int r = asSUCCESS;
+
+	// Contexts in different threads may call the same function for the first time
+	ENTERCRITICALSECTION(pendingLock);
+
+	if( func->scriptData->translationPending.get() )
+	{
+		// A function that failed before is left without bytecode
+		if( func->scriptData->byteCode.GetLength() == 0 )
+			r = asERROR;
+		else
+		{
+			error = false;
+			TranslateFunction(func);
+			if( error )
+			{
+				// Don't let ReleaseReferences look at the partially translated bytecode
+				func->scriptData->byteCode.SetLength(0);
+				r = asERROR;
+			}
+			else
+			{
+				func->AddReferences();
+				func->scriptData->translationPending.set(false);
+				pendingCount--;
+			}
+		}
+	}
+
+	LEAVECRITICALSECTION(pendingLock);
+
+	return r;
+}
+
+void asCReader::DiscardPending()
+{
+	// The remaining functions are left without bytecode. They can no longer be
+	// executed, and ReleaseReferences won't look for references in them.
+	for( asUINT n = 0; n < module->scriptFunctions.GetLength(); n++ )
+	{
+		asCScriptFunction *func = module->scriptFunctions[n];
+		if( func->scriptData && func->scriptData->translationPending.get() )
+			func->scriptData->byteCode.SetLength(0);
+	}
+	pendingCount = 0;
+}
+
+void asCReader::PinObjectType(asCObjectType *ot)
+{
+	if( ot == 0 ) return;
+
+	ot->AddRefInternal();
+	pinnedTypes.PushLast(ot);
+
+	asCConfigGroup *group = engine->FindConfigGroupForObjectType(ot);
+	if( group != 0 )
+	{
+		group->AddRef();
+		pinnedGroups.PushLast(group);
+	}
+}
+
+void asCReader::PinReferences()
+{
+	// The untranslated bytecode refers to these by their index in the tables,
+	// so they must stay alive until it has been translated. This holds the same
+	// references that AddReferences takes for the translated functions.
+	asUINT n;
+	for( n = 0; n < usedTypes.GetLength(); n++ )
+		PinObjectType(usedTypes[n]);
+
+	for( n = 0; n < usedObjectProperties.GetLength(); n++ )
+		PinObjectType(usedObjectProperties[n].objType);
+
+	for( n = 0; n < usedFunctions.GetLength(); n++ )
+	{
+		asCScriptFunction *func = usedFunctions[n];
+		if( func == 0 ) continue;
+
+		func->AddRefInternal();
+		pinnedFunctions.PushLast(func);
+
+		asCConfigGroup *group = engine->FindConfigGroupForFunction(func->id);
+		if( group != 0 )
+		{
+			group->AddRef();
+			pinnedGroups.PushLast(group);
+		}
+	}
+
+	for( n = 0; n < usedGlobalProperties.GetLength(); n++ )
+	{
+		asSMapNode<void*, asCGlobalProperty*> *node;
+		if( !engine->varAddressMap.MoveTo(&node, usedGlobalProperties[n]) )
+			continue;
+
+		node->value->AddRef();
+		pinnedProperties.PushLast(node->value);
+
+		asCConfigGroup *group = engine->FindConfigGroupForGlobalVar(node->value->id);
+		if( group != 0 )
+		{
+			group->AddRef();
+			pinnedGroups.PushLast(group);
+		}
+	}
+
+	// The types in the signature and of the variables are already resolved
+	for( n = 0; n < module->scriptFunctions.GetLength(); n++ )
+	{
+		asCScriptFunction *func = module->scriptFunctions[n];
+		if( func->scriptData == 0 || !func->scriptData->translationPending.get() )
+			continue;
+
+		PinObjectType(func->returnType.GetObjectType());
+		for( asUINT p = 0; p < func->parameterTypes.GetLength(); p++ )
+			PinObjectType(func->parameterTypes[p].GetObjectType());
+		for( asUINT v = 0; v < func->scriptData->objVariableTypes.GetLength(); v++ )
+			PinObjectType(func->scriptData->objVariableTypes[v]);
+	}
+}
+
 int asCReader::Error(const char *msg)
 {
 	// Don't write if it has already been reported an error earlier
@@ -145,7 +347,7 @@ int asCReader::ReadInner()
 	module->enumTypes.Allocate(count, false);
 	for( i = 0; i < count && !error; i++ )
 	{
-		asCObjectType *ot = asNEW(asCObjectType)(engine);
+		asCObjectType *ot = asNEWPOOLED(engine->memoryMgr, asPOOL_OBJECT_TYPE, asCObjectType)(engine);
 		if( ot == 0 )
 		{
 			error = true;
@@ -167,7 +369,7 @@ int asCReader::ReadInner()
 					t->nameSpace == ot->nameSpace &&
 					(t->flags & asOBJ_ENUM) )
 				{
-					asDELETE(ot, asCObjectType);
+					asDELETEPOOLED(ot, asCObjectType);
 					ot = t;
 					sharedExists = true;
 					break;
@@ -203,7 +405,7 @@ int asCReader::ReadInner()
 	module->classTypes.Allocate(count, false);
 	for( i = 0; i < count && !error; ++i )
 	{
-		asCObjectType *ot = asNEW(asCObjectType)(engine);
+		asCObjectType *ot = asNEWPOOLED(engine->memoryMgr, asPOOL_OBJECT_TYPE, asCObjectType)(engine);
 		if( ot == 0 )
 		{
 			error = true;
@@ -225,7 +427,7 @@ int asCReader::ReadInner()
 					t->nameSpace == ot->nameSpace &&
 					t->IsInterface() == ot->IsInterface() )
 				{
-					asDELETE(ot, asCObjectType);
+					asDELETEPOOLED(ot, asCObjectType);
 					ot = t;
 					sharedExists = true;
 					break;
@@ -330,7 +532,7 @@ int asCReader::ReadInner()
 	module->typeDefs.Allocate(count, false);
 	for( i = 0; i < count && !error; i++ )
 	{
-		asCObjectType *ot = asNEW(asCObjectType)(engine);
+		asCObjectType *ot = asNEWPOOLED(engine->memoryMgr, asPOOL_OBJECT_TYPE, asCObjectType)(engine);
 		if( ot == 0 )
 		{
 			error = true;
@@ -529,8 +731,20 @@ int asCReader::ReadInner()
 	// Update the loaded bytecode to point to the correct types, property offsets,
 	// function ids, etc. This is basically a linking stage.
 	for( i = 0; i < module->scriptFunctions.GetLength() && !error; i++ )
-		if( module->scriptFunctions[i]->funcType == asFUNC_SCRIPT )
-			TranslateFunction(module->scriptFunctions[i]);
+	{
+		func = module->scriptFunctions[i];
+		if( func->funcType != asFUNC_SCRIPT )
+			continue;
+
+		// Shared functions can outlive the module, and with it the reader, so they are always translated here
+		if( engine->ep.lazyBytecodeTranslation && !func->IsShared() && !dontTranslate.MoveTo(0, func) )
+		{
+			func->scriptData->translationPending.set(true);
+			pendingCount++;
+		}
+		else
+			TranslateFunction(func);
+	}
 
 	asCSymbolTable<asCGlobalProperty>::iterator globIt = module->scriptGlobals.List();
 	while( globIt && !error )
@@ -543,10 +757,19 @@ int asCReader::ReadInner()
 
 	if( error ) return asERROR;
 
-	// Add references for all functions (except for the pre-existing shared code)
+	// Add references for all functions (except for the pre-existing shared code). The
+	// functions that are still pending add theirs when they are translated.
 	for( i = 0; i < module->scriptFunctions.GetLength(); i++ )
-		if( !dontTranslate.MoveTo(0, module->scriptFunctions[i]) )
-			module->scriptFunctions[i]->AddReferences();
+	{
+		func = module->scriptFunctions[i];
+		if( func->scriptData && func->scriptData->translationPending.get() )
+			continue;
+		if( !dontTranslate.MoveTo(0, func) )
+			func->AddReferences();
+	}
+
+	if( pendingCount )
+		PinReferences();
 
 	globIt = module->scriptGlobals.List();
 	while( globIt )
@@ -575,6 +798,50 @@ void asCReader::ReadUsedStringConstants()
 	}
 }
 
+// Hash of the name, the parameter types and optionally the scope of a function. Only
+// what the searches in ReadUsedFunctions compare is hashed, so a match is always found
+// among the functions with the same hash.
+static asUINT HashFunctionSignature(const asCScriptFunction *func, const void *nameSpace, const void *objType)
+{
+	asUINT hash = asHashValue(func->name);
+	hash = hash * 31 + asHashValue(nameSpace);
+	hash = hash * 31 + asHashValue(objType);
+	for( asUINT n = 0; n < func->parameterTypes.GetLength(); n++ )
+	{
+		const asCDataType &dt = func->parameterTypes[n];
+		asQWORD flags = asQWORD(dt.GetTokenType()) | (asQWORD(dt.IsObjectHandle()) << 32) | (asQWORD(dt.IsReference()) << 33);
+		hash = hash * 31 + asHashValue(flags);
+		hash = hash * 31 + asHashValue(dt.GetObjectType());
+	}
+	return hash;
+}
+
+void asCReader::IndexFunctions(asCFunctionIndex &index, const asCArray<asCScriptFunction*> &funcs, bool withScope)
+{
+	// Inserted in list order, so the first match is the same as with a linear search
+	for( asUINT n = 0; n < funcs.GetLength(); n++ )
+	{
+		asCScriptFunction *f = funcs[n];
+		if( f == 0 ) continue;
+		index.Insert(withScope ? HashFunctionSignature(f, f->nameSpace, f->objectType) : HashFunctionSignature(f, 0, 0), f);
+	}
+}
+
+void asCReader::IndexMethods(asCObjectType *ot)
+{
+	if( indexedMethods.GetFirst(ot) >= 0 )
+		return;
+	indexedMethods.Insert(ot, true);
+
+	for( asUINT n = 0; n < ot->methods.GetLength(); n++ )
+	{
+		asCScriptFunction *f = engine->scriptFunctions[ot->methods[n]];
+		if( f == 0 ) continue;
+		asSIndexedMethod entry = {ot, f};
+		methodIndex.Insert(HashFunctionSignature(f, 0, ot), entry);
+	}
+}
+
 void asCReader::ReadUsedFunctions()
 {
 	TimeIt("asCReader::ReadUsedFunctions");
@@ -619,9 +886,18 @@ void asCReader::ReadUsedFunctions()
 			{
 				if( func.funcType == asFUNC_IMPORTED )
 				{
-					for( asUINT i = 0; i < module->bindInformations.GetLength(); i++ )
+					if( importedFunctionIndex.GetCount() == 0 )
+					{
+						asCArray<asCScriptFunction*> imports(module->bindInformations.GetLength());
+						for( asUINT i = 0; i < module->bindInformations.GetLength(); i++ )
+							imports.PushLast(module->bindInformations[i]->importedFunctionSignature);
+						IndexFunctions(importedFunctionIndex, imports, true);
+					}
+
+					asUINT hash = HashFunctionSignature(&func, func.nameSpace, func.objectType);
+					for( int i = importedFunctionIndex.GetFirst(hash); i >= 0; i = importedFunctionIndex.GetNext(i) )
 					{
-						asCScriptFunction *f = module->bindInformations[i]->importedFunctionSignature;
+						asCScriptFunction *f = importedFunctionIndex.GetValue(i);
 						if( func.objectType != f->objectType ||
 							func.funcType != f->funcType || 
 							func.nameSpace != f->nameSpace ||
@@ -634,10 +910,13 @@ void asCReader::ReadUsedFunctions()
 				}
 				else if( func.funcType == asFUNC_FUNCDEF )
 				{
-					const asCArray<asCScriptFunction *> &funcs = module->funcDefs;
-					for( asUINT i = 0; i < funcs.GetLength(); i++ )
+					if( moduleFuncDefIndex.GetCount() == 0 )
+						IndexFunctions(moduleFuncDefIndex, module->funcDefs, false);
+
+					asUINT hash = HashFunctionSignature(&func, 0, 0);
+					for( int i = moduleFuncDefIndex.GetFirst(hash); i >= 0; i = moduleFuncDefIndex.GetNext(i) )
 					{
-						asCScriptFunction *f = funcs[i];
+						asCScriptFunction *f = moduleFuncDefIndex.GetValue(i);
 						if( f == 0 || func.name != f->name || !func.IsSignatureExceptNameAndObjectTypeEqual(f) )
 							continue;
 
@@ -650,12 +929,13 @@ void asCReader::ReadUsedFunctions()
 				}
 				else
 				{
-					// TODO: optimize: Global functions should be searched for in module->globalFunctions
-					// TODO: optimize: funcdefs should be searched for in module->funcDefs
-					// TODO: optimize: object methods should be searched for directly in the object type
-					for( asUINT i = 0; i < module->scriptFunctions.GetLength(); i++ )
+					if( moduleFunctionIndex.GetCount() == 0 )
+						IndexFunctions(moduleFunctionIndex, module->scriptFunctions, true);
+
+					asUINT hash = HashFunctionSignature(&func, func.nameSpace, func.objectType);
+					for( int i = moduleFunctionIndex.GetFirst(hash); i >= 0; i = moduleFunctionIndex.GetNext(i) )
 					{
-						asCScriptFunction *f = module->scriptFunctions[i];
+						asCScriptFunction *f = moduleFunctionIndex.GetValue(i);
 						if( func.objectType != f->objectType ||
 							func.funcType != f->funcType || 
 							func.nameSpace != f->nameSpace ||
@@ -672,10 +952,13 @@ void asCReader::ReadUsedFunctions()
 				if( func.funcType == asFUNC_FUNCDEF )
 				{
 					// This is a funcdef (registered or shared)
-					const asCArray<asCScriptFunction *> &funcs = engine->funcDefs;
-					for( asUINT i = 0; i < funcs.GetLength(); i++ )
+					if( engineFuncDefIndex.GetCount() == 0 )
+						IndexFunctions(engineFuncDefIndex, engine->funcDefs, false);
+
+					asUINT hash = HashFunctionSignature(&func, 0, 0);
+					for( int i = engineFuncDefIndex.GetFirst(hash); i >= 0; i = engineFuncDefIndex.GetNext(i) )
 					{
-						asCScriptFunction *f = funcs[i];
+						asCScriptFunction *f = engineFuncDefIndex.GetValue(i);
 						if( f == 0 || func.name != f->name || !func.IsSignatureExceptNameAndObjectTypeEqual(f) )
 							continue;
 
@@ -786,10 +1069,15 @@ void asCReader::ReadUsedFunctions()
 				{
 					// It is a class member, so we can search directly in the object type's members
 					// TODO: virtual function is different that implemented method
-					for( asUINT i = 0; i < func.objectType->methods.GetLength(); i++ )
+					IndexMethods(func.objectType);
+
+					asUINT hash = HashFunctionSignature(&func, 0, func.objectType);
+					for( int i = methodIndex.GetFirst(hash); i >= 0; i = methodIndex.GetNext(i) )
 					{
-						asCScriptFunction *f = engine->scriptFunctions[func.objectType->methods[i]];
-						if( f == 0 ||
+						// Inherited methods belong to the base type, so compare the type they were indexed for
+						const asSIndexedMethod &entry = methodIndex.GetValue(i);
+						asCScriptFunction *f = entry.func;
+						if( entry.ot != func.objectType ||
 							!func.IsSignatureEqual(f) )
 							continue;
 
@@ -976,7 +1264,7 @@ asCScriptFunction *asCReader::ReadFunction(bool &isNew, bool addToModule, bool a
 
 	// Load the new function
 	isNew = true;
-	asCScriptFunction *func = asNEW(asCScriptFunction)(engine,0,asFUNC_DUMMY);
+	asCScriptFunction *func = asNEWPOOLED(engine->memoryMgr, asPOOL_SCRIPT_FUNCTION, asCScriptFunction)(engine,0,asFUNC_DUMMY);
 	if( func == 0 )
 	{
 		// Out of memory
@@ -1629,66 +1917,65 @@ asUINT asCReader::ReadEncodedUInt()
 asQWORD asCReader::ReadEncodedUInt64()
 {
 	asQWORD i = 0;
-	asBYTE b;
-	ReadData(&b, 1);
+	asBYTE b = ReadByte();
 	bool isNegative = ( b & 0x80 ) ? true : false;
 	b &= 0x7F;
 	
 	if( (b & 0x7F) == 0x7F )
 	{
-		ReadData(&b, 1); i = asQWORD(b) << 56;
-		ReadData(&b, 1); i += asQWORD(b) << 48;
-		ReadData(&b, 1); i += asQWORD(b) << 40;
-		ReadData(&b, 1); i += asQWORD(b) << 32;
-		ReadData(&b, 1); i += asUINT(b) << 24;
-		ReadData(&b, 1); i += asUINT(b) << 16;
-		ReadData(&b, 1); i += asUINT(b) << 8;
-		ReadData(&b, 1); i += b;
+		b = ReadByte(); i = asQWORD(b) << 56;
+		b = ReadByte(); i += asQWORD(b) << 48;
+		b = ReadByte(); i += asQWORD(b) << 40;
+		b = ReadByte(); i += asQWORD(b) << 32;
+		b = ReadByte(); i += asUINT(b) << 24;
+		b = ReadByte(); i += asUINT(b) << 16;
+		b = ReadByte(); i += asUINT(b) << 8;
+		b = ReadByte(); i += b;
 	}
 	else if( (b & 0x7E) == 0x7E )
 	{
 		i = asQWORD(b & 0x01) << 48;
-		ReadData(&b, 1); i += asQWORD(b) << 40;
-		ReadData(&b, 1); i += asQWORD(b) << 32;
-		ReadData(&b, 1); i += asUINT(b) << 24;
-		ReadData(&b, 1); i += asUINT(b) << 16;
-		ReadData(&b, 1); i += asUINT(b) << 8;
-		ReadData(&b, 1); i += b;
+		b = ReadByte(); i += asQWORD(b) << 40;
+		b = ReadByte(); i += asQWORD(b) << 32;
+		b = ReadByte(); i += asUINT(b) << 24;
+		b = ReadByte(); i += asUINT(b) << 16;
+		b = ReadByte(); i += asUINT(b) << 8;
+		b = ReadByte(); i += b;
 	}	
 	else if( (b & 0x7C) == 0x7C )
 	{
 		i = asQWORD(b & 0x03) << 40;
-		ReadData(&b, 1); i += asQWORD(b) << 32;
-		ReadData(&b, 1); i += asUINT(b) << 24;
-		ReadData(&b, 1); i += asUINT(b) << 16;
-		ReadData(&b, 1); i += asUINT(b) << 8;
-		ReadData(&b, 1); i += b;
+		b = ReadByte(); i += asQWORD(b) << 32;
+		b = ReadByte(); i += asUINT(b) << 24;
+		b = ReadByte(); i += asUINT(b) << 16;
+		b = ReadByte(); i += asUINT(b) << 8;
+		b = ReadByte(); i += b;
 	}	
 	else if( (b & 0x78) == 0x78 )
 	{
 		i = asQWORD(b & 0x07) << 32;
-		ReadData(&b, 1); i += asUINT(b) << 24;
-		ReadData(&b, 1); i += asUINT(b) << 16;
-		ReadData(&b, 1); i += asUINT(b) << 8;
-		ReadData(&b, 1); i += b;
+		b = ReadByte(); i += asUINT(b) << 24;
+		b = ReadByte(); i += asUINT(b) << 16;
+		b = ReadByte(); i += asUINT(b) << 8;
+		b = ReadByte(); i += b;
 	}	
 	else if( (b & 0x70) == 0x70 )
 	{
 		i = asUINT(b & 0x0F) << 24;
-		ReadData(&b, 1); i += asUINT(b) << 16;
-		ReadData(&b, 1); i += asUINT(b) << 8;
-		ReadData(&b, 1); i += b;
+		b = ReadByte(); i += asUINT(b) << 16;
+		b = ReadByte(); i += asUINT(b) << 8;
+		b = ReadByte(); i += b;
 	}
 	else if( (b & 0x60) == 0x60 )
 	{
 		i = asUINT(b & 0x1F) << 16;
-		ReadData(&b, 1); i += asUINT(b) << 8;
-		ReadData(&b, 1); i += b;
+		b = ReadByte(); i += asUINT(b) << 8;
+		b = ReadByte(); i += b;
 	}
 	else if( (b & 0x40) == 0x40 )
 	{
 		i = asUINT(b & 0x3F) << 8;
-		ReadData(&b, 1); i += b;
+		b = ReadByte(); i += b;
 	}
 	else
 	{
@@ -1715,7 +2002,20 @@ void asCReader::ReadString(asCString* str)
 	{
 		len /= 2;
 		str->SetLength(len);
-		stream->Read(str->AddressOf(), len);
+		if( buffer )
+		{
+			if( bufferSize - bufferPos < len )
+			{
+				str->SetLength(0);
+				bufferPos = bufferSize;
+				Error(TXT_INVALID_BYTECODE_d);
+				return;
+			}
+			memcpy(str->AddressOf(), buffer + bufferPos, len);
+			bufferPos += len;
+		}
+		else
+			stream->Read(str->AddressOf(), len);
 
 		savedStrings.PushLast(*str);
 	}
@@ -2020,6 +2320,8 @@ asCObjectType* asCReader::ReadObjectType()
 
 void asCReader::ReadByteCode(asCScriptFunction *func)
 {
+	TimeIt("asCReader::ReadByteCode");
+
 	asASSERT( func->scriptData );
 
 	// Read number of instructions
@@ -2032,8 +2334,7 @@ void asCReader::ReadByteCode(asCScriptFunction *func)
 	asUINT pos = 0;
 	while( numInstructions )
 	{
-		asBYTE b;
-		ReadData(&b, 1);
+		asBYTE b = ReadByte();
 
 		// Allocate the space for the instruction
 		asUINT len = asBCTypeSize[asBCInfo[b].type];
@@ -2381,6 +2682,8 @@ asCScriptFunction *asCReader::FindFunction(int idx)
 
 void asCReader::TranslateFunction(asCScriptFunction *func)
 {
+	TimeIt("asCReader::TranslateFunction");
+
 	// Skip this if the function is part of an pre-existing shared object
 	if( dontTranslate.MoveTo(0, func) ) return;
 
@@ -4472,6 +4775,22 @@ void asCWriter::WriteByteCode(asCScriptFunction *func)
 		// Copy the instruction to a temp buffer so we can work on it before saving
 		memcpy(tmp, bc, asBCTypeSize[asBCInfo[c].type]*sizeof(asDWORD));
 
+		// Superinstructions are saved as the first instruction of the pair they
+		// replaced, so the saved bytecode doesn't depend on which pairs are fused
+		if( c >= asBC_CMPiJZ && c <= asBC_CMPiJNP )
+			c = asBC_CMPi;
+		else if( c >= asBC_CMPIiJZ && c <= asBC_CMPIiJNP )
+			c = asBC_CMPIi;
+		else if( c == asBC_RDR4ADDi )
+			c = asBC_RDR4;
+		else if( c == asBC_PSFCALLSYS )
+			c = asBC_PSF;
+		else if( c == asBC_PshVPtrCALLSYS )
+			c = asBC_PshVPtr;
+		else if( c == asBC_PshV4CALLSYS )
+			c = asBC_PshV4;
+		*(asBYTE*)tmp = asBYTE(c);
+
 		if( c == asBC_ALLOC ) // PTR_DW_ARG
 		{
 			// Translate the object type 
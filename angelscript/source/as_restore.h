@@ -42,6 +42,7 @@
 #include "as_scriptengine.h"
 #include "as_context.h"
 #include "as_map.h"
+#include "as_hashmap.h"
 
 BEGIN_AS_NAMESPACE
 
@@ -49,9 +50,17 @@ class asCReader
 {
 public:
 	asCReader(asCModule *module, asIBinaryStream *stream, asCScriptEngine *engine);
+	~asCReader();
 
 	int Read(bool *wasDebugInfoStripped);
 
+	// With asEP_LAZY_BYTECODE_TRANSLATION the script functions are translated when they
+	// are first used. The module keeps the reader until then, as it holds the tables
+	// that the loaded bytecode refers to.
+	bool HasPendingFunctions() const;
+	int  TranslatePending(asCScriptFunction *func);
+	void DiscardPending();
+
 protected:
 	asCModule       *module;
 	asIBinaryStream *stream;
@@ -60,11 +69,17 @@ protected:
 	bool             error;
 	asUINT           bytesRead;
 
+	// The stream's unread bytes, if it exposes them through GetReadBuffer
+	const asBYTE    *buffer;
+	asUINT           bufferSize;
+	asUINT           bufferPos;
+
 	int                Error(const char *msg);
 
 	int                ReadInner();
 
 	void               ReadData(void *data, asUINT size);
+	asBYTE             ReadByte();
 	void               ReadString(asCString *str);
 	asCScriptFunction *ReadFunction(bool &isNew, bool addToModule = true, bool addToEngine = true, bool addToGC = true);
 	void               ReadFunctionSignature(asCScriptFunction *func);
@@ -89,6 +104,19 @@ protected:
 	short              FindObjectPropOffset(asWORD index);
 	asCScriptFunction *FindFunction(int idx);
 
+	// Signature indexes for ReadUsedFunctions, each built the first time its list is searched
+	typedef asCHashMap<asUINT, asCScriptFunction*> asCFunctionIndex;
+	void               IndexFunctions(asCFunctionIndex &index, const asCArray<asCScriptFunction*> &funcs, bool withScope);
+	void               IndexMethods(asCObjectType *ot);
+	asCFunctionIndex   moduleFunctionIndex;
+	asCFunctionIndex   importedFunctionIndex;
+	asCFunctionIndex   moduleFuncDefIndex;
+	asCFunctionIndex   engineFuncDefIndex;
+	// Methods of all indexed types share one index, so each entry remembers the type it was indexed for
+	struct asSIndexedMethod { asCObjectType *ot; asCScriptFunction *func; };
+	asCHashMap<asUINT, asSIndexedMethod> methodIndex;
+	asCHashMap<asCObjectType*, bool> indexedMethods;
+
 	// After loading, each function needs to be translated to update pointers, function ids, etc
 	void TranslateFunction(asCScriptFunction *func);
 	void CalculateAdjustmentByPos(asCScriptFunction *func);
@@ -97,6 +125,16 @@ protected:
 	void CalculateStackNeeded(asCScriptFunction *func);
 	asCScriptFunction *GetCalledFunction(asCScriptFunction *func, asDWORD programPos);
 
+	// References held for the functions that are still to be translated
+	void PinReferences();
+	void PinObjectType(asCObjectType *ot);
+	asUINT                       pendingCount;
+	asCArray<asCObjectType*>     pinnedTypes;
+	asCArray<asCScriptFunction*> pinnedFunctions;
+	asCArray<asCGlobalProperty*> pinnedProperties;
+	asCArray<asCConfigGroup*>    pinnedGroups;
+	DECLARECRITICALSECTION(pendingLock)
+
 	// Temporary storage for persisting variable data
 	asCArray<int>                usedTypeIds;
 	asCArray<asCObjectType*>     usedTypes;
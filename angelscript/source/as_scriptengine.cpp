@@ -37,6 +37,9 @@
 
 
 #include <stdlib.h>
+#ifdef AS_PROFILE
+#include <chrono>
+#endif
 
 #include "as_config.h"
 #include "as_scriptengine.h"
@@ -60,6 +63,179 @@ BEGIN_AS_NAMESPACE
 #ifdef AS_PROFILE
 // Instantiate the profiler once
 CProfiler g_profiler;
+
+// The innermost open scope of the current thread, or its root
+static thread_local asSProfileNode *g_profilerCurrent = 0;
+
+CProfiler::CProfiler()
+{
+	enabled     = false;
+	threadRoots = 0;
+}
+
+CProfiler::~CProfiler()
+{
+	while( threadRoots )
+	{
+		asSProfileNode *next = threadRoots->nextSibling;
+		Free(threadRoots);
+		threadRoots = next;
+	}
+}
+
+double CProfiler::GetTime()
+{
+	return std::chrono::duration<double>(std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+asSProfileNode *CProfiler::CreateNode(const char *name, asSProfileNode *parent)
+{
+	// Allocated outside of the engine's memory functions, so that the 
+	// profile stays valid regardless of what the application sets up
+	asSProfileNode *node = new asSProfileNode;
+	node->name        = name;
+	node->parent      = parent;
+	node->firstChild  = 0;
+	node->nextSibling = 0;
+	node->beginTime   = 0;
+	Clear(node);
+	return node;
+}
+
+asSProfileNode *CProfiler::FindChild(asSProfileNode *parent, const char *name)
+{
+	asSProfileNode **link = &parent->firstChild;
+	while( *link )
+	{
+		// Scope names are usually literals, so comparing the pointers is enough most of the time
+		if( (*link)->name == name || strcmp((*link)->name, name) == 0 )
+			return *link;
+		link = &(*link)->nextSibling;
+	}
+
+	// Appended, so the children are kept in the order they were first seen
+	*link = CreateNode(name, parent);
+	return *link;
+}
+
+asSProfileNode *CProfiler::GetThreadRoot()
+{
+	asSProfileNode *root = CreateNode("", 0);
+
+	ENTERCRITICALSECTION(lock);
+	root->nextSibling = threadRoots;
+	threadRoots = root;
+	LEAVECRITICALSECTION(lock);
+
+	return root;
+}
+
+void CProfiler::Begin(const char *name)
+{
+	if( g_profilerCurrent == 0 )
+		g_profilerCurrent = GetThreadRoot();
+
+	asSProfileNode *node = FindChild(g_profilerCurrent, name);
+	node->beginTime = GetTime();
+	g_profilerCurrent = node;
+}
+
+void CProfiler::End()
+{
+	asSProfileNode *node = g_profilerCurrent;
+	if( node == 0 || node->parent == 0 )
+		return;
+
+	double elapsed = GetTime() - node->beginTime;
+	if( node->count == 0 || elapsed < node->min )
+		node->min = elapsed;
+	if( elapsed > node->max )
+		node->max = elapsed;
+	node->time += elapsed;
+	node->count++;
+
+	g_profilerCurrent = node->parent;
+}
+
+void CProfiler::Merge(asSProfileNode *to, const asSProfileNode *from)
+{
+	for( const asSProfileNode *child = from->firstChild; child; child = child->nextSibling )
+	{
+		asSProfileNode *merged = FindChild(to, child->name);
+		if( child->count )
+		{
+			if( merged->count == 0 || child->min < merged->min )
+				merged->min = child->min;
+			if( child->max > merged->max )
+				merged->max = child->max;
+			merged->time  += child->time;
+			merged->count += child->count;
+		}
+		Merge(merged, child);
+	}
+}
+
+void CProfiler::Report(const asSProfileNode *node, asCString &path, int depth, asPROFILERCALLBACK_t callback, void *param)
+{
+	for( const asSProfileNode *child = node->firstChild; child; child = child->nextSibling )
+	{
+		asUINT length = path.GetLength();
+		if( length )
+			path += "|";
+		path += child->name;
+
+		callback(path.AddressOf(), child->name, depth, child->count, child->time, child->min, child->max, param);
+		Report(child, path, depth + 1, callback, param);
+
+		path.SetLength(length);
+	}
+}
+
+void CProfiler::Enumerate(asPROFILERCALLBACK_t callback, void *param)
+{
+	asSProfileNode *merged = CreateNode("", 0);
+
+	ENTERCRITICALSECTION(lock);
+	for( asSProfileNode *root = threadRoots; root; root = root->nextSibling )
+		Merge(merged, root);
+	LEAVECRITICALSECTION(lock);
+
+	asCString path;
+	Report(merged, path, 0, callback, param);
+	Free(merged);
+}
+
+void CProfiler::Clear(asSProfileNode *node)
+{
+	node->count = 0;
+	node->time  = 0;
+	node->max   = 0;
+	node->min   = 0;
+
+	for( asSProfileNode *child = node->firstChild; child; child = child->nextSibling )
+		Clear(child);
+}
+
+void CProfiler::Reset()
+{
+	// The nodes are kept, the threads may still point into their trees
+	ENTERCRITICALSECTION(lock);
+	for( asSProfileNode *root = threadRoots; root; root = root->nextSibling )
+		Clear(root);
+	LEAVECRITICALSECTION(lock);
+}
+
+void CProfiler::Free(asSProfileNode *node)
+{
+	asSProfileNode *child = node->firstChild;
+	while( child )
+	{
+		asSProfileNode *next = child->nextSibling;
+		Free(child);
+		child = next;
+	}
+	delete node;
+}
 #endif
 
 
@@ -115,6 +291,18 @@ AS_API const char * asGetLibraryOptions()
 #ifdef AS_NO_EXCEPTIONS
 		"AS_NO_EXCEPTIONS "
 #endif
+#ifdef AS_PROFILE
+		"AS_PROFILE "
+#endif
+#ifdef AS_OPCODE_STATS
+		"AS_OPCODE_STATS "
+#endif
+#ifdef AS_OPCODE_CYCLES
+		"AS_OPCODE_CYCLES "
+#endif
+#ifdef AS_COMPUTED_GOTO
+		"AS_COMPUTED_GOTO "
+#endif
 #ifdef WIP_16BYTE_ALIGN
 		"WIP_16BYTE_ALIGN "
 #endif
@@ -266,6 +454,67 @@ AS_API asIScriptEngine *asCreateScriptEngine(asDWORD version)
 	return asNEW(asCScriptEngine)();
 }
 
+AS_API int asSetProfilerEnabled(bool enabled)
+{
+#ifdef AS_PROFILE
+	g_profiler.SetEnabled(enabled);
+	return asSUCCESS;
+#else
+	UNUSED_VAR(enabled);
+	return asNOT_SUPPORTED;
+#endif
+}
+
+AS_API int asBeginProfilerScope(const char *name)
+{
+#ifdef AS_PROFILE
+	if( name == 0 )
+		return asINVALID_ARG;
+	if( !g_profiler.IsEnabled() )
+		return 0;
+	g_profiler.Begin(name);
+	return 1;
+#else
+	UNUSED_VAR(name);
+	return asNOT_SUPPORTED;
+#endif
+}
+
+AS_API int asEndProfilerScope()
+{
+#ifdef AS_PROFILE
+	// Also when the profiler was disabled after the scope began
+	g_profiler.End();
+	return asSUCCESS;
+#else
+	return asNOT_SUPPORTED;
+#endif
+}
+
+AS_API int asEnumerateProfilerScopes(asPROFILERCALLBACK_t callback, void *param)
+{
+#ifdef AS_PROFILE
+	if( callback == 0 )
+		return asINVALID_ARG;
+	g_profiler.Enumerate(callback, param);
+	return asSUCCESS;
+#else
+	UNUSED_VAR(callback);
+	UNUSED_VAR(param);
+	return asNOT_SUPPORTED;
+#endif
+}
+
+AS_API int asResetProfiler()
+{
+#ifdef AS_PROFILE
+	g_profiler.Reset();
+	return asSUCCESS;
+#else
+	return asNOT_SUPPORTED;
+#endif
+}
+
 } // extern "C"
 
 
@@ -401,6 +650,20 @@ int asCScriptEngine::SetEngineProperty(asEEngineProp property, asPWORD value)
 		ep.privatePropAsProtected = value ? true : false;
 		break;
 
+	case asEP_LAZY_BYTECODE_TRANSLATION:
+		ep.lazyBytecodeTranslation = value ? true : false;
+		break;
+
+	case asEP_GC_PROMOTION_AGE:
+		if( value < 1 || value > 100 )
+			return asINVALID_ARG;
+		ep.gcPromotionAge = (asUINT)value;
+		break;
+
+	case asEP_MAX_POOLED_CONTEXTS:
+		ep.maxPooledContexts = (asUINT)value;
+		break;
+
 	default:
 		return asINVALID_ARG;
 	}
@@ -485,6 +748,15 @@ asPWORD asCScriptEngine::GetEngineProperty(asEEngineProp property) const
 	case asEP_PRIVATE_PROP_AS_PROTECTED:
 		return ep.privatePropAsProtected;
 
+	case asEP_LAZY_BYTECODE_TRANSLATION:
+		return ep.lazyBytecodeTranslation;
+
+	case asEP_GC_PROMOTION_AGE:
+		return ep.gcPromotionAge;
+
+	case asEP_MAX_POOLED_CONTEXTS:
+		return ep.maxPooledContexts;
+
 	default:
 		return 0;
 	}
@@ -511,6 +783,9 @@ asIScriptFunction *asCScriptEngine::CreateDelegate(asIScriptFunction *func, void
 	return AS_NAMESPACE_QUALIFIER CreateDelegate(reinterpret_cast<asCScriptFunction*>(func), obj);
 }
 
+// Engine serial numbers are never reused, unlike the addresses of released engines
+static asCAtomic engineSerials;
+
 asCScriptEngine::asCScriptEngine()
 {
 	asCThreadManager::Prepare(0);
@@ -547,6 +822,9 @@ asCScriptEngine::asCScriptEngine()
 		ep.disableIntegerDivision        = false;
 		ep.disallowEmptyListElements     = false;
 		ep.privatePropAsProtected        = false;
+		ep.lazyBytecodeTranslation       = false;     // true = translate loaded functions when first used
+		ep.gcPromotionAge                = 3;         // sweeps a new object survives before it is moved to the old objects
+		ep.maxPooledContexts             = 4;         // contexts kept per thread by ReturnContext. 0 = release them
 	}
 
 	gc.engine = this;
@@ -578,6 +856,16 @@ asCScriptEngine::asCScriptEngine()
 	returnCtxFunc    = 0;
 	ctxCallbackParam = 0;
 
+	serial = engineSerials.atomicInc();
+
+	sampleCallback      = 0;
+	sampleCallbackParam = 0;
+
+#ifdef AS_OPCODE_STATS
+	opcodePairs.SetLength(256 * 256);
+	memset(opcodePairs.AddressOf(), 0, sizeof(asQWORD) * opcodePairs.GetLength());
+#endif
+
 	// We must set the namespace in the built-in types explicitly as
 	// this wasn't done by the default constructor. If we do not do
 	// this we will get null pointer access in other parts of the code
@@ -664,6 +952,9 @@ asCScriptEngine::~asCScriptEngine()
 		ShutDownAndRelease();
 	}
 
+	// The pooled contexts don't keep the engine alive, so they may still be here
+	ReleasePooledContexts();
+
 	// Unravel the registered interface
 	if( defaultArrayObjectType )
 	{
@@ -811,6 +1102,7 @@ asCScriptEngine::~asCScriptEngine()
 	for( n = 0; n < nameSpaces.GetLength(); n++ )
 		asDELETE(nameSpaces[n], asSNameSpace);
 	nameSpaces.SetLength(0);
+	nameSpaceIndex.EraseAll();
 
 	asCThreadManager::Unprepare();
 }
@@ -829,6 +1121,131 @@ int asCScriptEngine::SetContextCallbacks(asREQUESTCONTEXTFUNC_t requestCtx, asRE
 	return 0;
 }
 
+// interface
+int asCScriptEngine::SetSampleCallback(asSAMPLECALLBACK_t callback, void *param)
+{
+	ENTERCRITICALSECTION(sampleCritical);
+	sampleCallback      = callback;
+	sampleCallbackParam = param;
+	LEAVECRITICALSECTION(sampleCritical);
+
+	return 0;
+}
+
+// interface
+void asCScriptEngine::RequestSample()
+{
+	// May be called from any thread, e.g. a timer
+	ENTERCRITICALSECTION(sampleCritical);
+	for( asUINT n = 0; n < sampledContexts.GetLength(); n++ )
+		sampledContexts[n]->RequestSample();
+	LEAVECRITICALSECTION(sampleCritical);
+}
+
+// interface
+int asCScriptEngine::EnumerateOpcodeStats(asOPCODESTATSCALLBACK_t callback, void *param) const
+{
+#ifdef AS_OPCODE_STATS
+	if( callback == 0 )
+		return asINVALID_ARG;
+
+	for( asUINT n = 0; n < scriptFunctions.GetLength(); n++ )
+	{
+		asCScriptFunction *func = scriptFunctions[n];
+		if( func == 0 || func->scriptData == 0 )
+			continue;
+
+		// Skip the functions that haven't been executed
+		const asQWORD *counts = func->scriptData->opcodeCounts;
+		asUINT op = 0;
+		while( op < 256 && counts[op] == 0 )
+			op++;
+		if( op == 256 )
+			continue;
+
+#ifdef AS_OPCODE_CYCLES
+		callback(func, counts, func->scriptData->opcodeCycles, param);
+#else
+		callback(func, counts, 0, param);
+#endif
+	}
+
+	return asSUCCESS;
+#else
+	UNUSED_VAR(callback);
+	UNUSED_VAR(param);
+	return asNOT_SUPPORTED;
+#endif
+}
+
+// interface
+int asCScriptEngine::GetOpcodePairStats(asQWORD *counts) const
+{
+#ifdef AS_OPCODE_STATS
+	if( counts == 0 )
+		return asINVALID_ARG;
+
+	memcpy(counts, opcodePairs.AddressOf(), sizeof(asQWORD) * opcodePairs.GetLength());
+	return asSUCCESS;
+#else
+	UNUSED_VAR(counts);
+	return asNOT_SUPPORTED;
+#endif
+}
+
+// interface
+int asCScriptEngine::ResetOpcodeStats()
+{
+#ifdef AS_OPCODE_STATS
+	for( asUINT n = 0; n < scriptFunctions.GetLength(); n++ )
+	{
+		asCScriptFunction *func = scriptFunctions[n];
+		if( func == 0 || func->scriptData == 0 )
+			continue;
+
+		memset(func->scriptData->opcodeCounts, 0, sizeof(func->scriptData->opcodeCounts));
+#ifdef AS_OPCODE_CYCLES
+		memset(func->scriptData->opcodeCycles, 0, sizeof(func->scriptData->opcodeCycles));
+#endif
+	}
+
+	memset(opcodePairs.AddressOf(), 0, sizeof(asQWORD) * opcodePairs.GetLength());
+	return asSUCCESS;
+#else
+	return asNOT_SUPPORTED;
+#endif
+}
+
+// internal
+void asCScriptEngine::AddSampledContext(asCContext *ctx)
+{
+	ENTERCRITICALSECTION(sampleCritical);
+	if( ctx->m_sampleIndex < 0 )
+	{
+		ctx->m_sampleIndex = int(sampledContexts.GetLength());
+		sampledContexts.PushLast(ctx);
+	}
+	LEAVECRITICALSECTION(sampleCritical);
+}
+
+// internal
+void asCScriptEngine::RemoveSampledContext(asCContext *ctx)
+{
+	ENTERCRITICALSECTION(sampleCritical);
+	int idx = ctx->m_sampleIndex;
+	asASSERT( idx >= 0 && sampledContexts[idx] == ctx );
+
+	// Move the last context into the hole
+	asCContext *last = sampledContexts.PopLast();
+	if( last != ctx )
+	{
+		sampledContexts[idx] = last;
+		last->m_sampleIndex = idx;
+	}
+	ctx->m_sampleIndex = -1;
+	LEAVECRITICALSECTION(sampleCritical);
+}
+
 // interface
 asIScriptContext *asCScriptEngine::RequestContext()
 {
@@ -841,10 +1258,97 @@ asIScriptContext *asCScriptEngine::RequestContext()
 		return ctx;
 	}
 
+	// Reuse a context this thread returned earlier
+	if( ep.maxPooledContexts && !shuttingDown )
+	{
+		asSContextPool *pool = GetContextPool();
+		if( pool && pool->contexts.GetLength() )
+		{
+			asCContext *ctx = pool->contexts.PopLast();
+			pooledContexts.atomicDec();
+			ctx->TakeFromPool();
+			return ctx;
+		}
+	}
+
 	// As fallback we create a new context
 	return CreateContext();
 }
 
+// internal
+asSContextPool *asCScriptEngine::GetContextPool()
+{
+	asCThreadLocalData *tld = asCThreadManager::GetLocalData();
+	if( tld == 0 )
+		return 0;
+
+	for( asUINT n = tld->contextPools.GetLength(); n-- > 0; )
+	{
+		if( tld->contextPools[n].engineSerial == serial )
+			return tld->contextPools[n].pool;
+	}
+
+	// The thread hasn't used this engine recently. One reference is for the engine and one for the thread
+	asSContextPool *pool = asNEW(asSContextPool);
+	if( pool == 0 )
+		return 0;
+	pool->refCount.set(2);
+
+	ENTERCRITICALSECTION(contextPoolCritical);
+
+	// Drop the pools that no thread remembers anymore, because the thread
+	// called asThreadCleanup or has used too many other engines since
+	for( asUINT n = contextPools.GetLength(); n-- > 0; )
+	{
+		asSContextPool *unused = contextPools[n];
+		if( unused->refCount.get() == 1 )
+		{
+			ReleasePoolContexts(unused);
+			contextPools.RemoveIndexUnordered(n);
+			asReleaseContextPool(unused);
+		}
+	}
+	contextPools.PushLast(pool);
+
+	LEAVECRITICALSECTION(contextPoolCritical);
+
+	// Only remember a few engines, the pools of released engines are never used again
+	if( tld->contextPools.GetLength() >= 8 )
+	{
+		asReleaseContextPool(tld->contextPools[0].pool);
+		tld->contextPools.RemoveIndex(0);
+	}
+
+	asSThreadContextPool entry = {serial, pool};
+	tld->contextPools.PushLast(entry);
+
+	return pool;
+}
+
+// internal
+void asCScriptEngine::ReleasePoolContexts(asSContextPool *pool)
+{
+	for( asUINT n = 0; n < pool->contexts.GetLength(); n++ )
+	{
+		pool->contexts[n]->Release();
+		pooledContexts.atomicDec();
+	}
+	pool->contexts.SetLength(0);
+}
+
+// internal
+void asCScriptEngine::ReleasePooledContexts()
+{
+	ENTERCRITICALSECTION(contextPoolCritical);
+	for( asUINT n = 0; n < contextPools.GetLength(); n++ )
+	{
+		ReleasePoolContexts(contextPools[n]);
+		asReleaseContextPool(contextPools[n]);
+	}
+	contextPools.SetLength(0);
+	LEAVECRITICALSECTION(contextPoolCritical);
+}
+
 // internal
 asCModule *asCScriptEngine::FindNewOwnerForSharedType(asCObjectType *type, asCModule *mod)
 {
@@ -914,9 +1418,29 @@ void asCScriptEngine::ReturnContext(asIScriptContext *ctx)
 		return;
 	}
 
+	if( ctx == 0 )
+		return;
+
+	// Keep the context for the next request from this thread. The context gives up its
+	// reference to the engine, which mustn't be the last one
+	if( ep.maxPooledContexts && !shuttingDown && ctx->GetEngine() == this && refCount.get() > 1 )
+	{
+		asSContextPool *pool = GetContextPool();
+		asCContext *context = reinterpret_cast<asCContext*>(ctx);
+		if( pool && pool->contexts.GetLength() < ep.maxPooledContexts )
+		{
+			// Enough for a full pool on each of 16 threads
+			if( pooledContexts.atomicInc() <= ep.maxPooledContexts * 16 && context->ReleaseForPool() )
+			{
+				pool->contexts.PushLast(context);
+				return;
+			}
+			pooledContexts.atomicDec();
+		}
+	}
+
 	// As fallback we just release the context
-	if( ctx )
-		ctx->Release();
+	ctx->Release();
 }
 
 // interface
@@ -959,6 +1483,9 @@ int asCScriptEngine::ShutDownAndRelease()
 	// violations later on when the pool releases its contexts.
 	SetContextCallbacks(0, 0, 0);
 
+	// The pooled contexts hold references to the engine and to the functions they last called
+	ReleasePooledContexts();
+
 	// The modules must be deleted first, as they may use
 	// object types from the config groups
 	for( asUINT n = (asUINT)scriptModules.GetLength(); n-- > 0; )
@@ -983,6 +1510,12 @@ int asCScriptEngine::ShutDownAndRelease()
 	return Release();
 }
 
+// interface
+int asCScriptEngine::EnumerateMemoryPools(asMEMORYPOOLCALLBACK_t callback, void *param) const
+{
+	return memoryMgr.EnumeratePools(callback, param);
+}
+
 // internal
 asSNameSpace *asCScriptEngine::AddNameSpace(const char *name)
 {
@@ -999,6 +1532,7 @@ asSNameSpace *asCScriptEngine::AddNameSpace(const char *name)
 	ns->name = name;
 
 	nameSpaces.PushLast(ns);
+	nameSpaceIndex.Insert(ns->name, ns);
 
 	return ns;
 }
@@ -1006,10 +1540,9 @@ asSNameSpace *asCScriptEngine::AddNameSpace(const char *name)
 // internal
 asSNameSpace *asCScriptEngine::FindNameSpace(const char *name) const
 {
-	// TODO: optimize: Improve linear search
-	for( asUINT n = 0; n < nameSpaces.GetLength(); n++ )
-		if( nameSpaces[n]->name == name )
-			return nameSpaces[n];
+	int cursor = nameSpaceIndex.GetFirst(asCString(name));
+	if( cursor >= 0 )
+		return nameSpaceIndex.GetValue(cursor);
 
 	return 0;
 }
@@ -1440,7 +1973,7 @@ int asCScriptEngine::RegisterObjectProperty(const char *obj, const char *declara
 	if( byteOffset > 32767 || byteOffset < -32768 )
 		return ConfigError(asINVALID_ARG, "RegisterObjectProperty", obj, declaration);
 
-	asCObjectProperty *prop = asNEW(asCObjectProperty);
+	asCObjectProperty *prop = asNEWPOOLED(memoryMgr, asPOOL_OBJECT_PROPERTY, asCObjectProperty);
 	if( prop == 0 )
 		return ConfigError(asOUT_OF_MEMORY, "RegisterObjectProperty", obj, declaration);
 
@@ -1505,7 +2038,7 @@ int asCScriptEngine::RegisterInterface(const char *name)
 	// types as they are allowed to use the names
 
 	// Register the object type for the interface
-	asCObjectType *st = asNEW(asCObjectType)(this);
+	asCObjectType *st = asNEWPOOLED(memoryMgr, asPOOL_OBJECT_TYPE, asCObjectType)(this);
 	if( st == 0 )
 		return ConfigError(asOUT_OF_MEMORY, "RegisterInterface", name, 0);
 
@@ -1543,7 +2076,7 @@ int asCScriptEngine::RegisterInterfaceMethod(const char *intf, const char *decla
 	if( r < 0 )
 		return ConfigError(r, "RegisterInterfaceMethod", intf, declaration);
 
-	asCScriptFunction *func = asNEW(asCScriptFunction)(this, 0, asFUNC_INTERFACE);
+	asCScriptFunction *func = asNEWPOOLED(memoryMgr, asPOOL_SCRIPT_FUNCTION, asCScriptFunction)(this, 0, asFUNC_INTERFACE);
 	if( func == 0 )
 		return ConfigError(asOUT_OF_MEMORY, "RegisterInterfaceMethod", intf, declaration);
 
@@ -1554,7 +2087,7 @@ int asCScriptEngine::RegisterInterfaceMethod(const char *intf, const char *decla
 	if( r < 0 )
 	{
 		func->funcType = asFUNC_DUMMY;
-		asDELETE(func,asCScriptFunction);
+		asDELETEPOOLED(func,asCScriptFunction);
 		return ConfigError(asINVALID_DECLARATION, "RegisterInterfaceMethod", intf, declaration);
 	}
 
@@ -1563,7 +2096,7 @@ int asCScriptEngine::RegisterInterfaceMethod(const char *intf, const char *decla
 	if( r < 0 )
 	{
 		func->funcType = asFUNC_DUMMY;
-		asDELETE(func,asCScriptFunction);
+		asDELETEPOOLED(func,asCScriptFunction);
 		return ConfigError(asNAME_TAKEN, "RegisterInterfaceMethod", intf, declaration);
 	}
 
@@ -1701,7 +2234,7 @@ int asCScriptEngine::RegisterObjectType(const char *name, int byteSize, asDWORD
 			// This is not an irrepairable error, as it may just be that the same type is registered twice
 			return asALREADY_REGISTERED;
 
-		asCObjectType *type = asNEW(asCObjectType)(this);
+		asCObjectType *type = asNEWPOOLED(memoryMgr, asPOOL_OBJECT_TYPE, asCObjectType)(this);
 		if( type == 0 )
 			return ConfigError(asOUT_OF_MEMORY, "RegisterObjectType", name, 0);
 
@@ -1736,7 +2269,7 @@ int asCScriptEngine::RegisterObjectType(const char *name, int byteSize, asDWORD
 			if( subtype == 0 )
 			{
 				// Create the new subtype if not already existing
-				subtype = asNEW(asCObjectType)(this);
+				subtype = asNEWPOOLED(memoryMgr, asPOOL_OBJECT_TYPE, asCObjectType)(this);
 				if( subtype == 0 )
 					return ConfigError(asOUT_OF_MEMORY, "RegisterObjectType", name, 0);
 
@@ -1801,7 +2334,7 @@ int asCScriptEngine::RegisterObjectType(const char *name, int byteSize, asDWORD
 			// types as they are allowed to use the names
 
 			// Put the data type in the list
-			asCObjectType *type = asNEW(asCObjectType)(this);
+			asCObjectType *type = asNEWPOOLED(memoryMgr, asPOOL_OBJECT_TYPE, asCObjectType)(this);
 			if( type == 0 )
 				return ConfigError(asOUT_OF_MEMORY, "RegisterObjectType", name, 0);
 
@@ -1856,7 +2389,7 @@ int asCScriptEngine::RegisterObjectType(const char *name, int byteSize, asDWORD
 //				return ConfigError(asNOT_SUPPORTED, "RegisterObjectType", name, 0);
 
 			// Put the data type in the list
-			asCObjectType *type = asNEW(asCObjectType)(this);
+			asCObjectType *type = asNEWPOOLED(memoryMgr, asPOOL_OBJECT_TYPE, asCObjectType)(this);
 			if( type == 0 )
 				return ConfigError(asOUT_OF_MEMORY, "RegisterObjectType", name, 0);
 
@@ -2508,7 +3041,7 @@ int asCScriptEngine::AddBehaviourFunction(asCScriptFunction &func, asSSystemFunc
 	if( newInterface == 0 )
 		return asOUT_OF_MEMORY;
 
-	asCScriptFunction *f = asNEW(asCScriptFunction)(this, 0, asFUNC_SYSTEM);
+	asCScriptFunction *f = asNEWPOOLED(memoryMgr, asPOOL_SCRIPT_FUNCTION, asCScriptFunction)(this, 0, asFUNC_SYSTEM);
 	if( f == 0 )
 	{
 		asDELETE(newInterface, asSSystemFunctionInterface);
@@ -2544,24 +3077,63 @@ int asCScriptEngine::AddBehaviourFunction(asCScriptFunction &func, asSSystemFunc
 // interface
 int asCScriptEngine::RegisterGlobalProperty(const char *declaration, void *pointer)
 {
-	// Don't accept a null pointer
-	if( pointer == 0 )
-		return ConfigError(asINVALID_ARG, "RegisterGlobalProperty", declaration, 0);
-
-	asCDataType type;
-	asCString name;
-
-	int r;
 	asCBuilder bld(this, 0);
-	if( (r = bld.VerifyProperty(0, declaration, name, type, defaultNamespace)) < 0 )
+	int r = RegisterGlobalPropertyWithBuilder(bld, declaration, pointer);
+	if( r < 0 )
 		return ConfigError(r, "RegisterGlobalProperty", declaration, 0);
 
-	// Don't allow registering references as global properties
-	if( type.IsReference() )
-		return ConfigError(asINVALID_TYPE, "RegisterGlobalProperty", declaration, 0);
+	return asSUCCESS;
+}
 
-	// Store the property info
-	asCGlobalProperty *prop = AllocateGlobalProperty();
+// interface
+int asCScriptEngine::RegisterGlobalProperties(const asSPropRegistration *registrations, asUINT count, int *outResults)
+{
+	if( registrations == 0 && count > 0 )
+		return ConfigError(asINVALID_ARG, "RegisterGlobalProperties", 0, 0);
+
+	// Each property may conflict with the ones registered before it,
+	// so these are verified one at a time, but with the same builder
+	asCBuilder bld(this, 0);
+
+	int firstError = asSUCCESS;
+	for( asUINT n = 0; n < count; n++ )
+	{
+		int r = RegisterGlobalPropertyWithBuilder(bld, registrations[n].declaration, registrations[n].pointer);
+		if( r < 0 )
+		{
+			ConfigError(r, "RegisterGlobalProperties", registrations[n].declaration, 0);
+			if( firstError >= 0 )
+				firstError = r;
+		}
+
+		if( outResults )
+			outResults[n] = r;
+	}
+
+	return firstError;
+}
+
+// internal
+// Returns the error code without reporting it, so the caller can report it with its own name
+int asCScriptEngine::RegisterGlobalPropertyWithBuilder(asCBuilder &bld, const char *declaration, void *pointer)
+{
+	// Don't accept a null pointer
+	if( pointer == 0 )
+		return asINVALID_ARG;
+
+	asCDataType type;
+	asCString name;
+
+	int r;
+	if( (r = bld.VerifyProperty(0, declaration, name, type, defaultNamespace)) < 0 )
+		return r;
+
+	// Don't allow registering references as global properties
+	if( type.IsReference() )
+		return asINVALID_TYPE;
+
+	// Store the property info
+	asCGlobalProperty *prop = AllocateGlobalProperty();
 	prop->name        = name;
 	prop->nameSpace   = defaultNamespace;
 	prop->type        = type;
@@ -2582,7 +3154,7 @@ int asCScriptEngine::RegisterGlobalProperty(const char *declaration, void *point
 // internal
 asCGlobalProperty *asCScriptEngine::AllocateGlobalProperty()
 {
-	asCGlobalProperty *prop = asNEW(asCGlobalProperty);
+	asCGlobalProperty *prop = asNEWPOOLED(memoryMgr, asPOOL_GLOBAL_PROPERTY, asCGlobalProperty);
 	if( prop == 0 )
 	{
 		// Out of memory
@@ -2705,47 +3277,147 @@ int asCScriptEngine::GetGlobalPropertyIndexByDecl(const char *decl) const
 // interface
 int asCScriptEngine::RegisterObjectMethod(const char *obj, const char *declaration, const asSFuncPtr &funcPointer, asDWORD callConv, void *objForThiscall)
 {
+	asCBuilder bld(this, 0);
+	asCObjectType *objectType;
+	int r = GetObjectTypeForMethods(bld, obj, &objectType);
+	if( r < 0 )
+		return ConfigError(r, "RegisterObjectMethod", obj, declaration);
+
+	return RegisterMethodToObjectType(objectType, declaration, funcPointer, callConv, objForThiscall);
+}
+
+// interface
+int asCScriptEngine::RegisterObjectMethods(const char *obj, const asSFuncRegistration *registrations, asUINT count, int *outResults)
+{
+	if( registrations == 0 && count > 0 )
+		return ConfigError(asINVALID_ARG, "RegisterObjectMethods", obj, 0);
+
+	// All declarations are parsed with the same builder
+	asCBuilder bld(this, 0);
+
+	asUINT n;
+	asCObjectType *objectType;
+	int r = GetObjectTypeForMethods(bld, obj, &objectType);
+	if( r < 0 )
+	{
+		if( outResults )
+			for( n = 0; n < count; n++ )
+				outResults[n] = r;
+		return ConfigError(r, "RegisterObjectMethods", obj, 0);
+	}
+
+	// Registering methods doesn't change the properties that the names are checked against,
+	// so each distinct name is only checked once. The methods must still be added as they
+	// are parsed, since parsing may instantiate templates, which take function ids as well
+	asCHashMap<asCString, int> conflicts;
+	int firstError = asSUCCESS;
+	for( n = 0; n < count; n++ )
+	{
+		asCScriptFunction *func;
+		r = ParseSystemFunction(bld, objectType, registrations[n].declaration, registrations[n].funcPointer, registrations[n].callConv, registrations[n].objForThiscall, &func);
+		if( r >= 0 )
+		{
+			int entry = conflicts.GetFirst(func->name);
+			if( entry < 0 )
+				entry = conflicts.Insert(func->name, bld.CheckNameConflictMember(objectType, func->name.AddressOf(), 0, 0, false));
+
+			if( conflicts.GetValue(entry) < 0 )
+			{
+				DiscardSystemFunction(func);
+				r = asNAME_TAKEN;
+			}
+			else
+				r = AddSystemMethod(func);
+		}
+
+		if( r < 0 )
+		{
+			ConfigError(r, "RegisterObjectMethods", obj, registrations[n].declaration);
+			if( firstError >= 0 )
+				firstError = r;
+		}
+
+		if( outResults )
+			outResults[n] = r;
+	}
+
+	return firstError;
+}
+
+// internal
+int asCScriptEngine::GetObjectTypeForMethods(asCBuilder &bld, const char *obj, asCObjectType **outType)
+{
+	*outType = 0;
 	if( obj == 0 )
-		return ConfigError(asINVALID_ARG, "RegisterObjectMethod", obj, declaration);
+		return asINVALID_ARG;
 
 	// Determine the object type
 	asCDataType dt;
-	asCBuilder bld(this, 0);
 	int r = bld.ParseDataType(obj, &dt, defaultNamespace);
 	if( r < 0 )
-		return ConfigError(r, "RegisterObjectMethod", obj, declaration);
+		return r;
 
 	if( dt.GetObjectType() == 0 || dt.IsObjectHandle() )
-		return ConfigError(asINVALID_ARG, "RegisterObjectMethod", obj, declaration);
+		return asINVALID_ARG;
 
 	// Don't allow application to modify built-in types
 	if( dt.GetObjectType() == &functionBehaviours ||
 		dt.GetObjectType() == &scriptTypeBehaviours )
-		return ConfigError(asINVALID_ARG, "RegisterObjectMethod", obj, declaration);
+		return asINVALID_ARG;
 
 	// Don't allow modifying generated template instances
 	if( dt.GetObjectType() && (dt.GetObjectType()->flags & asOBJ_TEMPLATE) && generatedTemplateTypes.Exists(dt.GetObjectType()) )
-		return ConfigError(asINVALID_TYPE, "RegisterObjectMethod", obj, declaration);
+		return asINVALID_TYPE;
 
-	return RegisterMethodToObjectType(dt.GetObjectType(), declaration, funcPointer, callConv, objForThiscall);
+	*outType = dt.GetObjectType();
+	return asSUCCESS;
 }
 
 // internal
 int asCScriptEngine::RegisterMethodToObjectType(asCObjectType *objectType, const char *declaration, const asSFuncPtr &funcPointer, asDWORD callConv, void *objForThiscall)
 {
+	asCBuilder bld(this, 0);
+	asCScriptFunction *func;
+	int r = ParseSystemFunction(bld, objectType, declaration, funcPointer, callConv, objForThiscall, &func);
+	if( r < 0 )
+		return ConfigError(r, "RegisterObjectMethod", objectType->name.AddressOf(), declaration);
+
+	// Check name conflicts
+	r = bld.CheckNameConflictMember(objectType, func->name.AddressOf(), 0, 0, false);
+	if( r < 0 )
+	{
+		DiscardSystemFunction(func);
+		return ConfigError(asNAME_TAKEN, "RegisterObjectMethod", objectType->name.AddressOf(), declaration);
+	}
+
+	r = AddSystemMethod(func);
+	if( r < 0 )
+		return ConfigError(r, "RegisterObjectMethod", objectType->name.AddressOf(), declaration);
+
+	// Return the function id as success
+	return r;
+}
+
+// internal
+// Creates the function for an application registered method, or global function when objectType
+// is null, from its declaration. The name conflicts are left to the caller and nothing is added to
+// the engine yet. Errors are returned without being reported.
+int asCScriptEngine::ParseSystemFunction(asCBuilder &bld, asCObjectType *objectType, const char *declaration, const asSFuncPtr &funcPointer, asDWORD callConv, void *objForThiscall, asCScriptFunction **outFunc)
+{
+	*outFunc = 0;
+
 #ifdef AS_MAX_PORTABILITY
 	if( callConv != asCALL_GENERIC )
-		return ConfigError(asNOT_SUPPORTED, "RegisterObjectMethod", objectType->name.AddressOf(), declaration);
+		return asNOT_SUPPORTED;
 #endif
 
 	asSSystemFunctionInterface internal;
-	int r = DetectCallingConvention(true, funcPointer, callConv, objForThiscall, &internal);
+	int r = DetectCallingConvention(objectType != 0, funcPointer, callConv, objForThiscall, &internal);
 	if( r < 0 )
-		return ConfigError(r, "RegisterObjectMethod", objectType->name.AddressOf(), declaration);
+		return r;
 
-	// TODO: cleanup: This is identical to what is in RegisterMethodToObjectType
 	// If the object type is a template, make sure there are no generated instances already
-	if( objectType->flags & asOBJ_TEMPLATE )
+	if( objectType && (objectType->flags & asOBJ_TEMPLATE) )
 	{
 		for( asUINT n = 0; n < generatedTemplateTypes.GetLength(); n++ )
 		{
@@ -2757,7 +3429,7 @@ int asCScriptEngine::RegisterMethodToObjectType(asCObjectType *objectType, const
 				asCString msg;
 				msg.Format(TXT_TEMPLATE_s_ALREADY_GENERATED_CANT_REGISTER, asCDataType::CreateObject(tmpl, false).Format(tmpl->nameSpace).AddressOf());
 				WriteMessage("",0,0, asMSGTYPE_ERROR, msg.AddressOf());
-				return ConfigError(asERROR, "RegisterObjectMethod", objectType->name.AddressOf(), declaration);
+				return asERROR;
 			}
 		}
 	}
@@ -2767,72 +3439,84 @@ int asCScriptEngine::RegisterMethodToObjectType(asCObjectType *objectType, const
 	// Put the system function in the list of system functions
 	asSSystemFunctionInterface *newInterface = asNEW(asSSystemFunctionInterface)(internal);
 	if( newInterface == 0 )
-		return ConfigError(asOUT_OF_MEMORY, "RegisterObjectMethod", objectType->name.AddressOf(), declaration);
+		return asOUT_OF_MEMORY;
 
-	asCScriptFunction *func = asNEW(asCScriptFunction)(this, 0, asFUNC_SYSTEM);
+	asCScriptFunction *func = asNEWPOOLED(memoryMgr, asPOOL_SCRIPT_FUNCTION, asCScriptFunction)(this, 0, asFUNC_SYSTEM);
 	if( func == 0 )
 	{
 		asDELETE(newInterface, asSSystemFunctionInterface);
-		return ConfigError(asOUT_OF_MEMORY, "RegisterObjectMethod", objectType->name.AddressOf(), declaration);
+		return asOUT_OF_MEMORY;
 	}
 
 	func->sysFuncIntf = newInterface;
-	func->objectType  = objectType;
-	func->objectType->AddRefInternal();
-
-	asCBuilder bld(this, 0);
-	r = bld.ParseFunctionDeclaration(func->objectType, declaration, func, true, &newInterface->paramAutoHandles, &newInterface->returnAutoHandle);
-	if( r < 0 )
+	if( objectType )
 	{
-		// Set as dummy function before deleting
-		func->funcType = asFUNC_DUMMY;
-		asDELETE(func,asCScriptFunction);
-		return ConfigError(asINVALID_DECLARATION, "RegisterObjectMethod", objectType->name.AddressOf(), declaration);
+		func->objectType = objectType;
+		func->objectType->AddRefInternal();
 	}
 
-	// Check name conflicts
-	r = bld.CheckNameConflictMember(objectType, func->name.AddressOf(), 0, 0, false);
+	r = bld.ParseFunctionDeclaration(objectType, declaration, func, true, &newInterface->paramAutoHandles, &newInterface->returnAutoHandle, objectType ? 0 : defaultNamespace);
 	if( r < 0 )
 	{
-		func->funcType = asFUNC_DUMMY;
-		asDELETE(func,asCScriptFunction);
-		return ConfigError(asNAME_TAKEN, "RegisterObjectMethod", objectType->name.AddressOf(), declaration);
+		DiscardSystemFunction(func);
+		return asINVALID_DECLARATION;
 	}
 
+	// TODO: namespace: What if the declaration defined an explicit namespace?
+	if( objectType == 0 )
+		func->nameSpace = defaultNamespace;
+
+	*outFunc = func;
+	return asSUCCESS;
+}
+
+// internal
+void asCScriptEngine::DiscardSystemFunction(asCScriptFunction *func)
+{
+	// Set as dummy function before deleting
+	func->funcType = asFUNC_DUMMY;
+	asDELETEPOOLED(func,asCScriptFunction);
+}
+
+// internal
+// Adds a method parsed by ParseSystemFunction to its object type. Returns the function id,
+// or the error code without reporting it. The function is discarded if it wasn't added.
+int asCScriptEngine::AddSystemMethod(asCScriptFunction *func)
+{
+	asCObjectType *objectType = func->objectType;
+
 	// Check against duplicate methods
 	asUINT n;
 	if( func->name == "opConv" || func->name == "opImplConv" || func->name == "opCast" || func->name == "opImplCast" )
 	{
 		// opConv and opCast are special methods that the compiler differentiates between by the return type
-		for( n = 0; n < func->objectType->methods.GetLength(); n++ )
+		for( n = 0; n < objectType->methods.GetLength(); n++ )
 		{
-			asCScriptFunction *f = scriptFunctions[func->objectType->methods[n]];
+			asCScriptFunction *f = scriptFunctions[objectType->methods[n]];
 			if( f->name == func->name &&
 				f->IsSignatureExceptNameEqual(func) )
 			{
-				func->funcType = asFUNC_DUMMY;
-				asDELETE(func,asCScriptFunction);
-				return ConfigError(asALREADY_REGISTERED, "RegisterObjectMethod", objectType->name.AddressOf(), declaration);
+				DiscardSystemFunction(func);
+				return asALREADY_REGISTERED;
 			}
 		}
 	}
 	else
 	{
-		for( n = 0; n < func->objectType->methods.GetLength(); n++ )
+		for( n = 0; n < objectType->methods.GetLength(); n++ )
 		{
-			asCScriptFunction *f = scriptFunctions[func->objectType->methods[n]];
+			asCScriptFunction *f = scriptFunctions[objectType->methods[n]];
 			if( f->name == func->name &&
 				f->IsSignatureExceptNameAndReturnTypeEqual(func) )
 			{
-				func->funcType = asFUNC_DUMMY;
-				asDELETE(func,asCScriptFunction);
-				return ConfigError(asALREADY_REGISTERED, "RegisterObjectMethod", objectType->name.AddressOf(), declaration);
+				DiscardSystemFunction(func);
+				return asALREADY_REGISTERED;
 			}
 		}
 	}
 
 	func->id = GetNextScriptFunctionId();
-	func->objectType->methods.PushLast(func->id);
+	objectType->methods.PushLast(func->id);
 	func->accessMask = defaultAccessMask;
 	AddScriptFunction(func);
 
@@ -2840,35 +3524,35 @@ int asCScriptEngine::RegisterMethodToObjectType(asCObjectType *objectType, const
 	currentGroup->AddReferencesForFunc(this, func);
 
 	// Check if the method restricts that use of the template to value types or reference types
-	if( func->objectType->flags & asOBJ_TEMPLATE )
+	if( objectType->flags & asOBJ_TEMPLATE )
 	{
-		for( asUINT subTypeIdx = 0; subTypeIdx < func->objectType->templateSubTypes.GetLength(); subTypeIdx++ )
+		for( asUINT subTypeIdx = 0; subTypeIdx < objectType->templateSubTypes.GetLength(); subTypeIdx++ )
 		{
-			if( func->returnType.GetObjectType() == func->objectType->templateSubTypes[subTypeIdx].GetObjectType() )
+			if( func->returnType.GetObjectType() == objectType->templateSubTypes[subTypeIdx].GetObjectType() )
 			{
 				if( func->returnType.IsObjectHandle() )
-					func->objectType->acceptValueSubType = false;
+					objectType->acceptValueSubType = false;
 				else if( !func->returnType.IsReference() )
-					func->objectType->acceptRefSubType = false;
+					objectType->acceptRefSubType = false;
 
 				// Can't support template subtypes by value, since each type is treated differently in the ABI
 				if( !func->returnType.IsObjectHandle() && !func->returnType.IsReference() )
-					return ConfigError(asNOT_SUPPORTED, "RegisterObjectMethod", objectType->name.AddressOf(), declaration);
+					return asNOT_SUPPORTED;
 			}
 
 			for( asUINT n = 0; n < func->parameterTypes.GetLength(); n++ )
 			{
-				if( func->parameterTypes[n].GetObjectType() == func->objectType->templateSubTypes[subTypeIdx].GetObjectType() )
+				if( func->parameterTypes[n].GetObjectType() == objectType->templateSubTypes[subTypeIdx].GetObjectType() )
 				{
 					// TODO: If unsafe references are allowed, then inout references allow value types
 					if( func->parameterTypes[n].IsObjectHandle() || (func->parameterTypes[n].IsReference() && func->inOutFlags[n] == asTM_INOUTREF) )
-						func->objectType->acceptValueSubType = false;
+						objectType->acceptValueSubType = false;
 					else if( !func->parameterTypes[n].IsReference() )
-						func->objectType->acceptRefSubType = false;
+						objectType->acceptRefSubType = false;
 
 					// Can't support template subtypes by value, since each type is treated differently in the ABI
 					if( !func->parameterTypes[n].IsObjectHandle() && !func->parameterTypes[n].IsReference() )
-						return ConfigError(asNOT_SUPPORTED, "RegisterObjectMethod", objectType->name.AddressOf(), declaration);
+						return asNOT_SUPPORTED;
 				}
 			}
 		}
@@ -2877,71 +3561,95 @@ int asCScriptEngine::RegisterMethodToObjectType(asCObjectType *objectType, const
 	// TODO: beh.copy member will be removed, so this is not necessary
 	// Is this the default copy behaviour?
 	if( func->name == "opAssign" && func->parameterTypes.GetLength() == 1 && func->isReadOnly == false &&
-		((objectType->flags & asOBJ_SCRIPT_OBJECT) || func->parameterTypes[0].IsEqualExceptRefAndConst(asCDataType::CreateObject(func->objectType, false))) )
+		((objectType->flags & asOBJ_SCRIPT_OBJECT) || func->parameterTypes[0].IsEqualExceptRefAndConst(asCDataType::CreateObject(objectType, false))) )
 	{
-		if( func->objectType->beh.copy != 0 )
-			return ConfigError(asALREADY_REGISTERED, "RegisterObjectMethod", objectType->name.AddressOf(), declaration);
+		if( objectType->beh.copy != 0 )
+			return asALREADY_REGISTERED;
 
-		func->objectType->beh.copy = func->id;
+		objectType->beh.copy = func->id;
 		func->AddRefInternal();
 	}
 
-	// Return the function id as success
 	return func->id;
 }
 
 // interface
 int asCScriptEngine::RegisterGlobalFunction(const char *declaration, const asSFuncPtr &funcPointer, asDWORD callConv, void *objForThiscall)
 {
-#ifdef AS_MAX_PORTABILITY
-	if( callConv != asCALL_GENERIC )
-		return ConfigError(asNOT_SUPPORTED, "RegisterGlobalFunction", declaration, 0);
-#endif
-
-	asSSystemFunctionInterface internal;
-	int r = DetectCallingConvention(false, funcPointer, callConv, objForThiscall, &internal);
+	asCBuilder bld(this, 0);
+	asCScriptFunction *func;
+	int r = ParseSystemFunction(bld, 0, declaration, funcPointer, callConv, objForThiscall, &func);
 	if( r < 0 )
 		return ConfigError(r, "RegisterGlobalFunction", declaration, 0);
 
-	isPrepared = false;
-
-	// Put the system function in the list of system functions
-	asSSystemFunctionInterface *newInterface = asNEW(asSSystemFunctionInterface)(internal);
-	if( newInterface == 0 )
-		return ConfigError(asOUT_OF_MEMORY, "RegisterGlobalFunction", declaration, 0);
-
-	asCScriptFunction *func = asNEW(asCScriptFunction)(this, 0, asFUNC_SYSTEM);
-	if( func == 0 )
+	// Check name conflicts
+	r = bld.CheckNameConflict(func->name.AddressOf(), 0, 0, defaultNamespace);
+	if( r < 0 )
 	{
-		asDELETE(newInterface, asSSystemFunctionInterface);
-		return ConfigError(asOUT_OF_MEMORY, "RegisterGlobalFunction", declaration, 0);
+		DiscardSystemFunction(func);
+		return ConfigError(asNAME_TAKEN, "RegisterGlobalFunction", declaration, 0);
 	}
 
-	func->sysFuncIntf = newInterface;
+	r = AddSystemGlobalFunction(func);
+	if( r < 0 )
+		return ConfigError(r, "RegisterGlobalFunction", declaration, 0);
 
+	// Return the function id as success
+	return r;
+}
+
+// interface
+int asCScriptEngine::RegisterGlobalFunctions(const asSFuncRegistration *registrations, asUINT count, int *outResults)
+{
+	if( registrations == 0 && count > 0 )
+		return ConfigError(asINVALID_ARG, "RegisterGlobalFunctions", 0, 0);
+
+	// All declarations are parsed with the same builder
 	asCBuilder bld(this, 0);
-	r = bld.ParseFunctionDeclaration(0, declaration, func, true, &newInterface->paramAutoHandles, &newInterface->returnAutoHandle, defaultNamespace);
-	if( r < 0 )
+
+	// Global functions are only checked against types and properties, which registering
+	// functions doesn't change, so each distinct name is only checked once. The functions
+	// are still added as they are parsed, to get the same ids as when registered one by one
+	asCHashMap<asCString, int> conflicts;
+	int firstError = asSUCCESS;
+	for( asUINT n = 0; n < count; n++ )
 	{
-		// Set as dummy function before deleting
-		func->funcType = asFUNC_DUMMY;
-		asDELETE(func,asCScriptFunction);
-		return ConfigError(asINVALID_DECLARATION, "RegisterGlobalFunction", declaration, 0);
-	}
+		asCScriptFunction *func;
+		int r = ParseSystemFunction(bld, 0, registrations[n].declaration, registrations[n].funcPointer, registrations[n].callConv, registrations[n].objForThiscall, &func);
+		if( r >= 0 )
+		{
+			int entry = conflicts.GetFirst(func->name);
+			if( entry < 0 )
+				entry = conflicts.Insert(func->name, bld.CheckNameConflict(func->name.AddressOf(), 0, 0, defaultNamespace));
 
-	// TODO: namespace: What if the declaration defined an explicit namespace?
-	func->nameSpace = defaultNamespace;
+			if( conflicts.GetValue(entry) < 0 )
+			{
+				DiscardSystemFunction(func);
+				r = asNAME_TAKEN;
+			}
+			else
+				r = AddSystemGlobalFunction(func);
+		}
 
-	// Check name conflicts
-	r = bld.CheckNameConflict(func->name.AddressOf(), 0, 0, defaultNamespace);
-	if( r < 0 )
-	{
-		// Set as dummy function before deleting
-		func->funcType = asFUNC_DUMMY;
-		asDELETE(func,asCScriptFunction);
-		return ConfigError(asNAME_TAKEN, "RegisterGlobalFunction", declaration, 0);
+		if( r < 0 )
+		{
+			ConfigError(r, "RegisterGlobalFunctions", registrations[n].declaration, 0);
+			if( firstError >= 0 )
+				firstError = r;
+		}
+
+		if( outResults )
+			outResults[n] = r;
 	}
 
+	return firstError;
+}
+
+// internal
+// Adds a global function parsed by ParseSystemFunction to the engine. Returns the function id,
+// or the error code without reporting it. The function is discarded if it wasn't added.
+int asCScriptEngine::AddSystemGlobalFunction(asCScriptFunction *func)
+{
 	// Make sure the function is not identical to a previously registered function
 	asUINT n;
 	const asCArray<unsigned int> &idxs = registeredGlobalFuncs.GetIndexes(func->nameSpace, func->name);
@@ -2950,9 +3658,8 @@ int asCScriptEngine::RegisterGlobalFunction(const char *declaration, const asSFu
 		asCScriptFunction *f = registeredGlobalFuncs.Get(idxs[n]);
 		if( f->IsSignatureExceptNameAndReturnTypeEqual(func) )
 		{
-			func->funcType = asFUNC_DUMMY;
-			asDELETE(func,asCScriptFunction);
-			return ConfigError(asALREADY_REGISTERED, "RegisterGlobalFunction", declaration, 0);
+			DiscardSystemFunction(func);
+			return asALREADY_REGISTERED;
 		}
 	}
 
@@ -2966,7 +3673,6 @@ int asCScriptEngine::RegisterGlobalFunction(const char *declaration, const asSFu
 	// If parameter type from other groups are used, add references
 	currentGroup->AddReferencesForFunc(this, func);
 
-	// Return the function id as success
 	return func->id;
 }
 
@@ -3050,9 +3756,9 @@ asIScriptFunction *asCScriptEngine::GetGlobalFunctionByDecl(const char *decl) co
 
 asCObjectType *asCScriptEngine::GetRegisteredObjectType(const asCString &type, asSNameSpace *ns) const
 {
-	asSMapNode<asSNameSpaceNamePair, asCObjectType *> *cursor;
-	if( allRegisteredTypes.MoveTo(&cursor, asSNameSpaceNamePair(ns, type)) )
-		return cursor->value;
+	int cursor = allRegisteredTypes.GetFirst(asSNameSpaceNamePair(ns, type));
+	if( cursor >= 0 )
+		return allRegisteredTypes.GetValue(cursor);
 
 	return 0;
 }
@@ -3222,7 +3928,7 @@ int asCScriptEngine::RegisterStringFactory(const char *datatype, const asSFuncPt
 	if( newInterface == 0 )
 		return ConfigError(asOUT_OF_MEMORY, "RegisterStringFactory", datatype, 0);
 
-	asCScriptFunction *func = asNEW(asCScriptFunction)(this, 0, asFUNC_SYSTEM);
+	asCScriptFunction *func = asNEWPOOLED(memoryMgr, asPOOL_SCRIPT_FUNCTION, asCScriptFunction)(this, 0, asFUNC_SYSTEM);
 	if( func == 0 )
 	{
 		asDELETE(newInterface, asSSystemFunctionInterface);
@@ -3240,7 +3946,7 @@ int asCScriptEngine::RegisterStringFactory(const char *datatype, const asSFuncPt
 	{
 		// Set as dummy before deleting
 		func->funcType = asFUNC_DUMMY;
-		asDELETE(func,asCScriptFunction);
+		asDELETEPOOLED(func,asCScriptFunction);
 		return ConfigError(asINVALID_TYPE, "RegisterStringFactory", datatype, 0);
 	}
 
@@ -3430,7 +4136,7 @@ asCObjectType *asCScriptEngine::GetTemplateInstanceType(asCObjectType *templateT
 	}
 
 	// Create a new template instance type based on the templateType
-	asCObjectType *ot = asNEW(asCObjectType)(this);
+	asCObjectType *ot = asNEWPOOLED(memoryMgr, asPOOL_OBJECT_TYPE, asCObjectType)(this);
 	if( ot == 0 )
 	{
 		// Out of memory
@@ -3642,7 +4348,7 @@ asCObjectType *asCScriptEngine::GetTemplateInstanceType(asCObjectType *templateT
 	for( n = 0; n < templateType->properties.GetLength(); n++ )
 	{
 		asCObjectProperty *prop = templateType->properties[n];
-		ot->properties.PushLast(asNEW(asCObjectProperty)(*prop));
+		ot->properties.PushLast(asNEWPOOLED(memoryMgr, asPOOL_OBJECT_PROPERTY, asCObjectProperty)(*prop));
 		if( prop->type.GetObjectType() )
 			prop->type.GetObjectType()->AddRefInternal();
 	}
@@ -3781,7 +4487,7 @@ asCScriptFunction *asCScriptEngine::GenerateTemplateFactoryStub(asCObjectType *t
 	// I avoid having it added to the garbage collector. As it is known that this object will stay
 	// alive until the template instance is no longer used there is no need to have the GC check
 	// this function all the time.
-	asCScriptFunction *func = asNEW(asCScriptFunction)(this, 0, asFUNC_DUMMY);
+	asCScriptFunction *func = asNEWPOOLED(memoryMgr, asPOOL_SCRIPT_FUNCTION, asCScriptFunction)(this, 0, asFUNC_DUMMY);
 	if( func == 0 )
 	{
 		// Out of memory
@@ -3922,7 +4628,7 @@ bool asCScriptEngine::GenerateNewTemplateFunction(asCObjectType *templateType, a
 	if( !needNewFunc )
 		return false;
 
-	asCScriptFunction *func2 = asNEW(asCScriptFunction)(this, 0, func->funcType);
+	asCScriptFunction *func2 = asNEWPOOLED(memoryMgr, asPOOL_SCRIPT_FUNCTION, asCScriptFunction)(this, 0, func->funcType);
 	if( func2 == 0 )
 	{
 		// Out of memory
@@ -5289,6 +5995,510 @@ int asCScriptEngine::RemoveConfigGroup(const char *groupName)
 	return 0;
 }
 
+// Maps the entities of the source engine to their copies in the clone
+struct asSConfigCopy
+{
+	asSConfigCopy(asCScriptEngine *target) : target(target) {}
+
+	asSNameSpace *Map(const asSNameSpace *ns) const
+	{
+		return Find(nameSpaces, ns);
+	}
+
+	asCObjectType *Map(const asCObjectType *type) const
+	{
+		return Find(types, type);
+	}
+
+	asCConfigGroup *Map(const asCConfigGroup *group) const
+	{
+		return Find(groups, group);
+	}
+
+	// Functions and global properties keep their ids
+	asCScriptFunction *Map(const asCScriptFunction *func) const
+	{
+		return func ? target->scriptFunctions[func->id] : 0;
+	}
+
+	asCGlobalProperty *Map(const asCGlobalProperty *prop) const
+	{
+		return prop ? target->globalProperties[prop->id] : 0;
+	}
+
+	asCDataType Map(const asCDataType &dt) const
+	{
+		asCDataType copy(dt);
+		copy.SetObjectType(Map(dt.GetObjectType()));
+		if( dt.GetFuncDef() )
+			copy.SetFuncDef(Map(dt.GetFuncDef()));
+		return copy;
+	}
+
+	template<class T>
+	void MapArray(asCArray<T> &dst, const asCArray<T> &src) const
+	{
+		dst.SetLength(src.GetLength());
+		for( asUINT n = 0; n < src.GetLength(); n++ )
+			dst[n] = Map(src[n]);
+	}
+
+	template<class T>
+	static T *Find(const asCHashMap<const T*, T*> &map, const T *entity)
+	{
+		if( entity == 0 )
+			return 0;
+
+		int cursor = map.GetFirst(entity);
+		asASSERT( cursor >= 0 );
+		return cursor >= 0 ? map.GetValue(cursor) : 0;
+	}
+
+	asCScriptEngine *target;
+
+	asCHashMap<const asSNameSpace*, asSNameSpace*>     nameSpaces;
+	asCHashMap<const asCObjectType*, asCObjectType*>   types;
+	asCHashMap<const asCConfigGroup*, asCConfigGroup*> groups;
+
+	// The object types in the order they were found, so they can be copied once all are mapped
+	asCArray<const asCObjectType*> typeOrder;
+};
+
+static void AddTypeToCopy(asSConfigCopy &copy, const asCObjectType *type)
+{
+	if( type == 0 || copy.types.GetFirst(type) >= 0 )
+		return;
+
+	copy.types.Insert(type, 0);
+	copy.typeOrder.PushLast(type);
+}
+
+static void AddTypesToCopy(asSConfigCopy &copy, const asCArray<asCObjectType*> &types)
+{
+	for( asUINT n = 0; n < types.GetLength(); n++ )
+		AddTypeToCopy(copy, types[n]);
+}
+
+// Template factory stubs are the only script functions in a registered interface. Their
+// bytecode refers to the instance type, the system function and optionally the JIT entry
+static bool IsCopyableStub(const asCScriptFunction *func)
+{
+	const asCArray<asDWORD> &bc = func->scriptData->byteCode;
+	for( asUINT n = 0; n < bc.GetLength(); )
+	{
+		asEBCInstr op = asEBCInstr(*(const asBYTE*)&bc[n]);
+		if( op != asBC_JitEntry && op != asBC_OBJTYPE && op != asBC_SwapPtr &&
+			op != asBC_CALLSYS && op != asBC_RET )
+			return false;
+		n += asBCTypeSize[asBCInfo[op].type];
+	}
+
+	return func->scriptData->variables.GetLength() == 0;
+}
+
+static void CopyObjectType(const asCObjectType *src, asCObjectType *dst, const asSConfigCopy &copy)
+{
+	asUINT n;
+
+	dst->name      = src->name;
+	dst->nameSpace = copy.Map(src->nameSpace);
+	dst->size      = src->size;
+#ifdef WIP_16BYTE_ALIGN
+	dst->alignment = src->alignment;
+#endif
+	dst->typeId    = src->typeId;
+
+	for( n = 0; n < src->properties.GetLength(); n++ )
+	{
+		asCObjectProperty *prop = asNEWPOOLED(dst->engine->memoryMgr, asPOOL_OBJECT_PROPERTY, asCObjectProperty)(*src->properties[n]);
+		prop->type = copy.Map(prop->type);
+		dst->properties.PushLast(prop);
+	}
+
+	for( n = 0; n < src->enumValues.GetLength(); n++ )
+	{
+		asSEnumValue *value = asNEW(asSEnumValue);
+		*value = *src->enumValues[n];
+		dst->enumValues.PushLast(value);
+	}
+
+	dst->methods             = src->methods;
+	dst->interfaceVFTOffsets = src->interfaceVFTOffsets;
+	copy.MapArray(dst->interfaces, src->interfaces);
+	copy.MapArray(dst->virtualFunctionTable, src->virtualFunctionTable);
+	dst->derivedFrom         = copy.Map(src->derivedFrom);
+
+	dst->flags      = src->flags;
+	dst->accessMask = src->accessMask;
+	dst->beh        = src->beh;
+
+	copy.MapArray(dst->templateSubTypes, src->templateSubTypes);
+	dst->acceptValueSubType = src->acceptValueSubType;
+	dst->acceptRefSubType   = src->acceptRefSubType;
+
+	dst->scriptSectionIdx = src->scriptSectionIdx;
+	dst->declaredAt       = src->declaredAt;
+}
+
+static void CopyScriptFunction(const asCScriptFunction *src, asCScriptFunction *dst, const asSConfigCopy &copy)
+{
+	asUINT n;
+
+	dst->name       = src->name;
+	dst->returnType = copy.Map(src->returnType);
+	copy.MapArray(dst->parameterTypes, src->parameterTypes);
+	dst->parameterNames = src->parameterNames;
+	dst->inOutFlags     = src->inOutFlags;
+	for( n = 0; n < src->defaultArgs.GetLength(); n++ )
+		dst->defaultArgs.PushLast(src->defaultArgs[n] ? asNEW(asCString)(*src->defaultArgs[n]) : 0);
+
+	dst->isReadOnly  = src->isReadOnly;
+	dst->isPrivate   = src->isPrivate;
+	dst->isProtected = src->isProtected;
+	dst->isFinal     = src->isFinal;
+	dst->isOverride  = src->isOverride;
+	dst->objectType  = copy.Map(src->objectType);
+	dst->signatureId = src->signatureId;
+	dst->id          = src->id;
+	dst->funcType    = src->funcType;
+	dst->accessMask  = src->accessMask;
+	dst->isShared    = src->isShared;
+	dst->nameSpace   = copy.Map(src->nameSpace);
+
+	asSListPatternNode *last = 0;
+	for( asSListPatternNode *node = src->listPattern; node; node = node->next )
+	{
+		asSListPatternNode *newNode = node->Duplicate();
+		if( newNode->type == asLPT_TYPE )
+		{
+			asSListPatternDataTypeNode *typeNode = reinterpret_cast<asSListPatternDataTypeNode*>(newNode);
+			typeNode->dataType = copy.Map(typeNode->dataType);
+		}
+
+		if( last )
+			last->next = newNode;
+		else
+			dst->listPattern = newNode;
+		last = newNode;
+	}
+
+	if( src->scriptData )
+	{
+		dst->AllocateScriptFunctionData();
+
+		const asCScriptFunction::ScriptFunctionData *from = src->scriptData;
+		asCScriptFunction::ScriptFunctionData *to = dst->scriptData;
+		to->byteCode           = from->byteCode;
+		to->variableSpace      = from->variableSpace;
+		copy.MapArray(to->objVariableTypes, from->objVariableTypes);
+		copy.MapArray(to->funcVariableTypes, from->funcVariableTypes);
+		to->objVariablePos     = from->objVariablePos;
+		to->objVariablesOnHeap = from->objVariablesOnHeap;
+		to->objVariableInfo    = from->objVariableInfo;
+		to->stackNeeded        = from->stackNeeded;
+		to->lineNumbers        = from->lineNumbers;
+		to->scriptSectionIdx   = from->scriptSectionIdx;
+		to->declaredAt         = from->declaredAt;
+		to->sectionIdxs        = from->sectionIdxs;
+
+		// Fix up the pointers in the bytecode. The clone has no JIT compiled code
+		asDWORD *bc = to->byteCode.AddressOf();
+		for( asUINT pos = 0; pos < to->byteCode.GetLength(); )
+		{
+			asEBCInstr op = asEBCInstr(*(asBYTE*)&bc[pos]);
+			if( op == asBC_OBJTYPE )
+				*(asPWORD*)&bc[pos+1] = asPWORD(copy.Map(reinterpret_cast<asCObjectType*>(*(asPWORD*)&bc[pos+1])));
+			else if( op == asBC_JitEntry )
+				*(asPWORD*)&bc[pos+1] = 0;
+			pos += asBCTypeSize[asBCInfo[op].type];
+		}
+	}
+
+	dst->dontCleanUpOnException = src->dontCleanUpOnException;
+	dst->vfTableIdx             = src->vfTableIdx;
+
+	if( src->sysFuncIntf )
+	{
+		dst->sysFuncIntf = asNEW(asSSystemFunctionInterface)(*src->sysFuncIntf);
+		for( n = 0; n < dst->sysFuncIntf->cleanArgs.GetLength(); n++ )
+			dst->sysFuncIntf->cleanArgs[n].ot = copy.Map(dst->sysFuncIntf->cleanArgs[n].ot);
+	}
+}
+
+static void CopyConfigGroup(const asCConfigGroup *src, asCConfigGroup *dst, const asSConfigCopy &copy)
+{
+	dst->groupName = src->groupName;
+	dst->refCount  = src->refCount;
+	copy.MapArray(dst->objTypes, src->objTypes);
+	copy.MapArray(dst->scriptFunctions, src->scriptFunctions);
+	copy.MapArray(dst->globalProps, src->globalProps);
+	copy.MapArray(dst->referencedConfigGroups, src->referencedConfigGroups);
+	copy.MapArray(dst->funcDefs, src->funcDefs);
+	copy.MapArray(dst->generatedTemplateInstances, src->generatedTemplateInstances);
+}
+
+// interface
+asIScriptEngine *asCScriptEngine::CloneConfiguration() const
+{
+	asCScriptEngine *clone = asNEW(asCScriptEngine);
+	if( clone == 0 )
+		return 0;
+
+	if( clone->CopyConfiguration(this) < 0 )
+	{
+		clone->ShutDownAndRelease();
+		return 0;
+	}
+
+	return clone;
+}
+
+// internal
+// Copies the registered interface of the source into this newly created engine. The source is
+// only read, so several threads can clone the same engine at the same time. The copies keep
+// the function ids, type ids, property ids and reference counts of the source, so the
+// teardown of the clone mirrors that of the source. The JIT compiler, the context callbacks
+// and the user data are not copied, though the user data cleanup callbacks are.
+int asCScriptEngine::CopyConfiguration(const asCScriptEngine *source)
+{
+	asUINT n;
+
+	// Only the registered interface can be copied. Anything compiled or loaded
+	// refers to modules and string constants that belong to the source
+	if( source->scriptModules.GetLength() || source->discardedModules.GetLength() ||
+		source->sharedScriptTypes.GetLength() || source->stringConstants.GetLength() )
+		return asNOT_SUPPORTED;
+
+	for( n = 0; n < source->scriptFunctions.GetLength(); n++ )
+	{
+		const asCScriptFunction *func = source->scriptFunctions[n];
+		if( func && (func->module || (func->scriptData && !IsCopyableStub(func))) )
+			return asNOT_SUPPORTED;
+	}
+
+	for( n = 0; n < source->globalProperties.GetLength(); n++ )
+	{
+		const asCGlobalProperty *prop = source->globalProperties[n];
+		if( prop && (prop->GetRegisteredAddress() == 0 || prop->initFunc) )
+			return asNOT_SUPPORTED;
+	}
+
+	// The constructor registered the built-in functions with the same ids as in the source
+	asUINT builtinFuncs = scriptFunctions.GetLength();
+	asASSERT( source->scriptFunctions.GetLength() >= builtinFuncs );
+
+	ep                      = source->ep;
+	initialContextStackSize = source->initialContextStackSize;
+	defaultAccessMask       = source->defaultAccessMask;
+	configFailed            = source->configFailed;
+	isPrepared              = source->isPrepared;
+
+	msgCallback     = source->msgCallback;
+	msgCallbackFunc = source->msgCallbackFunc;
+	msgCallbackObj  = source->msgCallbackObj;
+
+	cleanEngineFuncs       = source->cleanEngineFuncs;
+	cleanModuleFuncs       = source->cleanModuleFuncs;
+	cleanContextFuncs      = source->cleanContextFuncs;
+	cleanFunctionFuncs     = source->cleanFunctionFuncs;
+	cleanObjectTypeFuncs   = source->cleanObjectTypeFuncs;
+	cleanScriptObjectFuncs = source->cleanScriptObjectFuncs;
+
+	// Parsing the declarations names a script section too
+	for( n = 0; n < source->scriptSectionNames.GetLength(); n++ )
+		scriptSectionNames.PushLast(asNEW(asCString)(*source->scriptSectionNames[n]));
+
+	asSConfigCopy copy(this);
+
+	// The global namespace was created by the constructor
+	copy.nameSpaces.Insert(source->nameSpaces[0], nameSpaces[0]);
+	for( n = 1; n < source->nameSpaces.GetLength(); n++ )
+		copy.nameSpaces.Insert(source->nameSpaces[n], AddNameSpace(source->nameSpaces[n]->name.AddressOf()));
+	defaultNamespace = copy.Map(source->defaultNamespace);
+
+	// Find every object type the configuration refers to before copying anything,
+	// so that all references can be mapped while copying
+	copy.types.Insert(&source->scriptTypeBehaviours, &scriptTypeBehaviours);
+	copy.types.Insert(&source->functionBehaviours, &functionBehaviours);
+
+	AddTypesToCopy(copy, source->registeredObjTypes);
+	AddTypesToCopy(copy, source->registeredTypeDefs);
+	AddTypesToCopy(copy, source->registeredEnums);
+	AddTypesToCopy(copy, source->registeredTemplateTypes);
+	AddTypesToCopy(copy, source->templateSubTypes);
+	AddTypesToCopy(copy, source->templateInstanceTypes);
+	AddTypesToCopy(copy, source->generatedTemplateTypes);
+	AddTypesToCopy(copy, source->listPatternTypes);
+	AddTypeToCopy(copy, source->defaultArrayObjectType);
+
+	for( n = 0; n < source->scriptFunctions.GetLength(); n++ )
+	{
+		const asCScriptFunction *func = source->scriptFunctions[n];
+		if( func == 0 )
+			continue;
+
+		AddTypeToCopy(copy, func->objectType);
+		AddTypeToCopy(copy, func->returnType.GetObjectType());
+		for( asUINT p = 0; p < func->parameterTypes.GetLength(); p++ )
+			AddTypeToCopy(copy, func->parameterTypes[p].GetObjectType());
+		for( asSListPatternNode *node = func->listPattern; node; node = node->next )
+			if( node->type == asLPT_TYPE )
+				AddTypeToCopy(copy, reinterpret_cast<asSListPatternDataTypeNode*>(node)->dataType.GetObjectType());
+		if( func->scriptData )
+			AddTypesToCopy(copy, func->scriptData->objVariableTypes);
+		if( func->sysFuncIntf )
+			for( asUINT a = 0; a < func->sysFuncIntf->cleanArgs.GetLength(); a++ )
+				AddTypeToCopy(copy, func->sysFuncIntf->cleanArgs[a].ot);
+	}
+
+	for( n = 0; n < source->globalProperties.GetLength(); n++ )
+		if( source->globalProperties[n] )
+			AddTypeToCopy(copy, source->globalProperties[n]->type.GetObjectType());
+
+	// The list grows while the types are searched for further references
+	for( n = 0; n < copy.typeOrder.GetLength(); n++ )
+	{
+		const asCObjectType *type = copy.typeOrder[n];
+		for( asUINT p = 0; p < type->properties.GetLength(); p++ )
+			AddTypeToCopy(copy, type->properties[p]->type.GetObjectType());
+		for( asUINT s = 0; s < type->templateSubTypes.GetLength(); s++ )
+			AddTypeToCopy(copy, type->templateSubTypes[s].GetObjectType());
+		AddTypesToCopy(copy, type->interfaces);
+		AddTypeToCopy(copy, type->derivedFrom);
+	}
+
+	for( n = 0; n < copy.typeOrder.GetLength(); n++ )
+		copy.types.GetValue(copy.types.GetFirst(copy.typeOrder[n])) = asNEWPOOLED(memoryMgr, asPOOL_OBJECT_TYPE, asCObjectType)(this);
+
+	// Create the functions with the same ids before filling in anything that refers to them
+	scriptFunctions.SetLength(source->scriptFunctions.GetLength());
+	for( n = builtinFuncs; n < source->scriptFunctions.GetLength(); n++ )
+		scriptFunctions[n] = source->scriptFunctions[n] ? asNEWPOOLED(memoryMgr, asPOOL_SCRIPT_FUNCTION, asCScriptFunction)(this, 0, asFUNC_DUMMY) : 0;
+	freeScriptFunctionIds = source->freeScriptFunctionIds;
+
+	for( n = 0; n < copy.typeOrder.GetLength(); n++ )
+		CopyObjectType(copy.typeOrder[n], copy.Map(copy.typeOrder[n]), copy);
+
+	for( n = builtinFuncs; n < source->scriptFunctions.GetLength(); n++ )
+		if( source->scriptFunctions[n] )
+			CopyScriptFunction(source->scriptFunctions[n], scriptFunctions[n], copy);
+
+	// The reference counts are copied for the built-in types and functions too, as the
+	// registered interface may refer to them
+	for( n = 0; n < copy.types.GetCount(); n++ )
+	{
+		const asCObjectType *from = copy.types.GetKey(n);
+		asCObjectType *to = copy.types.GetValue(n);
+		to->typeId = from->typeId;
+		to->externalRefCount.set(from->externalRefCount.get());
+		to->internalRefCount.set(from->internalRefCount.get());
+	}
+
+	for( n = 1; n < source->scriptFunctions.GetLength(); n++ )
+	{
+		const asCScriptFunction *from = source->scriptFunctions[n];
+		if( from == 0 )
+			continue;
+
+		asASSERT( n >= builtinFuncs || from->name == scriptFunctions[n]->name );
+		scriptFunctions[n]->externalRefCount.set(from->externalRefCount.get());
+		scriptFunctions[n]->internalRefCount.set(from->internalRefCount.get());
+	}
+
+	// Global properties
+	globalProperties.SetLength(source->globalProperties.GetLength());
+	for( n = 0; n < source->globalProperties.GetLength(); n++ )
+	{
+		const asCGlobalProperty *from = source->globalProperties[n];
+		if( from == 0 )
+		{
+			globalProperties[n] = 0;
+			continue;
+		}
+
+		asCGlobalProperty *prop = asNEWPOOLED(memoryMgr, asPOOL_GLOBAL_PROPERTY, asCGlobalProperty);
+		prop->name       = from->name;
+		prop->type       = copy.Map(from->type);
+		prop->id         = from->id;
+		prop->nameSpace  = copy.Map(from->nameSpace);
+		prop->accessMask = from->accessMask;
+		prop->SetRegisteredAddress(from->GetRegisteredAddress());
+		prop->refCount.set(from->refCount.get());
+
+		globalProperties[n] = prop;
+		varAddressMap.Insert(prop->GetAddressOfValue(), prop);
+	}
+	freeGlobalPropertyIds = source->freeGlobalPropertyIds;
+
+	asCSymbolTable<asCGlobalProperty>::const_iterator propIt = source->registeredGlobalProps.List();
+	for( ; propIt; propIt++ )
+		registeredGlobalProps.Put(copy.Map(*propIt));
+
+	// The built-in delegate factory is the first of the global functions in both engines
+	registeredGlobalFuncs.Clear();
+	asCSymbolTable<asCScriptFunction>::const_iterator funcIt = source->registeredGlobalFuncs.List();
+	for( ; funcIt; funcIt++ )
+		registeredGlobalFuncs.Put(copy.Map(*funcIt));
+
+	// Registered interface
+	copy.MapArray(registeredObjTypes, source->registeredObjTypes);
+	copy.MapArray(registeredTypeDefs, source->registeredTypeDefs);
+	copy.MapArray(registeredEnums, source->registeredEnums);
+	copy.MapArray(registeredFuncDefs, source->registeredFuncDefs);
+	copy.MapArray(registeredTemplateTypes, source->registeredTemplateTypes);
+	copy.MapArray(templateSubTypes, source->templateSubTypes);
+	copy.MapArray(templateInstanceTypes, source->templateInstanceTypes);
+	copy.MapArray(generatedTemplateTypes, source->generatedTemplateTypes);
+	copy.MapArray(listPatternTypes, source->listPatternTypes);
+	copy.MapArray(funcDefs, source->funcDefs);
+	copy.MapArray(signatureIds, source->signatureIds);
+	defaultArrayObjectType = copy.Map(source->defaultArrayObjectType);
+	stringFactory          = copy.Map(source->stringFactory);
+
+	registeredFuncDefIndex.EraseAll();
+	for( n = 0; n < source->registeredFuncDefIndex.GetCount(); n++ )
+		registeredFuncDefIndex.Insert(source->registeredFuncDefIndex.GetKey(n), copy.Map(source->registeredFuncDefIndex.GetValue(n)));
+
+	allRegisteredTypes.EraseAll();
+	for( n = 0; n < source->allRegisteredTypes.GetCount(); n++ )
+	{
+		const asSNameSpaceNamePair &key = source->allRegisteredTypes.GetKey(n);
+		allRegisteredTypes.Insert(asSNameSpaceNamePair(copy.Map(key.ns), key.name), copy.Map(source->allRegisteredTypes.GetValue(n)));
+	}
+
+	// Type ids
+	typeIdSeqNbr = source->typeIdSeqNbr;
+	mapTypeIdToObjectType.EraseAll();
+	mapTypeIdToFunction.EraseAll();
+
+	asSMapNode<int, asCObjectType*> *typeCursor = 0;
+	source->mapTypeIdToObjectType.MoveFirst(&typeCursor);
+	for( ; typeCursor; source->mapTypeIdToObjectType.MoveNext(&typeCursor, typeCursor) )
+		mapTypeIdToObjectType.Insert(source->mapTypeIdToObjectType.GetKey(typeCursor), copy.Map(source->mapTypeIdToObjectType.GetValue(typeCursor)));
+
+	asSMapNode<int, asCScriptFunction*> *funcCursor = 0;
+	source->mapTypeIdToFunction.MoveFirst(&funcCursor);
+	for( ; funcCursor; source->mapTypeIdToFunction.MoveNext(&funcCursor, funcCursor) )
+		mapTypeIdToFunction.Insert(source->mapTypeIdToFunction.GetKey(funcCursor), copy.Map(source->mapTypeIdToFunction.GetValue(funcCursor)));
+
+	// Configuration groups
+	copy.groups.Insert(&source->defaultGroup, &defaultGroup);
+	configGroups.SetLength(source->configGroups.GetLength());
+	for( n = 0; n < source->configGroups.GetLength(); n++ )
+	{
+		configGroups[n] = source->configGroups[n] ? asNEW(asCConfigGroup)() : 0;
+		copy.groups.Insert(source->configGroups[n], configGroups[n]);
+	}
+
+	CopyConfigGroup(&source->defaultGroup, &defaultGroup, copy);
+	for( n = 0; n < configGroups.GetLength(); n++ )
+		if( configGroups[n] )
+			CopyConfigGroup(source->configGroups[n], configGroups[n], copy);
+	currentGroup = copy.Map(source->currentGroup);
+
+	return asSUCCESS;
+}
+
 asCConfigGroup *asCScriptEngine::FindConfigGroupForFunction(int funcId) const
 {
 	for( asUINT n = 0; n < configGroups.GetLength(); n++ )
@@ -5458,7 +6668,7 @@ int asCScriptEngine::RegisterFuncdef(const char *decl)
 	if( decl == 0 ) return ConfigError(asINVALID_ARG, "RegisterFuncdef", decl, 0);
 
 	// Parse the function declaration
-	asCScriptFunction *func = asNEW(asCScriptFunction)(this, 0, asFUNC_FUNCDEF);
+	asCScriptFunction *func = asNEWPOOLED(memoryMgr, asPOOL_SCRIPT_FUNCTION, asCScriptFunction)(this, 0, asFUNC_FUNCDEF);
 	if( func == 0 )
 		return ConfigError(asOUT_OF_MEMORY, "RegisterFuncdef", decl, 0);
 
@@ -5468,7 +6678,7 @@ int asCScriptEngine::RegisterFuncdef(const char *decl)
 	{
 		// Set as dummy function before deleting
 		func->funcType = asFUNC_DUMMY;
-		asDELETE(func,asCScriptFunction);
+		asDELETEPOOLED(func,asCScriptFunction);
 		return ConfigError(asINVALID_DECLARATION, "RegisterFuncdef", decl, 0);
 	}
 
@@ -5476,7 +6686,7 @@ int asCScriptEngine::RegisterFuncdef(const char *decl)
 	r = bld.CheckNameConflict(func->name.AddressOf(), 0, 0, defaultNamespace);
 	if( r < 0 )
 	{
-		asDELETE(func,asCScriptFunction);
+		asDELETEPOOLED(func,asCScriptFunction);
 		return ConfigError(asNAME_TAKEN, "RegisterFuncdef", decl, 0);
 	}
 
@@ -5486,6 +6696,7 @@ int asCScriptEngine::RegisterFuncdef(const char *decl)
 	funcDefs.PushLast(func);
 	func->AddRefInternal();
 	registeredFuncDefs.PushLast(func);
+	registeredFuncDefIndex.Insert(func->name, func);
 	currentGroup->funcDefs.PushLast(func);
 
 	// If parameter type from other groups are used, add references
@@ -5568,7 +6779,7 @@ int asCScriptEngine::RegisterTypedef(const char *type, const char *decl)
 	// types as they are allowed to use the names
 
 	// Put the data type in the list
-	asCObjectType *object = asNEW(asCObjectType)(this);
+	asCObjectType *object = asNEWPOOLED(memoryMgr, asPOOL_OBJECT_TYPE, asCObjectType)(this);
 	if( object == 0 )
 		return ConfigError(asOUT_OF_MEMORY, "RegisterTypedef", type, decl);
 
@@ -5654,7 +6865,7 @@ int asCScriptEngine::RegisterEnum(const char *name)
 	if( r < 0 )
 		return ConfigError(asNAME_TAKEN, "RegisterEnum", name, 0);
 
-	asCObjectType *st = asNEW(asCObjectType)(this);
+	asCObjectType *st = asNEWPOOLED(memoryMgr, asPOOL_OBJECT_TYPE, asCObjectType)(this);
 	if( st == 0 )
 		return ConfigError(asOUT_OF_MEMORY, "RegisterEnum", name, 0);
 
@@ -6083,7 +7294,7 @@ asCObjectType *asCScriptEngine::GetListPatternType(int listPatternFuncId)
 	}
 
 	// Create a new list pattern type for the given object type
-	asCObjectType *lpt = asNEW(asCObjectType)(this);
+	asCObjectType *lpt = asNEWPOOLED(memoryMgr, asPOOL_OBJECT_TYPE, asCObjectType)(this);
 	lpt->templateSubTypes.PushLast(asCDataType::CreateObject(ot, false));
 	lpt->flags = asOBJ_LIST_PATTERN;
 	listPatternTypes.PushLast(lpt);
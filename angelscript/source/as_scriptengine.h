@@ -71,6 +71,7 @@ public:
 	virtual int AddRef() const;
 	virtual int Release() const;
 	virtual int ShutDownAndRelease();
+	virtual int EnumerateMemoryPools(asMEMORYPOOLCALLBACK_t callback, void *param) const;
 
 	// Engine properties
 	virtual int     SetEngineProperty(asEEngineProp property, asPWORD value);
@@ -87,12 +88,14 @@ public:
 
 	// Global functions
 	virtual int                RegisterGlobalFunction(const char *declaration, const asSFuncPtr &funcPointer, asDWORD callConv, void *objForThiscall = 0);
+	virtual int                RegisterGlobalFunctions(const asSFuncRegistration *registrations, asUINT count, int *outResults = 0);
 	virtual asUINT             GetGlobalFunctionCount() const;
 	virtual asIScriptFunction *GetGlobalFunctionByIndex(asUINT index) const;
 	virtual asIScriptFunction *GetGlobalFunctionByDecl(const char *declaration) const;
 
 	// Global properties
 	virtual int    RegisterGlobalProperty(const char *declaration, void *pointer);
+	virtual int    RegisterGlobalProperties(const asSPropRegistration *registrations, asUINT count, int *outResults = 0);
 	virtual asUINT GetGlobalPropertyCount() const;
 	virtual int    GetGlobalPropertyByIndex(asUINT index, const char **name, const char **nameSpace = 0, int *typeId = 0, bool *isConst = 0, const char **configGroup = 0, void **pointer = 0, asDWORD *accessMask = 0) const;
 	virtual int    GetGlobalPropertyIndexByName(const char *name) const;
@@ -102,6 +105,7 @@ public:
 	virtual int            RegisterObjectType(const char *obj, int byteSize, asDWORD flags);
 	virtual int            RegisterObjectProperty(const char *obj, const char *declaration, int byteOffset);
 	virtual int            RegisterObjectMethod(const char *obj, const char *declaration, const asSFuncPtr &funcPointer, asDWORD callConv, void *objForThiscall = 0);
+	virtual int            RegisterObjectMethods(const char *obj, const asSFuncRegistration *registrations, asUINT count, int *outResults = 0);
 	virtual int            RegisterObjectBehaviour(const char *obj, asEBehaviours behaviour, const char *declaration, const asSFuncPtr &funcPointer, asDWORD callConv, void *objForThiscall = 0);
 	virtual int            RegisterInterface(const char *name);
 	virtual int            RegisterInterfaceMethod(const char *intf, const char *declaration);
@@ -144,6 +148,7 @@ public:
 	virtual asDWORD     SetDefaultAccessMask(asDWORD defaultMask);
 	virtual int         SetDefaultNamespace(const char *nameSpace);
 	virtual const char *GetDefaultNamespace() const;
+	virtual asIScriptEngine *CloneConfiguration() const;
 
 	// Script modules
 	virtual asIScriptModule *GetModule(const char *module, asEGMFlags flag);
@@ -182,6 +187,15 @@ public:
 	virtual void              ReturnContext(asIScriptContext *ctx);
 	virtual int               SetContextCallbacks(asREQUESTCONTEXTFUNC_t requestCtx, asRETURNCONTEXTFUNC_t returnCtx, void *param = 0);
 
+	// Sampling of the executing scripts
+	virtual int               SetSampleCallback(asSAMPLECALLBACK_t callback, void *param = 0);
+	virtual void              RequestSample();
+
+	// Executed instructions
+	virtual int               EnumerateOpcodeStats(asOPCODESTATSCALLBACK_t callback, void *param = 0) const;
+	virtual int               GetOpcodePairStats(asQWORD *counts) const;
+	virtual int               ResetOpcodeStats();
+
 	// String interpretation
 	virtual asETokenClass ParseToken(const char *string, size_t stringLength = 0, asUINT *tokenLength = 0) const;
 
@@ -220,6 +234,12 @@ public:
 	friend int PrepareSystemFunction(asCScriptFunction *func, asSSystemFunctionInterface *internal, asCScriptEngine *engine);
 
 	int RegisterMethodToObjectType(asCObjectType *objectType, const char *declaration, const asSFuncPtr &funcPointer, asDWORD callConv, void *objForThiscall = 0);
+	int GetObjectTypeForMethods(asCBuilder &bld, const char *obj, asCObjectType **outType);
+	int ParseSystemFunction(asCBuilder &bld, asCObjectType *objectType, const char *declaration, const asSFuncPtr &funcPointer, asDWORD callConv, void *objForThiscall, asCScriptFunction **outFunc);
+	int AddSystemMethod(asCScriptFunction *func);
+	int AddSystemGlobalFunction(asCScriptFunction *func);
+	void DiscardSystemFunction(asCScriptFunction *func);
+	int RegisterGlobalPropertyWithBuilder(asCBuilder &bld, const char *declaration, void *pointer);
 	int RegisterBehaviourToObjectType(asCObjectType *objectType, asEBehaviours behaviour, const char *decl, const asSFuncPtr &funcPointer, asDWORD callConv, void *objForThiscall);
 
 	int VerifyVarTypeNotInFunction(asCScriptFunction *func);
@@ -249,6 +269,8 @@ public:
 	void RemoveTemplateInstanceType(asCObjectType *t);
 	void RemoveTypeAndRelatedFromList(asCMap<asCObjectType*,char> &types, asCObjectType *ot);
 
+	int CopyConfiguration(const asCScriptEngine *source);
+
 	asCConfigGroup *FindConfigGroupForFunction(int funcId) const;
 	asCConfigGroup *FindConfigGroupForGlobalVar(int gvarId) const;
 	asCConfigGroup *FindConfigGroupForObjectType(const asCObjectType *type) const;
@@ -302,6 +324,15 @@ public:
 	asCModule         *FindNewOwnerForSharedType(asCObjectType *type, asCModule *mod);
 	asCModule         *FindNewOwnerForSharedFunc(asCScriptFunction *func, asCModule *mod);
 
+	// Context pooling
+	asSContextPool    *GetContextPool();
+	void               ReleasePoolContexts(asSContextPool *pool);
+	void               ReleasePooledContexts();
+
+	// Sampling
+	void               AddSampledContext(asCContext *ctx);
+	void               RemoveSampledContext(asCContext *ctx);
+
 	// String constants
 	// TODO: Must free unused string constants, thus the ref count for each must be tracked
 	int              AddConstantString(const char *str, size_t length);
@@ -336,12 +367,13 @@ public:
 	asCSymbolTable<asCGlobalProperty> registeredGlobalProps; // increases ref count // TODO: memory savings: Since there can be only one property with the same name a simpler symbol table should be used
 	asCSymbolTable<asCScriptFunction> registeredGlobalFuncs;
 	asCArray<asCScriptFunction *>     registeredFuncDefs;
+	asCHashMap<asCString, asCScriptFunction*> registeredFuncDefIndex; // by name, for the builder
 	asCArray<asCObjectType *>         registeredTemplateTypes;
 	asCScriptFunction                *stringFactory;
 	bool configFailed;
 
 	// Stores all registered types except funcdefs
-	asCMap<asSNameSpaceNamePair, asCObjectType*> allRegisteredTypes; // increases ref count
+	asCHashMap<asSNameSpaceNamePair, asCObjectType*> allRegisteredTypes; // increases ref count
 
 	// Dummy types used to name the subtypes in the template objects 
 	asCArray<asCObjectType *>      templateSubTypes;
@@ -444,6 +476,7 @@ public:
 	// These are shared between all entities and are 
 	// only deleted once the engine is destroyed
 	asCArray<asSNameSpace*> nameSpaces;
+	asCHashMap<asCString, asSNameSpace*> nameSpaceIndex;
 
 	// String constants
 	// These are shared between all scripts and are
@@ -456,6 +489,30 @@ public:
 	asRETURNCONTEXTFUNC_t   returnCtxFunc;
 	void                   *ctxCallbackParam;
 
+	// The contexts kept by RequestContext and ReturnContext when no callbacks are set, one
+	// pool per thread. Each thread remembers its pools by the engine's serial number, which
+	// unlike the engine's address is never reused, so the lock is only taken the first time.
+	// The pooled contexts don't hold a reference to the engine, and their number is capped
+	// for all threads together, as threads that end without asThreadCleanup never let go
+	asCArray<asSContextPool*> contextPools;
+	asCAtomic                 pooledContexts;
+	asUINT                    serial;
+	DECLARECRITICALSECTION(contextPoolCritical)
+
+	// While a sample callback is set, the contexts add themselves to the list when they
+	// start executing, and stay there until destroyed. RequestSample flags the ones that
+	// are executing to call the callback at the next statement, on their own thread
+	asSAMPLECALLBACK_t    sampleCallback;
+	void                 *sampleCallbackParam;
+	asCArray<asCContext*> sampledContexts;
+	DECLARECRITICALSECTION(sampleCritical)
+
+#ifdef AS_OPCODE_STATS
+	// How often each instruction was directly followed by another in the same function,
+	// indexed by first * 256 + second. The counts per function are in its script data
+	asCArray<asQWORD> opcodePairs;
+#endif
+
 	// User data
 	asCArray<asPWORD>       userData;
 
@@ -504,6 +561,9 @@ public:
 		bool   disallowEmptyListElements;
 		// TODO: 3.0.0: Remove the privatePropAsProtected
 		bool   privatePropAsProtected;
+		bool   lazyBytecodeTranslation;
+		asUINT gcPromotionAge;
+		asUINT maxPooledContexts;
 	} ep;
 
 	// This flag is to allow a quicker shutdown when releasing the engine
@@ -47,6 +47,7 @@
 #include "as_scriptnode.h"
 #include "as_builder.h"
 #include "as_scriptcode.h"
+#include "as_restore.h"
 
 #include <cstdlib> // qsort
 
@@ -177,7 +178,8 @@ asCScriptFunction *CreateDelegate(asCScriptFunction *func, void *obj)
 
 	// Create an instance of a asCScriptFunction with the type asFUNC_DELEGATE
 	// The delegate shouldn't have a function id and is not added to the engine->scriptFunctions
-	asCScriptFunction *delegate = asNEW(asCScriptFunction)(static_cast<asCScriptEngine*>(func->GetEngine()), 0, asFUNC_DELEGATE);
+	asCScriptEngine *engine = static_cast<asCScriptEngine*>(func->GetEngine());
+	asCScriptFunction *delegate = asNEWPOOLED(engine->memoryMgr, asPOOL_SCRIPT_FUNCTION, asCScriptFunction)(engine, 0, asFUNC_DELEGATE);
 	if( delegate )
 		delegate->MakeDelegate(func, obj);
 
@@ -388,6 +390,13 @@ void asCScriptFunction::AllocateScriptFunctionData()
 	scriptData->scriptSectionIdx = -1;
 	scriptData->declaredAt       = 0;
 	scriptData->jitFunction      = 0;
+	scriptData->translationPending.set(false);
+#ifdef AS_OPCODE_STATS
+	memset(scriptData->opcodeCounts, 0, sizeof(scriptData->opcodeCounts));
+#ifdef AS_OPCODE_CYCLES
+	memset(scriptData->opcodeCycles, 0, sizeof(scriptData->opcodeCycles));
+#endif
+#endif
 }
 
 void asCScriptFunction::DeallocateScriptFunctionData()
@@ -439,7 +448,7 @@ void asCScriptFunction::DestroyHalfCreated()
 	if( scriptData )
 		scriptData->byteCode.SetLength(0);
 
-	asDELETE(this, asCScriptFunction);
+	asDELETEPOOLED(this, asCScriptFunction);
 }
 
 // internal
@@ -517,7 +526,7 @@ int asCScriptFunction::Release() const
 			// For example if the function was dynamically compiled without adding it to the scope of the module
 			asASSERT( module == 0 );
 
-			asDELETE(const_cast<asCScriptFunction*>(this),asCScriptFunction);
+			asDELETEPOOLED(const_cast<asCScriptFunction*>(this),asCScriptFunction);
 		}
 	}
 
@@ -541,7 +550,7 @@ int asCScriptFunction::ReleaseInternal()
 		// external references then it is time to delete the function
 		if( externalRefCount.get() == 0 )
 		{
-			asDELETE(const_cast<asCScriptFunction*>(this),asCScriptFunction);
+			asDELETEPOOLED(const_cast<asCScriptFunction*>(this),asCScriptFunction);
 		}
 	}
 
@@ -1523,11 +1532,32 @@ void asCScriptFunction::JITCompile()
 		asASSERT( scriptData->jitFunction == 0 );
 }
 
+// internal
+int asCScriptFunction::TranslatePendingByteCode()
+{
+	if( scriptData == 0 || !scriptData->translationPending.get() )
+		return asSUCCESS;
+
+	// The module keeps the reader until all its functions have been translated.
+	// Without it the function was never called before the module was discarded.
+	if( module == 0 || module->pendingReader == 0 )
+		return asERROR;
+
+	return module->pendingReader->TranslatePending(this);
+}
+
 // interface
 asDWORD *asCScriptFunction::GetByteCode(asUINT *length)
 {
 	if( scriptData == 0 ) return 0;
 
+	if( TranslatePendingByteCode() < 0 )
+	{
+		if( length )
+			*length = 0;
+		return 0;
+	}
+
 	if( length )
 		*length = (asUINT)scriptData->byteCode.GetLength();
 
@@ -221,6 +221,9 @@ public:
 
 	void      JITCompile();
 
+	// Translates bytecode that was loaded with asEP_LAZY_BYTECODE_TRANSLATION on its first use
+	int       TranslatePendingByteCode();
+
 	void      AddReferences();
 	void      ReleaseReferences();
 
@@ -316,6 +319,16 @@ public:
 		int                             declaredAt;
 		// Store position/index pairs if the bytecode is compiled from multiple script sections
 		asCArray<int>                   sectionIdxs;
+		// The bytecode is loaded but not yet translated, see asEP_LAZY_BYTECODE_TRANSLATION
+		asCAtomicFlag                   translationPending;
+#ifdef AS_OPCODE_STATS
+		// The number of times each instruction has been executed
+		asQWORD                         opcodeCounts[256];
+#ifdef AS_OPCODE_CYCLES
+		// The time stamp counter cycles from the start of each instruction to the start of the next one
+		asQWORD                         opcodeCycles[256];
+#endif
+#endif
 	};
 	ScriptFunctionData          *scriptData;
 
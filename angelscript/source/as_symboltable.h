@@ -44,7 +44,7 @@
 #include "as_config.h"
 #include "as_memory.h"
 #include "as_string.h"
-#include "as_map.h"
+#include "as_hashmap.h"
 #include "as_datatype.h"
 #include "as_namespace.h"
 
@@ -53,6 +53,14 @@ BEGIN_AS_NAMESPACE
 
 
 
+// Key hash for the lookup map
+inline asUINT asHashValue(const asSNameSpaceNamePair &key)
+{
+	return asHashValue(key.name) * 31 + asHashValue((const void*)key.ns);
+}
+
+
+
 
 
 // Interface to avoid nested templates which is not well supported by older compilers, e.g. MSVC6
@@ -100,7 +108,7 @@ private:
 
 // Symbol table mapping namespace + name to symbols
 // The structure keeps the entries indexed in an array so the indices will not change
-// There is also a map for a quick lookup. The map supports multiple entries with the same name
+// There is also a hash map for a quick lookup, with the indices of all entries with the same name
 template<class T>
 class asCSymbolTable
 {
@@ -149,9 +157,9 @@ private:
 	void GetKey(const T *entry, asSNameSpaceNamePair &key) const;
 	bool CheckIdx(asUINT idx) const;
 
-	asCMap<asSNameSpaceNamePair, asCArray<asUINT> > m_map;
-	asCArray<T*>                                    m_entries;
-	unsigned int                                    m_size;
+	asCHashMap<asSNameSpaceNamePair, asCArray<asUINT> > m_map;
+	asCArray<T*>                                        m_entries;
+	unsigned int                                        m_size;
 };
 
 
@@ -189,8 +197,8 @@ int asCSymbolTable<T>::GetFirstIndex(
 {
 	asSNameSpaceNamePair key(ns, name);
 
-	asSMapNode<asSNameSpaceNamePair, asCArray<asUINT> > *cursor;
-	if( m_map.MoveTo(&cursor, key) )
+	int cursor = m_map.GetFirst(key);
+	if( cursor >= 0 )
 	{
 		const asCArray<asUINT> &arr = m_map.GetValue(cursor);
 		for( asUINT n = 0; n < arr.GetLength(); n++ )
@@ -211,8 +219,8 @@ const asCArray<asUINT> &asCSymbolTable<T>::GetIndexes(const asSNameSpace *ns, co
 {
 	asSNameSpaceNamePair key(ns, name);
 
-	asSMapNode<asSNameSpaceNamePair, asCArray<asUINT> > *cursor;
-	if( m_map.MoveTo(&cursor, key) )
+	int cursor = m_map.GetFirst(key);
+	if( cursor >= 0 )
 		return m_map.GetValue(cursor);
 
 	static asCArray<asUINT> dummy;
@@ -238,8 +246,8 @@ int asCSymbolTable<T>::GetFirstIndex(const asSNameSpace *ns, const asCString &na
 {
 	asSNameSpaceNamePair key(ns, name);
 
-	asSMapNode<asSNameSpaceNamePair, asCArray<asUINT> > *cursor;
-	if( m_map.MoveTo(&cursor, key) )
+	int cursor = m_map.GetFirst(key);
+	if( cursor >= 0 )
 		return m_map.GetValue(cursor)[0];
 
 	return -1;
@@ -360,8 +368,8 @@ bool asCSymbolTable<T>::Erase(asUINT idx)
 	asSNameSpaceNamePair key;
 	GetKey(entry, key);
 
-	asSMapNode<asSNameSpaceNamePair, asCArray<asUINT> > *cursor;
-	if( m_map.MoveTo(&cursor, key) )
+	int cursor = m_map.GetFirst(key);
+	if( cursor >= 0 )
 	{
 		asCArray<asUINT> &arr = m_map.GetValue(cursor);
 		arr.RemoveValue(idx);
@@ -383,7 +391,8 @@ bool asCSymbolTable<T>::Erase(asUINT idx)
 		// Update the index in the lookup map
 		entry = m_entries[idx];
 		GetKey(entry, key);
-		if( m_map.MoveTo(&cursor, key) )
+		cursor = m_map.GetFirst(key);
+		if( cursor >= 0 )
 		{
 			asCArray<asUINT> &arr = m_map.GetValue(cursor);
 			arr[arr.IndexOf(prevIdx)] = idx;
@@ -406,8 +415,8 @@ asUINT asCSymbolTable<T>::Put(T *entry)
 	asSNameSpaceNamePair key;
 	GetKey(entry, key);
 
-	asSMapNode<asSNameSpaceNamePair, asCArray<asUINT> > *cursor;
-	if( m_map.MoveTo(&cursor, key) )
+	int cursor = m_map.GetFirst(key);
+	if( cursor >= 0 )
 		m_map.GetValue(cursor).PushLast(idx);
 	else
 	{
@@ -319,6 +319,14 @@ asCThreadLocalData::asCThreadLocalData()
 
 asCThreadLocalData::~asCThreadLocalData()
 {
+	for( asUINT n = 0; n < contextPools.GetLength(); n++ )
+		asReleaseContextPool(contextPools[n].pool);
+}
+
+void asReleaseContextPool(asSContextPool *pool)
+{
+	if( pool->refCount.atomicDec() == 0 )
+		asDELETE(pool, asSContextPool);
 }
 
 //=========================================================================
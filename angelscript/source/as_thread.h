@@ -44,6 +44,7 @@
 #include "as_array.h"
 #include "as_map.h"
 #include "as_criticalsection.h"
+#include "as_atomic.h"
 
 BEGIN_AS_NAMESPACE
 
@@ -89,6 +90,24 @@ protected:
 //======================================================================
 
 class asIScriptContext;
+class asCContext;
+
+// The contexts an engine keeps for one thread. The engine and the thread's list of
+// pools each hold a reference, so either can let go first. A pool only the engine
+// refers to is no longer used, and the engine releases its contexts
+struct asSContextPool
+{
+	asCArray<asCContext*> contexts;
+	asCAtomic             refCount;
+};
+
+void asReleaseContextPool(asSContextPool *pool);
+
+struct asSThreadContextPool
+{
+	asUINT          engineSerial;
+	asSContextPool *pool;
+};
 
 class asCThreadLocalData
 {
@@ -96,6 +115,9 @@ public:
 	asCArray<asIScriptContext *> activeContexts;
 	asCString string;
 
+	// The context pools of the engines this thread used most recently
+	asCArray<asSThreadContextPool> contextPools;
+
 protected:
 	friend class asCThreadManager;
 
@@ -0,0 +1,123 @@
+#include "arena_allocator.h"
+
+#include <angelscript.h>
+
+#include <atomic>
+#include <cstdint>
+#include <cstdlib>
+
+// Chunks are taken from malloc and never given back
+static const size_t cChunkSize = 1 << 20;
+
+// Same guarantee as malloc
+static const size_t cAlignment = alignof(std::max_align_t);
+
+// Blocks up to this size are recycled through per-thread free lists, one per multiple
+// of cAlignment. Larger ones go straight to malloc and free.
+static const size_t cMaxSmallBlock = 1024;
+static const size_t cSizeClasses = cMaxSmallBlock / cAlignment;
+
+// Every block starts with one of these, padded to keep the user pointer aligned
+union BlockHeader
+{
+	struct
+	{
+		size_t sizeClass;
+		BlockHeader *nextFree;
+	};
+	std::max_align_t alignment;
+};
+
+static const size_t cLargeBlock = ~size_t(0);
+
+namespace
+{
+	struct ArenaThread
+	{
+		uint8_t *next = nullptr;
+		uint8_t *end = nullptr;
+		BlockHeader *freeBlocks[cSizeClasses] = {};
+	};
+}
+
+// Every thread bumps through its own chunk and recycles into its own lists, so
+// allocating never takes a lock. A block freed on another thread than the one
+// that allocated it simply joins the freeing thread's list.
+static thread_local ArenaThread tArena;
+
+static std::atomic<size_t> sReserved{ 0 };
+static std::atomic<bool> sInstalled{ false };
+
+static void *arenaAlloc(size_t size)
+{
+	if (size > cMaxSmallBlock)
+	{
+		BlockHeader *block = static_cast<BlockHeader *>(std::malloc(sizeof(BlockHeader) + size));
+		if (!block)
+			return nullptr;
+		block->sizeClass = cLargeBlock;
+		return block + 1;
+	}
+
+	size_t sizeClass = size ? (size - 1) / cAlignment : 0;
+	ArenaThread &arena = tArena;
+
+	BlockHeader *block = arena.freeBlocks[sizeClass];
+	if (block)
+	{
+		arena.freeBlocks[sizeClass] = block->nextFree;
+		return block + 1;
+	}
+
+	size_t blockSize = sizeof(BlockHeader) + (sizeClass + 1) * cAlignment;
+	if (static_cast<size_t>(arena.end - arena.next) < blockSize)
+	{
+		// The rest of the old chunk is abandoned
+		uint8_t *chunk = static_cast<uint8_t *>(std::malloc(cChunkSize));
+		if (!chunk)
+			return nullptr;
+		sReserved += cChunkSize;
+		arena.next = chunk;
+		arena.end = chunk + cChunkSize;
+	}
+
+	block = reinterpret_cast<BlockHeader *>(arena.next);
+	block->sizeClass = sizeClass;
+	arena.next += blockSize;
+	return block + 1;
+}
+
+static void arenaFree(void *memory)
+{
+	if (!memory)
+		return;
+
+	BlockHeader *block = static_cast<BlockHeader *>(memory) - 1;
+	if (block->sizeClass == cLargeBlock)
+	{
+		std::free(block);
+		return;
+	}
+
+	ArenaThread &arena = tArena;
+	block->nextFree = arena.freeBlocks[block->sizeClass];
+	arena.freeBlocks[block->sizeClass] = block;
+}
+
+void installArenaAllocator()
+{
+	if (sInstalled.exchange(true))
+		return;
+
+	asSetGlobalMemoryFunctions(arenaAlloc, arenaFree);
+}
+
+bool isArenaAllocatorInstalled()
+{
+	return sInstalled;
+}
+
+size_t arenaBytesReserved()
+{
+	return sReserved;
+}
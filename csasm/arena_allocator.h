@@ -0,0 +1,18 @@
+#pragma once
+
+#include <cstddef>
+
+// Arena allocator for the AngelScript engine (--arena). Small blocks are bumped out
+// of large per-thread chunks and recycled through per-thread free lists, large ones
+// go to malloc. Chunks are only returned to the system when the process exits, which
+// suits a run-to-completion tool like csasm: allocating never takes a lock, and
+// engines don't have to be shut down at exit.
+//
+// Has to be installed before the first engine is created, and can't be removed again
+// since the engine would then hand arena memory to free().
+void installArenaAllocator();
+
+bool isArenaAllocatorInstalled();
+
+// Bytes of chunks taken from the system so far, over all threads
+size_t arenaBytesReserved();
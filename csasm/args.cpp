@@ -5,14 +5,100 @@
 
 static void print_help(const boost::program_options::options_description& description)
 {
-	std::cout << "Usage: csasm <data-root> <module>\n\n";
+	std::cout << "Usage: csasm <data-root> <module>\n"
+		"       csasm <data-root> --batch <folder|list> [-d <folder>] [-o <folder>] [-b <folder>] [--cache <folder>]\n"
+		"       csasm registry-compile [registry.json] [registry.bin]\n"
+		"       csasm scan <data-root> [index.json|index.bin] [folder|list]\n"
+		"       csasm opcode-pairs <data-root> [folder|list] [top]\n"
+		"       csasm bench <suite> [arguments]\n"
+		"The commands also take --timings.\n\n";
 	std::cout << "Required options:\n  data-root             The romfs folder. The scripts have to be decrypted.\n"
-		"  module                The relative path to the AngelScript.bin file.\n\n";
+		"  module                The relative path to the AngelScript.bin file. Not used in batch mode.\n\n";
 	std::cout << description << std::endl;
 }
 
-CommandlineArgs parseArgs(const int argc, char** argv)
+// The subcommands only take positional arguments, apart from --timings which is removed here
+static bool takeTimingsOption(int &argc, char **argv, std::string &timings)
 {
+	int kept = 1;
+	for (int i = 1; i < argc; ++i)
+	{
+		std::string arg = argv[i];
+		if (arg == "--timings")
+			timings = "table";
+		else if (arg.compare(0, 10, "--timings=") == 0)
+			timings = arg.substr(10);
+		else
+			argv[kept++] = argv[i];
+	}
+	argc = kept;
+
+	return timings.empty() || timings == "table" || timings == "json";
+}
+
+static CommandlineArgs parseSubcommand(const int argc, char** argv)
+{
+	if (argc >= 2 && std::string(argv[1]) == "registry-compile")
+	{
+		// Defaults to tok_as_registry.json and tok_as_registry.bin next to the executable
+		CommandlineArgs args = { true };
+		args.compileRegistry = true;
+		args.registryInput = argc >= 3 ? argv[2] : "";
+		args.registryOutput = argc >= 4 ? argv[3] : "";
+		return args;
+	}
+
+	if (argc >= 3 && std::string(argv[1]) == "scan")
+	{
+		// Scans the whole data root unless a folder or list is given
+		CommandlineArgs args = { true, argv[2] };
+		args.scan = true;
+		args.scanOutput = argc >= 4 ? argv[3] : "";
+		args.batchInput = argc >= 5 ? argv[4] : "";
+		return args;
+	}
+
+	if (argc >= 3 && std::string(argv[1]) == "opcode-pairs")
+	{
+		// Profiles the whole data root unless a folder or list is given
+		CommandlineArgs args = { true, argv[2] };
+		args.opcodePairs = true;
+		args.batchInput = argc >= 4 ? argv[3] : "";
+		args.opcodePairsTop = argc >= 5 ? std::stoul(argv[4]) : 40;
+		return args;
+	}
+
+	if (argc >= 3 && std::string(argv[1]) == "bench")
+	{
+		CommandlineArgs args = { true };
+		args.benchSuite = argv[2];
+		args.benchArguments.assign(argv + 3, argv + argc);
+		return args;
+	}
+
+	return { false };
+}
+
+CommandlineArgs parseArgs(int argc, char** argv)
+{
+	std::string command = argc >= 2 ? argv[1] : "";
+	if (command == "registry-compile" || command == "scan" || command == "opcode-pairs" || command == "bench")
+	{
+		std::string timings;
+		if (!takeTimingsOption(argc, argv, timings))
+		{
+			std::cerr << "Error: --timings must be table or json" << std::endl;
+			return { false };
+		}
+
+		CommandlineArgs args = parseSubcommand(argc, argv);
+		if (args.valid)
+		{
+			args.timings = timings;
+			return args;
+		}
+	}
+
 	using namespace boost::program_options;
 	using boost::program_options::value;
 
@@ -24,6 +110,14 @@ CommandlineArgs parseArgs(const int argc, char** argv)
 		("output,o", value<std::string>(), "the yaml output file. Less detailed than the dump but can be reassembled.")
 		("dump,d", value<std::string>(), "the dump output file. This is the default console output. Contains slightly more information than yaml but can't be reassembled.")
 		("bin,b", value<std::string>(), "the binary AngelScript output file.")
+		("batch", value<std::string>(), "disassemble every module in a folder (relative to data-root) or in a list file with one module per line. "
+			"-d, -o and -b then name output folders that mirror the module paths.")
+		("jobs,j", value<unsigned int>(), "the amount of worker threads: modules processed at once in batch mode, files read ahead while loading a single module. Defaults to the amount of hardware threads.")
+		("cache", value<std::string>(), "a folder to cache outputs in. Modules whose bytes, dependencies and registry are unchanged since the last run reuse their cached outputs.")
+		("arena", "allocate the engine's memory from large chunks that are never freed and skip shutting the engines down. Faster, but memory only grows while csasm runs.")
+		("function", value<std::string>(), "only disassemble the function with this declaration, as written in the dump, e.g. \"void main()\" or \"void Foo::bar(int)\". "
+			"The other functions of the module are loaded without being linked, so this is quicker on large modules.")
+		("timings", value<std::string>()->implicit_value("table"), "print how long each phase took when done, as a table or with --timings=json. Needs an AngelScript library built with AS_PROFILE.")
 		;
 
 	options_description hidden_options;
@@ -52,14 +146,50 @@ CommandlineArgs parseArgs(const int argc, char** argv)
 			return { false };
 		}
 
+		bool batch = map.count("batch") > 0;
+		if (!map.count("data-root") || (!batch && !map.count("module")))
+		{
+			std::cerr << "Error: missing " << (map.count("data-root") ? "module" : "data-root") << std::endl << std::endl;
+			print_help(visible_options);
+			return { false };
+		}
+
+		if (batch && !map.count("output") && !map.count("dump") && !map.count("bin"))
+		{
+			std::cerr << "Error: batch mode requires at least one of --dump, --output or --bin" << std::endl << std::endl;
+			print_help(visible_options);
+			return { false };
+		}
+
+		if (batch && map.count("function"))
+		{
+			std::cerr << "Error: --function can't be used in batch mode" << std::endl << std::endl;
+			print_help(visible_options);
+			return { false };
+		}
+
+		std::string timings = map.count("timings") ? map["timings"].as<std::string>() : "";
+		if (!timings.empty() && timings != "table" && timings != "json")
+		{
+			std::cerr << "Error: --timings must be table or json" << std::endl << std::endl;
+			print_help(visible_options);
+			return { false };
+		}
+
 		return {
 			true,
 			map["data-root"].as<std::string>(),
-			map["module"].as<std::string>(),
+			map.count("module") ? map["module"].as<std::string>() : "",
 			map.count("bin") ? map["bin"].as<std::string>() : "",
 			map.count("output") ? map["output"].as<std::string>() : "",
 			map.count("dump") ? map["dump"].as<std::string>() : "",
 			map.count("verbose") > 0,
+			batch ? map["batch"].as<std::string>() : "",
+			map.count("jobs") ? map["jobs"].as<unsigned int>() : 0,
+			map.count("cache") ? map["cache"].as<std::string>() : "",
+			timings,
+			map.count("arena") > 0,
+			map.count("function") ? map["function"].as<std::string>() : "",
 		};
 		
 	} catch (error& e) {
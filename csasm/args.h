@@ -1,6 +1,7 @@
 #pragma once
 
 #include <string>
+#include <vector>
 #include <boost/filesystem.hpp>
 
 struct CommandlineArgs
@@ -15,6 +16,39 @@ struct CommandlineArgs
 	std::string dumpFile;
 	
 	bool verbose;
+
+	// Batch mode: the module list or folder to process, and the amount of worker threads
+	std::string batchInput;
+	unsigned int jobs;
+
+	// Folder of the output cache, empty if disabled
+	std::string cacheFolder;
+
+	// "table" or "json" to print the profiler scopes at exit, empty if disabled
+	std::string timings;
+
+	// Allocate the engine's memory from a bump arena and skip engine shutdown
+	bool arena;
+
+	// Declaration of the one function to disassemble, empty for the whole module
+	std::string function;
+
+	// "csasm registry-compile [input.json] [output.bin]"
+	bool compileRegistry;
+	std::string registryInput;
+	std::string registryOutput;
+
+	// "csasm scan <data-root> [index.json|index.bin] [folder|list]", uses rootFolder and batchInput
+	bool scan;
+	std::string scanOutput;
+
+	// "csasm opcode-pairs <data-root> [folder|list] [top]", uses rootFolder and batchInput
+	bool opcodePairs;
+	size_t opcodePairsTop;
+
+	// "csasm bench <suite> [arguments]"
+	std::string benchSuite;
+	std::vector<std::string> benchArguments;
 };
 
 CommandlineArgs parseArgs(int argc, char** argv);
@@ -1,7 +1,20 @@
 #include "asf.h"
 
+#include "timings.h"
+
+#include <boost/interprocess/file_mapping.hpp>
+#include <boost/interprocess/mapped_region.hpp>
+
+#include <cstring>
 #include <iostream>
 
+static const uint8_t cAsfMagic[4] = {
+	'A', 'S', 'F', 0x01
+};
+
+// Size of each entry in the dependency table
+static const size_t cAsfDependencySlotSize = 128;
+
 file_not_found::file_not_found(std::string filepath, std::string role) : m_filepath(filepath), role(role), msg((role.empty() ? "F" : role + " f") + "ile not found: '" + filepath + "'")
 {
 	
@@ -27,6 +40,20 @@ AsfModuleTracker::~AsfModuleTracker()
 	}
 }
 
+boost::filesystem::path resolveModulePath(const boost::filesystem::path &root, const std::string &name)
+{
+	boost::filesystem::path filePath = root;
+	
+	char last_char = filePath.string()[filePath.string().length() - 1];
+	if (last_char != '/' && last_char != '\\')
+	{
+		filePath.concat("/");
+	}
+	
+	filePath.concat(name);
+	return filePath;
+}
+
 AsfModule *AsfModuleTracker::getModule(const std::string &name, std::vector<std::string>* direct_dependencies, bool verbose)
 {
 	// Check if it has been loaded already
@@ -38,55 +65,79 @@ AsfModule *AsfModuleTracker::getModule(const std::string &name, std::vector<std:
 	else
 	{
 		// Not found, load
-		boost::filesystem::path filePath = mRoot;
-		
-		char last_char = filePath.string()[filePath.string().length() - 1];
-		if (last_char != '/' && last_char != '\\')
-		{
-			filePath.concat("/");
-		}
-		
-		filePath.concat(name);
+		boost::filesystem::path filePath = resolveModulePath(mRoot, name);
 
 		if (!exists(filePath))
 		{
 			throw file_not_found(filePath.string(), "");
 		}
 		
-		std::ifstream inputStream(filePath.string(), std::ios::binary);
-		std::vector<uint8_t> inputBuffer((std::istreambuf_iterator<char>(inputStream)), (std::istreambuf_iterator<char>()));
-		auto *newModule = new AsfModule(name, inputBuffer, this, direct_dependencies, verbose);
-		mModules[name] = newModule;
-		return newModule;
+		// The mapping only has to live until the engine has loaded the bytecode
+		if (boost::filesystem::file_size(filePath) == 0)
+		{
+			return addModule(name, nullptr, 0, direct_dependencies, verbose);
+		}
+
+		using namespace boost::interprocess;
+		file_mapping file(filePath.string().c_str(), read_only);
+		mapped_region region(file, read_only);
+		return addModule(name, static_cast<const uint8_t *>(region.get_address()), region.get_size(), direct_dependencies, verbose);
 	}
 }
 
-AsfModule::AsfModule(const std::string &name, const std::vector<uint8_t> &buffer, AsfModuleTracker *tracker, std::vector<std::string>* direct_dependencies, bool verbose)
-	: mName(name), mData(buffer), mTracker(tracker)
+AsfModule *AsfModuleTracker::addModule(const std::string &name, const uint8_t *data, size_t size, std::vector<std::string>* direct_dependencies, bool verbose)
 {
-	mName = name;
-	mData = buffer;
-	
-	// Parse ASF header
-	uint8_t *data = mData.data();
-	if (memcmp(data, cAsfMagic, sizeof(cAsfMagic)))
+	AsfModule *newModule = new AsfModule(name, data, size, this, direct_dependencies, verbose);
+	mModules[name] = newModule;
+	return newModule;
+}
+
+bool readAsfHeader(BinaryCodeStream &stream, AsfHeader &header)
+{
+	uint8_t magic[sizeof(cAsfMagic)];
+	stream.Read(magic, sizeof(magic));
+	if (memcmp(magic, cAsfMagic, sizeof(cAsfMagic)))
 	{
-		return;
+		return false;
 	}
-	data += sizeof(cAsfMagic);
-	uint32_t codeOffset = *reinterpret_cast<uint32_t *>(data);
-	data += sizeof(uint32_t);
-	uint32_t codeSize = *reinterpret_cast<uint32_t *>(data);
-	data += sizeof(uint32_t);
-	uint32_t dependencyCount = *reinterpret_cast<uint32_t *>(data);
-	data += sizeof(uint32_t);
+
+	uint32_t dependencyCount;
+	stream.Read(&header.codeOffset, sizeof(uint32_t));
+	stream.Read(&header.codeSize, sizeof(uint32_t));
+	stream.Read(&dependencyCount, sizeof(uint32_t));
 
 	// Parse dependencies
+	if (dependencyCount > stream.remaining() / cAsfDependencySlotSize)
+	{
+		return false;
+	}
+
+	header.dependencies.clear();
+	header.dependencies.reserve(dependencyCount);
 	for (uint32_t i = 0; i < dependencyCount; ++i)
 	{
-		mDependencies.emplace_back(reinterpret_cast<char *>(data));
-		data += 128;
+		char slot[cAsfDependencySlotSize + 1] = {};
+		stream.Read(slot, cAsfDependencySlotSize);
+		header.dependencies.emplace_back(slot);
+	}
+
+	return true;
+}
+
+AsfModule::AsfModule(const std::string &name, const uint8_t *data, size_t size, AsfModuleTracker *tracker, std::vector<std::string>* direct_dependencies, bool verbose)
+	: mTracker(tracker), mName(name)
+{
+	// Parse ASF header
+	BinaryCodeStream file(data, size);
+	AsfHeader header;
+	{
+		TimingScope timing("csasm::readAsfHeader");
+		if (!readAsfHeader(file, header))
+		{
+			return;
+		}
 	}
+	mDependencies = std::move(header.dependencies);
 
 	// Load dependencies
 	if (verbose)
@@ -115,10 +166,10 @@ AsfModule::AsfModule(const std::string &name, const std::vector<uint8_t> &buffer
 	}
 
 	// Load code
-	BinaryCodeStream code(std::vector<uint8_t>(mData.begin() + codeOffset, 
-											   mData.begin() + codeOffset + codeSize));
+	BinaryCodeStream code = file.slice(header.codeOffset, header.codeSize);
 	mModule = mTracker->getEngine()->GetModule(name.c_str(), asGM_ALWAYS_CREATE);
 
+	TimingScope timing("csasm::LoadByteCode");
 	bool debugInfo = false;
 	mModule->LoadByteCode(&code, &debugInfo);
 }
@@ -126,10 +177,10 @@ AsfModule::AsfModule(const std::string &name, const std::vector<uint8_t> &buffer
 std::vector<uint8_t> AsfModule::save() const
 {
 	// Get bytecode
-	BinaryCodeStream codeStream{ std::vector<uint8_t>() };
+	BinaryOutputStream codeStream;
 	std::cout << mModule->SaveByteCode(&codeStream) << std::endl;
 
-	std::vector<uint8_t> bytecode = codeStream.getData();
+	const std::vector<uint8_t> &bytecode = codeStream.getData();
 	
 	// Construct Asf File
 	int codeOffset = 0x2010; // Code offset always starts at 0x2010
@@ -20,43 +20,107 @@ public:
 	const char* what() const override;
 };
 
+// Read-only stream over memory owned by someone else, usually a mapped ASF file
 class BinaryCodeStream : public asIBinaryStream
 {
 public:
-	BinaryCodeStream(const std::vector<uint8_t> &data)
-		: mData(data)
+	BinaryCodeStream(const uint8_t *data, size_t size)
+		: mData(data), mSize(size)
 	{
 		
 	}
 
 	virtual void Read(void *ptr, asUINT size)
 	{
-		memcpy(ptr, mData.data() + mHead, size);
+		// Reading past the end yields zeroes, which the engine rejects as invalid bytecode
+		size_t available = mHead < mSize ? mSize - mHead : 0;
+		size_t count = size < available ? size : available;
+		if (count)
+			memcpy(ptr, mData + mHead, count);
+		if (count < size)
+			memset(static_cast<uint8_t *>(ptr) + count, 0, size - count);
 		mHead += size;
 	}
 
+	virtual void Write(const void *, asUINT)
+	{
+		// Read-only
+	}
+
+	virtual const void *GetReadBuffer(asUINT *size)
+	{
+		// Everything is in memory already, so the engine can decode it in place
+		*size = static_cast<asUINT>(remaining());
+		return mData && *size ? mData + mHead : nullptr;
+	}
+
+	virtual void Skip(asUINT size)
+	{
+		mHead += size;
+	}
+
+	size_t remaining() const
+	{
+		return mHead < mSize ? mSize - mHead : 0;
+	}
+
+	// Sub-stream over [offset, offset + size), or nullptr-backed if out of bounds
+	BinaryCodeStream slice(size_t offset, size_t size) const
+	{
+		if (offset > mSize || size > mSize - offset)
+			return BinaryCodeStream(nullptr, 0);
+		return BinaryCodeStream(mData + offset, size);
+	}
+
+private:
+	const uint8_t *mData;
+	size_t mSize;
+	size_t mHead = 0;
+};
+
+class BinaryOutputStream : public asIBinaryStream
+{
+public:
+	virtual void Read(void *, asUINT)
+	{
+		// Write-only
+	}
+
 	virtual void Write(const void *ptr, asUINT size)
 	{
 		const uint8_t *data = static_cast<const uint8_t *>(ptr);
 		mData.insert(mData.end(), data, data + size);
 	}
 
-	std::vector<uint8_t> getData() const
+	const std::vector<uint8_t> &getData() const
 	{
 		return mData;
 	}
 
 private:
 	std::vector<uint8_t> mData;
-	int mHead = 0;
 };
 
+struct AsfHeader
+{
+	uint32_t codeOffset;
+	uint32_t codeSize;
+	std::vector<std::string> dependencies;
+};
+
+// Parses the ASF header: magic, code offset and size, and the 128 byte dependency slots.
+// Returns false if the stream doesn't hold an ASF file.
+bool readAsfHeader(BinaryCodeStream &stream, AsfHeader &header);
+
+// Path of a module inside the data root, the way dependency tables name them
+boost::filesystem::path resolveModulePath(const boost::filesystem::path &root, const std::string &name);
+
 class AsfModuleTracker;
 
 class AsfModule
 {
 public:
-	AsfModule(const std::string &name, const std::vector<uint8_t> &buffer, AsfModuleTracker *tracker, std::vector<std::string>* direct_dependencies = nullptr, bool verbose = false);
+	AsfModule(const std::string &name, const uint8_t *data, size_t size, AsfModuleTracker *tracker, std::vector<std::string>* direct_dependencies = nullptr, bool verbose = false);
 	
 	asIScriptModule *getScriptModule() const
 	{
@@ -69,15 +133,11 @@ private:
 	AsfModuleTracker *mTracker;
 
 	std::string mName;
-	std::vector<uint8_t> mData;
 
 	std::vector<std::string> mDependencies;
 	asIScriptModule *mModule = nullptr;
 
 	friend class AsfModuleTracker;
-	const uint8_t cAsfMagic[4] = {
-		'A', 'S', 'F', 0x01
-	};
 };
 
 class AsfModuleTracker
@@ -91,8 +151,22 @@ public:
 		return mEngine;
 	}
 
+	const boost::filesystem::path &getRoot() const
+	{
+		return mRoot;
+	}
+
 	AsfModule *getModule(const std::string &name, std::vector<std::string>* direct_dependencies, bool verbose = false);
 
+	bool hasModule(const std::string &name) const
+	{
+		return mModules.count(name) > 0;
+	}
+
+	// Loads a module from memory the caller keeps mapped until this returns.
+	// Dependencies that aren't loaded yet are loaded recursively.
+	AsfModule *addModule(const std::string &name, const uint8_t *data, size_t size, std::vector<std::string>* direct_dependencies, bool verbose = false);
+
 private:
 	asIScriptEngine *mEngine;
 	boost::filesystem::path mRoot;
@@ -0,0 +1,288 @@
+#include "batch.h"
+
+#include "arena_allocator.h"
+#include "asf.h"
+#include "engine_config.h"
+#include "format.h"
+#include "module_cache.h"
+#include "module_output.h"
+
+#include <boost/algorithm/string/trim.hpp>
+#include <boost/filesystem.hpp>
+#include <boost/filesystem/fstream.hpp>
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstring>
+#include <iostream>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace fs = boost::filesystem;
+using Clock = std::chrono::steady_clock;
+
+static double secondsSince(Clock::time_point start)
+{
+	return std::chrono::duration<double>(Clock::now() - start).count();
+}
+
+struct WorkerStats
+{
+	unsigned int modules = 0;
+	unsigned int failures = 0;
+	unsigned int cached = 0;
+	double setupSeconds = 0.0;
+	double busySeconds = 0.0;
+};
+
+struct BatchJob
+{
+	const CommandlineArgs &args;
+	const Registry &registry;
+	const std::vector<std::string> &modules;
+	ModuleCache *cache;
+
+	std::atomic<size_t> nextModule{ 0 };
+	std::mutex logMutex;
+	std::vector<WorkerStats> stats;
+
+	// Configured once, on the first module that isn't restored from the cache. Workers clone it.
+	std::once_flag configureOnce;
+	asIScriptEngine *configured = nullptr;
+
+	BatchJob(const CommandlineArgs &args, const Registry &registry, const std::vector<std::string> &modules, ModuleCache *cache)
+		: args(args), registry(registry), modules(modules), cache(cache)
+	{
+		
+	}
+};
+
+static bool isAsfFile(const fs::path &path)
+{
+	static const char cAsfMagic[4] = { 'A', 'S', 'F', 0x01 };
+
+	char magic[sizeof(cAsfMagic)] = {};
+	fs::ifstream stream(path, std::ios::binary);
+	stream.read(magic, sizeof(magic));
+	return stream.gcount() == sizeof(magic) && memcmp(magic, cAsfMagic, sizeof(magic)) == 0;
+}
+
+std::vector<std::string> collectModules(const fs::path &root, const std::string &input)
+{
+	std::vector<std::string> modules;
+
+	// Folders and lists are looked up relative to the data root first
+	fs::path inputPath(input);
+	if (inputPath.is_relative() && fs::exists(root / inputPath))
+	{
+		inputPath = root / inputPath;
+	}
+
+	if (fs::is_directory(inputPath))
+	{
+		// Module names are relative to the data root, with the same separators as the dependency tables
+		for (const auto &entry : fs::recursive_directory_iterator(inputPath))
+		{
+			if (fs::is_regular_file(entry.path()) && isAsfFile(entry.path()))
+			{
+				modules.push_back(fs::relative(entry.path(), root).generic_string());
+			}
+		}
+	}
+	else if (fs::is_regular_file(inputPath))
+	{
+		// List file, one module per line
+		fs::ifstream list(inputPath);
+		std::string line;
+		while (std::getline(list, line))
+		{
+			boost::trim(line);
+			if (line.empty() || line[0] == '#')
+				continue;
+
+			modules.push_back(fs::path(line).generic_string());
+		}
+	}
+	else
+	{
+		throw file_not_found(inputPath.string(), "Batch input");
+	}
+
+	std::sort(modules.begin(), modules.end());
+	modules.erase(std::unique(modules.begin(), modules.end()), modules.end());
+	return modules;
+}
+
+static std::string mirroredPath(const std::string &outputRoot, const std::string &module, const char *extension)
+{
+	if (outputRoot.empty())
+		return "";
+
+	fs::path path = fs::path(outputRoot) / module;
+	if (extension)
+		path.replace_extension(extension);
+
+	return path.string();
+}
+
+static void runWorker(BatchJob &job, unsigned int workerIndex)
+{
+	WorkerStats &stats = job.stats[workerIndex];
+
+	// Created on the first module that isn't restored from the cache
+	asIScriptEngine *engine = nullptr;
+	std::unique_ptr<AsfModuleTracker> tracker;
+
+	for (size_t i = job.nextModule++; i < job.modules.size(); i = job.nextModule++)
+	{
+		const std::string &module = job.modules[i];
+		Clock::time_point moduleStart = Clock::now();
+
+		try
+		{
+			ModuleOutputPaths paths;
+			paths.dumpFile = mirroredPath(job.args.dumpFile, module, ".txt");
+			paths.outputFile = mirroredPath(job.args.outputFile, module, ".yaml");
+			paths.binaryOutputFile = mirroredPath(job.args.binaryOutputFile, module, nullptr);
+
+			uint64_t key = 0;
+			bool restored = false;
+			if (job.cache)
+			{
+				key = job.cache->moduleKey(module);
+				restored = job.cache->restore(key, paths);
+			}
+
+			if (restored)
+			{
+				stats.cached++;
+			}
+			else
+			{
+				if (!tracker)
+				{
+					Clock::time_point setupStart = Clock::now();
+					std::call_once(job.configureOnce, [&] { job.configured = CreateConfiguredEngine(job.registry); });
+					engine = job.configured ? job.configured->CloneConfiguration() : nullptr;
+					if (!engine)
+					{
+						std::lock_guard<std::mutex> lock(job.logMutex);
+						std::cout << fmtString("[worker %u] failed to create engine\n", workerIndex);
+						return;
+					}
+					tracker.reset(new AsfModuleTracker(engine, job.args.rootFolder.string()));
+					stats.setupSeconds = secondsSince(setupStart);
+					moduleStart = Clock::now();
+				}
+
+				std::vector<std::string> dependencies;
+				AsfModule *asfModule = tracker->getModule(module, &dependencies, job.args.verbose);
+				if (!asfModule->getScriptModule())
+					throw std::runtime_error("module or one of its dependencies could not be loaded");
+
+				writeModuleOutputs(asfModule, dependencies, paths);
+
+				if (job.cache)
+					job.cache->store(module, key, dependencies, paths);
+			}
+		}
+		catch (std::exception &e)
+		{
+			stats.failures++;
+
+			std::lock_guard<std::mutex> lock(job.logMutex);
+			std::cout << fmtString("[worker %u] %s: %s\n", workerIndex, module.c_str(), e.what());
+		}
+
+		stats.modules++;
+		stats.busySeconds += secondsSince(moduleStart);
+	}
+
+	// Nothing allocated from the arena can be freed anyway, the process exits soon after
+	if (isArenaAllocatorInstalled())
+	{
+		tracker.release();
+		return;
+	}
+
+	// The tracker's modules belong to the engine, so it has to go first
+	tracker.reset();
+	if (engine)
+	{
+		engine->ShutDownAndRelease();
+	}
+}
+
+int runBatch(const CommandlineArgs &args, const Registry &registry)
+{
+	std::vector<std::string> modules = collectModules(args.rootFolder, args.batchInput);
+
+	unsigned int jobCount = args.jobs ? args.jobs : std::thread::hardware_concurrency();
+	jobCount = std::max(1u, std::min<unsigned int>(jobCount, static_cast<unsigned int>(modules.size())));
+
+	std::cout << fmtString("Processing %zu modules on %u workers\n", modules.size(), jobCount);
+
+	std::unique_ptr<ModuleCache> cache;
+	if (!args.cacheFolder.empty())
+	{
+		cache.reset(new ModuleCache(args.cacheFolder, args.rootFolder, registry.hash()));
+	}
+
+	BatchJob job(args, registry, modules, cache.get());
+	job.stats.resize(jobCount);
+
+	// Each worker clones its own engine, so the engine's thread manager has to exist beforehand
+	asPrepareMultithread();
+
+	Clock::time_point start = Clock::now();
+
+	std::vector<std::thread> workers;
+	workers.reserve(jobCount);
+	for (unsigned int i = 0; i < jobCount; ++i)
+	{
+		workers.emplace_back(runWorker, std::ref(job), i);
+	}
+	for (auto &worker : workers)
+	{
+		worker.join();
+	}
+
+	double elapsed = secondsSince(start);
+	if (job.configured && !isArenaAllocatorInstalled())
+	{
+		job.configured->ShutDownAndRelease();
+	}
+	asUnprepareMultithread();
+
+	if (cache)
+	{
+		cache->save();
+	}
+
+	// Report
+	unsigned int processed = 0;
+	unsigned int failed = 0;
+	for (const auto &stats : job.stats)
+	{
+		processed += stats.modules;
+		failed += stats.failures;
+	}
+
+	std::cout << fmtString("\nProcessed %u modules (%u failed, %u cached) in %.2f s: %.1f modules/sec\n\n",
+		processed, failed, cache ? cache->hits() : 0u, elapsed, elapsed > 0.0 ? processed / elapsed : 0.0);
+
+	std::cout << fmtString("%-8s %8s %8s %8s %10s %10s %12s\n", "worker", "modules", "failed", "cached", "setup s", "busy s", "modules/sec");
+	for (unsigned int i = 0; i < jobCount; ++i)
+	{
+		const WorkerStats &stats = job.stats[i];
+		std::cout << fmtString("%-8u %8u %8u %8u %10.2f %10.2f %12.1f\n",
+			i, stats.modules, stats.failures, stats.cached, stats.setupSeconds, stats.busySeconds,
+			stats.busySeconds > 0.0 ? stats.modules / stats.busySeconds : 0.0);
+	}
+
+	return failed ? 1 : 0;
+}
@@ -0,0 +1,15 @@
+#pragma once
+
+#include "args.h"
+#include "registry.h"
+
+#include <string>
+#include <vector>
+
+// Disassembles every module named by args.batchInput on a pool of worker threads.
+// Each worker owns its own engine and module tracker. Returns the process exit code.
+int runBatch(const CommandlineArgs &args, const Registry &registry);
+
+// Module names (relative to root, '/' separated) from a folder or a list file with
+// one module per line. Both are looked up relative to root first.
+std::vector<std::string> collectModules(const boost::filesystem::path &root, const std::string &input);
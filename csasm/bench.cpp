@@ -0,0 +1,1509 @@
+#include "bench.h"
+
+#include "arena_allocator.h"
+#include "asf.h"
+#include "bytecode_decoder.h"
+#include "engine_config.h"
+#include "format.h"
+#include "load_scheduler.h"
+#include "opcode_profile.h"
+
+#include <scriptjit/scriptjit.h>
+#include <scriptprofiler/scriptprofiler.h>
+#include <scriptstdstring/scriptstdstring.h>
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstring>
+#include <fstream>
+#include <functional>
+#include <iostream>
+#include <string>
+#include <thread>
+#include <vector>
+
+using Clock = std::chrono::steady_clock;
+
+struct BenchSamples
+{
+	std::string name;
+	std::vector<double> milliseconds;
+
+	double min() const
+	{
+		return *std::min_element(milliseconds.begin(), milliseconds.end());
+	}
+
+	double median() const
+	{
+		std::vector<double> sorted(milliseconds);
+		std::sort(sorted.begin(), sorted.end());
+		return sorted[sorted.size() / 2];
+	}
+
+	double mean() const
+	{
+		double sum = 0.0;
+		for (double sample : milliseconds)
+			sum += sample;
+		return sum / milliseconds.size();
+	}
+};
+
+static void printSamples(const std::vector<BenchSamples> &results)
+{
+	std::cout << fmtString("\n%-16s %10s %10s %10s %10s\n", "", "min ms", "median ms", "mean ms", "vs first");
+	for (const auto &result : results)
+	{
+		std::cout << fmtString("%-16s %10.3f %10.3f %10.3f %9.2fx\n",
+			result.name.c_str(), result.min(), result.median(), result.mean(),
+			results[0].median() / result.median());
+	}
+}
+
+static unsigned int parseCount(const std::vector<std::string> &arguments, size_t index, unsigned int fallback)
+{
+	return arguments.size() > index ? static_cast<unsigned int>(std::stoul(arguments[index])) : fallback;
+}
+
+// load <data-root> <module> [iterations] [jobs]
+// Loads a module and its dependencies into a fresh engine, recursively and through the scheduler
+static int benchLoad(const std::vector<std::string> &arguments, const Registry &registry)
+{
+	if (arguments.size() < 2)
+	{
+		std::cerr << "Usage: csasm bench load <data-root> <module> [iterations] [jobs]" << std::endl;
+		return 1;
+	}
+
+	const std::string &root = arguments[0];
+	const std::string &module = arguments[1];
+	unsigned int iterations = std::max(1u, parseCount(arguments, 2, 10));
+	unsigned int jobs = parseCount(arguments, 3, 0);
+
+	typedef std::function<AsfModule *(AsfModuleTracker &)> Loader;
+	struct
+	{
+		const char *name;
+		Loader load;
+	} loaders[] = {
+		{ "recursive", [&](AsfModuleTracker &tracker) { return tracker.getModule(module, nullptr); } },
+		{ "scheduled", [&](AsfModuleTracker &tracker) { return loadModuleScheduled(tracker, module, nullptr, jobs); } },
+	};
+
+	std::vector<BenchSamples> results;
+	for (const auto &loader : loaders)
+	{
+		results.push_back({ loader.name, {} });
+	}
+
+	std::cout << fmtString("Loading %s %u times per loader\n", module.c_str(), iterations);
+
+	// Interleaved so that both loaders see the same page cache state
+	for (unsigned int i = 0; i < iterations; ++i)
+	{
+		for (size_t j = 0; j < results.size(); ++j)
+		{
+			asIScriptEngine *engine = CreateConfiguredEngine(registry);
+			if (!engine)
+				return -1;
+
+			{
+				AsfModuleTracker tracker(engine, root);
+
+				Clock::time_point start = Clock::now();
+				AsfModule *loaded = loaders[j].load(tracker);
+				results[j].milliseconds.push_back(std::chrono::duration<double, std::milli>(Clock::now() - start).count());
+
+				if (!loaded->getScriptModule())
+				{
+					std::cerr << loaders[j].name << ": " << module << " could not be loaded" << std::endl;
+					return 1;
+				}
+			}
+
+			engine->ShutDownAndRelease();
+		}
+	}
+
+	printSamples(results);
+	return 0;
+}
+
+static void addReaderPhase(const char *, const char *name, int, asQWORD count, double totalSeconds, double, double, void *param)
+{
+	if (strcmp(name, "asCReader::ReadUsedFunctions") == 0)
+	{
+		auto &phase = *static_cast<std::pair<asQWORD, double> *>(param);
+		phase.first += count;
+		phase.second += totalSeconds;
+	}
+}
+
+// read <data-root> <module> [iterations]
+// Loads a module and its dependencies again and again into the same engine, timing the bytecode reader
+static int benchRead(const std::vector<std::string> &arguments, const Registry &registry)
+{
+	if (arguments.size() < 2)
+	{
+		std::cerr << "Usage: csasm bench read <data-root> <module> [iterations]" << std::endl;
+		return 1;
+	}
+
+	const std::string &root = arguments[0];
+	const std::string &module = arguments[1];
+	unsigned int iterations = std::max(1u, parseCount(arguments, 2, 10));
+
+	asIScriptEngine *engine = CreateConfiguredEngine(registry);
+	if (!engine)
+		return -1;
+
+	// Only the loads are profiled, not the registration
+	bool profiled = asSetProfilerEnabled(true) >= 0;
+	asResetProfiler();
+
+	std::vector<BenchSamples> results = { { "load", {} } };
+	std::cout << fmtString("Loading %s %u times\n", module.c_str(), iterations);
+
+	for (unsigned int i = 0; i < iterations; ++i)
+	{
+		// A new tracker loads everything again, replacing the modules of the previous iteration
+		AsfModuleTracker tracker(engine, root);
+
+		Clock::time_point start = Clock::now();
+		AsfModule *loaded = tracker.getModule(module, nullptr);
+		results[0].milliseconds.push_back(std::chrono::duration<double, std::milli>(Clock::now() - start).count());
+
+		if (!loaded->getScriptModule())
+		{
+			std::cerr << module << " could not be loaded" << std::endl;
+			return 1;
+		}
+	}
+
+	printSamples(results);
+
+	std::pair<asQWORD, double> phase(0, 0.0);
+	if (profiled && asEnumerateProfilerScopes(addReaderPhase, &phase) >= 0 && phase.first)
+	{
+		std::cout << fmtString("\nasCReader::ReadUsedFunctions: %.3f ms per load (%llu calls)\n",
+			phase.second * 1000.0 / iterations, static_cast<unsigned long long>(phase.first));
+	}
+	else
+	{
+		std::cout << "\nBuild the AngelScript library with AS_PROFILE to see the time spent resolving functions" << std::endl;
+	}
+
+	engine->ShutDownAndRelease();
+	return 0;
+}
+
+// Looks every registered global function, property and type up again by its declaration or name.
+// Returns the amount of lookups that didn't find what was registered. Some declarations in nested
+// namespaces use types the engine doesn't find from there, so this isn't always 0.
+static unsigned int resolveRegistry(asIScriptEngine *engine)
+{
+	unsigned int misses = 0;
+
+	for (asUINT i = 0; i < engine->GetGlobalFunctionCount(); ++i)
+	{
+		asIScriptFunction *func = engine->GetGlobalFunctionByIndex(i);
+		engine->SetDefaultNamespace(func->GetNamespace());
+		if (engine->GetGlobalFunctionByDecl(func->GetDeclaration(true, false, false)) != func)
+			++misses;
+	}
+
+	for (asUINT i = 0; i < engine->GetGlobalPropertyCount(); ++i)
+	{
+		const char *name;
+		const char *nameSpace;
+		engine->GetGlobalPropertyByIndex(i, &name, &nameSpace);
+		engine->SetDefaultNamespace(nameSpace);
+		if (engine->GetGlobalPropertyIndexByName(name) != static_cast<int>(i))
+			++misses;
+	}
+
+	for (asUINT i = 0; i < engine->GetObjectTypeCount(); ++i)
+	{
+		asIObjectType *type = engine->GetObjectTypeByIndex(i);
+		engine->SetDefaultNamespace(type->GetNamespace());
+		if (engine->GetObjectTypeByName(type->GetName()) != type)
+			++misses;
+	}
+
+	engine->SetDefaultNamespace("");
+	return misses;
+}
+
+struct PoolStatistics
+{
+	std::string name;
+	asUINT objectSize;
+	asUINT liveObjects;
+	asUINT peakObjects;
+	asQWORD totalAllocs;
+	asUINT slabCount;
+};
+
+static void addPoolStatistics(const char *name, asUINT objectSize, asUINT liveObjects, asUINT peakObjects, asQWORD totalAllocs, asUINT slabCount, void *param)
+{
+	static_cast<std::vector<PoolStatistics> *>(param)->push_back({ name, objectSize, liveObjects, peakObjects, totalAllocs, slabCount });
+}
+
+// registry [iterations]
+// Registers the registry into a fresh engine, then resolves every global function, property and type it registered,
+// and lists how the engine's metadata pools were used
+static int benchRegistry(const std::vector<std::string> &arguments, const Registry &registry)
+{
+	unsigned int iterations = std::max(1u, parseCount(arguments, 0, 10));
+
+	std::vector<BenchSamples> registration = { { "register", {} } };
+	std::vector<BenchSamples> resolution = { { "resolve", {} } };
+	unsigned int lookups = 0;
+	unsigned int misses = 0;
+	std::vector<PoolStatistics> pools;
+
+	std::cout << fmtString("Registering and resolving the registry %u times\n", iterations);
+
+	for (unsigned int i = 0; i < iterations; ++i)
+	{
+		Clock::time_point start = Clock::now();
+		asIScriptEngine *engine = CreateConfiguredEngine(registry);
+		if (!engine)
+			return -1;
+		Clock::time_point registered = Clock::now();
+
+		misses = resolveRegistry(engine);
+		Clock::time_point resolved = Clock::now();
+
+		registration[0].milliseconds.push_back(std::chrono::duration<double, std::milli>(registered - start).count());
+		resolution[0].milliseconds.push_back(std::chrono::duration<double, std::milli>(resolved - registered).count());
+		lookups = engine->GetGlobalFunctionCount() + engine->GetGlobalPropertyCount() + engine->GetObjectTypeCount();
+
+		pools.clear();
+		engine->EnumerateMemoryPools(addPoolStatistics, &pools);
+
+		engine->ShutDownAndRelease();
+	}
+
+	printSamples(registration);
+	printSamples(resolution);
+	std::cout << fmtString("\n%u symbols looked up per iteration, %u not found by their own declaration\n", lookups, misses);
+
+	std::cout << fmtString("\n%-20s %6s %8s %8s %10s %6s %10s\n", "Pool", "size", "live", "peak", "allocs", "slabs", "peak KiB");
+	for (const auto &pool : pools)
+	{
+		std::cout << fmtString("%-20s %6u %8u %8u %10llu %6u %10.1f\n", pool.name.c_str(), pool.objectSize,
+			pool.liveObjects, pool.peakObjects, static_cast<unsigned long long>(pool.totalAllocs), pool.slabCount,
+			pool.peakObjects * static_cast<double>(pool.objectSize) / 1024.0);
+	}
+	return 0;
+}
+
+// startup [iterations]
+// Registers the registry into a fresh engine and shuts it down again, with malloc and with the arena allocator
+static int benchStartup(const std::vector<std::string> &arguments, const Registry &registry)
+{
+	unsigned int iterations = std::max(1u, parseCount(arguments, 0, 10));
+
+	if (isArenaAllocatorInstalled())
+	{
+		std::cerr << "The arena allocator has to be installed by the benchmark itself" << std::endl;
+		return 1;
+	}
+
+	std::vector<BenchSamples> registration = { { "malloc", {} }, { "arena", {} } };
+	std::vector<BenchSamples> total = { { "malloc", {} }, { "arena", {} } };
+
+	std::cout << fmtString("Creating %u engines per allocator\n", iterations);
+
+	// The arena can't be uninstalled, so these can't be interleaved. malloc goes first.
+	for (size_t j = 0; j < registration.size(); ++j)
+	{
+		if (j == 1)
+			installArenaAllocator();
+
+		for (unsigned int i = 0; i < iterations; ++i)
+		{
+			Clock::time_point start = Clock::now();
+			asIScriptEngine *engine = CreateConfiguredEngine(registry);
+			if (!engine)
+				return -1;
+			Clock::time_point registered = Clock::now();
+
+			// With the arena, csasm exits without shutting the engine down
+			if (j == 0)
+				engine->ShutDownAndRelease();
+
+			registration[j].milliseconds.push_back(std::chrono::duration<double, std::milli>(registered - start).count());
+			total[j].milliseconds.push_back(std::chrono::duration<double, std::milli>(Clock::now() - start).count());
+		}
+	}
+
+	std::cout << "\nRegistration";
+	printSamples(registration);
+	std::cout << "\nRegistration and teardown";
+	printSamples(total);
+	std::cout << fmtString("\nArena: %.1f MiB reserved for %u engines\n", arenaBytesReserved() / (1024.0 * 1024.0), iterations);
+	return 0;
+}
+
+// clone [engines] [iterations]
+// Creates a set of configured engines, registering each one against cloning all from the first
+static int benchClone(const std::vector<std::string> &arguments, const Registry &registry)
+{
+	unsigned int engineCount = std::max(1u, parseCount(arguments, 0, 32));
+	unsigned int iterations = std::max(1u, parseCount(arguments, 1, 5));
+
+	std::vector<BenchSamples> results = { { "register", {} }, { "clone", {} } };
+	std::vector<asIScriptEngine *> engines;
+	engines.reserve(engineCount);
+
+	std::cout << fmtString("Creating %u configured engines %u times per method\n", engineCount, iterations);
+
+	for (unsigned int i = 0; i < iterations; ++i)
+	{
+		for (size_t j = 0; j < results.size(); ++j)
+		{
+			Clock::time_point start = Clock::now();
+			for (unsigned int k = 0; k < engineCount; ++k)
+			{
+				asIScriptEngine *engine = j == 0 || k == 0 ? CreateConfiguredEngine(registry) : engines[0]->CloneConfiguration();
+				if (!engine)
+					return -1;
+				engines.push_back(engine);
+			}
+			results[j].milliseconds.push_back(std::chrono::duration<double, std::milli>(Clock::now() - start).count());
+
+			// A clone has to look the same from the outside
+			for (asIScriptEngine *engine : engines)
+			{
+				if (engine->GetGlobalFunctionCount() != engines[0]->GetGlobalFunctionCount() ||
+					engine->GetGlobalPropertyCount() != engines[0]->GetGlobalPropertyCount() ||
+					engine->GetObjectTypeCount() != engines[0]->GetObjectTypeCount() ||
+					engine->GetFuncdefCount() != engines[0]->GetFuncdefCount() ||
+					engine->GetTypedefCount() != engines[0]->GetTypedefCount())
+				{
+					std::cerr << results[j].name << ": the engines differ in their configuration" << std::endl;
+					return 1;
+				}
+			}
+
+			for (asIScriptEngine *engine : engines)
+			{
+				engine->ShutDownAndRelease();
+			}
+			engines.clear();
+		}
+	}
+
+	printSamples(results);
+	return 0;
+}
+
+// Callbacks of the sizes an application would fire many times per frame
+static const char *cCallScript = R"(
+void empty(int)
+{
+}
+
+int add(int a)
+{
+	return a + 1;
+}
+
+int small(int a)
+{
+	int sum = 0;
+	for (int i = 0; i < 10; i++)
+		sum += a * i;
+	return sum;
+}
+)";
+
+// calls [calls] [iterations]
+// Calls tiny script functions one at a time and compares the ways of getting a context for each call
+static int benchCalls(const std::vector<std::string> &arguments, const Registry &)
+{
+	unsigned int calls = std::max(1u, parseCount(arguments, 0, 100000));
+	unsigned int iterations = std::max(1u, parseCount(arguments, 1, 5));
+
+	asIScriptEngine *engine = asCreateScriptEngine(ANGELSCRIPT_VERSION);
+	engine->SetMessageCallback(asFUNCTION(AngelScriptMessageCallback), 0, asCALL_CDECL);
+
+	asIScriptModule *module = engine->GetModule("bench", asGM_ALWAYS_CREATE);
+	module->AddScriptSection("bench", cCallScript);
+	if (module->Build() < 0)
+	{
+		engine->ShutDownAndRelease();
+		return -1;
+	}
+
+	// The value each function returns for the argument 7, or -1 if it returns nothing
+	struct
+	{
+		const char *name;
+		int expected;
+	} functions[] = {
+		{ "empty", -1 },
+		{ "add", 8 },
+		{ "small", 315 },
+	};
+
+	enum Method { CreateEach, PoolOff, Pool, Reuse };
+	static const char *cMethodNames[] = { "create", "pool off", "pool", "one context" };
+
+	std::cout << fmtString("Calling each function %u times, %u times per method\n", calls, iterations);
+	std::cout << fmtString("\n%-8s %-12s %10s %10s %10s %10s\n", "", "", "min ms", "median ms", "ns/call", "vs create");
+
+	int failures = 0;
+	for (const auto &function : functions)
+	{
+		asIScriptFunction *func = module->GetFunctionByName(function.name);
+		double firstMedian = 0.0;
+		for (int method = CreateEach; method <= Reuse; ++method)
+		{
+			engine->SetEngineProperty(asEP_MAX_POOLED_CONTEXTS, method == PoolOff ? 0 : 4);
+			asIScriptContext *held = method == Reuse ? engine->CreateContext() : nullptr;
+
+			BenchSamples samples;
+			for (unsigned int i = 0; i < iterations; ++i)
+			{
+				Clock::time_point start = Clock::now();
+				for (unsigned int n = 0; n < calls; ++n)
+				{
+					asIScriptContext *context = held ? held : method == CreateEach ? engine->CreateContext() : engine->RequestContext();
+					context->Prepare(func);
+					context->SetArgDWord(0, 7);
+					if (context->Execute() != asEXECUTION_FINISHED ||
+						(function.expected >= 0 && static_cast<int>(context->GetReturnDWord()) != function.expected))
+						failures++;
+
+					if (method == CreateEach)
+						context->Release();
+					else if (!held)
+						engine->ReturnContext(context);
+				}
+				samples.milliseconds.push_back(std::chrono::duration<double, std::milli>(Clock::now() - start).count());
+			}
+
+			if (held)
+				held->Release();
+
+			if (method == CreateEach)
+				firstMedian = samples.median();
+			std::cout << fmtString("%-8s %-12s %10.3f %10.3f %10.1f %9.2fx\n", method == CreateEach ? function.name : "",
+				cMethodNames[method], samples.min(), samples.median(), samples.median() * 1e6 / calls,
+				firstMedian / samples.median());
+		}
+	}
+
+	engine->ShutDownAndRelease();
+
+	if (failures)
+		std::cerr << failures << " calls returned the wrong result" << std::endl;
+	return failures ? 1 : 0;
+}
+
+// A small call tree, so that the profile has something to show
+static const char *cProfileScript = R"(
+int leaf(int x)
+{
+	int sum = 0;
+	for (int i = 0; i < 40; i++)
+		sum += (x ^ i) * 3;
+	return sum;
+}
+
+int branch(int x)
+{
+	return leaf(x) + leaf(x + 1);
+}
+
+int fib(int n)
+{
+	return n < 2 ? n : fib(n - 1) + fib(n - 2);
+}
+
+int run(int n)
+{
+	int sum = 0;
+	for (int i = 0; i < n; i++)
+	{
+		sum += branch(i);
+		sum += fib(10);
+	}
+	return sum;
+}
+)";
+
+// profiler [iterations] [samples per second] [folded stacks file]
+// Runs the same script with and without the sampling profiler and prints the profile
+static int benchProfiler(const std::vector<std::string> &arguments, const Registry &)
+{
+	unsigned int iterations = std::max(1u, parseCount(arguments, 0, 10));
+	unsigned int rate = std::max(1u, parseCount(arguments, 1, 1000));
+	const unsigned int cCalls = 20000;
+
+	asIScriptEngine *engine = asCreateScriptEngine(ANGELSCRIPT_VERSION);
+	engine->SetMessageCallback(asFUNCTION(AngelScriptMessageCallback), 0, asCALL_CDECL);
+
+	asIScriptModule *module = engine->GetModule("bench", asGM_ALWAYS_CREATE);
+	module->AddScriptSection("bench", cProfileScript);
+	if (module->Build() < 0)
+	{
+		engine->ShutDownAndRelease();
+		return -1;
+	}
+
+	asIScriptFunction *func = module->GetFunctionByName("run");
+	asIScriptContext *context = engine->CreateContext();
+	CScriptProfiler profiler;
+
+	// Alternate between the two, so that both see the same changes in clock speed and load
+	BenchSamples off, on;
+	int failures = 0;
+	asDWORD expected = 0;
+	for (unsigned int i = 0; i < iterations * 2; ++i)
+	{
+		bool profile = i % 2 == 1;
+		if (profile)
+			profiler.Start(engine, rate);
+
+		Clock::time_point start = Clock::now();
+		context->Prepare(func);
+		context->SetArgDWord(0, cCalls);
+		if (context->Execute() != asEXECUTION_FINISHED)
+			failures++;
+		double milliseconds = std::chrono::duration<double, std::milli>(Clock::now() - start).count();
+
+		if (profile)
+			profiler.Stop();
+
+		if (i == 0)
+			expected = context->GetReturnDWord();
+		else if (context->GetReturnDWord() != expected)
+			failures++;
+		(profile ? on : off).milliseconds.push_back(milliseconds);
+	}
+
+	context->Release();
+
+	std::cout << fmtString("Running the script %u times without and with the profiler at %u samples per second\n\n", iterations, rate);
+	std::cout << fmtString("%-10s %10s %10s\n", "", "min ms", "median ms");
+	std::cout << fmtString("%-10s %10.3f %10.3f\n", "off", off.min(), off.median());
+	std::cout << fmtString("%-10s %10.3f %10.3f\n", "on", on.min(), on.median());
+	std::cout << fmtString("overhead   %9.2f%% %9.2f%%\n", (on.min() / off.min() - 1) * 100, (on.median() / off.median() - 1) * 100);
+
+	double profiledSeconds = on.mean() * on.milliseconds.size() / 1000;
+	std::cout << fmtString("\n%u samples of %u requested, %.0f expected from the time profiled, %.3f ms each\n\n",
+		profiler.GetSampleCount(), profiler.GetRequestCount(), profiledSeconds * rate, profiler.GetSampleInterval() * 1000);
+	profiler.WriteReport(std::cout, 10);
+
+	if (arguments.size() > 2)
+	{
+		std::ofstream out(arguments[2]);
+		profiler.WriteFoldedStacks(out);
+		std::cout << "\nFolded stacks written to " << arguments[2] << std::endl;
+	}
+
+	profiler.Reset();
+	engine->ShutDownAndRelease();
+
+	if (failures)
+		std::cerr << failures << " runs returned the wrong result" << std::endl;
+	return failures ? 1 : 0;
+}
+
+// Script workloads for the VM. Each is one loop without branches in its body, so the
+// instructions it executes can be counted from its bytecode
+static const char *cVmScript = R"(
+final class Counter
+{
+	int value = 0;
+	void add(int amount) { value += amount; }
+}
+
+int loops(int n)
+{
+	int sum = 0;
+	for (int i = 0; i < n; i++)
+	{
+		sum += i * 7;
+		sum ^= sum >> 3;
+	}
+	return sum;
+}
+
+float floats(int n)
+{
+	float x = 0.5f;
+	float v = 0;
+	for (int i = 0; i < n; i++)
+	{
+		v = v * 0.99f + x;
+		x = x * 1.0001f - 0.00001f;
+	}
+	return v;
+}
+
+int calls(int n)
+{
+	Counter counter;
+	for (int i = 0; i < n; i++)
+	{
+		counter.add(i);
+	}
+	return counter.value;
+}
+
+uint strings(int n)
+{
+	uint total = 0;
+	for (int i = 0; i < n; i++)
+	{
+		string s = "item" + i;
+		total += s.length();
+	}
+	return total;
+}
+)";
+
+static uint64_t countFunctionInstructions(asIScriptEngine *engine, asIScriptFunction *func, int depth, bool dispatches);
+
+// A superinstruction executes the instruction after it too, without dispatching it
+static bool isSuperInstruction(asEBCInstr op)
+{
+	return op >= asBC_CMPiJZ && op <= asBC_PshV4CALLSYS;
+}
+
+// Bytecode instructions a call executes in the VM. Native functions count as the call
+// instruction only. Returns 0 when the callee branches or can't be resolved.
+static uint64_t countCallInstructions(asIScriptEngine *engine, const DecodedInstruction &inst, int depth, bool dispatches)
+{
+	if (inst.op != asBC_CALL && inst.op != asBC_CALLINTF)
+		return 1;
+
+	asIScriptFunction *callee = engine->GetFunctionById(static_cast<int>(inst.operands[0].i));
+	if (callee && callee->GetFuncType() == asFUNC_VIRTUAL && callee->GetObjectType())
+	{
+		// Only final classes are used, so the method can't be overridden
+		callee = callee->GetObjectType()->GetMethodByDecl(callee->GetDeclaration(false), false);
+	}
+	if (!callee || depth > 8)
+		return 0;
+
+	uint64_t count = countFunctionInstructions(engine, callee, depth + 1, dispatches);
+	return count ? count + 1 : 0;
+}
+
+static bool isJump(asEBCInstr op)
+{
+	return op == asBC_JMP || (op >= asBC_JZ && op <= asBC_JNP) || op == asBC_JLowZ || op == asBC_JLowNZ;
+}
+
+static uint64_t countFunctionInstructions(asIScriptEngine *engine, asIScriptFunction *func, int depth, bool dispatches)
+{
+	DecodedFunction decoded = decodeFunction(func);
+
+	uint64_t count = 0;
+	for (const auto &inst : decoded.instructions)
+	{
+		if (isJump(inst.op))
+			return 0;
+		if (dispatches && isSuperInstruction(inst.op))
+			continue;
+
+		uint64_t call = countCallInstructions(engine, inst, depth, dispatches);
+		if (call == 0)
+			return 0;
+		count += call;
+	}
+	return count;
+}
+
+// Bytecode instructions executed by each pass through the function's loop, including the
+// script functions called from it, or the dispatches they take when dispatches is set.
+// Returns 0 when the loop can't be counted.
+static uint64_t countLoopInstructions(asIScriptEngine *engine, asIScriptFunction *func, bool dispatches)
+{
+	DecodedFunction decoded = decodeFunction(func);
+	const auto &instructions = decoded.instructions;
+
+	// The loop runs from the target of the only backward jump up to that jump
+	size_t first = 0;
+	size_t last = instructions.size();
+	for (size_t i = 0; i < instructions.size(); ++i)
+	{
+		if (!isJump(instructions[i].op))
+			continue;
+
+		// Jumps are relative to the end of the instruction, which is 2 dwords long
+		int64_t target = instructions[i].position + 2 + instructions[i].operands[0].i;
+		if (target > instructions[i].position)
+			continue;
+		if (last != instructions.size())
+			return 0;
+
+		last = i;
+		while (first < i && instructions[first].position < target)
+			++first;
+	}
+	if (last == instructions.size())
+		return 0;
+
+	uint64_t count = 0;
+	for (size_t i = first; i <= last; ++i)
+	{
+		if (i != last && isJump(instructions[i].op))
+		{
+			// Only the exit may jump, and it isn't taken while the loop runs
+			int64_t target = instructions[i].position + 2 + instructions[i].operands[0].i;
+			if (target <= instructions[last].position)
+				return 0;
+		}
+		if (dispatches && isSuperInstruction(instructions[i].op))
+			continue;
+
+		uint64_t call = countCallInstructions(engine, instructions[i], 0, dispatches);
+		if (call == 0)
+			return 0;
+		count += call;
+	}
+	return count;
+}
+
+// vm [iterations]
+// Runs loop, float math, object call and string workloads in the VM and reports the bytecode instructions per second
+static int benchVm(const std::vector<std::string> &arguments, const Registry &)
+{
+	unsigned int iterations = std::max(1u, parseCount(arguments, 0, 5));
+
+	asIScriptEngine *engine = asCreateScriptEngine(ANGELSCRIPT_VERSION);
+	engine->SetMessageCallback(asFUNCTION(AngelScriptMessageCallback), 0, asCALL_CDECL);
+	RegisterStdString(engine);
+
+	asIScriptModule *module = engine->GetModule("bench", asGM_ALWAYS_CREATE);
+	module->AddScriptSection("bench", cVmScript);
+	if (module->Build() < 0)
+	{
+		engine->ShutDownAndRelease();
+		return -1;
+	}
+
+	struct
+	{
+		const char *name;
+		int loopCount;
+		uint64_t loopInstructions;
+		uint64_t loopDispatches;
+	} workloads[] = {
+		{ "loops", 2000000, 0, 0 },
+		{ "floats", 2000000, 0, 0 },
+		{ "calls", 1000000, 0, 0 },
+		{ "strings", 200000, 0, 0 },
+	};
+
+	std::vector<BenchSamples> results;
+	asIScriptContext *context = engine->CreateContext();
+
+	bool threaded = strstr(asGetLibraryOptions(), "AS_COMPUTED_GOTO") != nullptr;
+	std::cout << fmtString("Running %u times per workload, dispatching %s\n", iterations,
+		threaded ? "through the label table (AS_COMPUTED_GOTO)" : "through the switch");
+
+	for (auto &workload : workloads)
+	{
+		asIScriptFunction *func = module->GetFunctionByName(workload.name);
+		workload.loopInstructions = countLoopInstructions(engine, func, false);
+		workload.loopDispatches = countLoopInstructions(engine, func, true);
+		results.push_back({ workload.name, {} });
+
+		for (unsigned int i = 0; i < iterations; ++i)
+		{
+			context->Prepare(func);
+			context->SetArgDWord(0, workload.loopCount);
+
+			Clock::time_point start = Clock::now();
+			int r = context->Execute();
+			results.back().milliseconds.push_back(std::chrono::duration<double, std::milli>(Clock::now() - start).count());
+
+			if (r != asEXECUTION_FINISHED)
+			{
+				std::cerr << workload.name << ": the script didn't finish" << std::endl;
+				context->Release();
+				engine->ShutDownAndRelease();
+				return 1;
+			}
+		}
+	}
+
+	context->Release();
+	engine->ShutDownAndRelease();
+
+	std::cout << fmtString("\n%-16s %10s %10s %13s %10s %10s %12s\n", "", "loops", "instr/loop", "dispatch/loop", "min ms",
+		"median ms", "Minstr/s");
+	for (size_t i = 0; i < results.size(); ++i)
+	{
+		const auto &workload = workloads[i];
+		double instructions = static_cast<double>(workload.loopInstructions) * workload.loopCount;
+		if (workload.loopInstructions)
+		{
+			std::cout << fmtString("%-16s %10d %10llu %13llu %10.3f %10.3f %12.1f\n", workload.name, workload.loopCount,
+				static_cast<unsigned long long>(workload.loopInstructions), static_cast<unsigned long long>(workload.loopDispatches),
+				results[i].min(), results[i].median(), instructions / (results[i].median() * 1000.0));
+		}
+		else
+		{
+			std::cout << fmtString("%-16s %10d %10s %13s %10.3f %10.3f %12s\n", workload.name, workload.loopCount, "?", "?",
+				results[i].min(), results[i].median(), "?");
+		}
+	}
+	return 0;
+}
+
+// opcodes [top]
+// Runs the VM and profiler workloads and reports the instructions they executed, from a library
+// built with AS_OPCODE_STATS. The opcode pairs are the candidates for superinstructions
+static int benchOpcodes(const std::vector<std::string> &arguments, const Registry &)
+{
+	unsigned int top = std::max(1u, parseCount(arguments, 0, 20));
+
+	if (!strstr(asGetLibraryOptions(), "AS_OPCODE_STATS"))
+	{
+		std::cerr << "The AngelScript library must be built with AS_OPCODE_STATS to count the executed instructions" << std::endl;
+		return 1;
+	}
+
+	asIScriptEngine *engine = asCreateScriptEngine(ANGELSCRIPT_VERSION);
+	engine->SetMessageCallback(asFUNCTION(AngelScriptMessageCallback), 0, asCALL_CDECL);
+	RegisterStdString(engine);
+
+	asIScriptModule *module = engine->GetModule("bench", asGM_ALWAYS_CREATE);
+	module->AddScriptSection("vm", cVmScript);
+	module->AddScriptSection("profiler", cProfileScript);
+	if (module->Build() < 0)
+	{
+		engine->ShutDownAndRelease();
+		return -1;
+	}
+
+	struct
+	{
+		const char *name;
+		int argument;
+	} workloads[] = {
+		{ "loops", 200000 },
+		{ "floats", 200000 },
+		{ "calls", 100000 },
+		{ "strings", 20000 },
+		{ "run", 2000 },
+	};
+
+	int failures = 0;
+	asIScriptContext *context = engine->CreateContext();
+	for (const auto &workload : workloads)
+	{
+		context->Prepare(module->GetFunctionByName(workload.name));
+		context->SetArgDWord(0, workload.argument);
+		if (context->Execute() != asEXECUTION_FINISHED)
+		{
+			std::cerr << workload.name << ": the script didn't finish" << std::endl;
+			failures++;
+		}
+	}
+	context->Release();
+
+	OpcodeProfile profile;
+	profile.addExecuted(engine);
+	engine->ShutDownAndRelease();
+
+	printOpcodeProfile(profile, top);
+	return failures ? 1 : 0;
+}
+
+// Math heavy workloads for the JIT. They only use the instructions it translates in their loops
+static const char *cJitScript = R"(
+int ints(int n)
+{
+	int a = 1;
+	int b = 0;
+	for (int i = 0; i < n; i++)
+	{
+		a = a * 1103515245 + 12345;
+		b ^= (a >> 7) & 0xffff;
+		b += (a % 1000) - (i / 3);
+		if (b > 100000)
+			b -= 50000;
+		else if (b < -100000)
+			b = -b;
+	}
+	return a + b;
+}
+
+uint bits(int n)
+{
+	uint h = 2166136261;
+	for (int i = 0; i < n; i++)
+	{
+		h ^= uint(i) & 0xff;
+		h *= 16777619;
+		h = (h << 3) | (h >> 29);
+		h += h / 7 + h % 13;
+	}
+	return h;
+}
+
+int64 wide(int n)
+{
+	int64 s = 0;
+	for (int i = 0; i < n; i++)
+	{
+		int64 v = int64(i) * 6700417;
+		s = s * 31 + (v ^ (s >> 11));
+		s -= v & 0xffff;
+	}
+	return s;
+}
+
+float floats(int n)
+{
+	float x = 0.5f;
+	float v = 0;
+	for (int i = 0; i < n; i++)
+	{
+		x = x * 3.7f * (1 - x);
+		v += x / (1.0f + float(i % 10));
+		if (v > 1000.0f)
+			v -= 999.5f;
+	}
+	return v;
+}
+
+double mandelbrot(int n)
+{
+	int inside = 0;
+	for (int y = 0; y < n; y++)
+	{
+		for (int x = 0; x < n; x++)
+		{
+			double cr = x * 3.0 / n - 2.0;
+			double ci = y * 2.0 / n - 1.0;
+			double zr = 0;
+			double zi = 0;
+			int k = 0;
+			while (k < 50 && zr * zr + zi * zi <= 4.0)
+			{
+				double t = zr * zr - zi * zi + cr;
+				zi = 2 * zr * zi + ci;
+				zr = t;
+				k++;
+			}
+			if (k == 50)
+				inside++;
+		}
+	}
+	return n > 0 ? double(inside) / n / n : 0;
+}
+
+int conversions(int n)
+{
+	int s = 0;
+	for (int i = 0; i < n; i++)
+	{
+		double d = i * 0.37;
+		float f = float(d) - 0.5f;
+		s += int(f) - int(d * 0.5) + int(-f);
+	}
+	return s;
+}
+
+int divide(int n)
+{
+	int s = 0;
+	for (int i = n; i >= 0; i--)
+		s += 1000 / i;
+	return s;
+}
+)";
+
+// The JitEntry instructions change the bytecode a little, e.g. where the line callback is called,
+// so the JIT is checked against the VM running the same bytecode
+static asIScriptModule *buildJitScript(CScriptJIT *jit, bool jitInstructions)
+{
+	asIScriptEngine *engine = asCreateScriptEngine(ANGELSCRIPT_VERSION);
+	engine->SetMessageCallback(asFUNCTION(AngelScriptMessageCallback), 0, asCALL_CDECL);
+	engine->SetEngineProperty(asEP_INCLUDE_JIT_INSTRUCTIONS, jitInstructions);
+	if (jit)
+	{
+		engine->SetJITCompiler(jit);
+	}
+
+	asIScriptModule *module = engine->GetModule("bench", asGM_ALWAYS_CREATE);
+	module->AddScriptSection("bench", cJitScript);
+	if (module->Build() < 0)
+	{
+		engine->ShutDownAndRelease();
+		return nullptr;
+	}
+	return module;
+}
+
+static void countLines(asIScriptContext *, int *lines)
+{
+	++*lines;
+}
+
+// How a call ended, compared between the VM and the JIT
+struct JitCallResult
+{
+	int state;
+	asQWORD value;
+	std::string exception;
+	int exceptionLine;
+	int lines;
+
+	bool operator==(const JitCallResult &other) const
+	{
+		return state == other.state && value == other.value && exception == other.exception &&
+			exceptionLine == other.exceptionLine && lines == other.lines;
+	}
+};
+
+static JitCallResult callJitScript(asIScriptContext *context, asIScriptFunction *func, int n, bool lineCallback)
+{
+	JitCallResult result = { 0, 0, "", 0, 0 };
+	if (lineCallback)
+	{
+		context->SetLineCallback(asFUNCTION(countLines), &result.lines, asCALL_CDECL);
+	}
+
+	context->Prepare(func);
+	context->SetArgDWord(0, n);
+	result.state = context->Execute();
+	if (result.state == asEXECUTION_FINISHED)
+	{
+		int typeId = func->GetReturnTypeId();
+		bool wide = typeId == asTYPEID_INT64 || typeId == asTYPEID_UINT64 || typeId == asTYPEID_DOUBLE;
+		result.value = wide ? context->GetReturnQWord() : context->GetReturnDWord();
+	}
+	else if (result.state == asEXECUTION_EXCEPTION)
+	{
+		result.exception = context->GetExceptionString();
+		result.exceptionLine = context->GetExceptionLineNumber();
+	}
+
+	context->ClearLineCallback();
+	return result;
+}
+
+// jit [iterations]
+// Checks that the JIT computes the same as the VM and compares the time both take on math heavy scripts
+static int benchJit(const std::vector<std::string> &arguments, const Registry &)
+{
+	unsigned int iterations = std::max(1u, parseCount(arguments, 0, 5));
+
+	if (!CScriptJIT::IsSupported())
+	{
+		std::cout << "The JIT only supports x86-64 Linux" << std::endl;
+		return 0;
+	}
+
+	CScriptJIT jit;
+	asIScriptModule *vmModule = buildJitScript(nullptr, false);
+	asIScriptModule *checkModule = buildJitScript(nullptr, true);
+	asIScriptModule *jitModule = buildJitScript(&jit, true);
+	if (!vmModule || !checkModule || !jitModule)
+	{
+		for (asIScriptModule *module : { vmModule, checkModule, jitModule })
+		{
+			if (module)
+				module->GetEngine()->ShutDownAndRelease();
+		}
+		return -1;
+	}
+
+	asIScriptContext *vmContext = vmModule->GetEngine()->CreateContext();
+	asIScriptContext *checkContext = checkModule->GetEngine()->CreateContext();
+	asIScriptContext *jitContext = jitModule->GetEngine()->CreateContext();
+
+	struct
+	{
+		const char *name;
+		int n;
+	} workloads[] = {
+		{ "ints", 5000000 },
+		{ "bits", 5000000 },
+		{ "wide", 5000000 },
+		{ "floats", 5000000 },
+		{ "mandelbrot", 300 },
+		{ "conversions", 5000000 },
+	};
+
+	// Every function with small arguments, with and without a line callback, which makes
+	// the JIT return to the VM at every statement. divide ends in a division by zero
+	static const int cCheckArguments[] = { 0, 1, 2, 7, 100, 1000 };
+	size_t checks = 0;
+	size_t mismatches = 0;
+	for (asUINT i = 0; i < checkModule->GetFunctionCount(); ++i)
+	{
+		asIScriptFunction *vmFunc = checkModule->GetFunctionByIndex(i);
+		asIScriptFunction *jitFunc = jitModule->GetFunctionByName(vmFunc->GetName());
+		for (int n : cCheckArguments)
+		{
+			for (bool lineCallback : { false, true })
+			{
+				JitCallResult expected = callJitScript(checkContext, vmFunc, n, lineCallback);
+				JitCallResult actual = callJitScript(jitContext, jitFunc, n, lineCallback);
+				++checks;
+				if (!(expected == actual))
+				{
+					++mismatches;
+					std::cerr << fmtString("%s(%d)%s: the VM returned %d/0x%llx after %d lines, the JIT %d/0x%llx after %d lines\n",
+						vmFunc->GetName(), n, lineCallback ? " with line callback" : "", expected.state,
+						static_cast<unsigned long long>(expected.value), expected.lines, actual.state,
+						static_cast<unsigned long long>(actual.value), actual.lines);
+				}
+			}
+		}
+	}
+
+	std::cout << fmtString("Compiled %u functions, %u instructions translated and %u left to the VM\n",
+		jit.GetCompiledFunctionCount(), jit.GetCompiledInstructionCount(), jit.GetFallbackInstructionCount());
+	std::cout << fmtString("Checked %zu calls against the VM, %zu differed\n", checks, mismatches);
+
+	std::vector<BenchSamples> vmResults;
+	std::vector<BenchSamples> jitResults;
+	for (const auto &workload : workloads)
+	{
+		vmResults.push_back({ workload.name, {} });
+		jitResults.push_back({ workload.name, {} });
+		for (unsigned int i = 0; i < iterations; ++i)
+		{
+			for (bool useJit : { false, true })
+			{
+				asIScriptContext *context = useJit ? jitContext : vmContext;
+				asIScriptModule *module = useJit ? jitModule : vmModule;
+
+				Clock::time_point start = Clock::now();
+				JitCallResult result = callJitScript(context, module->GetFunctionByName(workload.name), workload.n, false);
+				double milliseconds = std::chrono::duration<double, std::milli>(Clock::now() - start).count();
+				(useJit ? jitResults : vmResults).back().milliseconds.push_back(milliseconds);
+
+				if (result.state != asEXECUTION_FINISHED)
+				{
+					std::cerr << workload.name << ": the script didn't finish" << std::endl;
+					++mismatches;
+				}
+			}
+		}
+	}
+
+	vmContext->Release();
+	checkContext->Release();
+	jitContext->Release();
+	for (asIScriptModule *module : { vmModule, checkModule, jitModule })
+	{
+		module->GetEngine()->ShutDownAndRelease();
+	}
+
+	std::cout << fmtString("\n%-16s %10s %10s %10s %10s %10s %10s\n", "", "n", "vm min ms", "vm median", "jit min ms",
+		"jit median", "speedup");
+	for (size_t i = 0; i < vmResults.size(); ++i)
+	{
+		std::cout << fmtString("%-16s %10d %10.3f %10.3f %10.3f %10.3f %9.2fx\n", workloads[i].name, workloads[i].n,
+			vmResults[i].min(), vmResults[i].median(), jitResults[i].min(), jitResults[i].median(),
+			vmResults[i].median() / jitResults[i].median());
+	}
+
+	return mismatches ? 1 : 0;
+}
+
+// Rings of script objects that only the cycle collector can free. Every tenth ring is kept
+// alive for a while, so that some of the objects are promoted before they become garbage
+static const char *cGcScript = R"(
+class Node
+{
+	Node @next;
+	Node @back;
+	Node @keep;
+}
+
+Node @survivors;
+
+void frame(int f, int rings, int size)
+{
+	for (int r = 0; r < rings; r++)
+	{
+		Node @first = Node();
+		Node @last = first;
+		for (int i = 1; i < size; i++)
+		{
+			Node @node = Node();
+			@last.next = node;
+			@node.back = last;
+			@last = node;
+		}
+		@last.next = first;
+
+		if (r % 10 == 0)
+		{
+			@first.keep = survivors;
+			@survivors = first;
+		}
+	}
+
+	if (f % 50 == 49)
+		@survivors = null;
+}
+)";
+
+struct GcPolicy
+{
+	const char *name;
+	asDWORD flags;
+	asUINT iterations;
+	asUINT promotionAge;
+};
+
+struct GcResult
+{
+	std::vector<double> pauses;
+	double totalMilliseconds = 0.0;
+	asUINT objectsAfterFrames = 0;
+	asUINT objectsAfterFullCycle = 0;
+	asUINT detected = 0;
+};
+
+static double percentile(const std::vector<double> &sorted, double fraction)
+{
+	return sorted[std::min(sorted.size() - 1, static_cast<size_t>(fraction * sorted.size()))];
+}
+
+static bool runGcPolicy(const GcPolicy &policy, unsigned int frames, int rings, int size, GcResult &result)
+{
+	asIScriptEngine *engine = asCreateScriptEngine(ANGELSCRIPT_VERSION);
+	engine->SetMessageCallback(asFUNCTION(AngelScriptMessageCallback), 0, asCALL_CDECL);
+
+	// All collection happens in the timed calls below
+	engine->SetEngineProperty(asEP_AUTO_GARBAGE_COLLECT, false);
+	engine->SetEngineProperty(asEP_GC_PROMOTION_AGE, policy.promotionAge);
+
+	asIScriptModule *module = engine->GetModule("bench", asGM_ALWAYS_CREATE);
+	module->AddScriptSection("bench", cGcScript);
+	if (module->Build() < 0)
+	{
+		engine->ShutDownAndRelease();
+		return false;
+	}
+
+	asIScriptFunction *func = module->GetFunctionByName("frame");
+	asIScriptContext *context = engine->CreateContext();
+
+	for (unsigned int f = 0; f < frames; ++f)
+	{
+		context->Prepare(func);
+		context->SetArgDWord(0, f);
+		context->SetArgDWord(1, rings);
+		context->SetArgDWord(2, size);
+		if (context->Execute() != asEXECUTION_FINISHED)
+		{
+			std::cerr << "The script didn't finish" << std::endl;
+			context->Release();
+			engine->ShutDownAndRelease();
+			return false;
+		}
+
+		Clock::time_point start = Clock::now();
+		engine->GarbageCollect(policy.flags, policy.iterations);
+		result.pauses.push_back(std::chrono::duration<double, std::micro>(Clock::now() - start).count());
+		result.totalMilliseconds += result.pauses.back() / 1000.0;
+	}
+
+	engine->GetGCStatistics(&result.objectsAfterFrames, nullptr, &result.detected);
+
+	// Whatever the policy left behind must still be collectable
+	engine->DiscardModule("bench");
+	engine->GarbageCollect(asGC_FULL_CYCLE);
+	engine->GetGCStatistics(&result.objectsAfterFullCycle);
+
+	context->Release();
+	engine->ShutDownAndRelease();
+
+	std::sort(result.pauses.begin(), result.pauses.end());
+	return true;
+}
+
+// gc [frames] [ring size]
+// Creates cyclic garbage every frame and reports the pause of the collection after each frame
+static int benchGc(const std::vector<std::string> &arguments, const Registry &)
+{
+	unsigned int frames = std::max(1u, parseCount(arguments, 0, 500));
+	int size = static_cast<int>(std::max(2u, parseCount(arguments, 1, 20)));
+	const int rings = 50;
+
+	static const GcPolicy cPolicies[] = {
+		{ "full cycle", asGC_FULL_CYCLE, 1, 3 },
+		{ "100 steps", asGC_ONE_STEP, 100, 3 },
+		{ "1000 steps", asGC_ONE_STEP, 1000, 3 },
+		{ "200us", asGC_ONE_STEP | asGC_TIME_BUDGET, 200, 3 },
+		{ "200us age 1", asGC_ONE_STEP | asGC_TIME_BUDGET, 200, 1 },
+		{ "200us age 8", asGC_ONE_STEP | asGC_TIME_BUDGET, 200, 8 },
+		{ "1000us", asGC_ONE_STEP | asGC_TIME_BUDGET, 1000, 3 },
+	};
+
+	std::cout << fmtString("Running %u frames of %d rings of %d objects\n", frames, rings, size);
+	std::cout << fmtString("\n%-16s %9s %9s %9s %9s %10s %9s %9s %9s\n", "", "p50 us", "p90 us", "p99 us", "max us",
+		"total ms", "in gc", "detected", "leaked");
+
+	int failures = 0;
+	for (const GcPolicy &policy : cPolicies)
+	{
+		GcResult result;
+		if (!runGcPolicy(policy, frames, rings, size, result))
+			return -1;
+
+		std::cout << fmtString("%-16s %9.1f %9.1f %9.1f %9.1f %10.2f %9u %9u %9u\n", policy.name,
+			percentile(result.pauses, 0.5), percentile(result.pauses, 0.9), percentile(result.pauses, 0.99),
+			result.pauses.back(), result.totalMilliseconds, result.objectsAfterFrames, result.detected,
+			result.objectsAfterFullCycle);
+
+		if (result.objectsAfterFullCycle)
+			failures++;
+	}
+
+	if (failures)
+		std::cerr << "Objects were left in the garbage collector after the final full cycle" << std::endl;
+	return failures ? 1 : 0;
+}
+
+// Every iteration creates eight string constants through the string factory
+static const char *cStringScript = R"(
+int literals(int n)
+{
+	int total = 0;
+	for (int i = 0; i < n; i++)
+	{
+		total += "alpha".length();
+		total += "beta".length();
+		total += "gamma".length();
+		total += "delta".length();
+		total += "a literal long enough to live on the heap".length();
+		total += "zeta".length();
+		total += "eta".length();
+		total += "theta".length();
+	}
+	return total;
+}
+)";
+
+// strings [max threads] [iterations]
+// Runs a script full of string literals in one engine from a growing number of threads
+static int benchStrings(const std::vector<std::string> &arguments, const Registry &)
+{
+	unsigned int maxThreads = std::max(1u, parseCount(arguments, 0, std::max(4u, std::thread::hardware_concurrency())));
+	unsigned int iterations = std::max(1u, parseCount(arguments, 1, 5));
+	const int loops = 500000;
+	const int literalsPerLoop = 8;
+	const int expected = loops * (5 + 4 + 5 + 5 + 41 + 4 + 3 + 5);
+
+	asPrepareMultithread();
+
+	asIScriptEngine *engine = asCreateScriptEngine(ANGELSCRIPT_VERSION);
+	engine->SetMessageCallback(asFUNCTION(AngelScriptMessageCallback), 0, asCALL_CDECL);
+	RegisterStdString(engine);
+
+	asIScriptModule *module = engine->GetModule("bench", asGM_ALWAYS_CREATE);
+	module->AddScriptSection("bench", cStringScript);
+	if (module->Build() < 0)
+	{
+		engine->ShutDownAndRelease();
+		asUnprepareMultithread();
+		return -1;
+	}
+	asIScriptFunction *func = module->GetFunctionByName("literals");
+
+	std::cout << fmtString("Running %d literals per thread %u times per thread count\n", loops * literalsPerLoop, iterations);
+	std::cout << fmtString("\n%-8s %10s %10s %14s %10s\n", "threads", "min ms", "median ms", "Mliterals/s", "scaling");
+
+	std::atomic<int> failures(0);
+	double singleThroughput = 0.0;
+	for (unsigned int threads = 1; threads <= maxThreads; threads *= 2)
+	{
+		BenchSamples samples;
+		for (unsigned int i = 0; i < iterations; ++i)
+		{
+			std::vector<std::thread> workers;
+			Clock::time_point start = Clock::now();
+			for (unsigned int t = 0; t < threads; ++t)
+			{
+				workers.emplace_back([&]()
+				{
+					asIScriptContext *context = engine->CreateContext();
+					context->Prepare(func);
+					context->SetArgDWord(0, loops);
+					if (context->Execute() != asEXECUTION_FINISHED || static_cast<int>(context->GetReturnDWord()) != expected)
+						failures++;
+					context->Release();
+					asThreadCleanup();
+				});
+			}
+			for (auto &worker : workers)
+			{
+				worker.join();
+			}
+			samples.milliseconds.push_back(std::chrono::duration<double, std::milli>(Clock::now() - start).count());
+		}
+
+		double throughput = static_cast<double>(threads) * loops * literalsPerLoop / (samples.median() * 1000.0);
+		if (threads == 1)
+			singleThroughput = throughput;
+		std::cout << fmtString("%-8u %10.3f %10.3f %14.2f %9.2fx\n", threads, samples.min(), samples.median(), throughput,
+			throughput / singleThroughput);
+	}
+
+	engine->ShutDownAndRelease();
+	asUnprepareMultithread();
+
+	if (failures)
+		std::cerr << failures << " runs returned the wrong result" << std::endl;
+	return failures ? 1 : 0;
+}
+
+int runBench(const std::string &suite, const std::vector<std::string> &arguments, const Registry &registry)
+{
+	static const struct
+	{
+		const char *name;
+		int (*run)(const std::vector<std::string> &, const Registry &);
+	} cSuites[] = {
+		{ "calls", benchCalls },
+		{ "clone", benchClone },
+		{ "gc", benchGc },
+		{ "jit", benchJit },
+		{ "load", benchLoad },
+		{ "opcodes", benchOpcodes },
+		{ "profiler", benchProfiler },
+		{ "read", benchRead },
+		{ "registry", benchRegistry },
+		{ "startup", benchStartup },
+		{ "strings", benchStrings },
+		{ "vm", benchVm },
+	};
+
+	for (const auto &entry : cSuites)
+	{
+		if (suite == entry.name)
+		{
+			return entry.run(arguments, registry);
+		}
+	}
+
+	std::cerr << "Unknown benchmark suite '" << suite << "'. Available:";
+	for (const auto &entry : cSuites)
+	{
+		std::cerr << " " << entry.name;
+	}
+	std::cerr << std::endl;
+	return 1;
+}
@@ -0,0 +1,9 @@
+#pragma once
+
+#include "registry.h"
+
+#include <string>
+#include <vector>
+
+// Implementation of "csasm bench <suite> [arguments]". Returns the process exit code.
+int runBench(const std::string &suite, const std::vector<std::string> &arguments, const Registry &registry);
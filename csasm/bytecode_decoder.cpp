@@ -0,0 +1,480 @@
+#include "bytecode_decoder.h"
+
+#include "output_sink.h"
+#include "timings.h"
+
+#include <cstring>
+
+#include <boost/algorithm/string/replace.hpp>
+
+#include "angelscript.h"
+#include <../source/as_scriptengine.h>
+
+// #todo-csasm: Investigate DW_DW layout further
+#define asBC_DWORDARG1(x)  (*(((asDWORD*)x)+2))
+// #todo-csasm: Investigate wW_rW_rW layout further
+#define asBC_WORDARG2(x)  (*(((asWORD*)x)+3))
+
+static void addOperand(DecodedInstruction &inst, OperandKind kind, int64_t value)
+{
+	Operand &operand = inst.operands[inst.operandCount++];
+	operand.kind = kind;
+	operand.i = value;
+}
+
+static void addUnsignedOperand(DecodedInstruction &inst, OperandKind kind, uint64_t value)
+{
+	Operand &operand = inst.operands[inst.operandCount++];
+	operand.kind = kind;
+	operand.u = value;
+}
+
+static void addFloatOperand(DecodedInstruction &inst, float value)
+{
+	Operand &operand = inst.operands[inst.operandCount++];
+	operand.kind = OperandKind::Float;
+	operand.f = value;
+}
+
+static void addVariable(DecodedInstruction &inst, asWORD var)
+{
+	addOperand(inst, OperandKind::Variable, reinterpret_cast<int16_t&>(var));
+}
+
+static void addSymbol(DecodedFunction &function, DecodedInstruction &inst, SymbolKind kind, int32_t id, const char *text)
+{
+	SymbolRef &symbol = inst.symbols[inst.symbolCount++];
+	symbol.kind = kind;
+	symbol.id = id;
+	symbol.textOffset = static_cast<uint32_t>(function.symbolText.size());
+	symbol.textLength = static_cast<uint32_t>(strlen(text));
+	function.symbolText.append(text, symbol.textLength);
+}
+
+static void addGlobalProperty(DecodedFunction &function, DecodedInstruction &inst, asCScriptFunction *owner, asDWORD address)
+{
+	asCGlobalProperty* prop = owner->GetPropertyByGlobalVarPtr(reinterpret_cast<void*>(address));
+	addSymbol(function, inst, SymbolKind::GlobalProperty,
+		prop ? prop->id : -1,
+		prop ? prop->name.AddressOf() : "{unknown}");
+}
+
+DecodedFunction decodeFunction(asIScriptFunction* func)
+{
+	DecodedFunction decoded;
+	decoded.declaration = func->GetDeclaration(true, true, true);
+
+	asCScriptFunction* function = static_cast<asCScriptFunction*>(func);
+	asCScriptEngine* engine = static_cast<asCScriptEngine*>(function->GetEngine());
+
+	asUINT length;
+	asDWORD* code = function->GetByteCode(&length);
+	if (!code)
+	{
+		return decoded;
+	}
+
+	for (uint32_t position = 0; position < length; )
+	{
+		// Read opcode
+		asDWORD* inst = code + position;
+		asEBCInstr op = static_cast<asEBCInstr>(*reinterpret_cast<asBYTE*>(inst));
+
+		DecodedInstruction out = {};
+		out.position = position;
+		out.op = op;
+
+		switch (asBCInfo[op].type)
+		{
+		case asBCTYPE_NO_ARG: // no args
+			break;
+		case asBCTYPE_W_ARG: // word imm
+		{
+			asWORD arg0 = asBC_WORDARG0(inst);
+			addOperand(out, OperandKind::Int, arg0);
+			if (op == asBC_STR)
+			{
+				const auto& str = engine->GetConstantString(arg0);
+				std::string formatted = str.AddressOf();
+				boost::replace_all(formatted, "\\", "\\\\");
+				boost::replace_all(formatted, "\n", "\\n");
+				addSymbol(decoded, out, SymbolKind::String, str.GetLength(), formatted.c_str());
+			}
+		}
+		break;
+		case asBCTYPE_wW_ARG: // word var dst
+		case asBCTYPE_rW_ARG: // word var src
+			addVariable(out, asBC_WORDARG0(inst));
+			break;
+		case asBCTYPE_wW_rW_ARG: // word dst, word src
+		case asBCTYPE_rW_rW_ARG: // word src, word src
+			addVariable(out, asBC_WORDARG0(inst));
+			addVariable(out, asBC_WORDARG1(inst));
+			break;
+		case asBCTYPE_wW_W_ARG: // word dst, word imm
+		{
+			uint16_t arg1 = asBC_WORDARG1(inst);
+			addVariable(out, asBC_WORDARG0(inst));
+			addOperand(out, OperandKind::Int, reinterpret_cast<int16_t&>(arg1));
+		}
+		break;
+		case asBCTYPE_wW_rW_DW_ARG: // word dst, word src, dword imm
+		case asBCTYPE_rW_W_DW_ARG:  // word src, word imm, dword imm
+		{
+			uint32_t arg2 = asBC_DWORDARG(inst);
+			addVariable(out, asBC_WORDARG0(inst));
+			addVariable(out, asBC_WORDARG1(inst));
+			switch (op)
+			{
+			case asBC_ADDIf:
+			case asBC_SUBIf:
+			case asBC_MULIf:
+				addFloatOperand(out, reinterpret_cast<float&>(arg2));
+				break;
+			default:
+				addOperand(out, OperandKind::Int, reinterpret_cast<int16_t&>(arg2));
+				break;
+			}
+		}
+		break;
+		case asBCTYPE_DW_ARG: // dword imm
+		{
+			uint32_t arg0 = asBC_DWORDARG(inst);
+			switch (op)
+			{
+			case asBC_OBJTYPE:
+			{
+				asIObjectType* type = reinterpret_cast<asIObjectType*>(arg0);
+				addUnsignedOperand(out, OperandKind::Hex, arg0);
+				addSymbol(decoded, out, SymbolKind::Type, 0, type->GetName());
+			}
+			break;
+			case asBC_FuncPtr:
+			{
+				asIScriptFunction* target = reinterpret_cast<asIScriptFunction*>(arg0);
+				addUnsignedOperand(out, OperandKind::Hex, arg0);
+				addSymbol(decoded, out, SymbolKind::FunctionPtr, 0, target->GetDeclaration());
+			}
+			break;
+			case asBC_PshC4:
+			case asBC_Cast:
+				addUnsignedOperand(out, OperandKind::DwordBits, arg0);
+				break;
+			case asBC_TYPEID:
+				addUnsignedOperand(out, OperandKind::Hex, arg0);
+				addSymbol(decoded, out, SymbolKind::TypeDecl, reinterpret_cast<int&>(arg0),
+					engine->GetTypeDeclaration(reinterpret_cast<int&>(arg0)));
+				break;
+			case asBC_PGA: // global vars
+			case asBC_PshGPtr:
+			case asBC_LDG:
+			case asBC_PshG4:
+				addUnsignedOperand(out, OperandKind::Hex, arg0);
+				addGlobalProperty(decoded, out, function, arg0);
+				break;
+			case asBC_CALL:
+			case asBC_CALLSYS:
+			case asBC_CALLBND:
+			case asBC_CALLINTF:
+			case asBC_Thiscall1:
+			{
+				asIScriptFunction* callee;
+				if (arg0 & 0x40000000)
+				{
+					callee = engine->importedFunctions[reinterpret_cast<int&>(arg0) & ~0x40000000]->importedFunctionSignature;
+				}
+				else
+				{
+					callee = engine->GetFunctionById(reinterpret_cast<int&>(arg0));
+				}
+
+				addOperand(out, OperandKind::Int, reinterpret_cast<int&>(arg0));
+				addSymbol(decoded, out, SymbolKind::Function, reinterpret_cast<int&>(arg0),
+					callee ? callee->GetDeclaration(true, true, true) : "{no func}");
+			}
+			break;
+			case asBC_REFCPY:
+				addUnsignedOperand(out, OperandKind::Hex, arg0);
+				break;
+			case asBC_JMP:
+			case asBC_JZ:
+			case asBC_JLowZ:
+			case asBC_JS:
+			case asBC_JP:
+			case asBC_JNZ:
+			case asBC_JLowNZ:
+			case asBC_JNS:
+			case asBC_JNP:
+				addOperand(out, OperandKind::JumpOffset, reinterpret_cast<int&>(arg0));
+				break;
+			default:
+				addOperand(out, OperandKind::Int, reinterpret_cast<int&>(arg0));
+				break;
+			}
+		}
+		break;
+		case asBCTYPE_QW_ARG: // qword imm
+			// #todo-csasm: Potentially add 64-bit pointer opcode handling
+			addUnsignedOperand(out, OperandKind::QwordBits, asBC_QWORDARG(inst));
+			break;
+		case asBCTYPE_wW_QW_ARG: // word dst, qword imm
+		case asBCTYPE_rW_QW_ARG: // word src, qword imm
+		{
+			uint64_t arg1 = asBC_QWORDARG(inst);
+			addVariable(out, asBC_WORDARG0(inst));
+			switch (op)
+			{
+			case asBC_RefCpyV:
+			case asBC_FREE:
+			{
+				asIObjectType* type = reinterpret_cast<asIObjectType*>(arg1);
+				addUnsignedOperand(out, OperandKind::Hex, static_cast<uint32_t>(arg1));
+				addSymbol(decoded, out, SymbolKind::Type, 0, type->GetName());
+			}
+			break;
+			default:
+				addUnsignedOperand(out, OperandKind::QwordBits, arg1);
+				break;
+			}
+		}
+		break;
+		case asBCTYPE_DW_DW_ARG: // dword imm, dword imm
+		{
+			uint32_t arg0 = asBC_DWORDARG(inst);
+			uint32_t arg1 = asBC_DWORDARG1(inst);
+			switch (op)
+			{
+			case asBC_ALLOC:
+			{
+				asIObjectType* type = reinterpret_cast<asIObjectType*>(arg0);
+				asIScriptFunction* constructor = engine->GetFunctionById(asBC_WORDARG0(inst));
+				addUnsignedOperand(out, OperandKind::Hex, arg0);
+				addOperand(out, OperandKind::Int, reinterpret_cast<int&>(arg1));
+				addSymbol(decoded, out, SymbolKind::Type, 0, type->GetName());
+				addSymbol(decoded, out, SymbolKind::Function, asBC_WORDARG0(inst),
+					constructor ? constructor->GetDeclaration() : "{no func}");
+			}
+			break;
+			case asBC_SetG4:
+				addUnsignedOperand(out, OperandKind::Hex, arg0);
+				addOperand(out, OperandKind::Int, reinterpret_cast<int&>(arg1));
+				addGlobalProperty(decoded, out, function, arg0);
+				break;
+			default:
+				addUnsignedOperand(out, OperandKind::UInt, arg0);
+				addOperand(out, OperandKind::Int, reinterpret_cast<int&>(arg1));
+				break;
+			}
+		}
+		break;
+		case asBCTYPE_rW_DW_DW_ARG: // word src, dword imm, dword imm
+			addVariable(out, asBC_WORDARG0(inst));
+			addUnsignedOperand(out, OperandKind::UInt, asBC_DWORDARG(inst));
+			addUnsignedOperand(out, OperandKind::UInt, asBC_DWORDARG1(inst));
+			break;
+		case asBCTYPE_QW_DW_ARG: // qword imm, dword imm
+		{
+			// #todo-csasm: Consider adding support for 64-bit asBC_ALLOC
+			uint32_t arg1 = asBC_DWORDARG(inst);
+			addUnsignedOperand(out, OperandKind::UInt64, asBC_QWORDARG(inst));
+			addOperand(out, OperandKind::Int, reinterpret_cast<int&>(arg1));
+		}
+		break;
+		case asBCTYPE_INFO: // word imm
+			// Labels and blocks are printed specially, see formatInstruction
+			addOperand(out, OperandKind::Int, asBC_WORDARG0(inst));
+			break;
+		case asBCTYPE_rW_DW_ARG: // word src, dword imm
+		case asBCTYPE_wW_DW_ARG: // word dst, dword imm
+		case asBCTYPE_W_DW_ARG: // word imm, dword imm
+		{
+			uint32_t arg1 = asBC_DWORDARG(inst);
+			addVariable(out, asBC_WORDARG0(inst));
+			switch (op)
+			{
+			case asBC_SetV1:
+				addUnsignedOperand(out, OperandKind::Hex, static_cast<uint8_t>(arg1));
+				break;
+			case asBC_SetV2:
+				addUnsignedOperand(out, OperandKind::Hex, static_cast<uint16_t>(arg1));
+				break;
+			case asBC_SetV4:
+				addUnsignedOperand(out, OperandKind::DwordBits, arg1);
+				break;
+			case asBC_CMPIf:
+				addFloatOperand(out, reinterpret_cast<float&>(arg1));
+				break;
+			case asBC_LdGRdR4: // global vars
+			case asBC_CpyGtoV4:
+			case asBC_CpyVtoV4:
+				addUnsignedOperand(out, OperandKind::Hex, arg1);
+				addGlobalProperty(decoded, out, function, arg1);
+				break;
+			default:
+				addOperand(out, OperandKind::Int, reinterpret_cast<int&>(arg1));
+				break;
+			}
+		}
+		break;
+		case asBCTYPE_wW_rW_rW_ARG: // dst word, src word, src word
+			addVariable(out, asBC_WORDARG0(inst));
+			addVariable(out, asBC_WORDARG1(inst));
+			addVariable(out, asBC_WORDARG2(inst));
+			break;
+		default:
+			__debugbreak();
+			break;
+		}
+
+		decoded.instructions.push_back(out);
+		position += asBCTypeSize[asBCInfo[op].type];
+	}
+
+	return decoded;
+}
+
+DecodedModule decodeModule(asIScriptModule* module)
+{
+	TimingScope timing("csasm::decodeModule");
+
+	DecodedModule decoded;
+	decoded.functions.reserve(module->GetFunctionCount());
+	for (unsigned int i = 0; i < module->GetFunctionCount(); ++i)
+	{
+		decoded.functions.push_back(decodeFunction(module->GetFunctionByIndex(i)));
+	}
+	return decoded;
+}
+
+static void formatOperand(OutputSink &out, const Operand &operand, uint32_t position)
+{
+	switch (operand.kind)
+	{
+	case OperandKind::Variable:
+		out.put('v');
+		out.writeInt(operand.i);
+		break;
+	case OperandKind::Int:
+		out.writeInt(operand.i);
+		break;
+	case OperandKind::UInt:
+	case OperandKind::UInt64:
+		out.writeUInt(operand.u);
+		break;
+	case OperandKind::Hex:
+		out.write("0x", 2);
+		out.writeHex(operand.u);
+		break;
+	case OperandKind::Float:
+		out.writeFloat(operand.f);
+		break;
+	case OperandKind::DwordBits:
+	{
+		uint32_t bits = static_cast<uint32_t>(operand.u);
+		out.write("0x", 2);
+		out.writeHex(bits);
+		out.write(" (i:", 4);
+		out.writeInt(reinterpret_cast<int32_t&>(bits));
+		out.write(", f:", 4);
+		out.writeFloat(reinterpret_cast<float&>(bits), 'g');
+		out.put(')');
+	}
+	break;
+	case OperandKind::QwordBits:
+	{
+		uint64_t bits = operand.u;
+		out.write("0x", 2);
+		out.writeHex(bits);
+		out.write(" (i:", 4);
+		out.writeInt(reinterpret_cast<int64_t&>(bits));
+		out.write(", f:", 4);
+		out.writeFloat(reinterpret_cast<double&>(bits), 'g');
+		out.put(')');
+	}
+	break;
+	case OperandKind::JumpOffset:
+		if (operand.i >= 0)
+			out.put('+');
+		out.writeInt(operand.i);
+		out.write(" (d:", 4);
+		out.writeHex(static_cast<uint32_t>(position + static_cast<int32_t>(operand.i)));
+		out.put(')');
+		break;
+	}
+}
+
+static void formatSymbol(OutputSink &out, const DecodedFunction &function, const SymbolRef &symbol, InstructionStyle style)
+{
+	switch (symbol.kind)
+	{
+	case SymbolKind::String:
+		if (style == InstructionStyle::Yaml)
+			out.write("length ", 7);
+		out.writeInt(symbol.id);
+		out.write(":\"", 2);
+		out.write(function.symbolText.data() + symbol.textOffset, symbol.textLength);
+		out.put('"');
+		return;
+	case SymbolKind::Type:
+		out.write("type:", 5);
+		break;
+	case SymbolKind::FunctionPtr:
+		out.write("func:", 5);
+		break;
+	case SymbolKind::TypeDecl:
+		out.write("decl:", 5);
+		break;
+	case SymbolKind::GlobalProperty:
+		out.writeInt(symbol.id);
+		out.put(':');
+		break;
+	case SymbolKind::Function:
+		break;
+	}
+	out.write(function.symbolText.data() + symbol.textOffset, symbol.textLength);
+}
+
+void formatInstruction(OutputSink &out, const DecodedFunction &function, const DecodedInstruction &instruction, InstructionStyle style)
+{
+	const char* mnem = asBCInfo[instruction.op].name;
+
+	if (asBCInfo[instruction.op].type == asBCTYPE_INFO)
+	{
+		switch (instruction.op)
+		{
+		case asBC_LABEL:
+			out.writeInt(instruction.operands[0].i);
+			out.put(':');
+			break;
+		case asBC_LINE:
+			out.writePadded(mnem, 8);
+			break;
+		case asBC_Block:
+			// #todo-csasm: Add block indenting
+			out.put(instruction.operands[0].i ? '{' : '}');
+			break;
+		default:
+			out.write("UNK", 3);
+			break;
+		}
+		return;
+	}
+
+	out.writePadded(mnem, 8);
+
+	for (uint8_t i = 0; i < instruction.operandCount; ++i)
+	{
+		out.write(i == 0 ? " " : ", ");
+		formatOperand(out, instruction.operands[i], instruction.position);
+	}
+
+	for (uint8_t i = 0; i < instruction.symbolCount; ++i)
+	{
+		out.write(i == 0 ? " (" : ", ");
+		formatSymbol(out, function, instruction.symbols[i], style);
+	}
+	if (instruction.symbolCount)
+	{
+		out.put(')');
+	}
+}
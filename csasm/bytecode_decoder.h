@@ -0,0 +1,90 @@
+#pragma once
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include "angelscript.h"
+
+class OutputSink;
+
+// How an operand is printed. The decoder picks the kind per opcode, so every
+// output format agrees on how e.g. a SetV4 immediate is shown.
+enum class OperandKind : uint8_t
+{
+	Variable,   // v%d
+	Int,        // %d
+	UInt,       // %u
+	UInt64,     // %llu
+	Hex,        // 0x%x
+	Float,      // %f
+	DwordBits,  // 0x%x (i:%d, f:%g)
+	QwordBits,  // 0x%llx (i:%lld, f:%g)
+	JumpOffset, // %+d (d:%x), relative to the instruction
+};
+
+struct Operand
+{
+	OperandKind kind;
+	union
+	{
+		int64_t i;
+		uint64_t u;
+		double f;
+	};
+};
+
+enum class SymbolKind : uint8_t
+{
+	String,         // constant string, id is its length
+	Type,           // object type name
+	FunctionPtr,    // declaration of a function pointer target
+	TypeDecl,       // type declaration of a type id
+	GlobalProperty, // global variable, id is the property id
+	Function,       // declaration of a called function
+};
+
+struct SymbolRef
+{
+	SymbolKind kind;
+	int32_t id;
+	uint32_t textOffset;
+	uint32_t textLength;
+};
+
+struct DecodedInstruction
+{
+	uint32_t position;
+	asEBCInstr op;
+	uint8_t operandCount;
+	uint8_t symbolCount;
+	Operand operands[3];
+	SymbolRef symbols[2];
+};
+
+struct DecodedFunction
+{
+	std::string declaration;
+	std::vector<DecodedInstruction> instructions;
+
+	// Backing storage for the symbol texts, referenced by offset
+	std::string symbolText;
+};
+
+// Functions in the same order as asIScriptModule::GetFunctionByIndex
+struct DecodedModule
+{
+	std::vector<DecodedFunction> functions;
+};
+
+enum class InstructionStyle
+{
+	Dump,
+	Yaml,
+};
+
+DecodedFunction decodeFunction(asIScriptFunction *func);
+DecodedModule decodeModule(asIScriptModule *module);
+
+// Appends the disassembly of one instruction, without its position or a line break
+void formatInstruction(OutputSink &out, const DecodedFunction &function, const DecodedInstruction &instruction, InstructionStyle style);
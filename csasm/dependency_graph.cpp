@@ -0,0 +1,408 @@
+#include "dependency_graph.h"
+
+#include "asf.h"
+#include "batch.h"
+#include "format.h"
+#include "json.hpp"
+
+#include <boost/filesystem/fstream.hpp>
+#include <boost/interprocess/file_mapping.hpp>
+#include <boost/interprocess/mapped_region.hpp>
+
+#include <algorithm>
+#include <chrono>
+#include <cstring>
+#include <iostream>
+#include <unordered_map>
+
+namespace fs = boost::filesystem;
+
+static const char cDependencyIndexMagic[4] = {
+	'C', 'S', 'D', 'G'
+};
+static const uint32_t cDependencyIndexVersion = 1;
+
+static const uint32_t cUnvisited = ~0u;
+
+// Reads the dependency table of one module, returns the node flags
+static uint32_t readDependencies(const fs::path &root, const std::string &name, std::vector<std::string> &dependencies)
+{
+	fs::path filePath = resolveModulePath(root, name);
+
+	boost::system::error_code error;
+	uintmax_t size = fs::file_size(filePath, error);
+	if (error)
+	{
+		return cNodeMissing;
+	}
+	if (size == 0)
+	{
+		return cNodeNotAsf;
+	}
+
+	using namespace boost::interprocess;
+	file_mapping file(filePath.string().c_str(), read_only);
+	mapped_region region(file, read_only);
+
+	BinaryCodeStream stream(static_cast<const uint8_t *>(region.get_address()), region.get_size());
+	AsfHeader header;
+	if (!readAsfHeader(stream, header))
+	{
+		return cNodeNotAsf;
+	}
+
+	dependencies = std::move(header.dependencies);
+	return 0;
+}
+
+// Tarjan's algorithm, without recursion. Components come out dependencies
+// first, which is the topological order the graph stores.
+static void findComponents(DependencyGraph &graph)
+{
+	std::vector<DependencyNode> &nodes = graph.nodes;
+
+	std::vector<uint32_t> index(nodes.size(), cUnvisited);
+	std::vector<uint32_t> lowLink(nodes.size(), 0);
+	std::vector<bool> onStack(nodes.size(), false);
+	std::vector<uint32_t> stack;
+	uint32_t nextIndex = 0;
+
+	struct Frame
+	{
+		uint32_t node;
+		size_t nextEdge;
+	};
+	std::vector<Frame> callStack;
+
+	auto visit = [&](uint32_t node)
+	{
+		index[node] = lowLink[node] = nextIndex++;
+		stack.push_back(node);
+		onStack[node] = true;
+		callStack.push_back({ node, 0 });
+	};
+
+	graph.order.reserve(nodes.size());
+	for (uint32_t start = 0; start < nodes.size(); ++start)
+	{
+		if (index[start] != cUnvisited)
+			continue;
+
+		visit(start);
+		while (!callStack.empty())
+		{
+			Frame &frame = callStack.back();
+			uint32_t node = frame.node;
+
+			if (frame.nextEdge < nodes[node].dependencies.size())
+			{
+				uint32_t dependency = nodes[node].dependencies[frame.nextEdge++];
+				if (index[dependency] == cUnvisited)
+				{
+					visit(dependency);
+				}
+				else if (onStack[dependency])
+				{
+					lowLink[node] = std::min(lowLink[node], index[dependency]);
+				}
+				continue;
+			}
+
+			callStack.pop_back();
+			if (!callStack.empty())
+			{
+				uint32_t parent = callStack.back().node;
+				lowLink[parent] = std::min(lowLink[parent], lowLink[node]);
+			}
+
+			if (lowLink[node] != index[node])
+				continue;
+
+			// node is the root of a component, everything above it on the stack belongs to it
+			size_t componentStart = graph.order.size();
+			uint32_t member;
+			do
+			{
+				member = stack.back();
+				stack.pop_back();
+				onStack[member] = false;
+				graph.order.push_back(member);
+			} while (member != node);
+
+			std::vector<uint32_t> component(graph.order.begin() + componentStart, graph.order.end());
+			auto inComponent = [&](uint32_t id)
+			{
+				return std::find(component.begin(), component.end(), id) != component.end();
+			};
+
+			// Dependencies outside the component are already done, so their depth is final
+			uint32_t depth = 0;
+			bool selfDependent = false;
+			for (uint32_t id : component)
+			{
+				for (uint32_t dependency : nodes[id].dependencies)
+				{
+					if (dependency == id)
+						selfDependent = true;
+					else if (!inComponent(dependency))
+						depth = std::max(depth, nodes[dependency].depth + 1);
+				}
+			}
+			for (uint32_t id : component)
+			{
+				nodes[id].depth = depth;
+			}
+
+			if (component.size() > 1 || selfDependent)
+			{
+				std::sort(component.begin(), component.end());
+				for (uint32_t id : component)
+				{
+					nodes[id].flags |= cNodeInCycle;
+				}
+				graph.cycles.push_back(std::move(component));
+			}
+		}
+	}
+}
+
+DependencyGraph scanDependencyGraph(const fs::path &root, const std::vector<std::string> &modules)
+{
+	// Discover every module reachable from the input
+	std::vector<std::string> names;
+	std::vector<std::vector<std::string>> tables;
+	std::vector<uint32_t> flags;
+	std::unordered_map<std::string, uint32_t> ids;
+
+	auto add = [&](const std::string &name)
+	{
+		if (ids.emplace(name, static_cast<uint32_t>(names.size())).second)
+		{
+			names.push_back(name);
+		}
+	};
+
+	for (const auto &module : modules)
+	{
+		add(module);
+	}
+	for (size_t i = 0; i < names.size(); ++i)
+	{
+		std::vector<std::string> dependencies;
+		flags.push_back(readDependencies(root, names[i], dependencies));
+		for (const auto &dependency : dependencies)
+		{
+			add(dependency);
+		}
+		tables.push_back(std::move(dependencies));
+	}
+
+	// Number the nodes by name so the output doesn't depend on the input order
+	std::vector<uint32_t> sorted(names.size());
+	for (uint32_t i = 0; i < sorted.size(); ++i)
+	{
+		sorted[i] = i;
+	}
+	std::sort(sorted.begin(), sorted.end(), [&](uint32_t a, uint32_t b) { return names[a] < names[b]; });
+
+	std::vector<uint32_t> remap(names.size());
+	for (uint32_t i = 0; i < sorted.size(); ++i)
+	{
+		remap[sorted[i]] = i;
+	}
+
+	DependencyGraph graph;
+	graph.nodes.resize(names.size());
+	for (uint32_t i = 0; i < names.size(); ++i)
+	{
+		DependencyNode &node = graph.nodes[remap[i]];
+		node.name = std::move(names[i]);
+		node.flags = flags[i];
+		node.dependencies.reserve(tables[i].size());
+		for (const auto &dependency : tables[i])
+		{
+			uint32_t id = remap[ids[dependency]];
+			node.dependencies.push_back(id);
+			graph.nodes[id].fanIn++;
+		}
+	}
+
+	findComponents(graph);
+	return graph;
+}
+
+size_t DependencyGraph::edgeCount() const
+{
+	size_t count = 0;
+	for (const auto &node : nodes)
+	{
+		count += node.dependencies.size();
+	}
+	return count;
+}
+
+int DependencyGraph::find(const std::string &name) const
+{
+	auto it = std::lower_bound(nodes.begin(), nodes.end(), name,
+		[](const DependencyNode &node, const std::string &name) { return node.name < name; });
+	if (it == nodes.end() || it->name != name)
+		return -1;
+	return static_cast<int>(it - nodes.begin());
+}
+
+void DependencyGraph::saveJson(const std::string &path) const
+{
+	nlohmann::json json;
+
+	nlohmann::json &modules = json["modules"] = nlohmann::json::array();
+	for (const auto &node : nodes)
+	{
+		nlohmann::json dependencies = nlohmann::json::array();
+		for (uint32_t dependency : node.dependencies)
+		{
+			dependencies.push_back(nodes[dependency].name);
+		}
+
+		nlohmann::json module = {
+			{ "name", node.name },
+			{ "dependencies", dependencies },
+			{ "fan_in", node.fanIn },
+			{ "depth", node.depth },
+		};
+		if (node.flags & cNodeMissing)
+			module["missing"] = true;
+		if (node.flags & cNodeNotAsf)
+			module["not_asf"] = true;
+		if (node.flags & cNodeInCycle)
+			module["in_cycle"] = true;
+
+		modules.push_back(module);
+	}
+
+	nlohmann::json &order = json["order"] = nlohmann::json::array();
+	for (uint32_t id : this->order)
+	{
+		order.push_back(nodes[id].name);
+	}
+
+	nlohmann::json &cycles = json["cycles"] = nlohmann::json::array();
+	for (const auto &cycle : this->cycles)
+	{
+		nlohmann::json members = nlohmann::json::array();
+		for (uint32_t id : cycle)
+		{
+			members.push_back(nodes[id].name);
+		}
+		cycles.push_back(members);
+	}
+
+	fs::path file(path);
+	fs::create_directories(fs::absolute(file).parent_path());
+
+	fs::ofstream stream(file);
+	stream << json.dump(1, '\t') << std::endl;
+}
+
+void DependencyGraph::saveBinary(const std::string &path) const
+{
+	std::vector<DependencyIndexNode> indexNodes;
+	std::vector<uint32_t> edges;
+	std::vector<uint32_t> cycleTable;
+	std::string strings;
+
+	indexNodes.reserve(nodes.size());
+	for (const auto &node : nodes)
+	{
+		DependencyIndexNode indexNode = {};
+		indexNode.nameOffset = static_cast<uint32_t>(strings.size());
+		indexNode.flags = node.flags;
+		indexNode.firstDependency = static_cast<uint32_t>(edges.size());
+		indexNode.dependencyCount = static_cast<uint32_t>(node.dependencies.size());
+		indexNode.fanIn = node.fanIn;
+		indexNode.depth = node.depth;
+		indexNodes.push_back(indexNode);
+
+		edges.insert(edges.end(), node.dependencies.begin(), node.dependencies.end());
+		strings.append(node.name);
+		strings.push_back('\0');
+	}
+	for (const auto &cycle : cycles)
+	{
+		cycleTable.push_back(static_cast<uint32_t>(cycle.size()));
+		cycleTable.insert(cycleTable.end(), cycle.begin(), cycle.end());
+	}
+
+	DependencyIndexHeader header = {};
+	memcpy(header.magic, cDependencyIndexMagic, sizeof(header.magic));
+	header.version = cDependencyIndexVersion;
+	header.nodeCount = static_cast<uint32_t>(nodes.size());
+	header.edgeCount = static_cast<uint32_t>(edges.size());
+	header.cycleCount = static_cast<uint32_t>(cycles.size());
+	header.stringPoolSize = static_cast<uint32_t>(strings.size());
+
+	fs::path file(path);
+	fs::create_directories(fs::absolute(file).parent_path());
+
+	fs::ofstream stream(file, std::ios::binary);
+	stream.write(reinterpret_cast<const char *>(&header), sizeof(header));
+	stream.write(reinterpret_cast<const char *>(indexNodes.data()), indexNodes.size() * sizeof(DependencyIndexNode));
+	stream.write(reinterpret_cast<const char *>(edges.data()), edges.size() * sizeof(uint32_t));
+	stream.write(reinterpret_cast<const char *>(order.data()), order.size() * sizeof(uint32_t));
+	stream.write(reinterpret_cast<const char *>(cycleTable.data()), cycleTable.size() * sizeof(uint32_t));
+	stream.write(strings.data(), strings.size());
+}
+
+int runScan(const fs::path &root, const std::string &input, const std::string &outputPath)
+{
+	auto start = std::chrono::steady_clock::now();
+
+	std::vector<std::string> modules = collectModules(root, input.empty() ? "." : input);
+	DependencyGraph graph = scanDependencyGraph(root, modules);
+
+	double elapsed = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+	unsigned int missing = 0;
+	unsigned int maxDepth = 0;
+	for (const auto &node : graph.nodes)
+	{
+		if (node.flags & (cNodeMissing | cNodeNotAsf))
+			missing++;
+		maxDepth = std::max(maxDepth, node.depth);
+	}
+
+	std::cout << fmtString("Scanned %zu modules (%u missing or invalid) with %zu dependencies in %.1f ms\n",
+		graph.nodes.size(), missing, graph.edgeCount(), elapsed * 1000.0);
+	std::cout << fmtString("Longest dependency chain: %u, cycles: %zu\n", maxDepth, graph.cycles.size());
+
+	// The most shared modules are the ones worth loading first
+	std::vector<uint32_t> byFanIn(graph.order);
+	std::stable_sort(byFanIn.begin(), byFanIn.end(),
+		[&](uint32_t a, uint32_t b) { return graph.nodes[a].fanIn > graph.nodes[b].fanIn; });
+	for (size_t i = 0; i < byFanIn.size() && i < 5 && graph.nodes[byFanIn[i]].fanIn; ++i)
+	{
+		const DependencyNode &node = graph.nodes[byFanIn[i]];
+		std::cout << fmtString("\t%5u dependents: %s\n", node.fanIn, node.name.c_str());
+	}
+
+	for (const auto &cycle : graph.cycles)
+	{
+		std::cout << "Cycle:";
+		for (uint32_t id : cycle)
+		{
+			std::cout << " " << graph.nodes[id].name;
+		}
+		std::cout << std::endl;
+	}
+
+	if (!outputPath.empty())
+	{
+		if (fs::path(outputPath).extension() == ".json")
+			graph.saveJson(outputPath);
+		else
+			graph.saveBinary(outputPath);
+
+		std::cout << "Wrote dependency index to " << outputPath << std::endl;
+	}
+
+	return graph.cycles.empty() ? 0 : 1;
+}
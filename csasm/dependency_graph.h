@@ -0,0 +1,81 @@
+#pragma once
+
+#include <boost/filesystem.hpp>
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+enum DependencyNodeFlags : uint32_t
+{
+	cNodeMissing = 1 << 0,   // Named as a dependency but the file doesn't exist
+	cNodeNotAsf = 1 << 1,    // The file exists but has no valid ASF header
+	cNodeInCycle = 1 << 2,   // Part of a dependency cycle, the engine can't load it
+};
+
+struct DependencyNode
+{
+	std::string name;
+	uint32_t flags = 0;
+
+	// Direct dependencies in the order of the ASF dependency table
+	std::vector<uint32_t> dependencies;
+
+	// Amount of modules that directly depend on this one
+	uint32_t fanIn = 0;
+
+	// Longest chain of dependencies below this module, 0 for modules without any
+	uint32_t depth = 0;
+};
+
+// Module dependency graph, read from the ASF headers alone without an engine
+struct DependencyGraph
+{
+	// Sorted by name, a node's index is its id
+	std::vector<DependencyNode> nodes;
+
+	// Every node, dependencies before the modules that use them. Members of a
+	// cycle are adjacent, in no particular order.
+	std::vector<uint32_t> order;
+
+	// Strongly connected components with more than one node, or a node depending on itself
+	std::vector<std::vector<uint32_t>> cycles;
+
+	size_t edgeCount() const;
+	int find(const std::string &name) const;
+
+	void saveJson(const std::string &path) const;
+	void saveBinary(const std::string &path) const;
+};
+
+// Reads the headers of the given modules and, transitively, everything they depend on
+DependencyGraph scanDependencyGraph(const boost::filesystem::path &root, const std::vector<std::string> &modules);
+
+struct DependencyIndexHeader
+{
+	char magic[4];
+	uint32_t version;
+	uint32_t nodeCount;
+	uint32_t edgeCount;
+	uint32_t cycleCount;
+	uint32_t stringPoolSize;
+};
+
+// Binary index layout (little endian), following the header:
+//   DependencyIndexNode nodes[nodeCount]
+//   uint32_t edges[edgeCount]           dependency ids, nodes reference ranges of it
+//   uint32_t order[nodeCount]           topological order, dependencies first
+//   cycles, each as uint32_t count followed by count node ids
+//   char strings[stringPoolSize]        zero terminated names
+struct DependencyIndexNode
+{
+	uint32_t nameOffset;
+	uint32_t flags;
+	uint32_t firstDependency;
+	uint32_t dependencyCount;
+	uint32_t fanIn;
+	uint32_t depth;
+};
+
+// Implementation of "csasm scan"
+int runScan(const boost::filesystem::path &root, const std::string &input, const std::string &outputPath);
@@ -0,0 +1,12 @@
+#pragma once
+
+#include <angelscript.h>
+
+#include "registry.h"
+
+void AngelScriptMessageCallback(const asSMessageInfo *msg, void *param);
+
+void ConfigureEngine(asIScriptEngine *engine, const Registry &registry);
+
+// Creates an engine with the message callback installed and the PMCS environment registered
+asIScriptEngine *CreateConfiguredEngine(const Registry &registry);
@@ -0,0 +1,13 @@
+#pragma once
+
+#include <cstdio>
+#include <string>
+
+// printf-style formatting into a std::string. Thread safe, the result is cut off at 2047 characters.
+template<typename... A>
+std::string fmtString(const std::string &format, A... args)
+{
+	static thread_local char sFormatBuf[2048];
+	snprintf(sFormatBuf, sizeof(sFormatBuf), format.c_str(), args...);
+	return std::string(sFormatBuf);
+}
@@ -0,0 +1,39 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+static const uint64_t cFnvOffsetBasis = 0xcbf29ce484222325ull;
+static const uint64_t cFnvPrime = 0x100000001b3ull;
+
+// 64-bit FNV-1a. Pass a previous result as seed to hash several pieces as one.
+inline uint64_t fnv1a64(const void *data, size_t size, uint64_t seed = cFnvOffsetBasis)
+{
+	const uint8_t *bytes = static_cast<const uint8_t *>(data);
+	uint64_t hash = seed;
+	for (size_t i = 0; i < size; ++i)
+	{
+		hash ^= bytes[i];
+		hash *= cFnvPrime;
+	}
+	return hash;
+}
+
+inline uint64_t fnv1a64(const std::string &str, uint64_t seed = cFnvOffsetBasis)
+{
+	// Include the terminator so that "ab" + "c" and "a" + "bc" differ
+	return fnv1a64(str.c_str(), str.size() + 1, seed);
+}
+
+inline std::string hashToString(uint64_t hash)
+{
+	static const char cHexDigits[] = "0123456789abcdef";
+
+	std::string str(16, '0');
+	for (int i = 15; i >= 0; --i, hash >>= 4)
+	{
+		str[i] = cHexDigits[hash & 0xf];
+	}
+	return str;
+}
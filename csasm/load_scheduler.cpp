@@ -0,0 +1,236 @@
+#include "load_scheduler.h"
+
+#include "dependency_graph.h"
+#include "timings.h"
+
+#include <boost/interprocess/file_mapping.hpp>
+#include <boost/interprocess/mapped_region.hpp>
+
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <exception>
+#include <mutex>
+#include <stdexcept>
+#include <thread>
+
+namespace fs = boost::filesystem;
+
+// Granularity at which prepared files are touched to fault them in
+static const size_t cPageSize = 4096;
+
+namespace
+{
+	struct PreparedFile
+	{
+		boost::interprocess::file_mapping file;
+		boost::interprocess::mapped_region region;
+		const uint8_t *data = nullptr;
+		size_t size = 0;
+
+		bool ready = false;
+		std::exception_ptr error;
+	};
+
+	class LoadSchedule
+	{
+	public:
+		LoadSchedule(const fs::path &root, const std::vector<std::string> &order)
+			: mRoot(root), mOrder(order), mFiles(order.size())
+		{
+
+		}
+
+		void start(unsigned int workerCount)
+		{
+			for (unsigned int i = 0; i < workerCount; ++i)
+			{
+				mWorkers.emplace_back(&LoadSchedule::runWorker, this);
+			}
+		}
+
+		void stop()
+		{
+			mStopped = true;
+			for (auto &worker : mWorkers)
+			{
+				worker.join();
+			}
+			mWorkers.clear();
+		}
+
+		PreparedFile &wait(size_t index)
+		{
+			std::unique_lock<std::mutex> lock(mMutex);
+			mReady.wait(lock, [&] { return mFiles[index].ready; });
+
+			if (mFiles[index].error)
+				std::rethrow_exception(mFiles[index].error);
+			return mFiles[index];
+		}
+
+	private:
+		void runWorker()
+		{
+			for (size_t i = mNext++; i < mOrder.size() && !mStopped; i = mNext++)
+			{
+				PreparedFile &prepared = mFiles[i];
+				try
+				{
+					prepare(mOrder[i], prepared);
+				}
+				catch (...)
+				{
+					prepared.error = std::current_exception();
+				}
+
+				std::lock_guard<std::mutex> lock(mMutex);
+				prepared.ready = true;
+				mReady.notify_all();
+			}
+		}
+
+		void prepare(const std::string &name, PreparedFile &prepared)
+		{
+			TimingScope timing("csasm::prepareAsf");
+
+			using namespace boost::interprocess;
+
+			fs::path filePath = resolveModulePath(mRoot, name);
+			if (!fs::exists(filePath))
+			{
+				throw file_not_found(filePath.string(), "");
+			}
+			if (fs::file_size(filePath) == 0)
+			{
+				return;
+			}
+
+			prepared.file = file_mapping(filePath.string().c_str(), read_only);
+			prepared.region = mapped_region(prepared.file, read_only);
+			prepared.data = static_cast<const uint8_t *>(prepared.region.get_address());
+			prepared.size = prepared.region.get_size();
+
+			// Fault every page in here, so the engine thread doesn't wait on the disk
+			volatile uint8_t sink = 0;
+			for (size_t offset = 0; offset < prepared.size; offset += cPageSize)
+			{
+				sink ^= prepared.data[offset];
+			}
+		}
+
+		const fs::path &mRoot;
+		const std::vector<std::string> &mOrder;
+		std::vector<PreparedFile> mFiles;
+
+		std::vector<std::thread> mWorkers;
+		std::atomic<size_t> mNext{ 0 };
+		std::atomic<bool> mStopped{ false };
+
+		std::mutex mMutex;
+		std::condition_variable mReady;
+	};
+}
+
+// Post-order of the dependency tables starting at root, skipping what the tracker already has
+static std::vector<std::string> loadOrder(const AsfModuleTracker &tracker, const DependencyGraph &graph, const std::string &root)
+{
+	enum : uint8_t { cNew, cOnPath, cDone };
+	std::vector<uint8_t> state(graph.nodes.size(), cNew);
+	std::vector<std::string> order;
+
+	struct Frame
+	{
+		uint32_t node;
+		size_t nextEdge;
+	};
+	std::vector<Frame> path;
+
+	auto enter = [&](uint32_t node)
+	{
+		const DependencyNode &info = graph.nodes[node];
+		if (info.flags & cNodeMissing)
+		{
+			throw file_not_found(resolveModulePath(tracker.getRoot(), info.name).string(), "");
+		}
+
+		state[node] = cOnPath;
+		path.push_back({ node, 0 });
+	};
+
+	enter(static_cast<uint32_t>(graph.find(root)));
+	while (!path.empty())
+	{
+		Frame &frame = path.back();
+		const DependencyNode &node = graph.nodes[frame.node];
+
+		if (frame.nextEdge < node.dependencies.size())
+		{
+			uint32_t dependency = node.dependencies[frame.nextEdge++];
+			if (state[dependency] == cOnPath)
+			{
+				throw std::runtime_error("dependency cycle between " + node.name + " and " + graph.nodes[dependency].name);
+			}
+			if (state[dependency] == cNew && !tracker.hasModule(graph.nodes[dependency].name))
+			{
+				enter(dependency);
+			}
+			continue;
+		}
+
+		state[frame.node] = cDone;
+		order.push_back(node.name);
+		path.pop_back();
+	}
+
+	return order;
+}
+
+AsfModule *loadModuleScheduled(AsfModuleTracker &tracker, const std::string &name, std::vector<std::string> *direct_dependencies,
+	unsigned int jobs, bool verbose)
+{
+	if (tracker.hasModule(name))
+	{
+		return tracker.getModule(name, direct_dependencies, verbose);
+	}
+
+	DependencyGraph graph = scanDependencyGraph(tracker.getRoot(), { name });
+	std::vector<std::string> order = loadOrder(tracker, graph, name);
+
+	// Nothing to read ahead, so the workers would only add thread start-up
+	if (order.size() < 2)
+	{
+		return tracker.getModule(name, direct_dependencies, verbose);
+	}
+
+	unsigned int workerCount = jobs ? jobs : std::thread::hardware_concurrency();
+	workerCount = std::max(1u, std::min<unsigned int>(workerCount, static_cast<unsigned int>(order.size())));
+
+	LoadSchedule schedule(tracker.getRoot(), order);
+	schedule.start(workerCount);
+
+	AsfModule *module = nullptr;
+	try
+	{
+		for (size_t i = 0; i < order.size(); ++i)
+		{
+			PreparedFile &prepared = schedule.wait(i);
+
+			// Every dependency is loaded by now, so this doesn't recurse
+			bool isRoot = i + 1 == order.size();
+			module = tracker.addModule(order[i], prepared.data, prepared.size, isRoot ? direct_dependencies : nullptr, verbose);
+
+			// The engine has copied what it needs
+			prepared.region = boost::interprocess::mapped_region();
+			prepared.file = boost::interprocess::file_mapping();
+		}
+	}
+	catch (...)
+	{
+		schedule.stop();
+		throw;
+	}
+
+	schedule.stop();
+	return module;
+}
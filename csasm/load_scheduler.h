@@ -0,0 +1,17 @@
+#pragma once
+
+#include "asf.h"
+
+#include <string>
+#include <vector>
+
+// Loads a module together with everything it depends on. The dependency graph is
+// read from the ASF headers up front, then worker threads map the files and page
+// them in while the calling thread hands them to the engine one at a time, in the
+// same order the recursive loader in AsfModule would. The engine itself is never
+// used from more than one thread. A module whose dependencies are all loaded
+// already is read on the calling thread.
+//
+// jobs is the amount of worker threads, 0 for one per hardware thread.
+AsfModule *loadModuleScheduled(AsfModuleTracker &tracker, const std::string &name, std::vector<std::string> *direct_dependencies,
+	unsigned int jobs, bool verbose = false);
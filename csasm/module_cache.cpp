@@ -0,0 +1,225 @@
+#include "module_cache.h"
+
+#include "asf.h"
+#include "hash.h"
+
+#include <boost/filesystem/fstream.hpp>
+#include <boost/interprocess/file_mapping.hpp>
+#include <boost/interprocess/mapped_region.hpp>
+
+#include <iostream>
+
+namespace fs = boost::filesystem;
+
+// Bump whenever the output format changes, so older cache entries are not reused
+static const uint32_t cCacheVersion = 1;
+
+struct CachedOutput
+{
+	const std::string &path;
+	const char *extension;
+};
+
+static void replaceFile(const fs::path &from, const fs::path &to)
+{
+	fs::create_directories(fs::absolute(to).parent_path());
+	fs::remove(to);
+	fs::copy_file(from, to);
+}
+
+ModuleCache::ModuleCache(const std::string &directory, const fs::path &root, uint64_t registryHash)
+	: mDirectory(directory), mRoot(root), mRegistryHash(registryHash)
+{
+	fs::create_directories(mDirectory / "objects");
+
+	fs::path manifestPath = mDirectory / "manifest.json";
+	if (fs::exists(manifestPath))
+	{
+		try
+		{
+			fs::ifstream stream(manifestPath);
+			mManifest = nlohmann::json::parse(stream);
+		}
+		catch (std::exception &e)
+		{
+			std::cout << "Ignoring broken cache manifest " << manifestPath.string() << ": " << e.what() << std::endl;
+			mManifest = nlohmann::json();
+		}
+	}
+
+	if (!mManifest.is_object() || mManifest.value("version", 0u) != cCacheVersion)
+	{
+		mManifest = { { "version", cCacheVersion }, { "modules", nlohmann::json::object() } };
+		mDirty = true;
+	}
+	if (mManifest.value("registry", std::string()) != hashToString(mRegistryHash))
+	{
+		mManifest["registry"] = hashToString(mRegistryHash);
+		mDirty = true;
+	}
+}
+
+uint64_t ModuleCache::moduleKey(const std::string &module)
+{
+	std::set<std::string> visiting;
+	return moduleKey(module, visiting);
+}
+
+uint64_t ModuleCache::moduleKey(const std::string &module, std::set<std::string> &visiting)
+{
+	{
+		std::lock_guard<std::mutex> lock(mMutex);
+		auto it = mKeys.find(module);
+		if (it != mKeys.end())
+			return it->second;
+	}
+
+	// A dependency cycle can't be loaded by the engine either. Every module on it or
+	// depending on it gets the same key whichever is hashed first, and isn't cached.
+	if (!visiting.insert(module).second)
+		return cUncachedKey;
+
+	fs::path filePath = resolveModulePath(mRoot, module);
+
+	if (!fs::exists(filePath))
+	{
+		throw file_not_found(filePath.string(), "");
+	}
+
+	uint64_t key = fnv1a64(&cCacheVersion, sizeof(cCacheVersion));
+	key = fnv1a64(&mRegistryHash, sizeof(mRegistryHash), key);
+
+	AsfHeader header;
+	bool isAsf = false;
+	if (fs::file_size(filePath) != 0)
+	{
+		using namespace boost::interprocess;
+		file_mapping file(filePath.string().c_str(), read_only);
+		mapped_region region(file, read_only);
+
+		const uint8_t *data = static_cast<const uint8_t *>(region.get_address());
+		key = fnv1a64(data, region.get_size(), key);
+
+		BinaryCodeStream stream(data, region.get_size());
+		isAsf = readAsfHeader(stream, header);
+	}
+
+	if (isAsf)
+	{
+		for (const auto &dependency : header.dependencies)
+		{
+			uint64_t dependencyKey = moduleKey(dependency, visiting);
+			if (dependencyKey == cUncachedKey)
+			{
+				key = cUncachedKey;
+				break;
+			}
+			key = fnv1a64(dependency, key);
+			key = fnv1a64(&dependencyKey, sizeof(dependencyKey), key);
+		}
+	}
+
+	visiting.erase(module);
+
+	std::lock_guard<std::mutex> lock(mMutex);
+	mKeys.emplace(module, key);
+	return key;
+}
+
+fs::path ModuleCache::objectPath(uint64_t key, const char *extension) const
+{
+	return mDirectory / "objects" / (hashToString(key) + extension);
+}
+
+bool ModuleCache::restore(uint64_t key, const ModuleOutputPaths &paths)
+{
+	if (key == cUncachedKey)
+		return false;
+
+	const CachedOutput outputs[] = {
+		{ paths.dumpFile, ".txt" },
+		{ paths.outputFile, ".yaml" },
+		{ paths.binaryOutputFile, ".bin" },
+	};
+
+	for (const auto &output : outputs)
+	{
+		if (!output.path.empty() && !fs::exists(objectPath(key, output.extension)))
+			return false;
+	}
+
+	for (const auto &output : outputs)
+	{
+		if (!output.path.empty())
+			replaceFile(objectPath(key, output.extension), output.path);
+	}
+
+	mHits++;
+	return true;
+}
+
+void ModuleCache::store(const std::string &module, uint64_t key, const std::vector<std::string> &dependencies, const ModuleOutputPaths &paths)
+{
+	if (key == cUncachedKey)
+		return;
+
+	const CachedOutput outputs[] = {
+		{ paths.dumpFile, ".txt" },
+		{ paths.outputFile, ".yaml" },
+		{ paths.binaryOutputFile, ".bin" },
+	};
+
+	// Copy next to the object first, identical modules under different names may be stored concurrently
+	std::string temporarySuffix = "." + hashToString(fnv1a64(module)) + ".tmp";
+
+	nlohmann::json cachedOutputs = nlohmann::json::array();
+	for (const auto &output : outputs)
+	{
+		if (output.path.empty())
+			continue;
+
+		fs::path object = objectPath(key, output.extension);
+		fs::path temporary = object;
+		temporary.concat(temporarySuffix);
+
+		replaceFile(output.path, temporary);
+		fs::rename(temporary, object);
+		cachedOutputs.push_back(output.extension + 1);
+	}
+
+	std::lock_guard<std::mutex> lock(mMutex);
+
+	nlohmann::json dependencyKeys = nlohmann::json::array();
+	for (const auto &dependency : dependencies)
+	{
+		auto it = mKeys.find(dependency);
+		dependencyKeys.push_back({
+			{ "name", dependency },
+			{ "key", hashToString(it != mKeys.end() ? it->second : 0) },
+		});
+	}
+
+	mManifest["modules"][module] = {
+		{ "key", hashToString(key) },
+		{ "dependencies", dependencyKeys },
+		{ "outputs", cachedOutputs },
+	};
+	mDirty = true;
+}
+
+void ModuleCache::save()
+{
+	std::lock_guard<std::mutex> lock(mMutex);
+	if (!mDirty)
+		return;
+
+	fs::path manifestPath = mDirectory / "manifest.json";
+	fs::path temporary = manifestPath;
+	temporary.concat(".tmp");
+	{
+		fs::ofstream stream(temporary);
+		stream << mManifest.dump(1, '\t') << std::endl;
+	}
+	fs::rename(temporary, manifestPath);
+	mDirty = false;
+}
@@ -0,0 +1,64 @@
+#pragma once
+
+#include "json.hpp"
+#include "module_output.h"
+
+#include <boost/filesystem.hpp>
+
+#include <atomic>
+#include <cstdint>
+#include <map>
+#include <mutex>
+#include <set>
+#include <string>
+#include <vector>
+
+// On-disk cache of module outputs (--cache). Each module is keyed by a hash of
+// its bytes, the keys of its dependencies and the registry, so a module is only
+// processed again when it or anything it was loaded together with has changed.
+//
+// Layout:
+//   <cache>/manifest.json        module name -> key, dependencies and cached outputs
+//   <cache>/objects/<key>.txt    dump
+//   <cache>/objects/<key>.yaml   yaml
+//   <cache>/objects/<key>.bin    binary
+class ModuleCache
+{
+public:
+	static const uint64_t cUncachedKey = 0;
+
+	ModuleCache(const std::string &directory, const boost::filesystem::path &root, uint64_t registryHash);
+
+	// Key of a module and its dependency closure. Thread safe, each module is hashed once.
+	// cUncachedKey if the module is on or depends on a dependency cycle.
+	uint64_t moduleKey(const std::string &module);
+
+	// Copies the cached outputs to every requested path. Returns false if any of them is missing.
+	bool restore(uint64_t key, const ModuleOutputPaths &paths);
+
+	// Records freshly written outputs, unless the key is cUncachedKey
+	void store(const std::string &module, uint64_t key, const std::vector<std::string> &dependencies, const ModuleOutputPaths &paths);
+
+	// Writes the manifest back to disk
+	void save();
+
+	unsigned int hits() const
+	{
+		return mHits;
+	}
+
+private:
+	uint64_t moduleKey(const std::string &module, std::set<std::string> &visiting);
+	boost::filesystem::path objectPath(uint64_t key, const char *extension) const;
+
+	boost::filesystem::path mDirectory;
+	boost::filesystem::path mRoot;
+	uint64_t mRegistryHash;
+
+	std::mutex mMutex;
+	std::map<std::string, uint64_t> mKeys;
+	nlohmann::json mManifest;
+	bool mDirty = false;
+
+	std::atomic<unsigned int> mHits{ 0 };
+};
@@ -0,0 +1,47 @@
+#include "module_output.h"
+
+#include "bytecode_decoder.h"
+#include "output_sink.h"
+#include "text_serialization.h"
+#include "timings.h"
+#include "yaml_serialization.h"
+
+#include <boost/filesystem/fstream.hpp>
+
+namespace fs = boost::filesystem;
+
+void writeModuleOutputs(const AsfModule *module, const std::vector<std::string> &dependencies, const ModuleOutputPaths &paths)
+{
+	// Both text outputs share one pass over the bytecode
+	DecodedModule decoded;
+	if (!paths.outputFile.empty() || !paths.dumpFile.empty())
+	{
+		decoded = decodeModule(module->getScriptModule());
+	}
+
+	if (!paths.outputFile.empty())
+	{
+		TimingScope timing("csasm::serializeModuleYaml");
+		FileOutputSink stream(paths.outputFile);
+		serializeModuleYaml(stream, module->getScriptModule(), dependencies, decoded);
+	}
+	if (!paths.dumpFile.empty())
+	{
+		TimingScope timing("csasm::dumpModule");
+		FileOutputSink stream(paths.dumpFile);
+		dumpModule(stream, module->getScriptModule(), dependencies, decoded);
+	}
+
+	if (!paths.binaryOutputFile.empty())
+	{
+		TimingScope timing("csasm::saveBinary");
+		std::vector<uint8_t> data = module->save();
+		
+		fs::path file(paths.binaryOutputFile);
+		fs::create_directories(fs::absolute(file).parent_path());
+
+		fs::ofstream stream(file, std::ios::binary);
+		stream.write(reinterpret_cast<const char*>(data.data()), data.size());
+		stream.close();
+	}
+}
@@ -0,0 +1,16 @@
+#pragma once
+
+#include "asf.h"
+
+#include <string>
+#include <vector>
+
+struct ModuleOutputPaths
+{
+	std::string dumpFile;
+	std::string outputFile;
+	std::string binaryOutputFile;
+};
+
+// Writes every requested output of a loaded module, creating parent folders as needed
+void writeModuleOutputs(const AsfModule *module, const std::vector<std::string> &dependencies, const ModuleOutputPaths &paths);
@@ -0,0 +1,216 @@
+#include "opcode_profile.h"
+
+#include "asf.h"
+#include "batch.h"
+#include "engine_config.h"
+#include "format.h"
+
+#include <algorithm>
+#include <cstring>
+#include <iostream>
+#include <set>
+
+namespace fs = boost::filesystem;
+
+OpcodeProfile::OpcodeProfile()
+	: instructionCount(0), pairs(256 * 256, 0), hasCycles(false)
+{
+	memset(opcodes, 0, sizeof(opcodes));
+	memset(cycles, 0, sizeof(cycles));
+}
+
+void OpcodeProfile::addFunction(const DecodedFunction &function)
+{
+	const auto &instructions = function.instructions;
+	for (size_t i = 0; i < instructions.size(); ++i)
+	{
+		instructionCount++;
+		opcodes[instructions[i].op]++;
+
+		// A pair is counted even when the second instruction is a jump target. A superinstruction
+		// leaves the second instruction in place, so jumps to it still work.
+		if (i + 1 < instructions.size())
+		{
+			pairs[instructions[i].op * 256 + instructions[i + 1].op]++;
+		}
+	}
+}
+
+void OpcodeProfile::addModule(const DecodedModule &module)
+{
+	for (const auto &function : module.functions)
+	{
+		addFunction(function);
+	}
+}
+
+static void addExecutedFunction(asIScriptFunction *func, const asQWORD *counts, const asQWORD *cycles, void *param)
+{
+	OpcodeProfile &profile = *static_cast<OpcodeProfile *>(param);
+
+	OpcodeProfile::FunctionCount function = { func->GetDeclaration(true, true), 0, 0 };
+	for (size_t op = 0; op < 256; ++op)
+	{
+		function.instructions += counts[op];
+		profile.opcodes[op] += counts[op];
+		if (cycles)
+		{
+			function.cycles += cycles[op];
+			profile.cycles[op] += cycles[op];
+		}
+	}
+
+	profile.instructionCount += function.instructions;
+	profile.hasCycles = profile.hasCycles || cycles;
+	profile.functions.push_back(function);
+}
+
+bool OpcodeProfile::addExecuted(asIScriptEngine *engine)
+{
+	if (engine->EnumerateOpcodeStats(addExecutedFunction, this) < 0)
+		return false;
+
+	std::vector<uint64_t> executedPairs(256 * 256);
+	engine->GetOpcodePairStats(executedPairs.data());
+	for (size_t pair = 0; pair < pairs.size(); ++pair)
+	{
+		pairs[pair] += executedPairs[pair];
+	}
+
+	return !functions.empty();
+}
+
+static const char *opcodeName(size_t op)
+{
+	return op < asBC_MAXBYTECODE ? asBCInfo[op].name : "?";
+}
+
+void printOpcodeProfile(const OpcodeProfile &profile, size_t top)
+{
+	if (profile.instructionCount == 0)
+	{
+		std::cout << "No instructions" << std::endl;
+		return;
+	}
+
+	double total = static_cast<double>(profile.instructionCount);
+
+	std::vector<size_t> opcodes;
+	for (size_t op = 0; op < 256; ++op)
+	{
+		if (profile.opcodes[op])
+			opcodes.push_back(op);
+	}
+	std::stable_sort(opcodes.begin(), opcodes.end(), [&](size_t a, size_t b) { return profile.opcodes[a] > profile.opcodes[b]; });
+
+	std::cout << fmtString("%llu instructions, %zu different opcodes\n\n", static_cast<unsigned long long>(profile.instructionCount), opcodes.size());
+	uint64_t totalCycles = 0;
+	for (size_t op = 0; op < 256; ++op)
+	{
+		totalCycles += profile.cycles[op];
+	}
+
+	std::cout << fmtString("%-14s %12s %8s", "Opcode", "count", "share");
+	if (profile.hasCycles)
+		std::cout << fmtString(" %10s %8s", "cycles/op", "of cycles");
+	std::cout << "\n";
+	for (size_t i = 0; i < opcodes.size() && i < top; ++i)
+	{
+		size_t op = opcodes[i];
+		std::cout << fmtString("%-14s %12llu %7.2f%%", opcodeName(op),
+			static_cast<unsigned long long>(profile.opcodes[op]), 100.0 * profile.opcodes[op] / total);
+		if (profile.hasCycles)
+		{
+			std::cout << fmtString(" %10.1f %8.2f%%", static_cast<double>(profile.cycles[op]) / profile.opcodes[op],
+				totalCycles ? 100.0 * profile.cycles[op] / totalCycles : 0.0);
+		}
+		std::cout << "\n";
+	}
+
+	std::vector<size_t> pairs;
+	for (size_t pair = 0; pair < profile.pairs.size(); ++pair)
+	{
+		if (profile.pairs[pair])
+			pairs.push_back(pair);
+	}
+	std::stable_sort(pairs.begin(), pairs.end(), [&](size_t a, size_t b) { return profile.pairs[a] > profile.pairs[b]; });
+
+	// The share of the first opcode tells how much of its dispatches a superinstruction would save
+	std::cout << fmtString("\n%-14s %-14s %12s %8s %8s\n", "First", "Second", "count", "share", "of first");
+	for (size_t i = 0; i < pairs.size() && i < top; ++i)
+	{
+		size_t first = pairs[i] / 256;
+		uint64_t count = profile.pairs[pairs[i]];
+		std::cout << fmtString("%-14s %-14s %12llu %7.2f%% %7.2f%%\n", opcodeName(first), opcodeName(pairs[i] % 256),
+			static_cast<unsigned long long>(count), 100.0 * count / total, 100.0 * count / profile.opcodes[first]);
+	}
+
+	if (profile.functions.empty())
+		return;
+
+	// The busiest functions are the candidates for the JIT
+	std::vector<OpcodeProfile::FunctionCount> functions(profile.functions);
+	std::stable_sort(functions.begin(), functions.end(), [&](const OpcodeProfile::FunctionCount &a, const OpcodeProfile::FunctionCount &b) {
+		return profile.hasCycles ? a.cycles > b.cycles : a.instructions > b.instructions;
+	});
+
+	std::cout << fmtString("\n%12s %8s", "instructions", "share");
+	if (profile.hasCycles)
+		std::cout << fmtString(" %14s %8s", "cycles", "share");
+	std::cout << "  Function\n";
+	for (size_t i = 0; i < functions.size() && i < top; ++i)
+	{
+		const auto &function = functions[i];
+		std::cout << fmtString("%12llu %7.2f%%", static_cast<unsigned long long>(function.instructions), 100.0 * function.instructions / total);
+		if (profile.hasCycles)
+		{
+			std::cout << fmtString(" %14llu %7.2f%%", static_cast<unsigned long long>(function.cycles),
+				totalCycles ? 100.0 * function.cycles / totalCycles : 0.0);
+		}
+		std::cout << "  " << function.declaration << "\n";
+	}
+}
+
+int runOpcodeProfile(const fs::path &root, const std::string &input, size_t top, const Registry &registry)
+{
+	std::vector<std::string> modules = collectModules(root, input.empty() ? "." : input);
+
+	asIScriptEngine *engine = CreateConfiguredEngine(registry);
+	if (!engine)
+		return -1;
+
+	OpcodeProfile profile;
+	unsigned int failed = 0;
+	{
+		AsfModuleTracker tracker(engine, root.string());
+
+		// Dependencies are loaded along with the modules that need them, but only profiled once
+		std::set<asIScriptModule *> profiled;
+		for (const auto &name : modules)
+		{
+			try
+			{
+				asIScriptModule *module = tracker.getModule(name, nullptr)->getScriptModule();
+				if (profiled.insert(module).second)
+				{
+					profile.addModule(decodeModule(module));
+				}
+			}
+			catch (const std::exception &e)
+			{
+				std::cerr << name << ": " << e.what() << std::endl;
+				failed++;
+			}
+		}
+
+		std::cout << fmtString("Profiled %zu modules", profiled.size());
+		if (failed)
+			std::cout << fmtString(", %u failed to load", failed);
+		std::cout << "\n\n";
+	}
+
+	engine->ShutDownAndRelease();
+
+	printOpcodeProfile(profile, top);
+	return failed ? 1 : 0;
+}
@@ -0,0 +1,54 @@
+#pragma once
+
+#include "bytecode_decoder.h"
+#include "registry.h"
+
+#include <boost/filesystem.hpp>
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+// How often each opcode and each pair of adjacent opcodes occurs in a body of bytecode.
+// This is what the VM's superinstructions were picked from.
+struct OpcodeProfile
+{
+	OpcodeProfile();
+
+	void addFunction(const DecodedFunction &function);
+	void addModule(const DecodedModule &module);
+
+	// Adds the instructions the engine has executed instead, which needs a library built with
+	// AS_OPCODE_STATS. Pairs are only counted when the second instruction directly follows the
+	// first, and the cycles only with AS_OPCODE_CYCLES. Returns false if nothing was counted
+	bool addExecuted(asIScriptEngine *engine);
+
+	uint64_t pairCount(asBYTE first, asBYTE second) const
+	{
+		return pairs[first * 256 + second];
+	}
+
+	uint64_t instructionCount;
+	uint64_t opcodes[256];
+
+	// Indexed by first * 256 + second
+	std::vector<uint64_t> pairs;
+
+	// Only filled in by addExecuted
+	struct FunctionCount
+	{
+		std::string declaration;
+		uint64_t instructions;
+		uint64_t cycles;
+	};
+	std::vector<FunctionCount> functions;
+	uint64_t cycles[256];
+	bool hasCycles;
+};
+
+// Prints the most common opcodes and the most common pairs, and the cycles and
+// the busiest functions when the profile has them
+void printOpcodeProfile(const OpcodeProfile &profile, size_t top);
+
+// Implementation of "csasm opcode-pairs"
+int runOpcodeProfile(const boost::filesystem::path &root, const std::string &input, size_t top, const Registry &registry);
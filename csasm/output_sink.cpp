@@ -0,0 +1,171 @@
+#include "output_sink.h"
+
+#include <boost/filesystem.hpp>
+
+#include <cstdio>
+#include <cstring>
+#include <iostream>
+#include <stdexcept>
+
+namespace fs = boost::filesystem;
+
+// Longest number any of the write functions produce without going through the buffer in pieces
+static const size_t cMaxNumberLength = 32;
+
+void OutputSink::write(const char *data, size_t size)
+{
+	if (size > cBufferSize - mUsed)
+	{
+		flush();
+		if (size > cBufferSize)
+		{
+			flushBuffer(data, size);
+			return;
+		}
+	}
+
+	memcpy(mBuffer + mUsed, data, size);
+	mUsed += size;
+}
+
+void OutputSink::write(const char *str)
+{
+	write(str, strlen(str));
+}
+
+void OutputSink::writePadded(const char *str, size_t width)
+{
+	size_t length = strlen(str);
+	write(str, length);
+	for (; length < width; ++length)
+	{
+		put(' ');
+	}
+}
+
+void OutputSink::writeInt(int64_t value)
+{
+	if (value < 0)
+	{
+		put('-');
+		writeUInt(0 - static_cast<uint64_t>(value));
+	}
+	else
+	{
+		writeUInt(static_cast<uint64_t>(value));
+	}
+}
+
+void OutputSink::writeUInt(uint64_t value)
+{
+	char digits[20];
+	size_t count = 0;
+	do
+	{
+		digits[count++] = static_cast<char>('0' + value % 10);
+		value /= 10;
+	} while (value);
+
+	char *out = reserve(count);
+	while (count)
+	{
+		*out++ = digits[--count];
+	}
+	mUsed = out - mBuffer;
+}
+
+void OutputSink::writeHex(uint64_t value, int minDigits)
+{
+	static const char cHexDigits[] = "0123456789abcdef";
+
+	char digits[16];
+	int count = 0;
+	do
+	{
+		digits[count++] = cHexDigits[value & 0xf];
+		value >>= 4;
+	} while (value);
+
+	char *out = reserve(cMaxNumberLength);
+	for (int i = count; i < minDigits; ++i)
+	{
+		*out++ = '0';
+	}
+	while (count)
+	{
+		*out++ = digits[--count];
+	}
+	mUsed = out - mBuffer;
+}
+
+void OutputSink::writeFloat(double value, char format)
+{
+	// %f of a large value can be long, so go through a local buffer.
+	// snprintf does not allocate, it only has to match printf exactly.
+	char buf[512];
+	int length = snprintf(buf, sizeof(buf), format == 'g' ? "%g" : "%f", value);
+	if (length > 0)
+	{
+		write(buf, static_cast<size_t>(length) < sizeof(buf) ? length : sizeof(buf) - 1);
+	}
+}
+
+void OutputSink::flush()
+{
+	if (mUsed)
+	{
+		flushBuffer(mBuffer, mUsed);
+		mUsed = 0;
+	}
+}
+
+char *OutputSink::reserve(size_t size)
+{
+	if (size > cBufferSize - mUsed)
+	{
+		flush();
+	}
+	return mBuffer + mUsed;
+}
+
+FileOutputSink::FileOutputSink(const std::string &path)
+{
+	fs::path file(path);
+	fs::create_directories(fs::absolute(file).parent_path());
+
+	mStream.open(file);
+	if (!mStream)
+	{
+		throw std::runtime_error("Could not open " + path + " for writing");
+	}
+}
+
+FileOutputSink::~FileOutputSink()
+{
+	flush();
+}
+
+void FileOutputSink::flushBuffer(const char *data, size_t size)
+{
+	mStream.write(data, size);
+}
+
+StdoutOutputSink::~StdoutOutputSink()
+{
+	flush();
+}
+
+void StdoutOutputSink::flushBuffer(const char *data, size_t size)
+{
+	std::cout.write(data, size);
+}
+
+StringOutputSink::~StringOutputSink()
+{
+	flush();
+}
+
+void StringOutputSink::flushBuffer(const char *data, size_t size)
+{
+	mTarget.append(data, size);
+}
@@ -0,0 +1,98 @@
+#pragma once
+
+#include <boost/filesystem/fstream.hpp>
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+// Buffered writer for the text outputs. Everything is formatted straight into
+// a fixed-size buffer which is handed to the target whenever it fills up, so
+// writing a dump never holds more than one buffer worth of it in memory.
+class OutputSink
+{
+public:
+	static const size_t cBufferSize = 64 * 1024;
+
+	OutputSink() = default;
+	OutputSink(const OutputSink&) = delete;
+	OutputSink& operator=(const OutputSink&) = delete;
+	virtual ~OutputSink() = default;
+
+	void write(const char *data, size_t size);
+	void write(const char *str);
+	void write(const std::string &str)
+	{
+		write(str.data(), str.size());
+	}
+
+	void put(char c)
+	{
+		if (mUsed == cBufferSize)
+			flush();
+		mBuffer[mUsed++] = c;
+	}
+
+	// Equivalent to printf's %-*s
+	void writePadded(const char *str, size_t width);
+
+	// Equivalent to printf's %lld, %llu and %0*llx
+	void writeInt(int64_t value);
+	void writeUInt(uint64_t value);
+	void writeHex(uint64_t value, int minDigits = 1);
+
+	// Equivalent to printf's %f or %g
+	void writeFloat(double value, char format = 'f');
+
+	void flush();
+
+protected:
+	virtual void flushBuffer(const char *data, size_t size) = 0;
+
+private:
+	// Makes sure a number of at most size characters can be formatted in place
+	char *reserve(size_t size);
+
+	char mBuffer[cBufferSize];
+	size_t mUsed = 0;
+};
+
+// Writes to a file, creating its parent folders
+class FileOutputSink : public OutputSink
+{
+public:
+	explicit FileOutputSink(const std::string &path);
+	~FileOutputSink() override;
+
+protected:
+	void flushBuffer(const char *data, size_t size) override;
+
+private:
+	boost::filesystem::ofstream mStream;
+};
+
+class StdoutOutputSink : public OutputSink
+{
+public:
+	~StdoutOutputSink() override;
+
+protected:
+	void flushBuffer(const char *data, size_t size) override;
+};
+
+// Appends to a string, for callers that want the output in memory
+class StringOutputSink : public OutputSink
+{
+public:
+	explicit StringOutputSink(std::string &target)
+		: mTarget(target)
+	{
+	}
+	~StringOutputSink() override;
+
+protected:
+	void flushBuffer(const char *data, size_t size) override;
+
+private:
+	std::string &mTarget;
+};
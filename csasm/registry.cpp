@@ -0,0 +1,280 @@
+#include "registry.h"
+
+#include "asf.h"
+#include "hash.h"
+#include "timings.h"
+
+#include <boost/dll/runtime_symbol_info.hpp>
+#include <boost/filesystem.hpp>
+#include <boost/filesystem/fstream.hpp>
+
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <stdexcept>
+#include <unordered_map>
+
+namespace fs = boost::filesystem;
+
+static const char cRegistryMagic[4] = {
+	'C', 'S', 'R', 'G'
+};
+static const uint32_t cRegistryVersion = 1;
+
+static const char *const cSectionNames[] = {
+	"namespaces",
+	"object_types",
+	"funcdefs",
+	"object_properties",
+	"object_behaviours",
+	"object_methods",
+	"global_functions",
+	"global_properties",
+};
+static_assert(sizeof(cSectionNames) / sizeof(cSectionNames[0]) == static_cast<size_t>(RegistrySection::Count), "Missing section name");
+
+namespace
+{
+	class RegistryBuilder
+	{
+	public:
+		RegistryBuilder()
+		{
+			// Offset 0 is always the empty string, which is also the global namespace
+			mPool.push_back('\0');
+			mOffsets[""] = 0;
+		}
+
+		uint32_t intern(const std::string &str)
+		{
+			auto it = mOffsets.find(str);
+			if (it != mOffsets.end())
+				return it->second;
+
+			uint32_t offset = static_cast<uint32_t>(mPool.size());
+			mPool.append(str);
+			mPool.push_back('\0');
+			mOffsets.emplace(str, offset);
+			return offset;
+		}
+
+		void add(RegistrySection section, const RegistryEntry &entry)
+		{
+			mSections[static_cast<size_t>(section)].push_back(entry);
+		}
+
+		std::vector<uint8_t> build() const
+		{
+			RegistryFileHeader header = {};
+			memcpy(header.magic, cRegistryMagic, sizeof(header.magic));
+			header.version = cRegistryVersion;
+
+			uint32_t offset = sizeof(RegistryFileHeader);
+			for (size_t i = 0; i < static_cast<size_t>(RegistrySection::Count); ++i)
+			{
+				header.sections[i].offset = offset;
+				header.sections[i].count = static_cast<uint32_t>(mSections[i].size());
+				offset += header.sections[i].count * sizeof(RegistryEntry);
+			}
+			header.stringPoolOffset = offset;
+			header.stringPoolSize = static_cast<uint32_t>(mPool.size());
+
+			std::vector<uint8_t> out;
+			out.reserve(offset + mPool.size());
+			out.insert(out.end(), reinterpret_cast<const uint8_t *>(&header), reinterpret_cast<const uint8_t *>(&header + 1));
+			for (const auto &section : mSections)
+			{
+				out.insert(out.end(), reinterpret_cast<const uint8_t *>(section.data()),
+					reinterpret_cast<const uint8_t *>(section.data() + section.size()));
+			}
+			out.insert(out.end(), mPool.begin(), mPool.end());
+			return out;
+		}
+
+	private:
+		std::string mPool;
+		std::unordered_map<std::string, uint32_t> mOffsets;
+		std::vector<RegistryEntry> mSections[static_cast<size_t>(RegistrySection::Count)];
+	};
+}
+
+std::unique_ptr<Registry> Registry::fromJson(const nlohmann::json &json)
+{
+	RegistryBuilder builder;
+
+	for (size_t i = 0; i < static_cast<size_t>(RegistrySection::Count); ++i)
+	{
+		auto section = json.find(cSectionNames[i]);
+		if (section == json.end())
+			continue;
+
+		for (const auto &registration : *section)
+		{
+			RegistryEntry entry = {};
+			entry.nameSpace = builder.intern(registration.value("namespace", std::string()));
+			entry.objectName = builder.intern(registration.value("object_name", std::string()));
+			entry.declaration = builder.intern(registration.value("declaration", std::string()));
+
+			switch (static_cast<RegistrySection>(i))
+			{
+			case RegistrySection::ObjectTypes:
+				entry.value = registration["size"].get<int32_t>();
+				entry.flags = registration["flags"].get<uint32_t>();
+				break;
+			case RegistrySection::ObjectProperties:
+				entry.value = registration["offset"].get<int32_t>();
+				break;
+			case RegistrySection::ObjectBehaviours:
+				entry.value = registration["behaviour"].get<int32_t>();
+				entry.flags = registration["calling_convention"].get<uint32_t>();
+				break;
+			case RegistrySection::ObjectMethods:
+				entry.flags = registration["calling_convention"].get<uint32_t>();
+				break;
+			default:
+				break;
+			}
+
+			builder.add(static_cast<RegistrySection>(i), entry);
+		}
+	}
+
+	std::unique_ptr<Registry> registry(new Registry());
+	registry->mOwnedData = builder.build();
+	registry->mData = registry->mOwnedData.data();
+	registry->mSize = registry->mOwnedData.size();
+	return registry;
+}
+
+std::unique_ptr<Registry> Registry::fromFile(const std::string &path)
+{
+	using namespace boost::interprocess;
+
+	std::unique_ptr<Registry> registry(new Registry());
+	registry->mFile = file_mapping(path.c_str(), read_only);
+	registry->mRegion = mapped_region(registry->mFile, read_only);
+	registry->mData = static_cast<const uint8_t *>(registry->mRegion.get_address());
+	registry->mSize = registry->mRegion.get_size();
+
+	registry->validate();
+	return registry;
+}
+
+void Registry::validate() const
+{
+	if (mSize < sizeof(RegistryFileHeader) || memcmp(header().magic, cRegistryMagic, sizeof(cRegistryMagic)))
+		throw std::runtime_error("not a compiled registry");
+	if (header().version != cRegistryVersion)
+		throw std::runtime_error("compiled registry has version " + std::to_string(header().version) +
+			", expected " + std::to_string(cRegistryVersion));
+
+	const RegistryFileHeader &h = header();
+	if (h.stringPoolSize == 0 || static_cast<uint64_t>(h.stringPoolOffset) + h.stringPoolSize > mSize ||
+		mData[h.stringPoolOffset + h.stringPoolSize - 1] != '\0')
+		throw std::runtime_error("compiled registry has a broken string pool");
+
+	for (const auto &section : h.sections)
+	{
+		if (static_cast<uint64_t>(section.offset) + static_cast<uint64_t>(section.count) * sizeof(RegistryEntry) > h.stringPoolOffset)
+			throw std::runtime_error("compiled registry has a broken section table");
+
+		const RegistryEntry *entries = reinterpret_cast<const RegistryEntry *>(mData + section.offset);
+		for (uint32_t i = 0; i < section.count; ++i)
+		{
+			if (entries[i].nameSpace >= h.stringPoolSize || entries[i].objectName >= h.stringPoolSize ||
+				entries[i].declaration >= h.stringPoolSize)
+				throw std::runtime_error("compiled registry has a string outside of the string pool");
+		}
+	}
+}
+
+void Registry::save(const std::string &path) const
+{
+	fs::path file(path);
+	fs::create_directories(fs::absolute(file).parent_path());
+
+	fs::ofstream stream(file, std::ios::binary);
+	stream.write(reinterpret_cast<const char *>(mData), mSize);
+}
+
+uint64_t Registry::hash() const
+{
+	return fnv1a64(mData, mSize);
+}
+
+const RegistryEntry *Registry::entries(RegistrySection section) const
+{
+	return reinterpret_cast<const RegistryEntry *>(mData + header().sections[static_cast<size_t>(section)].offset);
+}
+
+uint32_t Registry::count(RegistrySection section) const
+{
+	return header().sections[static_cast<size_t>(section)].count;
+}
+
+std::unique_ptr<Registry> loadRegistry(bool verbose)
+{
+	TimingScope timing("csasm::loadRegistry");
+
+	fs::path location = boost::dll::program_location().parent_path();
+	fs::path jsonLocation = location / "tok_as_registry.json";
+	fs::path compiledLocation = location / "tok_as_registry.bin";
+
+	if (fs::exists(compiledLocation))
+	{
+		if (fs::exists(jsonLocation) && fs::last_write_time(jsonLocation) > fs::last_write_time(compiledLocation))
+		{
+			std::cout << "tok_as_registry.json is newer than tok_as_registry.bin, using the JSON registry. "
+				"Run \"csasm registry-compile\" to update it.\n";
+		}
+		else
+		{
+			try
+			{
+				return Registry::fromFile(compiledLocation.string());
+			}
+			catch (std::exception &e)
+			{
+				std::cout << "Ignoring " << compiledLocation.string() << ": " << e.what() << std::endl;
+			}
+		}
+	}
+	else if (verbose)
+	{
+		std::cout << "No compiled registry found, parsing " << jsonLocation.string() << std::endl;
+	}
+
+	if (!fs::exists(jsonLocation))
+	{
+		throw file_not_found(jsonLocation.string(), "Registry");
+	}
+
+	std::ifstream configStream(jsonLocation.c_str());
+	return Registry::fromJson(nlohmann::json::parse(configStream));
+}
+
+int compileRegistry(const std::string &inputPath, const std::string &outputPath)
+{
+	fs::path location = boost::dll::program_location().parent_path();
+	fs::path input = inputPath.empty() ? location / "tok_as_registry.json" : fs::path(inputPath);
+	fs::path output = outputPath.empty() ? location / "tok_as_registry.bin" : fs::path(outputPath);
+
+	if (!fs::exists(input))
+	{
+		throw file_not_found(input.string(), "Registry");
+	}
+
+	std::ifstream configStream(input.c_str());
+	std::unique_ptr<Registry> registry = Registry::fromJson(nlohmann::json::parse(configStream));
+	registry->save(output.string());
+
+	uint32_t entryCount = 0;
+	for (size_t i = 0; i < static_cast<size_t>(RegistrySection::Count); ++i)
+	{
+		entryCount += registry->count(static_cast<RegistrySection>(i));
+	}
+
+	std::cout << "Compiled " << entryCount << " registrations from " << input.string()
+		<< " into " << output.string() << " (" << fs::file_size(output) << " bytes)" << std::endl;
+	return 0;
+}
@@ -0,0 +1,100 @@
+#pragma once
+
+#include "json.hpp"
+
+#include <boost/interprocess/file_mapping.hpp>
+#include <boost/interprocess/mapped_region.hpp>
+
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+
+// The sections of tok_as_registry.json, in the order ConfigureEngine registers them
+enum class RegistrySection : uint32_t
+{
+	Namespaces,
+	ObjectTypes,
+	FuncDefs,
+	ObjectProperties,
+	ObjectBehaviours,
+	ObjectMethods,
+	GlobalFunctions,
+	GlobalProperties,
+
+	Count
+};
+
+// One registration. Strings are offsets into the string pool, the meaning of
+// value and flags depends on the section (size and flags for object types,
+// offset for properties, behaviour and calling convention for behaviours, ...)
+struct RegistryEntry
+{
+	uint32_t nameSpace;
+	uint32_t objectName;
+	uint32_t declaration;
+	int32_t value;
+	uint32_t flags;
+};
+
+struct RegistrySectionHeader
+{
+	uint32_t offset;
+	uint32_t count;
+};
+
+struct RegistryFileHeader
+{
+	char magic[4];
+	uint32_t version;
+	uint32_t stringPoolOffset;
+	uint32_t stringPoolSize;
+	RegistrySectionHeader sections[static_cast<uint32_t>(RegistrySection::Count)];
+};
+
+// The registry as a flat table with an interned string pool. The compiled form
+// (csasm registry-compile) is this exact layout on disk, so loading it is a
+// single memory mapping and the strings are handed to the engine in place.
+class Registry
+{
+public:
+	static std::unique_ptr<Registry> fromJson(const nlohmann::json &json);
+	static std::unique_ptr<Registry> fromFile(const std::string &path);
+
+	void save(const std::string &path) const;
+
+	const RegistryEntry *entries(RegistrySection section) const;
+	uint32_t count(RegistrySection section) const;
+
+	// Hash of the compiled form, identical for a JSON registry and its compiled version
+	uint64_t hash() const;
+
+	const char *string(uint32_t offset) const
+	{
+		return reinterpret_cast<const char *>(mData + header().stringPoolOffset + offset);
+	}
+
+private:
+	Registry() = default;
+
+	const RegistryFileHeader &header() const
+	{
+		return *reinterpret_cast<const RegistryFileHeader *>(mData);
+	}
+
+	void validate() const;
+
+	const uint8_t *mData = nullptr;
+	size_t mSize = 0;
+
+	// Backing storage, either built from JSON or mapped from a compiled registry
+	std::vector<uint8_t> mOwnedData;
+	boost::interprocess::file_mapping mFile;
+	boost::interprocess::mapped_region mRegion;
+};
+
+// Loads the compiled registry next to the executable, falling back to parsing the JSON registry
+std::unique_ptr<Registry> loadRegistry(bool verbose = false);
+
+// Implementation of "csasm registry-compile"
+int compileRegistry(const std::string &inputPath, const std::string &outputPath);
@@ -3,479 +3,173 @@
 #include <string>
 #include <vector>
 
-#include <boost/algorithm/string/replace.hpp>
-
 #include "angelscript.h"
-#include <../source/as_scriptengine.h>
-
+#include "output_sink.h"
 
-template<typename... A>
-static std::string fmtString(const std::string& format, A... args)
+static void dumpBytecode(OutputSink& out, const DecodedFunction& function)
 {
-	// Thread safe
-	static thread_local char sFormatBuf[2048];
-	snprintf(sFormatBuf, sizeof(sFormatBuf), format.c_str(), args...);
-	return std::string(sFormatBuf);
+	for (const auto& instruction : function.instructions)
+	{
+		out.write("\t\t", 2);
+		out.writeHex(instruction.position, 4);
+		out.write(": ", 2);
+		formatInstruction(out, function, instruction, InstructionStyle::Dump);
+		out.put('\n');
+	}
 }
 
 std::string dumpBytecode(asIScriptFunction* func)
 {
 	std::string dump;
-	asCScriptFunction* function = static_cast<asCScriptFunction*>(func);
-
-	asCScriptEngine* engine = static_cast<asCScriptEngine*>(function->GetEngine());
-
-	asUINT length;
-	asDWORD* code = function->GetByteCode(&length);
-	for (uint32_t position = 0; position < length; )
 	{
-		std::string disas = "UNK";
-
-		// Read opcode
-		asDWORD* inst = code + position;
-		asEBCInstr op = static_cast<asEBCInstr>(*reinterpret_cast<asBYTE*>(inst));
-		const char* mnem = asBCInfo[op].name;
-		switch (asBCInfo[op].type)
-		{
-		case asBCTYPE_NO_ARG: // no args
-		{
-			disas = fmtString("%-8s", mnem);
-		}
-		break;
-		case asBCTYPE_W_ARG: // word imm
-		{
-			asWORD arg0 = asBC_WORDARG0(inst);
-			switch (op)
-			{
-			case asBC_STR:
-			{
-				const auto& str = engine->GetConstantString(arg0);
-				std::string formatted = str.AddressOf();
-				boost::replace_all(formatted, "\\", "\\\\");
-				boost::replace_all(formatted, "\n", "\\n");
-				disas = fmtString("%-8s %d (%d:\"%s\")", mnem, arg0, str.GetLength(), formatted.c_str());
-			}
-			break;
-			default:
-				disas = fmtString("%-8s %d", mnem, arg0);
-				break;
-			}
-		}
-		break;
-		case asBCTYPE_wW_ARG: // word var dst
-		case asBCTYPE_rW_ARG: // word var src
-		{
-			uint16_t arg0 = asBC_WORDARG0(inst);
-			disas = fmtString("%-8s v%d", mnem,
-				reinterpret_cast<int16_t&>(arg0));
-		}
-		break;
-		case asBCTYPE_wW_rW_ARG: // word dst, word src
-		case asBCTYPE_rW_rW_ARG: // word src, word src
-		{
-			uint16_t arg0 = asBC_WORDARG0(inst);
-			uint16_t arg1 = asBC_WORDARG1(inst);
-			disas = fmtString("%-8s v%d, v%d", mnem,
-				reinterpret_cast<int16_t&>(arg0),
-				reinterpret_cast<int16_t&>(arg1));
-		}
-		break;
-		case asBCTYPE_wW_W_ARG: // word dst, word imm
-		{
-			uint16_t arg0 = asBC_WORDARG0(inst);
-			uint16_t arg1 = asBC_WORDARG1(inst);
-			disas = fmtString("%-8s v%d, %d", mnem,
-				reinterpret_cast<int16_t&>(arg0),
-				reinterpret_cast<int16_t&>(arg1));
-		}
-		break;
-		case asBCTYPE_wW_rW_DW_ARG: // word dst, word src, dword imm
-		case asBCTYPE_rW_W_DW_ARG:  // word src, word imm, dword imm
-		{
-			uint16_t arg0 = asBC_WORDARG0(inst);
-			uint16_t arg1 = asBC_WORDARG1(inst);
-			uint32_t arg2 = asBC_DWORDARG(inst);
-			switch (op)
-			{
-			case asBC_ADDIf:
-			case asBC_SUBIf:
-			case asBC_MULIf:
-				disas = fmtString("%-8s v%d, v%d, %f", mnem,
-					reinterpret_cast<int16_t&>(arg0),
-					reinterpret_cast<int16_t&>(arg1),
-					reinterpret_cast<float&>(arg2));
-				break;
-			default:
-				disas = fmtString("%-8s v%d, v%d, %d", mnem,
-					reinterpret_cast<int16_t&>(arg0),
-					reinterpret_cast<int16_t&>(arg1),
-					reinterpret_cast<int16_t&>(arg2));
-				break;
-			}
-		}
-		break;
-		case asBCTYPE_DW_ARG: // dword imm
-		{
-			uint32_t arg0 = asBC_DWORDARG(inst);
-			switch (op)
-			{
-			case asBC_OBJTYPE:
-			{
-				asIObjectType* type = reinterpret_cast<asIObjectType*>(arg0);
-				disas = fmtString("%-8s 0x%x (type:%s)", mnem, arg0, type->GetName());
-			}
-			break;
-			case asBC_FuncPtr:
-			{
-				asIScriptFunction* func = reinterpret_cast<asIScriptFunction*>(arg0);
-				disas = fmtString("%-8s 0x%x (func:%s)", mnem, arg0, func->GetDeclaration());
-			}
-			break;
-			case asBC_PshC4:
-			case asBC_Cast:
-				disas = fmtString("%-8s 0x%x (i:%d, f:%g)", mnem,
-					arg0, reinterpret_cast<int&>(arg0), reinterpret_cast<float&>(arg0));
-				break;
-			case asBC_TYPEID:
-				disas = fmtString("%-8s 0x%x (decl:%s)", mnem,
-					arg0, engine->GetTypeDeclaration(reinterpret_cast<int&>(arg0)));
-				break;
-			case asBC_PGA: // global vars
-			case asBC_PshGPtr:
-			case asBC_LDG:
-			case asBC_PshG4:
-			{
-				asCGlobalProperty* prop = function->GetPropertyByGlobalVarPtr(reinterpret_cast<void*>(arg0));
-				disas = fmtString("%-8s 0x%x (%d:%s)", mnem,
-					arg0,
-					prop->id,
-					prop->name.AddressOf());
-			}
-			break;
-			case asBC_CALL:
-			case asBC_CALLSYS:
-			case asBC_CALLBND:
-			case asBC_CALLINTF:
-			case asBC_Thiscall1:
-			{
-				asIScriptFunction* func;
-				if (arg0 & 0x40000000)
-				{
-					func = engine->importedFunctions[reinterpret_cast<int&>(arg0) & ~0x40000000]->importedFunctionSignature;
-				}
-				else
-				{
-					func = engine->GetFunctionById(reinterpret_cast<int&>(arg0));
-				}
-
-				disas = fmtString("%-8s %d (%s)", mnem,
-					arg0,
-					func->GetDeclaration(true, true, true));
-			}
-			break;
-			case asBC_REFCPY:
-				disas = fmtString("%-8s 0x%x", mnem, arg0);
-				break;
-			case asBC_JMP:
-			case asBC_JZ:
-			case asBC_JLowZ:
-			case asBC_JS:
-			case asBC_JP:
-			case asBC_JNZ:
-			case asBC_JLowNZ:
-			case asBC_JNS:
-			case asBC_JNP:
-				disas = fmtString("%-8s %+d (d:%x)", mnem,
-					reinterpret_cast<int&>(arg0),
-					position + reinterpret_cast<int&>(arg0));
-				break;
-			default:
-				disas = fmtString("%-8s %d", mnem, reinterpret_cast<int&>(arg0));
-				break;
-			}
-		}
-		break;
-		case asBCTYPE_QW_ARG: // qword imm
-		{
-			uint64_t arg0 = asBC_QWORDARG(inst);
-			// #todo-csasm: Potentially add 64-bit pointer opcode handling
-			disas = fmtString("%-8s 0x%llx (i:%lld, f:%g)", mnem,
-				arg0, reinterpret_cast<int64_t&>(arg0), reinterpret_cast<double&>(arg0));
-		}
-		break;
-		case asBCTYPE_wW_QW_ARG: // word dst, qword imm
-		case asBCTYPE_rW_QW_ARG: // word src, qword imm
-		{
-			uint16_t arg0 = asBC_WORDARG0(inst);
-			uint64_t arg1 = asBC_QWORDARG(inst);
-			switch (op)
-			{
-			case asBC_RefCpyV:
-			case asBC_FREE:
-			{
-				asIObjectType* type = reinterpret_cast<asIObjectType*>(arg1);
-				disas = fmtString("%-8s v%d, 0x%x (type:%s)", mnem,
-					reinterpret_cast<int16_t&>(arg0),
-					static_cast<uint32_t>(arg1),
-					type->GetName());
-			}
-			break;
-			default:
-				disas = fmtString("%-8s v%d, 0x%llx (i:%lld, f:%g)", mnem,
-					reinterpret_cast<int16_t&>(arg0),
-					arg1,
-					reinterpret_cast<int64_t&>(arg1),
-					reinterpret_cast<double&>(arg1));
-				break;
-			}
-		}
-		break;
-		case asBCTYPE_DW_DW_ARG: // dword imm, dword imm
-		{
-			// #todo-csasm: Investigate DW_DW layout further
-#define asBC_DWORDARG1(x)  (*(((asDWORD*)x)+2))
-			uint32_t arg0 = asBC_DWORDARG(inst);
-			uint32_t arg1 = asBC_DWORDARG1(inst);
-			switch (op)
-			{
-			case asBC_ALLOC:
-			{
-				asIObjectType* type = reinterpret_cast<asIObjectType*>(arg0);
-				asIScriptFunction* func = engine->GetFunctionById(asBC_WORDARG0(inst));
-				disas = fmtString("%-8s 0x%x, %d (type:%s, %s)", mnem,
-					arg0,
-					reinterpret_cast<int&>(arg1),
-					type->GetName(),
-					func ? func->GetDeclaration() : "{no func}");
-			}
-			break;
-			case asBC_SetG4:
-			{
-				asCGlobalProperty* prop = function->GetPropertyByGlobalVarPtr(reinterpret_cast<void*>(arg0));
-				disas = fmtString("%-8s 0x%x, %d (%d:%s)", mnem,
-					arg0,
-					reinterpret_cast<int&>(arg1),
-					prop->id,
-					prop->name.AddressOf());
-			}
-			break;
-			default:
-				disas = fmtString("%-8s %u, %d", mnem,
-					arg0,
-					reinterpret_cast<int&>(arg1));
-				break;
-			}
-		}
-		break;
-		case asBCTYPE_rW_DW_DW_ARG: // word src, dword imm, dword imm
-		{
-			uint16_t arg0 = asBC_WORDARG0(inst);
-			uint32_t arg1 = asBC_DWORDARG(inst);
-			uint32_t arg2 = asBC_DWORDARG1(inst);
-
-			disas = fmtString("%-8s v%d, %u, %u", mnem,
-				reinterpret_cast<int16_t&>(arg0), arg1, arg2);
-		}
-		break;
-		case asBCTYPE_QW_DW_ARG: // qword imm, dword imm
-		{
-			// #todo-csasm: Consider adding support for 64-bit asBC_ALLOC
-			uint64_t arg0 = asBC_QWORDARG(inst);
-			uint32_t arg1 = asBC_DWORDARG(inst);
-
-			disas = fmtString("%-8s %llu, %d", mnem,
-				reinterpret_cast<int64_t&>(arg0), reinterpret_cast<int&>(arg1));
-		}
-		break;
-		case asBCTYPE_INFO: // word imm
-		{
-			uint16_t arg0 = asBC_WORDARG0(inst);
-			switch (op)
-			{
-			case asBC_LABEL:
-				disas = fmtString("%d:", arg0);
-				break;
-			case asBC_LINE:
-				disas = fmtString("%-8s", mnem);
-				break;
-			case asBC_Block:
-				// #todo-csasm: Add block indenting
-				disas = fmtString("%c", arg0 ? '{' : '}');
-				break;
-			}
-		}
-		break;
-		case asBCTYPE_rW_DW_ARG: // word src, dword imm
-		case asBCTYPE_wW_DW_ARG: // word dst, dword imm
-		case asBCTYPE_W_DW_ARG: // word imm, dword imm
-		{
-			uint16_t arg0 = asBC_WORDARG0(inst);
-			uint32_t arg1 = asBC_DWORDARG(inst);
-			switch (op)
-			{
-			case asBC_SetV1:
-				disas = fmtString("%-8s v%d, 0x%x", mnem,
-					reinterpret_cast<int16_t&>(arg0),
-					static_cast<uint8_t>(arg1));
-				break;
-			case asBC_SetV2:
-				disas = fmtString("%-8s v%d, 0x%x", mnem,
-					reinterpret_cast<int16_t&>(arg0),
-					static_cast<uint16_t>(arg1));
-				break;
-			case asBC_SetV4:
-				disas = fmtString("%-8s v%d, 0x%x (i:%d, f:%g)", mnem,
-					reinterpret_cast<int16_t&>(arg0),
-					arg1,
-					reinterpret_cast<int&>(arg1),
-					reinterpret_cast<float&>(arg1));
-				break;
-			case asBC_CMPIf:
-				disas = fmtString("%-8s v%d, %f", mnem,
-					reinterpret_cast<int16_t&>(arg0),
-					reinterpret_cast<float&>(arg1));
-				break;
-			case asBC_LdGRdR4: // global vars
-			case asBC_CpyGtoV4:
-			case asBC_CpyVtoV4:
-			{
-				asCGlobalProperty* prop = function->GetPropertyByGlobalVarPtr(reinterpret_cast<void*>(arg1));
-				disas = fmtString("%-8s v%d, 0x%x (%d:%s)", mnem,
-					reinterpret_cast<int16_t&>(arg0),
-					reinterpret_cast<int&>(arg1),
-					prop->id,
-					prop->name.AddressOf());
-			}
-			break;
-			default:
-				disas = fmtString("%-8s v%d, %d", mnem,
-					reinterpret_cast<int16_t&>(arg0),
-					reinterpret_cast<int&>(arg1));
-				break;
-			}
-		}
-		break;
-		case asBCTYPE_wW_rW_rW_ARG: // dst word, src word, src word
-		{
-			// #todo-csasm: Investigate wW_rW_rW layout further
-#define asBC_WORDARG2(x)  (*(((asWORD*)x)+3))
-			uint16_t arg0 = asBC_WORDARG0(inst);
-			uint16_t arg1 = asBC_WORDARG1(inst);
-			uint16_t arg2 = asBC_WORDARG2(inst);
-			disas = fmtString("%-8s v%d, v%d, v%d", mnem,
-				reinterpret_cast<int16_t&>(arg0),
-				reinterpret_cast<int16_t&>(arg1),
-				reinterpret_cast<int16_t&>(arg2));
-		}
-		break;
-		default:
-			__debugbreak();
-			break;
-		}
-		dump.append(fmtString("\t\t%04x: %s\n", position, disas.c_str()));
-
-		position += asBCTypeSize[asBCInfo[op].type];
+		StringOutputSink out(dump);
+		dumpBytecode(out, decodeFunction(func));
 	}
 	return dump;
 }
 
 std::string dumpModule(asIScriptModule* module, const std::vector<std::string>& dependencies)
+{
+	std::string dump;
+	{
+		StringOutputSink out(dump);
+		dumpModule(out, module, dependencies, decodeModule(module));
+	}
+	return dump;
+}
+
+void dumpModule(OutputSink& out, asIScriptModule* module, const std::vector<std::string>& dependencies, const DecodedModule& decoded)
 {
 	// Dump all information in the module
-	std::string dump = "";
 
 	// Dependencies
-	dump.append(fmtString("dependencies: %zu\n", dependencies.size()));
+	out.write("dependencies: ");
+	out.writeUInt(dependencies.size());
+	out.put('\n');
 	for (const auto& dependency : dependencies)
 	{
-		dump.append(fmtString("\t%s\n", dependency.c_str()));
+		out.put('\t');
+		out.write(dependency);
+		out.put('\n');
 	}
 
 	// Enums
-	dump.append(fmtString("enums: %u\n", module->GetEnumCount()));
+	out.write("enums: ");
+	out.writeUInt(module->GetEnumCount());
+	out.put('\n');
 	for (unsigned int i = 0; i < module->GetEnumCount(); ++i)
 	{
 		int typeId;
 		const char* nameSpace;
 		const char* enumName = module->GetEnumByIndex(i, &typeId, &nameSpace);
 
-		std::string prefix = "";
-		if (std::string(nameSpace) != "")
+		out.put('\t');
+		if (nameSpace[0] != '\0')
 		{
-			prefix = nameSpace;
-			prefix += "::";
+			out.write(nameSpace);
+			out.write("::", 2);
 		}
-		dump.append(fmtString("\t%s%s",
-			prefix.c_str(),
-			enumName));
+		out.write(enumName);
 
 		asIObjectType* type = module->GetEngine()->GetObjectTypeById(typeId);
 		if (type)
 		{
-			dump.append(fmtString(" : %s", type->GetName()));
+			out.write(" : ", 3);
+			out.write(type->GetName());
 		}
-		dump.append("\n");
+		out.put('\n');
 
 		// Values
 		for (int j = 0; j < module->GetEnumValueCount(typeId); ++j)
 		{
 			int value;
 			const char* valueName = module->GetEnumValueByIndex(typeId, j, &value);
-			dump.append(fmtString("\t\t%s = %d,\n", valueName, value));
+			out.write("\t\t", 2);
+			out.write(valueName);
+			out.write(" = ", 3);
+			out.writeInt(value);
+			out.write(",\n", 2);
 		}
 	}
 
 	// Typedefs
-	dump.append(fmtString("typedefs: %u\n", module->GetTypedefCount()));
+	out.write("typedefs: ");
+	out.writeUInt(module->GetTypedefCount());
+	out.put('\n');
 	for (unsigned int i = 0; i < module->GetTypedefCount(); ++i)
 	{
 		int typeId;
 		const char* typedefName = module->GetTypedefByIndex(i, &typeId);
-		dump.append(fmtString("\t%s %d\n", typedefName, typeId));
+		out.put('\t');
+		out.write(typedefName);
+		out.put(' ');
+		out.writeInt(typeId);
+		out.put('\n');
 	}
 
 	// Object types
-	dump.append(fmtString("object_types: %u\n", module->GetObjectTypeCount()));
+	out.write("object_types: ");
+	out.writeUInt(module->GetObjectTypeCount());
+	out.put('\n');
 	for (unsigned int i = 0; i < module->GetObjectTypeCount(); ++i)
 	{
 		asIObjectType* type = module->GetObjectTypeByIndex(i);
-		dump.append(fmtString("\t%s %d %08x\n", type->GetName(), type->GetSize(), type->GetFlags()));
+		out.put('\t');
+		out.write(type->GetName());
+		out.put(' ');
+		out.writeInt(type->GetSize());
+		out.put(' ');
+		out.writeHex(type->GetFlags(), 8);
+		out.put('\n');
 		// #todo-csasm: Advanced object type dumping
-		dump.append(fmtString("\t\tproperties: %u\n", type->GetPropertyCount()));
+		out.write("\t\tproperties: ");
+		out.writeUInt(type->GetPropertyCount());
+		out.put('\n');
 		for (unsigned int j = 0; j < type->GetPropertyCount(); ++j)
 		{
-			dump.append(fmtString("\t\t\t%s\n", type->GetPropertyDeclaration(j)));
+			out.write("\t\t\t", 3);
+			out.write(type->GetPropertyDeclaration(j));
+			out.put('\n');
 		}
 	}
 
 	// Global variables
-	dump.append(fmtString("global_variables: %u\n", module->GetGlobalVarCount()));
+	out.write("global_variables: ");
+	out.writeUInt(module->GetGlobalVarCount());
+	out.put('\n');
 	for (unsigned int i = 0; i < module->GetGlobalVarCount(); ++i)
 	{
 		// #todo-csasm: Dump global variables
-		dump.append(fmtString("\t%s\n", module->GetGlobalVarDeclaration(i, true)));
+		out.put('\t');
+		out.write(module->GetGlobalVarDeclaration(i, true));
+		out.put('\n');
 	}
 
 	// Imported functions
-	dump.append(fmtString("imported_functions: %u\n", module->GetImportedFunctionCount()));
+	out.write("imported_functions: ");
+	out.writeUInt(module->GetImportedFunctionCount());
+	out.put('\n');
 	for (unsigned int i = 0; i < module->GetImportedFunctionCount(); ++i)
 	{
 		// #todo-csasm: Dump imported functions
-		dump.append(fmtString("\t%s (from %s)\n",
-			module->GetImportedFunctionDeclaration(i),
-			module->GetImportedFunctionSourceModule(i)));
+		out.put('\t');
+		out.write(module->GetImportedFunctionDeclaration(i));
+		out.write(" (from ");
+		out.write(module->GetImportedFunctionSourceModule(i));
+		out.write(")\n", 2);
 	}
 
 	// Functions
-	dump.append(fmtString("functions: %u\n", module->GetFunctionCount()));
+	out.write("functions: ");
+	out.writeUInt(module->GetFunctionCount());
+	out.put('\n');
 	for (unsigned int i = 0; i < module->GetFunctionCount(); ++i)
 	{
-		asIScriptFunction* func = module->GetFunctionByIndex(i);
+		const DecodedFunction& function = decoded.functions[i];
 		// #todo-csasm: Dump functions
-		dump.append(fmtString("\t%s\n",
-			func->GetDeclaration(true, true, true)));
-		dump.append(dumpBytecode(func));
+		out.put('\t');
+		out.write(function.declaration);
+		out.put('\n');
+		dumpBytecode(out, function);
 	}
-
-	return dump;
 }
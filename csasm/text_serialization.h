@@ -3,6 +3,11 @@
 #include <vector>
 
 #include "angelscript.h"
+#include "bytecode_decoder.h"
+
+class OutputSink;
 
 std::string dumpBytecode(asIScriptFunction* func);
 std::string dumpModule(asIScriptModule* module, const std::vector<std::string>& dependencies);
+// Streams the dump into out, reusing bytecode that was already decoded for another output
+void dumpModule(OutputSink& out, asIScriptModule* module, const std::vector<std::string>& dependencies, const DecodedModule& decoded);
@@ -0,0 +1,86 @@
+#include "timings.h"
+
+#include "format.h"
+#include "json.hpp"
+
+#include <angelscript.h>
+
+#include <iostream>
+#include <string>
+#include <vector>
+
+namespace
+{
+	struct TimingEntry
+	{
+		std::string path;
+		std::string name;
+		int depth;
+		uint64_t count;
+		double total;
+		double min;
+		double max;
+	};
+}
+
+static void collectTiming(const char *path, const char *name, int depth, asQWORD count, double totalSeconds, double minSeconds, double maxSeconds, void *param)
+{
+	static_cast<std::vector<TimingEntry> *>(param)->push_back({ path, name, depth, count, totalSeconds, minSeconds, maxSeconds });
+}
+
+TimingScope::TimingScope(const char *name)
+	: mActive(asBeginProfilerScope(name) > 0)
+{
+
+}
+
+TimingScope::~TimingScope()
+{
+	if (mActive)
+		asEndProfilerScope();
+}
+
+bool enableTimings()
+{
+	return asSetProfilerEnabled(true) >= 0;
+}
+
+void printTimings(const std::string &format)
+{
+	std::vector<TimingEntry> entries;
+	if (asEnumerateProfilerScopes(collectTiming, &entries) < 0)
+	{
+		std::cout << "Timings are not available, the AngelScript library was built without AS_PROFILE" << std::endl;
+		return;
+	}
+
+	if (format == "json")
+	{
+		// Flat list in depth-first order, path joins the nested scope names with '|'
+		nlohmann::json scopes = nlohmann::json::array();
+		for (const auto &entry : entries)
+		{
+			scopes.push_back({
+				{ "path", entry.path },
+				{ "count", entry.count },
+				{ "total_ms", entry.total * 1000.0 },
+				{ "min_ms", entry.min * 1000.0 },
+				{ "max_ms", entry.max * 1000.0 },
+			});
+		}
+		nlohmann::json json;
+		json["scopes"] = scopes;
+		std::cout << json.dump(1, '\t') << std::endl;
+		return;
+	}
+
+	// Scopes that ran on several threads are summed, so a total can exceed the wall time
+	std::cout << fmtString("\n%-48s %10s %12s %10s %10s %10s\n", "scope", "count", "total ms", "avg ms", "min ms", "max ms");
+	for (const auto &entry : entries)
+	{
+		std::string label = std::string(entry.depth * 2, ' ') + entry.name;
+		double average = entry.count ? entry.total / entry.count : 0.0;
+		std::cout << fmtString("%-48s %10llu %12.3f %10.4f %10.4f %10.4f\n", label.c_str(),
+			static_cast<unsigned long long>(entry.count), entry.total * 1000.0, average * 1000.0, entry.min * 1000.0, entry.max * 1000.0);
+	}
+}
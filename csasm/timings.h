@@ -0,0 +1,26 @@
+#pragma once
+
+#include <string>
+
+// Times the enclosing scope with the AngelScript profiler (--timings), so that the
+// csasm phases nest with the engine's own scopes such as asCReader::Read. Costs
+// a flag check while timings are off or the library was built without AS_PROFILE.
+class TimingScope
+{
+public:
+	explicit TimingScope(const char *name);
+	~TimingScope();
+
+	TimingScope(const TimingScope &) = delete;
+	TimingScope &operator=(const TimingScope &) = delete;
+
+private:
+	// Whether a scope was begun, so it is ended even if timings are turned off meanwhile
+	bool mActive;
+};
+
+// Starts collecting timings. Returns false if the library can't profile.
+bool enableTimings();
+
+// Prints the timings collected on every thread so far, as "table" or "json"
+void printTimings(const std::string &format);
@@ -4,6 +4,10 @@
 #include <vector>
 
 #include "angelscript.h"
+#include "bytecode_decoder.h"
+
+class OutputSink;
 
-//std::string serializeBytecode(asIScriptFunction* func);
 std::string serializeModuleYaml(asIScriptModule* module, const std::vector<std::string>& dependencies);
+// Streams the YAML into out, reusing bytecode that was already decoded for another output
+void serializeModuleYaml(OutputSink& out, asIScriptModule* module, const std::vector<std::string>& dependencies, const DecodedModule& decoded);